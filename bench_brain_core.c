@@ -9,6 +9,7 @@
  *   - brain_recall() search speed
  *   - organ initialization time
  *   - event loop tick overhead
+ *   - Hippocampus store / retrieve / recall / reload at 10k and 100k memories
  *
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
@@ -18,9 +19,14 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <math.h>
 
 #define BENCHMARK_ITERATIONS 10000
 #define MEMORY_TEST_SIZE 1000
+#define SCALE_DB "bench_hippocampus.db"
+#define BENCH_DB "bench_brain_core.db"           /* g_brain (실제 HIPPO_DB_PATH는 건드리지 않음) */
+#define SCRATCH_DB "bench_brain_core_scratch.db" /* Test 2 / 3의 임시 뇌 */
+#define SCALE_RETRIEVE_ITERATIONS 1000
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * Test Functions (Closures)
@@ -44,7 +50,49 @@ static void bench_brain_remember(void* arg) {
 
 /* Test: brain_recall() */
 static void bench_brain_recall(void* arg) {
-    char** results = brain_recall(g_brain, "memory", 5);
+    hippocampus_recall_t results;
+    if (brain_recall(g_brain, "memory", 5, &results) >= 0) {
+        brain_recall_release(&results);
+    }
+}
+
+/* Hippocampus 직접 (brain_t 잠금 / 벡터화 없이) */
+static hippocampus_t* g_hippo = NULL;
+static uint32_t g_hippo_next = 0;       /* 다음 저장 / 조회 번호 */
+
+/* 장기 기억 파일 + 옆 파일 (WAL, 저장된 인덱스) 지우기 */
+static void remove_memory(const char* path) {
+    char side[256];
+    unlink(path);
+    snprintf(side, sizeof(side), "%s%s", path, HIPPO_WAL_SUFFIX);
+    unlink(side);
+    snprintf(side, sizeof(side), "%s%s", path, HIPPO_INDEX_SUFFIX);
+    unlink(side);
+}
+
+static void scale_vector(float* vector, uint32_t n) {
+    for (int i = 0; i < HIPPO_VECTOR_DIM; i++) {
+        vector[i] = sinf((float)n * 0.37f + (float)i * 0.1f);
+    }
+}
+
+/* Test: hippocampus_store() */
+static void bench_hippo_store(void* arg) {
+    (void)arg;
+    float vector[HIPPO_VECTOR_DIM];
+    char buffer[128];
+    scale_vector(vector, g_hippo_next);
+    snprintf(buffer, sizeof(buffer), "Scaled memory #%u", g_hippo_next++);
+    hippocampus_store(g_hippo, buffer, vector, 0.9f);
+}
+
+/* Test: hippocampus_retrieve() top-10 */
+static void bench_hippo_retrieve(void* arg) {
+    uint32_t count = *(const uint32_t*)arg;
+    float vector[HIPPO_VECTOR_DIM];
+    scale_vector(vector, (g_hippo_next++ * 7919u) % count);
+
+    memory_entry_t** results = hippocampus_retrieve(g_hippo, vector, 10);
     if (results) {
         for (int i = 0; results[i] != NULL; i++) {
             free(results[i]);
@@ -53,6 +101,18 @@ static void bench_brain_recall(void* arg) {
     }
 }
 
+/* Test: hippocampus_recall() top-10 (복사 없이 매핑 안 뷰, 핀 하나만 잡고 놓음) */
+static void bench_hippo_recall(void* arg) {
+    uint32_t count = *(const uint32_t*)arg;
+    float vector[HIPPO_VECTOR_DIM];
+    scale_vector(vector, (g_hippo_next++ * 7919u) % count);
+
+    hippocampus_recall_t results;
+    if (hippocampus_recall(g_hippo, vector, 10, &results) >= 0) {
+        hippocampus_recall_release(&results);
+    }
+}
+
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * Test Suite
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
@@ -96,7 +156,8 @@ void test_memory_usage(void) {
     printf("\n📊 Testing memory efficiency...\n");
 
     /* Create fresh brain */
-    brain_t* test_brain = brain_create();
+    remove_memory(SCRATCH_DB);
+    brain_t* test_brain = brain_create_ex(SCRATCH_DB);
     printf("   ✓ Brain created\n");
 
     /* Store memories */
@@ -119,6 +180,7 @@ void test_memory_usage(void) {
     printf("   Estimated usage:      ~%.1f MB\n", 2.1 + (MEMORY_TEST_SIZE * 650.0 / 1024 / 1024));
 
     brain_destroy(test_brain);
+    remove_memory(SCRATCH_DB);
     printf("\n   ✓ Brain destroyed\n");
 }
 
@@ -131,8 +193,9 @@ void test_brain_lifecycle(void) {
     uint64_t start, end;
 
     printf("\n⏱️  Measuring initialization time...\n");
+    remove_memory(SCRATCH_DB);
     start = benchmark_get_timestamp_us();
-    brain_t* test_brain = brain_create();
+    brain_t* test_brain = brain_create_ex(SCRATCH_DB);
     end = benchmark_get_timestamp_us();
     printf("   ✓ brain_create(): %lu μs\n", end - start);
 
@@ -140,6 +203,59 @@ void test_brain_lifecycle(void) {
     brain_destroy(test_brain);
     end = benchmark_get_timestamp_us();
     printf("   ✓ brain_destroy(): %lu μs\n", end - start);
+    remove_memory(SCRATCH_DB);
+}
+
+/* Test: Hippocampus scaling (파일 + ID 인덱스 + HNSW) */
+void test_hippocampus_scaling(void) {
+    printf("\n╔════════════════════════════════════════════════════════════════╗\n");
+    printf("║              Test 4: Hippocampus Store / Retrieve Scaling     ║\n");
+    printf("╚════════════════════════════════════════════════════════════════╝\n");
+
+    static const uint32_t sizes[] = { 10000, 100000 };
+    static const char* names[][3] = {
+        { "hippo_store_10k", "hippo_retrieve_10k", "hippo_recall_10k" },
+        { "hippo_store_100k", "hippo_retrieve_100k", "hippo_recall_100k" }
+    };
+    benchmark_result_t results[6];
+    int count = 0;
+
+    for (int s = 0; s < 2; s++) {
+        uint32_t n = sizes[s];
+        remove_memory(SCALE_DB);
+
+        g_hippo = hippocampus_create_ex(SCALE_DB, n);
+        if (!g_hippo) return;
+
+        printf("\n💾 Storing %u memories...\n", n);
+        g_hippo_next = 0;
+        benchmark_run(names[s][0], bench_hippo_store, NULL, n, &results[count++]);
+        uint32_t stored = hippocampus_get_count(g_hippo);
+        hippocampus_destroy(g_hippo);
+
+        /* 다시 열기 = 파일 매핑 (WAL) + 닫을 때 저장된 인덱스 로드 */
+        g_hippo = hippocampus_create_ex(SCALE_DB, n);
+        if (!g_hippo) return;
+        printf("   ✓ %u stored, reloaded %u in %.1f ms (%.0f memories/sec)\n",
+               stored, hippocampus_get_count(g_hippo), g_hippo->load_ms,
+               hippocampus_get_count(g_hippo) / (g_hippo->load_ms / 1000.0 + 1e-9));
+
+        printf("\n🔍 Retrieving top-10 from %u memories...\n", n);
+        g_hippo_next = 0;
+        benchmark_run(names[s][1], bench_hippo_retrieve, &n, SCALE_RETRIEVE_ITERATIONS,
+                      &results[count++]);
+
+        printf("\n🔍 Recalling top-10 (zero-copy) from %u memories...\n", n);
+        g_hippo_next = 0;
+        benchmark_run(names[s][2], bench_hippo_recall, &n, SCALE_RETRIEVE_ITERATIONS,
+                      &results[count++]);
+
+        hippocampus_destroy(g_hippo);
+        g_hippo = NULL;
+        remove_memory(SCALE_DB);
+    }
+
+    benchmark_print_table(results, count);
 }
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -153,7 +269,8 @@ int main(void) {
     printf("╚════════════════════════════════════════════════════════════════════╝\n");
 
     printf("\n🧠 Creating Brain instance for benchmarks...\n");
-    g_brain = brain_create();
+    remove_memory(BENCH_DB);    /* 이전 실행의 장기 기억 없이 */
+    g_brain = brain_create_ex(BENCH_DB);
     if (!g_brain) {
         fprintf(stderr, "Error: Failed to create brain\n");
         return 1;
@@ -173,6 +290,7 @@ int main(void) {
     test_brain_lifecycle();
     test_throughput();
     test_memory_usage();
+    test_hippocampus_scaling();
 
     /* Summary */
     printf("\n╔════════════════════════════════════════════════════════════════════╗\n");
@@ -195,6 +313,7 @@ int main(void) {
     /* Cleanup */
     printf("\n🛑 Cleaning up...\n");
     brain_destroy(g_brain);
+    remove_memory(BENCH_DB);
     printf("   ✓ Done\n");
 
     printf("\n✅ Benchmark suite complete!\n\n");
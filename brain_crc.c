@@ -0,0 +1,139 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_crc.c
+ *
+ * CRC32C 구현 (런타임 디스패치)
+ *
+ * Zero Dependency: 컴파일러 내장 intrinsic만 사용
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#include "brain_crc.h"
+#include <string.h>
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CRC_X86 1
+#include <immintrin.h>
+#endif
+
+#define CRC32C_POLY 0x82F63B78u
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Slicing-by-8 (기준 구현)
+ *
+ * g_table[0]은 바이트 단위 테이블, g_table[k]는 바이트 뒤에
+ * 0이 k개 더 붙었을 때의 CRC → 8바이트를 테이블 8번 조회로 처리
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static uint32_t g_table[8][256];
+
+static void table_init(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) c = (c >> 1) ^ (CRC32C_POLY & (0u - (c & 1)));
+        g_table[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int k = 1; k < 8; k++) {
+            uint32_t c = g_table[k - 1][i];
+            g_table[k][i] = (c >> 8) ^ g_table[0][c & 0xFF];
+        }
+    }
+}
+
+static inline uint32_t load_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t crc_slice8(uint32_t crc, const uint8_t* p, size_t len) {
+    while (len >= 8) {
+        uint32_t lo = crc ^ load_le32(p);
+        uint32_t hi = load_le32(p + 4);
+        crc = g_table[7][lo & 0xFF] ^ g_table[6][(lo >> 8) & 0xFF] ^
+              g_table[5][(lo >> 16) & 0xFF] ^ g_table[4][lo >> 24] ^
+              g_table[3][hi & 0xFF] ^ g_table[2][(hi >> 8) & 0xFF] ^
+              g_table[1][(hi >> 16) & 0xFF] ^ g_table[0][hi >> 24];
+        p += 8;
+        len -= 8;
+    }
+    while (len--) crc = g_table[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * SSE4.2 (crc32 명령, 8바이트씩)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+#ifdef CRC_X86
+__attribute__((target("sse4.2")))
+static uint32_t crc_sse42(uint32_t crc, const uint8_t* p, size_t len) {
+#if defined(__x86_64__)
+    uint64_t c = crc;
+    while (len >= 8) {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v));
+        c = _mm_crc32_u64(c, v);
+        p += 8;
+        len -= 8;
+    }
+    crc = (uint32_t)c;
+#endif
+    while (len >= 4) {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        crc = _mm_crc32_u32(crc, v);
+        p += 4;
+        len -= 4;
+    }
+    while (len--) crc = _mm_crc32_u8(crc, *p++);
+    return crc;
+}
+#endif
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Dispatch
+ *
+ * 첫 호출 시 pthread_once로 한 번만 결정 (g_table 채우기 포함,
+ * 동시에 처음 부르는 스레드는 끝날 때까지 기다림)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+typedef struct {
+    uint32_t (*update)(uint32_t crc, const uint8_t* p, size_t len);
+    const char* name;
+} crc_impl_t;
+
+static crc_impl_t g_impl;
+static pthread_once_t g_impl_once = PTHREAD_ONCE_INIT;
+
+static void resolve_impl(void) {
+    crc_impl_t impl = { crc_slice8, "slice8" };
+
+    table_init();
+
+#ifdef CRC_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) {
+        impl.update = crc_sse42;
+        impl.name = "sse4.2";
+    }
+#endif
+
+    g_impl = impl;
+}
+
+static inline const crc_impl_t* impl(void) {
+    pthread_once(&g_impl_once, resolve_impl);
+    return &g_impl;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Public API
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+uint32_t brain_crc32c(uint32_t crc, const void* data, size_t len) {
+    return ~impl()->update(~crc, (const uint8_t*)data, len);
+}
+
+uint32_t brain_crc32c_sw(uint32_t crc, const void* data, size_t len) {
+    impl();     /* 테이블 초기화 */
+    return ~crc_slice8(~crc, (const uint8_t*)data, len);
+}
+
+const char* brain_crc32c_impl(void) {
+    return impl()->name;
+}
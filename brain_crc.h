@@ -0,0 +1,34 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_crc.h
+ *
+ * CRC32C (Castagnoli, 반사 다항식 0x82F63B78)
+ *
+ * 사용처:
+ *   - WAL 레코드 / 스냅샷
+ *   - Brain 레코드 체크섬 (벡터 + 메타데이터)
+ *   - ID 인덱스 페이지 체크섬
+ *
+ * 구현 선택 순서 (x86-64):
+ *   SSE4.2 crc32 명령 → Slicing-by-8 테이블
+ *   그 외 아키텍처는 Slicing-by-8
+ *
+ * -march 플래그 없이 빌드해도 target attribute로 SSE4.2 경로가 컴파일되며,
+ * 실행 시 __builtin_cpu_supports()로 선택된다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#ifndef BRAIN_CRC_H
+#define BRAIN_CRC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* CRC32C (crc = 이전 결과, 처음은 0) */
+uint32_t brain_crc32c(uint32_t crc, const void* data, size_t len);
+
+/* 디스패치 없이 테이블 구현 강제 (검증용) */
+uint32_t brain_crc32c_sw(uint32_t crc, const void* data, size_t len);
+
+/* 선택된 구현 이름 ("sse4.2", "slice8") */
+const char* brain_crc32c_impl(void);
+
+#endif /* BRAIN_CRC_H */
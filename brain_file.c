@@ -0,0 +1,2143 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_file.c
+ *
+ * Brain 파일 저장 엔진
+ *
+ * 쓰기:
+ *   - 레코드 번호 = header->record_count (추가 전용)
+ *   - chunk k가 처음 필요할 때 RECORDS / VECTORS / COUNTERS 영역을 함께 할당
+ *   - 메타데이터는 현재 heap extent 끝에 bump 할당
+ *     (extent가 차면 2배 크기로 새 extent, 남은 꼬리는 버림)
+ *   - 덮어쓰기/삭제는 레코드에 DELETED 표시 + heap_dead 집계
+ *     (공간 회수는 brain_file_compact_step)
+ *
+ * 빈 공간:
+ *   - 모든 영역은 brain_alloc_region (FREE 섹션 first-fit → 파일 끝)
+ *   - 인덱스 재해시도 같은 할당기를 쓰고, 재해시가 끝난 이전 테이블은
+ *     FREE 섹션으로 반환된다
+ *
+ * 읽기:
+ *   - ID → index_lookup → 레코드 번호 → chunk 오프셋 캐시로 주소 계산
+ *   - 복사 없이 매핑 안 포인터 (벡터는 BRAIN_ALIGN 정렬)
+ *
+ * WAL (선택):
+ *   - append / delete = 로그 레코드 + 매핑 갱신, 내구화는 그룹 커밋
+ *   - 복구 = 스냅샷 헤더 → 레코드 상태 되돌림 → 인덱스 재구축 → 재생
+ *
+ * Dirty 추적 (BRAIN_OPEN_TRACK / brain_file_set_flush_age):
+ *   - 매핑을 바꾸는 경로가 쓴 범위를 mmap_file_mark_dirty로 표시
+ *     (헤더 + 디렉터리는 변경 단위 끝에 한 번, 복구는 파일 전체)
+ *
+ * 무결성:
+ *   - 레코드마다 CRC32C (쓰기 때 계산), 인덱스 페이지 CRC는 체크포인트 때 봉인
+ *   - 검사는 첫 조회 / 새벽 scrub / 안 함 중 선택 (brain_file_set_verify)
+ *
+ * 보조 인덱스:
+ *   - timestamp / importance 정렬 run + 메모리 delta (brain_file_range)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* clock_gettime (scrub 토큰 버킷) 선언을 위해 필요 */
+#define _POSIX_C_SOURCE 200809L
+
+#include "brain_file.h"
+#include "brain_crc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 내부 헬퍼
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 매핑 안 p부터 len 바이트를 썼음 (추적 중일 때만 기록, 쓴 뒤에 호출) */
+static void mark_dirty(const brain_file_t* bf, const void* p, uint64_t len) {
+    mmap_file_mark_dirty(bf->mf, (size_t)((const char*)p - (const char*)bf->mf->addr), len);
+}
+
+/* 헤더 + 섹션 디렉터리 (record_count / 카운트 / 섹션 used / 인덱스 메타) */
+static void mark_header(const brain_file_t* bf) {
+    const brain_header_t* header = brain_file_header(bf);
+    mmap_file_mark_dirty(bf->mf, 0, header->section_offset +
+                         (uint64_t)header->section_capacity * sizeof(brain_section_t));
+}
+
+/* 레코드 하나가 차지하는 영역 (레코드 / 벡터 / 메타데이터 / 카운터) */
+static void mark_entry(const brain_file_t* bf, const brain_entry_t* e) {
+    mark_dirty(bf, e->record, sizeof(brain_record_t));
+    mark_dirty(bf, e->vector, brain_file_header(bf)->vector_stride);
+    if (e->metadata) mark_dirty(bf, e->metadata, e->meta_len);
+    if (e->timestamp) {
+        mark_dirty(bf, e->timestamp, sizeof(*e->timestamp));
+        mark_dirty(bf, e->access_count, sizeof(*e->access_count));
+        mark_dirty(bf, e->importance, sizeof(*e->importance));
+    }
+}
+
+/* 할당으로 file_size가 매핑보다 커졌으면 재매핑 */
+static int grow_mapping(brain_file_t* bf) {
+    uint64_t file_size = brain_file_header(bf)->file_size;
+    if (file_size <= bf->mf->size) return 0;
+    return mmap_file_resize(bf->mf, file_size);
+}
+
+/* 재해시가 끝난 이전 인덱스 테이블을 FREE로 반환 */
+static void reclaim_index(brain_file_t* bf) {
+    brain_header_t* header = brain_file_header(bf);
+    if (bf->retire_size == 0 || header->index.old_table_offset != 0) return;
+
+    brain_free_region(header, bf->retire_offset, bf->retire_size);
+    bf->retire_offset = 0;
+    bf->retire_size = 0;
+}
+
+/* index_manager 재해시 테이블 할당 (현재 테이블은 곧 이전 테이블이 됨) */
+static uint64_t alloc_index_table(void* ctx, mmap_file_t* mf, uint64_t size) {
+    brain_file_t* bf = (brain_file_t*)ctx;
+    (void)mf;
+
+    reclaim_index(bf);
+
+    brain_header_t* header = brain_file_header(bf);
+    bf->retire_offset = header->index.table_offset;
+    bf->retire_size = index_table_size(header->index.log2, index_layout(bf->index));
+
+    uint64_t offset = brain_alloc_region(header, size);
+    if (grow_mapping(bf) < 0) return 0;
+    return offset;
+}
+
+/* chunk k의 RECORDS / VECTORS / COUNTERS 영역 할당 (매핑 확장은 호출자) */
+static int alloc_chunk(brain_file_t* bf, uint32_t k) {
+    if (k >= BRAIN_MAX_CHUNKS) return -1;
+    if (bf->rec_chunk[k] != 0) return 0;
+
+    brain_header_t* header = brain_file_header(bf);
+    if (header->section_count + 3 > header->section_capacity) {
+        fprintf(stderr, "[brain] Error: no room for chunk %u\n", k);
+        return -1;
+    }
+
+    uint64_t records = brain_chunk_records(header, k);
+    uint64_t rec_size = records * sizeof(brain_record_t);
+    uint64_t vec_size = records * header->vector_stride;
+    uint64_t cnt_size = records * BRAIN_COUNTER_BYTES;
+    uint64_t rec_offset = brain_alloc_region(header, rec_size);
+    uint64_t vec_offset = brain_alloc_region(header, vec_size);
+    uint64_t cnt_offset = brain_alloc_region(header, cnt_size);
+
+    brain_section_add(header, BRAIN_SECTION_RECORDS, k, rec_offset, rec_size);
+    brain_section_add(header, BRAIN_SECTION_VECTORS, k, vec_offset, vec_size);
+    brain_section_add(header, BRAIN_SECTION_COUNTERS, k, cnt_offset, cnt_size);
+
+    bf->rec_chunk[k] = rec_offset;
+    bf->vec_chunk[k] = vec_offset;
+    bf->cnt_chunk[k] = cnt_offset;
+    return 0;
+}
+
+static int ensure_chunk(brain_file_t* bf, uint32_t k) {
+    if (k < BRAIN_MAX_CHUNKS && bf->rec_chunk[k] != 0) return 0;
+    if (alloc_chunk(bf, k) < 0) return -1;
+    return grow_mapping(bf);
+}
+
+/* 체크포인트 후 첫 변경 전에 BEGIN을 내구화
+ * → 매핑 변경이 로그보다 먼저 디스크에 나가도 다음 열기에서 복구가 돈다 */
+static int wal_touch(brain_file_t* bf) {
+    if (!bf->wal || bf->wal_dirty) return 0;
+
+    uint64_t lsn;
+    if (brain_wal_log(bf->wal, BRAIN_WAL_BEGIN, NULL, 0, &lsn) < 0 ||
+        brain_wal_commit(bf->wal, lsn) < 0) return -1;
+    bf->wal_dirty = 1;
+    return 0;
+}
+
+/* 로그하지 않는 DELETED 표시 (컴팩션)의 dead_lsn → 복구 시 되살아남 */
+static uint64_t wal_mark(brain_file_t* bf) {
+    return bf->wal ? brain_wal_next_lsn(bf->wal) : 0;
+}
+
+/* heap에서 len 바이트 (리턴: 파일 오프셋, 0 = 실패) */
+static uint64_t heap_reserve(brain_file_t* bf, uint32_t len) {
+    brain_header_t* header = brain_file_header(bf);
+    brain_section_t* sections = BRAIN_SECTIONS(header, header);
+    uint64_t extent_size = BRAIN_HEAP_EXTENT_MIN;
+    uint32_t extent_no = 0;
+
+    if (bf->heap_section >= 0) {
+        brain_section_t* heap = &sections[bf->heap_section];
+        if (heap->size - heap->used >= len) {
+            uint64_t offset = heap->offset + heap->used;
+            heap->used += len;
+            return offset;
+        }
+        extent_size = heap->size * 2;
+        extent_no = heap->chunk + 1;
+    }
+
+    if (extent_size > BRAIN_HEAP_EXTENT_MAX) extent_size = BRAIN_HEAP_EXTENT_MAX;
+    if (extent_size < len) extent_size = BRAIN_ALIGN_UP(len, BRAIN_PAGE_SIZE);
+    if (header->section_count >= header->section_capacity) {
+        fprintf(stderr, "[brain] Error: no room for heap extent %u\n", extent_no);
+        return 0;
+    }
+
+    uint64_t offset = brain_alloc_region(header, extent_size);
+    int section = brain_section_add(header, BRAIN_SECTION_HEAP, extent_no, offset, extent_size);
+    if (grow_mapping(bf) < 0) return 0;
+
+    header = brain_file_header(bf);
+    BRAIN_SECTIONS(header, header)[section].used = len;
+    bf->heap_section = section;
+    return offset;
+}
+
+/* 디렉터리에서 chunk / heap 캐시 채우기 */
+static void load_sections(brain_file_t* bf) {
+    brain_header_t* header = brain_file_header(bf);
+    const brain_section_t* sections = BRAIN_SECTIONS(header, header);
+    uint32_t last_extent = 0;
+
+    bf->heap_section = -1;
+    bf->index_crc_section = -1;
+    for (uint32_t key = 0; key < BRAIN_RANGE_KEYS; key++) bf->range[key].section = -1;
+    for (uint32_t i = 0; i < header->section_count; i++) {
+        const brain_section_t* s = &sections[i];
+        if (s->type == BRAIN_SECTION_RECORDS && s->chunk < BRAIN_MAX_CHUNKS) {
+            bf->rec_chunk[s->chunk] = s->offset;
+        } else if (s->type == BRAIN_SECTION_VECTORS && s->chunk < BRAIN_MAX_CHUNKS) {
+            bf->vec_chunk[s->chunk] = s->offset;
+        } else if (s->type == BRAIN_SECTION_COUNTERS && s->chunk < BRAIN_MAX_CHUNKS) {
+            bf->cnt_chunk[s->chunk] = s->offset;
+        } else if (s->type == BRAIN_SECTION_HEAP &&
+                   (bf->heap_section < 0 || s->chunk >= last_extent)) {
+            bf->heap_section = (int32_t)i;
+            last_extent = s->chunk;
+        } else if (s->type == BRAIN_SECTION_INDEX_CRC) {
+            bf->index_crc_section = (int32_t)i;
+        } else if (s->type == BRAIN_SECTION_RANGE && s->chunk < BRAIN_RANGE_KEYS) {
+            bf->range[s->chunk].section = (int32_t)i;
+        }
+    }
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 인덱스 페이지 CRC
+ *
+ * 인덱스는 삽입마다 여러 페이지가 바뀌므로 매번 CRC를 고치지 않고,
+ * 체크포인트 / 닫기 때 테이블 전체를 한 번에 봉인한다.
+ * 봉인 = INDEX_CRC 섹션에 페이지별 CRC + used = 테이블 오프셋.
+ * 봉인 후 첫 변경이 used를 0으로 지우므로, 봉인이 살아 있으면
+ * 테이블은 그때와 같아야 한다 (다르면 디스크 손상).
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+static uint64_t index_bytes(const brain_file_t* bf) {
+    return index_table_size(brain_file_header(bf)->index.log2, index_layout(bf->index));
+}
+
+static uint64_t index_page_count(const brain_file_t* bf) {
+    return (index_bytes(bf) + BRAIN_INDEX_CRC_PAGE - 1) / BRAIN_INDEX_CRC_PAGE;
+}
+
+/* 봉인이 현재 테이블과 맞는가 (재해시 중이면 봉인하지 않음) */
+static int index_sealed(const brain_file_t* bf) {
+    if (bf->index_crc_section < 0) return 0;
+
+    const brain_header_t* header = brain_file_header(bf);
+    const brain_section_t* s = &BRAIN_SECTIONS(header, header)[bf->index_crc_section];
+    return header->index.old_table_offset == 0 && s->used == header->index.table_offset &&
+           s->chunk == header->index.log2 && s->size >= index_page_count(bf) * sizeof(uint32_t);
+}
+
+/* 인덱스를 바꾸기 전에 호출 */
+static void index_unseal(brain_file_t* bf) {
+    if (bf->index_crc_section < 0) return;
+
+    brain_header_t* header = brain_file_header(bf);
+    brain_section_t* s = &BRAIN_SECTIONS(header, header)[bf->index_crc_section];
+    if (s->used != 0) {
+        s->used = 0;
+        mark_dirty(bf, &s->used, sizeof(s->used));
+    }
+}
+
+static uint32_t index_page_crc(const brain_file_t* bf, uint64_t page) {
+    uint64_t bytes = index_bytes(bf);
+    uint64_t offset = page * BRAIN_INDEX_CRC_PAGE;
+    uint64_t len = bytes - offset < BRAIN_INDEX_CRC_PAGE ? bytes - offset : BRAIN_INDEX_CRC_PAGE;
+    const char* table = (const char*)bf->mf->addr + brain_file_header(bf)->index.table_offset;
+    return brain_crc32c(0, table + offset, len);
+}
+
+/* 페이지 검사 (봉인된 상태에서만): 0 = 일치, -1 = 불일치 */
+static int index_page_check(const brain_file_t* bf, uint64_t page) {
+    const brain_header_t* header = brain_file_header(bf);
+    const brain_section_t* s = &BRAIN_SECTIONS(header, header)[bf->index_crc_section];
+    const uint32_t* crc = (const uint32_t*)((const char*)bf->mf->addr + s->offset);
+    return crc[page] == index_page_crc(bf, page) ? 0 : -1;
+}
+
+/* 체크포인트 / 닫기: 현재 테이블 봉인 (섹션이 작으면 새로 할당) */
+static int index_seal(brain_file_t* bf) {
+    brain_header_t* header = brain_file_header(bf);
+    if (header->index.old_table_offset != 0 || index_sealed(bf)) return 0;
+    if (wal_touch(bf) < 0) return -1;
+
+    uint64_t pages = index_page_count(bf);
+    uint64_t size = BRAIN_ALIGN_UP(pages * sizeof(uint32_t), BRAIN_PAGE_SIZE);
+
+    if (bf->index_crc_section >= 0 &&
+        BRAIN_SECTIONS(header, header)[bf->index_crc_section].size < size) {
+        brain_section_release(header, (uint32_t)bf->index_crc_section);
+        bf->index_crc_section = -1;
+    }
+    if (bf->index_crc_section < 0) {
+        if (header->section_count >= header->section_capacity) return -1;
+
+        uint64_t offset = brain_alloc_region(header, size);
+        int section = brain_section_add(header, BRAIN_SECTION_INDEX_CRC, 0, offset, size);
+        if (grow_mapping(bf) < 0) return -1;
+        bf->index_crc_section = section;
+    }
+
+    header = brain_file_header(bf);
+    brain_section_t* s = &BRAIN_SECTIONS(header, header)[bf->index_crc_section];
+    uint32_t* crc = (uint32_t*)((char*)bf->mf->addr + s->offset);
+    for (uint64_t p = 0; p < pages; p++) crc[p] = index_page_crc(bf, p);
+    mark_dirty(bf, crc, pages * sizeof(uint32_t));
+
+    s->chunk = header->index.log2;
+    s->used = header->index.table_offset;
+    mark_header(bf);
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 레코드 체크섬
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 비트맵을 record_count까지 (쓰기 경로에서만 호출 → 조회와 겹치지 않음) */
+static int verify_grow(brain_file_t* bf) {
+    brain_verify_t* v = bf->verify;
+    if (!v) return 0;
+
+    uint64_t need = (brain_file_header(bf)->record_count + 63) / 64;
+    if (need <= v->words) return 0;
+
+    uint64_t words = v->words * 2 > need ? v->words * 2 : need;
+    uint64_t* checked = (uint64_t*)realloc(v->checked, words * sizeof(uint64_t));
+    if (!checked) return -1;
+    v->checked = checked;
+    uint64_t* corrupt = (uint64_t*)realloc(v->corrupt, words * sizeof(uint64_t));
+    if (!corrupt) return -1;
+    v->corrupt = corrupt;
+
+    memset(v->checked + v->words, 0, (words - v->words) * sizeof(uint64_t));
+    memset(v->corrupt + v->words, 0, (words - v->words) * sizeof(uint64_t));
+    v->words = words;
+    return 0;
+}
+
+/* 레코드 검사 결과 기록: 0 = 일치 / 체크섬 없음, -1 = 불일치 */
+static int record_verify(const brain_file_t* bf, const brain_entry_t* e) {
+    brain_verify_t* v = bf->verify;
+    const brain_record_t* record = e->record;
+    uint64_t w = e->record_no / 64;
+    uint64_t bit = 1ull << (e->record_no % 64);
+    int tracked = w < v->words;
+
+    if (!(record->flags & BRAIN_RECORD_LIVE) || record->checks != BRAIN_CHECK_CRC32C) return 0;
+
+    if (brain_record_crc(brain_file_header(bf), record, e->vector, e->metadata) != record->crc) {
+        if (tracked) __atomic_fetch_or(&v->corrupt[w], bit, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&v->stats.records_failed, 1, __ATOMIC_RELAXED);
+        fprintf(stderr, "[brain] Error: record %lu (id %ld) checksum mismatch\n",
+                (unsigned long)e->record_no, (long)record->id);
+        return -1;
+    }
+
+    if (tracked) __atomic_fetch_or(&v->checked[w], bit, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&v->stats.records_verified, 1, __ATOMIC_RELAXED);
+    return 0;
+}
+
+/* brain_file_get: 불일치로 표시된 레코드 거부, FIRST_TOUCH면 처음 한 번 검사 */
+static int verify_touch(const brain_file_t* bf, const brain_entry_t* e) {
+    const brain_verify_t* v = bf->verify;
+    uint64_t w = e->record_no / 64;
+    uint64_t bit = 1ull << (e->record_no % 64);
+
+    if (w < v->words) {
+        if (__atomic_load_n(&v->corrupt[w], __ATOMIC_RELAXED) & bit) return -1;
+        if (__atomic_load_n(&v->checked[w], __ATOMIC_RELAXED) & bit) return 0;
+    }
+    if (v->mode != BRAIN_VERIFY_FIRST_TOUCH) return 0;
+    return record_verify(bf, e);
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 보조 정렬 인덱스 (run + delta)
+ *
+ * run 항목은 (키, 레코드 번호)만 들고 있고, 읽을 때마다 레코드가
+ * 살아 있는지와 열의 현재 값이 키와 같은지 확인한다.
+ * → 삭제 / 덮어쓰기 / 컴팩션 이동에 툼스톤이 필요 없다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+static int64_t range_value(const brain_entry_t* e, uint32_t key) {
+    return key == BRAIN_RANGE_TIMESTAMP ? *e->timestamp : brain_importance_key(*e->importance);
+}
+
+/* 항목이 아직 맞는가 (맞으면 e를 채움) */
+static int range_valid(const brain_file_t* bf, uint32_t key, const brain_range_entry_t* x,
+                       brain_entry_t* e) {
+    return brain_file_entry(bf, x->record_no, e) == 0 && (e->record->flags & BRAIN_RECORD_LIVE) &&
+           e->timestamp && range_value(e, key) == x->key;
+}
+
+static int range_cmp(const brain_range_entry_t* a, const brain_range_entry_t* b) {
+    if (a->key != b->key) return a->key < b->key ? -1 : 1;
+    if (a->record_no != b->record_no) return a->record_no < b->record_no ? -1 : 1;
+    return 0;
+}
+
+static int range_qsort_cmp(const void* a, const void* b) {
+    return range_cmp((const brain_range_entry_t*)a, (const brain_range_entry_t*)b);
+}
+
+/* RANGE 섹션의 run (없으면 NULL, sealed = 1이면 봉인된 것만) */
+static const brain_range_run_t* range_run(const brain_file_t* bf, uint32_t key, int sealed) {
+    int32_t section = bf->range[key].section;
+    if (section < 0) return NULL;
+
+    const brain_header_t* header = brain_file_header(bf);
+    const brain_section_t* s = &BRAIN_SECTIONS(header, header)[section];
+    if (sealed && s->used == 0) return NULL;
+
+    const brain_range_run_t* run = (const brain_range_run_t*)((const char*)bf->mf->addr + s->offset);
+    if (sizeof(*run) + run->count * sizeof(brain_range_entry_t) > s->size) return NULL;
+    return run;
+}
+
+static int range_push(brain_range_t* r, int64_t value, uint64_t record_no) {
+    if (r->delta_count == r->delta_cap) {
+        uint64_t cap = r->delta_cap ? r->delta_cap * 2 : 1024;
+        brain_range_entry_t* delta =
+            (brain_range_entry_t*)realloc(r->delta, cap * sizeof(brain_range_entry_t));
+        if (!delta) return -1;
+        r->delta = delta;
+        r->delta_cap = cap;
+    }
+
+    brain_range_entry_t x = { value, record_no };
+    if (r->delta_count > 0 && range_cmp(&r->delta[r->delta_count - 1], &x) > 0) {
+        r->delta_sorted = 0;
+    }
+    r->delta[r->delta_count++] = x;
+    return 0;
+}
+
+/* 파일의 run을 믿지 않게 표시 (값 변경은 delta에만 있으므로) */
+static void range_unseal(brain_file_t* bf, uint32_t key) {
+    int32_t section = bf->range[key].section;
+    if (section < 0) return;
+
+    brain_header_t* header = brain_file_header(bf);
+    brain_section_t* s = &BRAIN_SECTIONS(header, header)[section];
+    if (s->used != 0) {
+        s->used = 0;
+        mark_dirty(bf, &s->used, sizeof(s->used));
+    }
+}
+
+/* 복구 / 인덱스 재구축: run을 버리고 다음 조회가 처음부터 */
+static void range_reset(brain_file_t* bf) {
+    for (uint32_t key = 0; key < BRAIN_RANGE_KEYS; key++) {
+        brain_range_t* r = &bf->range[key];
+        if (bf->mf->writable) range_unseal(bf, key);
+        free(r->delta);
+        r->delta = NULL;
+        r->delta_count = 0;
+        r->delta_cap = 0;
+        r->delta_sorted = 1;
+        r->loaded = 0;
+        r->run_valid = 0;
+        r->upto = 0;
+    }
+}
+
+/* run 확인 (처음 한 번) + run 이후 레코드를 delta로 */
+static int range_catch_up(brain_file_t* bf, uint32_t key) {
+    brain_range_t* r = &bf->range[key];
+    if (!r->loaded) {
+        const brain_range_run_t* run = range_run(bf, key, 1);
+        r->run_valid = run != NULL;
+        r->upto = run ? run->records : 0;
+        r->delta_sorted = 1;
+        r->loaded = 1;
+    }
+
+    uint64_t issued = brain_file_header(bf)->record_count;
+    for (; r->upto < issued; r->upto++) {
+        brain_entry_t e;
+        if (brain_file_entry(bf, r->upto, &e) < 0) continue;       /* 반환된 chunk */
+        if (!(e.record->flags & BRAIN_RECORD_LIVE) || !e.timestamp) continue;
+        if (range_push(r, range_value(&e, key), r->upto) < 0) return -1;
+    }
+    return 0;
+}
+
+/* run + delta → 새 run (살아 있고 값이 맞는 항목만) */
+static int range_merge(brain_file_t* bf, uint32_t key) {
+    brain_range_t* r = &bf->range[key];
+    if (!bf->mf->writable || range_catch_up(bf, key) < 0) return -1;
+    if (!r->delta_sorted) {
+        qsort(r->delta, r->delta_count, sizeof(brain_range_entry_t), range_qsort_cmp);
+        r->delta_sorted = 1;
+    }
+
+    const brain_range_run_t* run = r->run_valid ? range_run(bf, key, 0) : NULL;
+    uint64_t run_count = run ? run->count : 0;
+    const brain_range_entry_t* old = run ? (const brain_range_entry_t*)(run + 1) : NULL;
+
+    brain_range_entry_t* merged =
+        (brain_range_entry_t*)malloc((run_count + r->delta_count + 1) * sizeof(brain_range_entry_t));
+    if (!merged) return -1;
+
+    uint64_t n = 0, i = 0, j = 0;
+    while (i < run_count || j < r->delta_count) {
+        const brain_range_entry_t* x;
+        if (j == r->delta_count || (i < run_count && range_cmp(&old[i], &r->delta[j]) <= 0)) {
+            x = &old[i++];
+        } else {
+            x = &r->delta[j++];
+        }
+
+        brain_entry_t e;
+        if (n > 0 && range_cmp(&merged[n - 1], x) == 0) continue;
+        if (range_valid(bf, key, x, &e)) merged[n++] = *x;
+    }
+
+    /* 기존 섹션이 작으면 반환하고 1.5배 여유로 새로 */
+    if (wal_touch(bf) < 0) {
+        free(merged);
+        return -1;
+    }
+    uint64_t need = sizeof(brain_range_run_t) + n * sizeof(brain_range_entry_t);
+    brain_header_t* header = brain_file_header(bf);
+    if (r->section >= 0 && BRAIN_SECTIONS(header, header)[r->section].size < need) {
+        brain_section_release(header, (uint32_t)r->section);
+        r->section = -1;
+    }
+    if (r->section < 0) {
+        uint64_t size = BRAIN_ALIGN_UP(need + need / 2, BRAIN_PAGE_SIZE);
+        if (header->section_count >= header->section_capacity) {
+            free(merged);
+            return -1;
+        }
+        uint64_t offset = brain_alloc_region(header, size);
+        int section = brain_section_add(header, BRAIN_SECTION_RANGE, key, offset, size);
+        if (grow_mapping(bf) < 0) {
+            free(merged);
+            return -1;
+        }
+        r->section = section;
+    }
+
+    header = brain_file_header(bf);
+    brain_section_t* s = &BRAIN_SECTIONS(header, header)[r->section];
+    brain_range_run_t* out = (brain_range_run_t*)((char*)bf->mf->addr + s->offset);
+    s->used = 0;
+    out->count = n;
+    out->records = r->upto;
+    memcpy(out + 1, merged, n * sizeof(brain_range_entry_t));
+    s->used = 1;
+    mark_dirty(bf, out, need);
+    mark_header(bf);
+    free(merged);
+
+    r->delta_count = 0;
+    r->run_valid = 1;
+    r->merges++;
+    return 0;
+}
+
+/* 닫기: 바뀐 키만 병합 (쓰기 가능한 파일) */
+static void range_flush(brain_file_t* bf) {
+    for (uint32_t key = 0; key < BRAIN_RANGE_KEYS; key++) {
+        brain_range_t* r = &bf->range[key];
+        if (!r->loaded) continue;
+        if (bf->mf->writable &&
+            (r->delta_count > 0 || brain_file_header(bf)->record_count > r->upto ||
+             range_run(bf, key, 1) == NULL)) {
+            range_merge(bf, key);
+        }
+        free(r->delta);
+        r->delta = NULL;
+    }
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_file_create
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+brain_file_t* brain_file_create(const char* path, uint32_t dim, index_layout_t layout) {
+    return brain_file_create_ex(path, dim, layout, BRAIN_INDEX_DEFAULT_LOG2);
+}
+
+brain_file_t* brain_file_create_ex(const char* path, uint32_t dim, index_layout_t layout,
+                                   uint32_t log2) {
+    if (!path || dim == 0) return NULL;
+    if (log2 < BRAIN_INDEX_MIN_LOG2) log2 = BRAIN_INDEX_MIN_LOG2;
+    if (log2 > BRAIN_INDEX_MAX_LOG2) log2 = BRAIN_INDEX_MAX_LOG2;
+
+    brain_header_t header;
+    brain_init_header(&header, dim);
+
+    uint64_t index_offset = brain_alloc_region(&header, index_table_size(log2, layout));
+
+    mmap_file_t* mf = mmap_file_create(path, header.file_size);
+    if (!mf) return NULL;
+    memcpy(mf->addr, &header, sizeof(header));
+
+    brain_file_t* bf = (brain_file_t*)calloc(1, sizeof(brain_file_t));
+    if (!bf) {
+        mmap_file_close(mf);
+        return NULL;
+    }
+    bf->mf = mf;
+    bf->heap_section = -1;
+    bf->index_crc_section = -1;
+    for (uint32_t key = 0; key < BRAIN_RANGE_KEYS; key++) bf->range[key].section = -1;
+    bf->created = 1;
+
+    bf->index = index_create(mf, BRAIN_INDEX_META_OFFSET, index_offset, log2, layout);
+    if (!bf->index) {
+        free(bf);
+        mmap_file_close(mf);
+        return NULL;
+    }
+    index_set_allocator(bf->index, alloc_index_table, bf);
+
+    printf("[brain] ✓ Created '%s' (dim %u, stride %u)\n",
+           path, dim, header.vector_stride);
+    return bf;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_file_open
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static brain_file_t* open_mapped(mmap_file_t* mf, const char* path) {
+    int version = brain_detect_version(mf->addr, mf->size);
+    if (version != BRAIN_VERSION) {
+        fprintf(stderr, "[brain] Error: '%s' is not a v%d brain file (found v%d)%s\n",
+                path, BRAIN_VERSION, version,
+                version == BRAIN_VERSION_V1 ? ", migrate with brain_v1_foreach" : "");
+        mmap_file_close(mf);
+        return NULL;
+    }
+
+    const brain_header_t* header = (const brain_header_t*)mf->addr;
+    if (brain_validate_header(header) < 0 || header->file_size > mf->size ||
+        header->section_offset + (uint64_t)header->section_capacity *
+            sizeof(brain_section_t) > mf->size) {
+        mmap_file_close(mf);
+        return NULL;
+    }
+
+    brain_file_t* bf = (brain_file_t*)calloc(1, sizeof(brain_file_t));
+    if (!bf) {
+        mmap_file_close(mf);
+        return NULL;
+    }
+    bf->mf = mf;
+
+    bf->index = index_open(mf, BRAIN_INDEX_META_OFFSET);
+    if (!bf->index) {
+        free(bf);
+        mmap_file_close(mf);
+        return NULL;
+    }
+    index_set_allocator(bf->index, alloc_index_table, bf);
+
+    load_sections(bf);
+
+    /* 재해시 도중에 닫혔으면 끝난 뒤 이전 테이블 반환 */
+    if (header->index.old_table_offset != 0) {
+        bf->retire_offset = header->index.old_table_offset;
+        bf->retire_size = index_table_size(header->index.old_log2, index_layout(bf->index));
+    }
+
+    return bf;
+}
+
+brain_file_t* brain_file_open(const char* path, int writable) {
+    return brain_file_open_ex(path, writable, 0);
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 예열 / 메모리 고정
+ *
+ * 재시작 직후 첫 조회는 헤더 → 디렉터리 → 인덱스 테이블 → 레코드 순으로
+ * fault가 난다. 인덱스 쪽은 파일의 작은 일부라 미리 매핑 / 고정해 두면
+ * 첫 조회부터 레코드 1~2 페이지 fault만 남는다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* what에 해당하는 현재 영역 (최대 MMAP_LOCK_MAX개) */
+static uint32_t warm_regions(const brain_file_t* bf, uint32_t what, mmap_range_t* out) {
+    const brain_header_t* header = brain_file_header(bf);
+    const brain_section_t* sections = BRAIN_SECTIONS(header, header);
+    uint32_t n = 0;
+
+    if (what & BRAIN_LOCK_INDEX) {
+        index_layout_t layout = index_layout(bf->index);
+        out[n].offset = 0;
+        out[n++].len = header->section_offset + (uint64_t)header->section_capacity * sizeof(brain_section_t);
+        out[n].offset = header->index.table_offset;
+        out[n++].len = index_table_size(header->index.log2, layout);
+        if (header->index.old_table_offset != 0) {
+            out[n].offset = header->index.old_table_offset;
+            out[n++].len = index_table_size(header->index.old_log2, layout);
+        }
+        if (bf->index_crc_section >= 0) {
+            out[n].offset = sections[bf->index_crc_section].offset;
+            out[n++].len = sections[bf->index_crc_section].size;
+        }
+    }
+    if (what & BRAIN_LOCK_RANGE) {
+        for (uint32_t key = 0; key < BRAIN_RANGE_KEYS; key++) {
+            if (bf->range[key].section < 0) continue;
+            out[n].offset = sections[bf->range[key].section].offset;
+            out[n++].len = sections[bf->range[key].section].size;
+        }
+    }
+    return n;
+}
+
+brain_file_t* brain_file_open_ex(const char* path, int writable, uint32_t flags) {
+    mmap_file_t* mf = mmap_file_open_ex(path, writable,
+                                        flags & (BRAIN_OPEN_POPULATE | BRAIN_OPEN_HUGEPAGE |
+                                                 BRAIN_OPEN_NORESERVE));
+    if (!mf) return NULL;
+
+    brain_file_t* bf = open_mapped(mf, path);
+
+    /* 실패해도 계속 (체크포인트가 전체 msync) */
+    if (bf && writable && (flags & BRAIN_OPEN_TRACK)) mmap_file_track(mf, BRAIN_FLUSH_AGE_MS);
+
+    if (bf && (flags & BRAIN_OPEN_WARM_INDEX)) {
+        mmap_range_t regions[MMAP_LOCK_MAX];
+        uint32_t n = warm_regions(bf, BRAIN_LOCK_INDEX, regions);
+        for (uint32_t i = 0; i < n; i++) mmap_file_warm(mf, regions[i].offset, regions[i].len);
+    }
+    if (bf && (flags & BRAIN_OPEN_PREFETCH)) {
+        size_t len = strlen(path) + sizeof(BRAIN_HEAT_SUFFIX);
+        bf->heat_path = (char*)malloc(len);
+        if (bf->heat_path) snprintf(bf->heat_path, len, "%s%s", path, BRAIN_HEAT_SUFFIX);
+
+        /* 실패해도 계속 (선읽기 / 기록 없이 demand fault) */
+        if (bf->heat_path && mmap_file_heat(mf, BRAIN_HEAT_SAMPLE_MS) == 0) {
+            mmap_file_prefetch(mf, bf->heat_path, 0);
+        }
+    }
+    return bf;
+}
+
+int brain_file_save_heat(brain_file_t* bf) {
+    if (!bf || !bf->heat_path) return -1;
+    return mmap_file_heat_save(bf->mf, bf->heat_path);
+}
+
+int brain_file_lock(brain_file_t* bf, uint32_t what) {
+    if (!bf) return -1;
+
+    mmap_file_unlock_all(bf->mf);
+    mmap_range_t regions[MMAP_LOCK_MAX];
+    uint32_t n = warm_regions(bf, what, regions);
+    int rc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (mmap_file_lock(bf->mf, regions[i].offset, regions[i].len) < 0) rc = -1;
+    }
+    return rc;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_file_snapshot
+ *
+ * 시점 고정 읽기 전용 사본 (쓰기는 계속)
+ *   1. path가 있으면 reflink 복제, 안 되면 copy_file_range 복사
+ *      → 그 파일을 읽기 전용으로 연다
+ *   2. path = NULL이면 원본 매핑을 메모리로 복사한 뷰
+ *
+ * 쓰기와 같은 잠금 아래에서 부른다 (레코드 / 인덱스가 완성된 시점).
+ * reflink 외에는 파일 크기만큼 복사하는 동안 잠금을 잡는다.
+ * 뷰를 파일로 남기려면 잠금을 푼 뒤 brain_file_save.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+brain_file_t* brain_file_snapshot(brain_file_t* bf, const char* path) {
+    if (!bf) return NULL;
+
+    if (path) {
+        int linked = mmap_file_clone(bf->mf, path) == 0;
+        if (!linked && mmap_file_copy(bf->mf, path) < 0) return NULL;
+        printf("[brain] ✓ Snapshot '%s' (%s)\n", path, linked ? "reflink" : "copy");
+        return brain_file_open(path, 0);
+    }
+
+    mmap_file_t* view = mmap_file_snapshot(bf->mf);
+    if (!view) return NULL;
+    return open_mapped(view, "(snapshot)");
+}
+
+int brain_file_save(const brain_file_t* bf, const char* path) {
+    if (!bf || !path || bf->mf->writable) return -1;
+    if (mmap_file_copy(bf->mf, path) < 0) return -1;
+
+    printf("[brain] ✓ Saved %lu bytes to '%s'\n",
+           (unsigned long)brain_file_header(bf)->file_size, path);
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_file_reserve
+ *
+ * 레코드 0 ~ records-1을 담을 chunk를 모두 할당하고 파일을 한 번에 확장
+ * (대량 적재: 이후 레코드 주소가 고정되므로 여러 스레드가 나눠 쓸 수 있음)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int brain_file_reserve(brain_file_t* bf, uint64_t records) {
+    if (!bf || !bf->mf->writable) return -1;
+    if (records == 0) return 0;
+    if (wal_touch(bf) < 0) return -1;
+
+    /* 이미 발급된 chunk는 건너뜀 (컴팩션이 반환한 chunk를 되살리지 않도록) */
+    const brain_header_t* header = brain_file_header(bf);
+    uint32_t first = brain_chunk_of(header, header->record_count, NULL);
+    uint32_t last = brain_chunk_of(header, records - 1, NULL);
+    for (uint32_t k = first; k <= last; k++) {
+        if (alloc_chunk(bf, k) < 0) return -1;
+    }
+    if (grow_mapping(bf) < 0) return -1;
+    mark_header(bf);
+    return 0;
+}
+
+void brain_file_close(brain_file_t* bf) {
+    if (!bf) return;
+
+    range_flush(bf);
+    if (bf->wal) {
+        brain_file_checkpoint(bf);
+        brain_wal_close(bf->wal);
+    } else if (bf->mf->writable) {
+        index_seal(bf);
+        mmap_file_sync(bf->mf);
+    }
+    brain_file_set_verify(bf, BRAIN_VERIFY_NEVER);
+    if (bf->heat_path) {
+        brain_file_save_heat(bf);
+        free(bf->heat_path);
+    }
+    free(bf->compact.heap);
+    index_close(bf->index);
+    mmap_file_close(bf->mf);
+    free(bf);
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_file_entry / brain_file_get
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int brain_file_entry(const brain_file_t* bf, uint64_t record_no, brain_entry_t* out) {
+    if (!bf || !out) return -1;
+
+    const brain_header_t* header = brain_file_header(bf);
+    if (record_no >= header->record_count) return -1;
+
+    uint64_t i;
+    uint32_t k = brain_chunk_of(header, record_no, &i);
+    if (k >= BRAIN_MAX_CHUNKS || bf->rec_chunk[k] == 0) return -1;
+
+    char* base = (char*)bf->mf->addr;
+    brain_record_t* record = (brain_record_t*)(base + bf->rec_chunk[k]) + i;
+
+    out->record_no = record_no;
+    out->record = record;
+    out->vector = (const float*)(base + bf->vec_chunk[k] + i * header->vector_stride);
+    /* 삭제된 레코드의 메타데이터는 컴팩션이 반환했을 수 있음 */
+    int has_meta = record->meta_len && (record->flags & BRAIN_RECORD_LIVE);
+    out->metadata = has_meta ? base + record->meta_offset : NULL;
+    out->meta_len = has_meta ? record->meta_len : 0;
+
+    if (bf->cnt_chunk[k] != 0) {
+        char* counters = base + bf->cnt_chunk[k];
+        uint64_t n = brain_chunk_records(header, k);
+        out->timestamp = (int64_t*)(counters + BRAIN_COL_TIMESTAMP(n)) + i;
+        out->access_count = (uint32_t*)(counters + BRAIN_COL_ACCESS(n)) + i;
+        out->importance = (float*)(counters + BRAIN_COL_IMPORTANCE(n)) + i;
+    } else {
+        out->timestamp = NULL;
+        out->access_count = NULL;
+        out->importance = NULL;
+    }
+    return 0;
+}
+
+int brain_file_touch(const brain_file_t* bf, const brain_entry_t* entry) {
+    if (!bf || !entry || !entry->access_count || !bf->mf->writable) return -1;
+    __atomic_fetch_add(entry->access_count, 1, __ATOMIC_RELAXED);
+    mark_dirty(bf, entry->access_count, sizeof(*entry->access_count));
+    return 0;
+}
+
+int brain_file_columns(const brain_file_t* bf, uint32_t chunk, brain_columns_t* out) {
+    if (!bf || !out || chunk >= BRAIN_MAX_CHUNKS) return -1;
+
+    const brain_header_t* header = brain_file_header(bf);
+    uint64_t first = brain_chunk_first(header, chunk);
+    if (first >= header->record_count || bf->cnt_chunk[chunk] == 0) return -1;
+
+    uint64_t n = brain_chunk_records(header, chunk);
+    char* counters = (char*)bf->mf->addr + bf->cnt_chunk[chunk];
+    out->first = first;
+    out->count = header->record_count - first < n ? header->record_count - first : n;
+    out->timestamp = (int64_t*)(counters + BRAIN_COL_TIMESTAMP(n));
+    out->access_count = (uint32_t*)(counters + BRAIN_COL_ACCESS(n));
+    out->importance = (float*)(counters + BRAIN_COL_IMPORTANCE(n));
+    out->records = (brain_record_t*)((char*)bf->mf->addr + bf->rec_chunk[chunk]);
+    return 0;
+}
+
+/* 검증 없는 조회 (쓰기 경로 내부용) */
+static int lookup_entry(const brain_file_t* bf, int64_t id, brain_entry_t* out) {
+    int64_t ref = index_lookup(bf->index, id);
+    if (ref <= 0) return -1;
+
+    return brain_file_entry(bf, BRAIN_REF_RECORD(ref), out);
+}
+
+int brain_file_get(const brain_file_t* bf, int64_t id, brain_entry_t* out) {
+    if (!bf || !out) return -1;
+    if (lookup_entry(bf, id, out) < 0) return -1;
+    if (bf->verify && verify_touch(bf, out) < 0) return -1;
+    if (bf->mf->heat) {
+        const char* base = (const char*)bf->mf->addr;
+        mmap_file_heat_touch(bf->mf, (size_t)((const char*)out->record - base));
+        mmap_file_heat_touch(bf->mf, (size_t)((const char*)out->vector - base));
+    }
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_file_append
+ *
+ * 레코드 / 벡터 / 메타데이터를 쓰고 나서 record_count와 인덱스를 갱신
+ * → 인덱스가 가리키는 레코드는 항상 완성된 상태
+ *
+ * WAL이 있으면 먼저 로그 (lsn = 덮어쓴 레코드의 dead_lsn)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* BRAIN_WAL_PUT payload: [wal_put_t][float × vector_dim][metadata] */
+typedef struct {
+    int64_t  id;
+    int64_t  timestamp;
+    float    importance;
+    uint32_t meta_len;
+} wal_put_t;
+
+static int64_t file_append(brain_file_t* bf, int64_t id, const float* vector,
+                           const char* metadata, uint32_t meta_len, float importance,
+                           int64_t timestamp, uint64_t lsn) {
+    uint64_t record_no = brain_file_header(bf)->record_count;
+    if (BRAIN_RECORD_REF(record_no) > BRAIN_INDEX_OFFSET_MASK) return -1;
+
+    uint64_t i;
+    uint32_t k = brain_chunk_of(brain_file_header(bf), record_no, &i);
+    if (ensure_chunk(bf, k) < 0) return -1;
+    index_unseal(bf);
+
+    uint64_t meta_offset = 0;
+    if (metadata && meta_len > 0) {
+        meta_offset = heap_reserve(bf, meta_len);
+        if (meta_offset == 0) return -1;
+        memcpy((char*)bf->mf->addr + meta_offset, metadata, meta_len);
+    } else {
+        meta_len = 0;
+    }
+
+    /* 재매핑이 끝난 뒤 포인터 계산 */
+    brain_header_t* header = brain_file_header(bf);
+    char* base = (char*)bf->mf->addr;
+    brain_record_t* record = (brain_record_t*)(base + bf->rec_chunk[k]) + i;
+
+    memset(record, 0, sizeof(*record));
+    record->id = id;
+    record->flags = BRAIN_RECORD_LIVE;
+    record->meta_len = meta_len;
+    record->meta_offset = meta_offset;
+
+    char* slot = base + bf->vec_chunk[k] + i * header->vector_stride;
+    memcpy(slot, vector, (size_t)header->vector_dim * sizeof(float));
+    record->crc = brain_record_crc(header, record, slot, base + meta_offset);
+    record->checks = BRAIN_CHECK_CRC32C;
+
+    brain_entry_t e;
+    header->record_count++;
+    brain_file_entry(bf, record_no, &e);
+    if (e.timestamp) {
+        *e.timestamp = timestamp;
+        *e.access_count = 0;
+        *e.importance = importance;
+    }
+    mark_entry(bf, &e);
+
+    if (verify_grow(bf) < 0) return -1;
+
+    /* 기존 ID → 이전 레코드 삭제 표시 */
+    brain_entry_t old;
+    int replaced = (lookup_entry(bf, id, &old) == 0);
+    if (replaced) {
+        old.record->dead_lsn = lsn;
+        old.record->flags = BRAIN_RECORD_DELETED;
+        header->heap_dead += old.meta_len;
+        mark_dirty(bf, old.record, sizeof(brain_record_t));
+    }
+
+    if (index_insert(bf->index, id, BRAIN_RECORD_REF(record_no)) < 0) {
+        /* 인덱스가 이전 레코드를 계속 가리키므로 되돌림 */
+        header = brain_file_header(bf);
+        if (replaced) {
+            brain_file_entry(bf, old.record_no, &old);
+            old.record->flags = BRAIN_RECORD_LIVE;
+            old.record->dead_lsn = 0;
+            header->heap_dead -= old.record->meta_len;
+            mark_dirty(bf, old.record, sizeof(brain_record_t));
+        }
+        brain_file_entry(bf, record_no, &old);
+        old.record->dead_lsn = lsn;
+        old.record->flags = BRAIN_RECORD_DELETED;
+        header->heap_dead += meta_len;
+        mark_dirty(bf, old.record, sizeof(brain_record_t));
+        mark_header(bf);
+        return -1;
+    }
+
+    if (!replaced) brain_file_header(bf)->live_count++;
+    reclaim_index(bf);
+    mark_header(bf);
+
+    return (int64_t)record_no;
+}
+
+/* 로그가 커졌으면 체크포인트 (다음 열기의 재생 시간 상한) */
+static void wal_maybe_checkpoint(brain_file_t* bf) {
+    if (bf->wal && brain_wal_size(bf->wal) >= BRAIN_WAL_CHECKPOINT_BYTES) {
+        brain_file_checkpoint(bf);
+    }
+}
+
+uint64_t brain_file_append_growth(const brain_file_t* bf, uint32_t meta_len) {
+    if (!bf) return 0;
+
+    const brain_header_t* header = brain_file_header(bf);
+    uint64_t growth = 0;
+
+    /* 다음 레코드가 새 chunk를 여는가 */
+    uint32_t k = brain_chunk_of(header, header->record_count, NULL);
+    if (k < BRAIN_MAX_CHUNKS && bf->rec_chunk[k] == 0) {
+        uint64_t records = brain_chunk_records(header, k);
+        growth += BRAIN_ALIGN_UP(records * sizeof(brain_record_t), BRAIN_PAGE_SIZE) +
+                  BRAIN_ALIGN_UP(records * header->vector_stride, BRAIN_PAGE_SIZE) +
+                  BRAIN_ALIGN_UP(records * BRAIN_COUNTER_BYTES, BRAIN_PAGE_SIZE);
+    }
+
+    /* heap_reserve와 같은 extent 크기 */
+    if (meta_len > 0) {
+        uint64_t extent = BRAIN_HEAP_EXTENT_MIN;
+        if (bf->heap_section >= 0) {
+            const brain_section_t* heap = &BRAIN_SECTIONS(header, header)[bf->heap_section];
+            extent = heap->size - heap->used >= meta_len ? 0 : heap->size * 2;
+        }
+        if (extent > BRAIN_HEAP_EXTENT_MAX) extent = BRAIN_HEAP_EXTENT_MAX;
+        if (extent > 0 && extent < meta_len) extent = BRAIN_ALIGN_UP(meta_len, BRAIN_PAGE_SIZE);
+        growth += extent;
+    }
+
+    return growth + index_grow_size(bf->index);
+}
+
+int64_t brain_file_append(brain_file_t* bf, int64_t id, const float* vector,
+                          const char* metadata, uint32_t meta_len, float importance) {
+    if (!bf || !bf->mf->writable || id < 0 || !vector) return -1;
+    if (brain_file_header(bf)->vector_storage != 0) {
+        fprintf(stderr, "[brain] Error: append supports fp32 files only\n");
+        return -1;
+    }
+    if (!metadata) meta_len = 0;
+
+    int64_t timestamp = time(NULL);
+    uint64_t lsn = 0;
+    if (bf->wal) {
+        if (wal_touch(bf) < 0) return -1;
+
+        wal_put_t put = { id, timestamp, importance, meta_len };
+        struct iovec iov[3] = {
+            { &put, sizeof(put) },
+            { (void*)vector, (size_t)brain_file_header(bf)->vector_dim * sizeof(float) },
+            { (void*)metadata, meta_len }
+        };
+        if (brain_wal_log(bf->wal, BRAIN_WAL_PUT, iov, 3, &lsn) < 0) return -1;
+    }
+
+    int64_t record_no = file_append(bf, id, vector, metadata, meta_len, importance,
+                                    timestamp, lsn);
+    wal_maybe_checkpoint(bf);
+    return record_no;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_file_delete
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int file_delete(brain_file_t* bf, int64_t id, uint64_t lsn) {
+    brain_entry_t entry;
+    if (lookup_entry(bf, id, &entry) < 0) return -1;
+    index_unseal(bf);
+    if (index_delete(bf->index, id) < 0) return -1;
+
+    brain_header_t* header = brain_file_header(bf);
+    entry.record->dead_lsn = lsn;
+    entry.record->flags = BRAIN_RECORD_DELETED;
+    header->live_count--;
+    header->heap_dead += entry.meta_len;
+    mark_dirty(bf, entry.record, sizeof(brain_record_t));
+    mark_header(bf);
+    return 0;
+}
+
+int brain_file_delete(brain_file_t* bf, int64_t id) {
+    if (!bf || !bf->mf->writable) return -1;
+    if (index_lookup(bf->index, id) <= 0) return -1;
+
+    uint64_t lsn = 0;
+    if (bf->wal) {
+        if (wal_touch(bf) < 0) return -1;
+
+        struct iovec iov = { &id, sizeof(id) };
+        if (brain_wal_log(bf->wal, BRAIN_WAL_DELETE, &iov, 1, &lsn) < 0) return -1;
+    }
+
+    int rc = file_delete(bf, id, lsn);
+    wal_maybe_checkpoint(bf);
+    return rc;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * WAL 체크포인트 / 복구
+ *
+ * 체크포인트 시점 파일은 msync로 내구화되어 있고, 그 이후 매핑 변경은
+ * 일부만 디스크에 나갔을 수 있다. 복구는 그 "일부"를 모두 무시할 수 있게
+ * 스냅샷 시점 상태를 재구성한 뒤 로그를 재생한다:
+ *
+ *   1. 헤더 + 디렉터리 ← 스냅샷 (record_count / 섹션 / heap used 되돌림)
+ *      파일 크기도 스냅샷대로, 끝 할당 영역은 0으로
+ *   2. 스냅샷 이전 레코드에서 바뀔 수 있는 것:
+ *        DELETED 표시 → dead_lsn > 체크포인트면 LIVE로
+ *        meta_offset (컴팩션) → 스냅샷 heap 밖이면 meta_prev로
+ *   3. ID 인덱스 테이블은 통째로 비우고 LIVE 레코드에서 다시 삽입
+ *   4. 로그 재생 (PUT / DELETE), 끝나면 체크포인트
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+static uint32_t snapshot_len(const brain_header_t* header) {
+    return (uint32_t)(header->section_offset +
+                      (uint64_t)header->section_capacity * sizeof(brain_section_t));
+}
+
+static int wal_checkpoint(brain_file_t* bf) {
+    if (index_seal(bf) < 0) return -1;
+    if (brain_wal_flush(bf->wal) < 0 || mmap_file_sync(bf->mf) < 0) return -1;
+
+    const brain_header_t* header = brain_file_header(bf);
+    if (brain_wal_reset(bf->wal, header, snapshot_len(header),
+                        brain_wal_last_lsn(bf->wal)) < 0) return -1;
+    bf->wal_dirty = 0;
+    return 0;
+}
+
+int brain_file_checkpoint(brain_file_t* bf) {
+    if (!bf || !bf->mf->writable) return -1;
+    if (!bf->wal) {
+        if (index_seal(bf) < 0) return -1;
+        return mmap_file_sync(bf->mf);
+    }
+    if (!bf->wal_dirty) return 0;
+    return wal_checkpoint(bf);
+}
+
+int brain_file_set_flush_age(brain_file_t* bf, uint32_t max_age_ms) {
+    if (!bf || !bf->mf->writable) return -1;
+    return mmap_file_track(bf->mf, max_age_ms);
+}
+
+uint64_t brain_file_lsn(const brain_file_t* bf) {
+    return bf && bf->wal ? brain_wal_last_lsn(bf->wal) : 0;
+}
+
+int brain_file_commit(brain_file_t* bf, uint64_t lsn) {
+    if (!bf) return -1;
+    if (!bf->wal) return 0;
+    if (lsn == 0) return brain_wal_flush(bf->wal);
+    return brain_wal_commit(bf->wal, lsn);
+}
+
+/* 1. 스냅샷 헤더를 파일에 되돌림 (brain_file_open 전이라 헤더가 깨져 있어도 됨) */
+static int wal_restore(const char* path, const brain_wal_t* wal) {
+    uint32_t len = 0;
+    const brain_header_t* snap = (const brain_header_t*)brain_wal_snapshot(wal, &len);
+    if (!snap || len < sizeof(brain_header_t) || brain_validate_header(snap) < 0 ||
+        snapshot_len(snap) != len) {
+        fprintf(stderr, "[brain] Error: WAL snapshot does not describe a v2 brain file\n");
+        return -1;
+    }
+
+    mmap_file_t* mf = mmap_file_open(path, 1);
+    if (!mf) return -1;
+
+    int rc = 0;
+    if (mf->size != snap->file_size) rc = mmap_file_resize(mf, snap->file_size);
+    if (rc == 0) {
+        memcpy(mf->addr, snap, len);
+        memset((char*)mf->addr + snap->alloc_offset, 0, snap->file_size - snap->alloc_offset);
+    }
+    mmap_file_close(mf);
+    return rc;
+}
+
+/* 스냅샷의 heap extent 사용 구간 안인가 */
+static int meta_in_heap(const brain_header_t* header, uint64_t offset, uint32_t len) {
+    const brain_section_t* sections = BRAIN_SECTIONS(header, header);
+    for (uint32_t i = 0; i < header->section_count; i++) {
+        const brain_section_t* s = &sections[i];
+        if (s->type == BRAIN_SECTION_HEAP && offset >= s->offset &&
+            offset + len <= s->offset + s->used) return 1;
+    }
+    return 0;
+}
+
+/* 2~3. 레코드를 스냅샷 시점 상태로, 인덱스는 처음부터
+ * (인덱스 페이지 손상도 checkpoint = UINT64_MAX로 같은 경로를 탄다) */
+static int rebuild_index(brain_file_t* bf, uint64_t checkpoint) {
+    index_unseal(bf);
+    range_reset(bf);
+
+    brain_header_t* header = brain_file_header(bf);
+    brain_index_meta_t* meta = &header->index;
+    index_layout_t layout = index_layout(bf->index);
+    index_close(bf->index);
+
+    /* 재해시 중이던 이전 테이블은 반환, 현재 테이블은 비움 */
+    if (meta->old_table_offset != 0) {
+        brain_free_region(header, meta->old_table_offset,
+                          index_table_size(meta->old_log2, layout));
+    }
+    memset((char*)bf->mf->addr + meta->table_offset, 0, index_table_size(meta->log2, layout));
+    meta->old_table_offset = 0;
+    meta->old_log2 = 0;
+    meta->count = 0;
+    meta->migrated = 0;
+    meta->max_probe = 0;
+    bf->retire_offset = 0;
+    bf->retire_size = 0;
+
+    bf->index = index_open(bf->mf, BRAIN_INDEX_META_OFFSET);
+    if (!bf->index) return -1;
+    index_set_allocator(bf->index, alloc_index_table, bf);
+
+    uint64_t live = 0, revived = 0, restored = 0;
+    for (uint64_t r = 0; r < brain_file_header(bf)->record_count; r++) {
+        brain_entry_t e;
+        if (brain_file_entry(bf, r, &e) < 0) continue;      /* 반환된 chunk */
+
+        brain_record_t* record = e.record;
+        if ((record->flags & BRAIN_RECORD_DELETED) && record->dead_lsn > checkpoint) {
+            record->flags = BRAIN_RECORD_LIVE;
+            record->dead_lsn = 0;
+            revived++;
+        }
+        if (!(record->flags & BRAIN_RECORD_LIVE)) continue;
+
+        header = brain_file_header(bf);
+        if (record->meta_len && !meta_in_heap(header, record->meta_offset, record->meta_len) &&
+            record->meta_prev != 0) {
+            record->meta_offset = record->meta_prev;
+            restored++;
+        }
+
+        /* 같은 ID의 LIVE 잔재 (WAL 이전 파일) → 나중 레코드가 이김 */
+        int64_t prev = index_lookup(bf->index, record->id);
+        if (prev > 0) {
+            brain_file_entry(bf, BRAIN_REF_RECORD(prev), &e);
+            e.record->flags = BRAIN_RECORD_DELETED;
+            header->heap_dead += e.record->meta_len;
+        } else {
+            live++;
+        }
+        if (index_insert(bf->index, record->id, BRAIN_RECORD_REF(r)) < 0) return -1;
+    }
+
+    brain_file_header(bf)->live_count = live;
+    reclaim_index(bf);
+
+    /* 레코드 / 인덱스 전체가 바뀜 */
+    mmap_file_mark_dirty(bf->mf, 0, bf->mf->size);
+
+    printf("[brain] ✓ Rebuilt index from records (%lu live, %lu revived, %lu metadata restored)\n",
+           (unsigned long)live, (unsigned long)revived, (unsigned long)restored);
+    return 0;
+}
+
+/* 4. 로그 재생 (bf->wal을 붙이기 전이라 다시 로그되지 않음) */
+static int wal_apply(void* ctx, uint64_t lsn, uint32_t type, const void* payload, uint32_t len) {
+    brain_file_t* bf = (brain_file_t*)ctx;
+
+    if (type == BRAIN_WAL_PUT) {
+        const wal_put_t* put = (const wal_put_t*)payload;
+        size_t vec_size = (size_t)brain_file_header(bf)->vector_dim * sizeof(float);
+        if (len < sizeof(*put) || len != sizeof(*put) + vec_size + put->meta_len) {
+            fprintf(stderr, "[brain] Error: WAL record %lu does not match the file geometry\n",
+                    (unsigned long)lsn);
+            return -1;
+        }
+        const float* vector = (const float*)(put + 1);
+        const char* metadata = (const char*)vector + vec_size;
+        if (file_append(bf, put->id, vector, metadata, put->meta_len, put->importance,
+                        put->timestamp, lsn) < 0) return -1;
+    } else if (type == BRAIN_WAL_DELETE && len == sizeof(int64_t)) {
+        int64_t id;
+        memcpy(&id, payload, sizeof(id));
+        file_delete(bf, id, lsn);           /* 이미 없으면 그대로 */
+    }
+    return 0;
+}
+
+brain_file_t* brain_file_open_durable(const char* path, const char* wal_path, uint32_t window_us) {
+    brain_wal_t* wal = brain_wal_open(wal_path, window_us);
+    if (!wal) return NULL;
+
+    uint64_t pending = brain_wal_replay_count(wal);
+    if (pending > 0 && wal_restore(path, wal) < 0) {
+        brain_wal_close(wal);
+        return NULL;
+    }
+
+    brain_file_t* bf = brain_file_open(path, 1);
+    if (!bf) {
+        brain_wal_close(wal);
+        return NULL;
+    }
+
+    if (pending > 0) {
+        if (rebuild_index(bf, wal->checkpoint_lsn) < 0 ||
+            brain_wal_replay(wal, wal_apply, bf) < 0) {
+            fprintf(stderr, "[brain] Error: recovery of '%s' failed\n", path);
+            brain_wal_close(wal);
+            brain_file_close(bf);
+            return NULL;
+        }
+        printf("[brain] ✓ Recovered '%s': replayed %lu log records\n",
+               path, (unsigned long)pending);
+    }
+
+    bf->wal = wal;
+    if (wal_checkpoint(bf) < 0) {
+        brain_file_close(bf);
+        return NULL;
+    }
+    return bf;
+}
+
+int brain_file_attach_wal(brain_file_t* bf, const char* wal_path, uint32_t window_us) {
+    if (!bf || !bf->mf->writable || bf->wal) return -1;
+
+    brain_wal_t* wal = brain_wal_open(wal_path, window_us);
+    if (!wal) return -1;
+
+    /* 열어 둔 파일의 밀린 로그를 버리면 커밋된 변경을 잃는다 */
+    if (!bf->created && brain_wal_replay_count(wal) > 0) {
+        fprintf(stderr, "[brain] Error: '%s' has records to replay, "
+                "use brain_file_open_durable\n", wal_path);
+        brain_wal_close(wal);
+        return -1;
+    }
+    brain_wal_replay(wal, NULL, NULL);
+
+    bf->wal = wal;
+    return wal_checkpoint(bf);
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 컴팩션 (온라인 vacuum)
+ *
+ * 레코드 번호는 chunk 위치로 정해지므로 제자리에서 당겨 채울 수 없다.
+ * 대신 성긴 chunk의 살아 있는 레코드를 파일 끝에 다시 추가하고
+ * index_update로 인덱스 값만 바꾼 뒤, 빈 chunk를 통째로 반환한다.
+ *
+ * 이동 순서: 새 레코드 완성 → record_count 증가 → 인덱스 교체 → 이전 삭제
+ * → 어느 시점에 조회해도 완성된 레코드 하나를 보게 된다.
+ * 중간에 끊기면 인덱스에 없는 LIVE 레코드가 남는데, 다음 검사에서 삭제된다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 인덱스가 가리키는 살아 있는 레코드인가 (아니면 LIVE 잔재를 삭제 표시) */
+static int record_indexed(brain_file_t* bf, uint64_t record_no, brain_record_t* record) {
+    if (!(record->flags & BRAIN_RECORD_LIVE)) return 0;
+    if (index_lookup(bf->index, record->id) == (int64_t)BRAIN_RECORD_REF(record_no)) return 1;
+
+    record->flags = BRAIN_RECORD_DELETED;
+    mark_dirty(bf, record, sizeof(*record));
+    return 0;
+}
+
+/* 발급된 레코드 중 죽은 수 / heap 사용량 (반환된 chunk 제외) */
+static void compact_measure(const brain_file_t* bf, uint64_t* issued, uint64_t* dead,
+                            uint64_t* heap_used) {
+    const brain_header_t* header = brain_file_header(bf);
+    const brain_section_t* sections = BRAIN_SECTIONS(header, header);
+
+    *issued = 0;
+    for (uint32_t k = 0; k < BRAIN_MAX_CHUNKS; k++) {
+        uint64_t first = brain_chunk_first(header, k);
+        if (first >= header->record_count) break;
+        if (bf->rec_chunk[k] == 0) continue;
+
+        uint64_t n = header->record_count - first;
+        uint64_t records = brain_chunk_records(header, k);
+        *issued += n < records ? n : records;
+    }
+    *dead = *issued > header->live_count ? *issued - header->live_count : 0;
+
+    *heap_used = 0;
+    for (uint32_t i = 0; i < header->section_count; i++) {
+        if (sections[i].type == BRAIN_SECTION_HEAP) *heap_used += sections[i].used;
+    }
+}
+
+/* 지난 cycle 이후 늘어난 죽은 공간이 트리거 비율을 넘었는가 */
+static int compact_needed(const brain_file_t* bf) {
+    const brain_compact_t* c = &bf->compact;
+    uint64_t issued, dead, heap_used;
+    compact_measure(bf, &issued, &dead, &heap_used);
+
+    uint64_t heap_dead = brain_file_header(bf)->heap_dead;
+    uint64_t new_dead = dead > c->base_dead ? dead - c->base_dead : 0;
+    uint64_t new_heap_dead = heap_dead > c->base_heap_dead ? heap_dead - c->base_heap_dead : 0;
+
+    return (new_dead > 0 && new_dead * 100 >= issued * BRAIN_COMPACT_TRIGGER_PCT) ||
+           (new_heap_dead > 0 && new_heap_dead * 100 >= heap_used * BRAIN_COMPACT_TRIGGER_PCT);
+}
+
+/* 레코드 from을 파일 끝으로 복사하고 인덱스를 옮김 */
+static int move_record(brain_file_t* bf, uint64_t from) {
+    brain_header_t* header = brain_file_header(bf);
+    uint64_t to = header->record_count;
+    if (BRAIN_RECORD_REF(to) > BRAIN_INDEX_OFFSET_MASK) return -1;
+
+    uint64_t i;
+    uint32_t k = brain_chunk_of(header, to, &i);
+    if (ensure_chunk(bf, k) < 0) return -1;
+    index_unseal(bf);
+
+    brain_entry_t src;
+    brain_file_entry(bf, from, &src);
+    uint32_t meta_len = src.meta_len;
+    uint64_t meta_offset = 0;
+    if (meta_len > 0) {
+        meta_offset = heap_reserve(bf, meta_len);
+        if (meta_offset == 0) return -1;
+        brain_file_entry(bf, from, &src);       /* heap 확장으로 재매핑됐을 수 있음 */
+        memcpy((char*)bf->mf->addr + meta_offset, src.metadata, meta_len);
+    }
+
+    header = brain_file_header(bf);
+    char* base = (char*)bf->mf->addr;
+    brain_record_t* record = (brain_record_t*)(base + bf->rec_chunk[k]) + i;
+    *record = *src.record;
+    record->meta_offset = meta_offset;
+    memcpy(base + bf->vec_chunk[k] + i * header->vector_stride, src.vector,
+           header->vector_stride);
+
+    brain_entry_t dst;
+    header->record_count++;
+    brain_file_entry(bf, to, &dst);
+    if (dst.timestamp && src.timestamp) {
+        *dst.timestamp = *src.timestamp;
+        *dst.access_count = __atomic_load_n(src.access_count, __ATOMIC_RELAXED);
+        *dst.importance = *src.importance;
+    }
+    mark_entry(bf, &dst);
+    if (verify_grow(bf) < 0) return -1;
+
+    if (index_update(bf->index, record->id, BRAIN_RECORD_REF(from), BRAIN_RECORD_REF(to)) < 0) {
+        record->flags = BRAIN_RECORD_DELETED;
+        header->heap_dead += meta_len;
+        mark_dirty(bf, record, sizeof(*record));
+        return -1;
+    }
+
+    src.record->dead_lsn = wal_mark(bf);
+    src.record->flags = BRAIN_RECORD_DELETED;
+    header->heap_dead += meta_len;
+    mark_dirty(bf, src.record, sizeof(brain_record_t));
+    return 0;
+}
+
+/* 디렉터리 항목 반환 + 디스크 블록 반환 */
+static void release_section(brain_file_t* bf, uint32_t index) {
+    brain_header_t* header = brain_file_header(bf);
+    const brain_section_t* s = &BRAIN_SECTIONS(header, header)[index];
+    uint64_t offset = s->offset;
+    uint64_t size = s->size;
+
+    brain_section_release(header, index);
+    bf->compact.stats.bytes_freed += size;
+    if (mmap_file_punch(bf->mf, offset, size) == 0) bf->compact.stats.bytes_punched += size;
+}
+
+static int cmp_extent(const void* a, const void* b) {
+    uint64_t x = ((const brain_compact_extent_t*)a)->offset;
+    uint64_t y = ((const brain_compact_extent_t*)b)->offset;
+    return (x > y) - (x < y);
+}
+
+/* meta_offset이 들어 있는 후보 extent (없으면 NULL) */
+static brain_compact_extent_t* find_extent(const brain_compact_t* c, uint64_t offset) {
+    uint32_t lo = 0, hi = c->heap_count;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (c->heap[mid].offset <= offset) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == 0) return NULL;
+
+    brain_compact_extent_t* x = &c->heap[lo - 1];
+    return offset < x->offset + x->used ? x : NULL;
+}
+
+/* HEAP_SCAN 시작: 현재 extent를 뺀 heap extent가 후보 */
+static void compact_heap_begin(brain_file_t* bf) {
+    brain_compact_t* c = &bf->compact;
+    brain_header_t* header = brain_file_header(bf);
+    const brain_section_t* sections = BRAIN_SECTIONS(header, header);
+
+    free(c->heap);
+    c->heap = NULL;
+    c->heap_count = 0;
+    c->phase = BRAIN_COMPACT_RELEASE;
+
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < header->section_count; i++) {
+        n += sections[i].type == BRAIN_SECTION_HEAP && (int32_t)i != bf->heap_section;
+    }
+    if (n == 0) return;
+
+    c->heap = (brain_compact_extent_t*)calloc(n, sizeof(brain_compact_extent_t));
+    if (!c->heap) return;
+
+    for (uint32_t i = 0; i < header->section_count; i++) {
+        if (sections[i].type != BRAIN_SECTION_HEAP || (int32_t)i == bf->heap_section) continue;
+
+        brain_compact_extent_t* x = &c->heap[c->heap_count++];
+        x->offset = sections[i].offset;
+        x->used = sections[i].used;
+        x->section = i;
+    }
+    qsort(c->heap, c->heap_count, sizeof(brain_compact_extent_t), cmp_extent);
+
+    c->phase = BRAIN_COMPACT_HEAP_SCAN;
+    c->cursor = 0;
+    c->end = header->record_count;
+}
+
+/* 다음 chunk로 (c->end 안에서 완성된 chunk만) */
+static void compact_next_chunk(brain_file_t* bf) {
+    brain_compact_t* c = &bf->compact;
+    c->chunk++;
+    c->cursor = brain_chunk_first(brain_file_header(bf), c->chunk);
+    c->moving = 0;
+    c->live = 0;
+}
+
+static int compact_records(brain_file_t* bf, uint32_t budget) {
+    brain_compact_t* c = &bf->compact;
+
+    while (budget > 0) {
+        const brain_header_t* header = brain_file_header(bf);
+        uint32_t k = c->chunk;
+        uint64_t first = brain_chunk_first(header, k);
+        uint64_t records = brain_chunk_records(header, k);
+
+        /* 채우는 중인 끝 chunk (와 이번 cycle에 옮겨 온 chunk)는 대상 아님 */
+        if (k >= BRAIN_MAX_CHUNKS || first + records > c->end) {
+            compact_heap_begin(bf);
+            return 1;
+        }
+        if (bf->rec_chunk[k] == 0) {
+            compact_next_chunk(bf);
+            continue;
+        }
+
+        if (!c->moving) {
+            for (; c->cursor < first + records && budget > 0; c->cursor++, budget--) {
+                brain_entry_t e;
+                brain_file_entry(bf, c->cursor, &e);
+                c->live += record_indexed(bf, c->cursor, e.record);
+                c->stats.scanned++;
+            }
+            if (c->cursor < first + records) return 1;
+
+            if (c->live * 100 > records * (100 - BRAIN_COMPACT_SPARSE_PCT)) {
+                compact_next_chunk(bf);
+                continue;
+            }
+            c->moving = 1;
+            c->cursor = first;
+            if (c->live == 0) c->cursor = first + records;
+        }
+
+        for (; c->cursor < first + records && budget > 0; c->cursor++, budget--) {
+            brain_entry_t e;
+            brain_file_entry(bf, c->cursor, &e);
+            if (!record_indexed(bf, c->cursor, e.record)) continue;
+
+            if (move_record(bf, c->cursor) < 0) {
+                fprintf(stderr, "[brain] Error: compaction could not move record %lu\n",
+                        (unsigned long)c->cursor);
+                compact_heap_begin(bf);
+                return -1;
+            }
+            c->stats.moved++;
+        }
+        if (c->cursor < first + records) return 1;
+
+        c->dead_chunks |= 1ull << k;
+        compact_next_chunk(bf);
+    }
+    return 1;
+}
+
+/* HEAP_SCAN / HEAP_MOVE 공통: 다음 검사할 레코드 (반환된 chunk는 건너뜀) */
+static int compact_next_record(brain_file_t* bf, brain_entry_t* e) {
+    brain_compact_t* c = &bf->compact;
+    const brain_header_t* header = brain_file_header(bf);
+
+    while (c->cursor < c->end) {
+        if (brain_file_entry(bf, c->cursor, e) == 0) return 1;
+
+        uint32_t k = brain_chunk_of(header, c->cursor, NULL);
+        c->cursor = brain_chunk_first(header, k + 1);
+    }
+    return 0;
+}
+
+static int compact_heap_scan(brain_file_t* bf, uint32_t budget) {
+    brain_compact_t* c = &bf->compact;
+    brain_entry_t e;
+
+    for (; budget > 0 && compact_next_record(bf, &e); c->cursor++, budget--) {
+        if (e.meta_len == 0 || !record_indexed(bf, c->cursor, e.record)) continue;
+
+        brain_compact_extent_t* x = find_extent(c, e.record->meta_offset);
+        if (x) x->live += e.meta_len;
+    }
+    if (c->cursor < c->end) return 1;
+
+    int move = 0;
+    for (uint32_t i = 0; i < c->heap_count; i++) {
+        brain_compact_extent_t* x = &c->heap[i];
+        if (x->live * 100 > x->used * (100 - BRAIN_COMPACT_SPARSE_PCT)) continue;
+        x->sparse = 1;
+        move |= x->live > 0;
+    }
+
+    c->phase = move ? BRAIN_COMPACT_HEAP_MOVE : BRAIN_COMPACT_RELEASE;
+    c->cursor = 0;
+    return 1;
+}
+
+/* 성긴 extent의 메타데이터를 현재 extent로 (레코드 번호는 그대로) */
+static int compact_heap_move(brain_file_t* bf, uint32_t budget) {
+    brain_compact_t* c = &bf->compact;
+    brain_entry_t e;
+
+    for (; budget > 0 && compact_next_record(bf, &e); c->cursor++, budget--) {
+        if (e.meta_len == 0 || !record_indexed(bf, c->cursor, e.record)) continue;
+
+        brain_compact_extent_t* x = find_extent(c, e.record->meta_offset);
+        if (!x || !x->sparse) continue;
+
+        uint64_t old_offset = e.record->meta_offset;
+        uint64_t offset = heap_reserve(bf, e.meta_len);
+        if (offset == 0) {
+            x->sparse = 0;                  /* 이 extent는 이번에 반환하지 않음 */
+            continue;
+        }
+
+        char* base = (char*)bf->mf->addr;
+        memcpy(base + offset, base + old_offset, e.meta_len);
+        brain_file_entry(bf, c->cursor, &e);
+        e.record->meta_prev = old_offset;   /* 체크포인트 전에 끊기면 복구가 되돌림 */
+        __atomic_store_n(&e.record->meta_offset, offset, __ATOMIC_RELEASE);
+        mark_dirty(bf, base + offset, e.meta_len);
+        mark_dirty(bf, e.record, sizeof(brain_record_t));
+        c->stats.meta_moved++;
+    }
+    if (c->cursor < c->end) return 1;
+
+    c->phase = BRAIN_COMPACT_RELEASE;
+    return 1;
+}
+
+static int compact_release(brain_file_t* bf) {
+    brain_compact_t* c = &bf->compact;
+
+    /* WAL: 옮긴 레코드가 내구화된 뒤에만 이전 영역을 반환하고,
+     * 반환 직후에도 체크포인트 (재사용된 영역을 옛 스냅샷이 가리키지 않도록) */
+    if (bf->wal && (brain_file_checkpoint(bf) < 0 || wal_touch(bf) < 0)) return -1;
+
+    brain_header_t* header = brain_file_header(bf);
+    const brain_section_t* sections = BRAIN_SECTIONS(header, header);
+
+    for (uint32_t i = 0; i < header->section_count; i++) {
+        const brain_section_t* s = &sections[i];
+        if ((s->type != BRAIN_SECTION_RECORDS && s->type != BRAIN_SECTION_VECTORS &&
+             s->type != BRAIN_SECTION_COUNTERS) ||
+            s->chunk >= BRAIN_MAX_CHUNKS || !(c->dead_chunks & (1ull << s->chunk))) continue;
+
+        if (s->type == BRAIN_SECTION_RECORDS) c->stats.chunks_freed++;
+        bf->rec_chunk[s->chunk] = 0;
+        bf->vec_chunk[s->chunk] = 0;
+        bf->cnt_chunk[s->chunk] = 0;
+        release_section(bf, i);
+    }
+
+    for (uint32_t i = 0; i < c->heap_count; i++) {
+        const brain_compact_extent_t* x = &c->heap[i];
+        if (!x->sparse) continue;
+
+        uint64_t dead = x->used - x->live;
+        header->heap_dead -= dead < header->heap_dead ? dead : header->heap_dead;
+        release_section(bf, x->section);
+        c->stats.extents_freed++;
+    }
+
+    /* 파일 끝까지 비었으면 잘라냄 */
+    uint64_t old_size = bf->mf->size;
+    c->stats.bytes_truncated += brain_trim_tail(header);
+    if (header->file_size < old_size) mmap_file_resize(bf->mf, header->file_size);
+
+    free(c->heap);
+    c->heap = NULL;
+    c->heap_count = 0;
+    c->dead_chunks = 0;
+    c->phase = BRAIN_COMPACT_IDLE;
+    c->stats.cycles++;
+
+    uint64_t issued, heap_used;
+    compact_measure(bf, &issued, &c->base_dead, &heap_used);
+    c->base_heap_dead = brain_file_header(bf)->heap_dead;
+
+    if (bf->wal && brain_file_checkpoint(bf) < 0) return -1;
+
+    const brain_compact_stats_t* b = &c->begin;
+    printf("[brain] ✓ Compaction #%lu: moved %lu records + %lu metadata, "
+           "freed %lu chunks / %lu extents (%.1f MB, %.1f MB truncated)\n",
+           (unsigned long)c->stats.cycles,
+           (unsigned long)(c->stats.moved - b->moved),
+           (unsigned long)(c->stats.meta_moved - b->meta_moved),
+           (unsigned long)(c->stats.chunks_freed - b->chunks_freed),
+           (unsigned long)(c->stats.extents_freed - b->extents_freed),
+           (c->stats.bytes_freed - b->bytes_freed) / 1024.0 / 1024.0,
+           (c->stats.bytes_truncated - b->bytes_truncated) / 1024.0 / 1024.0);
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_file_compact_step
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int compact_phase(brain_file_t* bf, uint32_t budget) {
+    brain_compact_t* c = &bf->compact;
+
+    switch (c->phase) {
+        case BRAIN_COMPACT_IDLE:
+            if (!compact_needed(bf)) return 0;
+            if (wal_touch(bf) < 0) return -1;
+
+            c->phase = BRAIN_COMPACT_RECORDS;
+            c->chunk = 0;
+            c->cursor = 0;
+            c->moving = 0;
+            c->live = 0;
+            c->end = brain_file_header(bf)->record_count;
+            c->dead_chunks = 0;
+            c->begin = c->stats;
+            return compact_records(bf, budget);
+
+        case BRAIN_COMPACT_RECORDS:   return compact_records(bf, budget);
+        case BRAIN_COMPACT_HEAP_SCAN: return compact_heap_scan(bf, budget);
+        case BRAIN_COMPACT_HEAP_MOVE: return compact_heap_move(bf, budget);
+        case BRAIN_COMPACT_RELEASE:   return compact_release(bf);
+    }
+    return -1;
+}
+
+int brain_file_compact_step(brain_file_t* bf, uint32_t budget) {
+    if (!bf || !bf->mf->writable) return -1;
+    if (budget == 0) budget = 1;
+
+    brain_compact_phase_t phase = bf->compact.phase;
+    if (phase != BRAIN_COMPACT_IDLE && wal_touch(bf) < 0) return -1;
+
+    /* 진행한 단계는 record_count / heap_dead / 섹션 반환으로 헤더를 바꿈 */
+    int rc = compact_phase(bf, budget);
+    if (phase != BRAIN_COMPACT_IDLE || bf->compact.phase != BRAIN_COMPACT_IDLE) mark_header(bf);
+    return rc;
+}
+
+int brain_file_compact(brain_file_t* bf) {
+    int rc;
+    while ((rc = brain_file_compact_step(bf, BRAIN_COMPACT_BATCH)) > 0) {}
+    return rc;
+}
+
+int brain_file_compact_task(void* ctx) {
+    return brain_file_compact_step((brain_file_t*)ctx, BRAIN_COMPACT_BATCH);
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 체크섬 검증 / scrub
+ *
+ * 레코드 손상은 고칠 수 없으므로 비트맵에 표시해 조회에서 뺀다.
+ * 인덱스는 레코드에서 다시 만들 수 있으므로 불일치면 재구축한다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 인덱스 페이지 불일치 → 재구축 (읽기 전용이면 -1) */
+static int index_repair(brain_file_t* bf, uint64_t page) {
+    brain_verify_t* v = bf->verify;
+    v->stats.pages_failed++;
+    fprintf(stderr, "[brain] Error: ID index page %lu checksum mismatch%s\n",
+            (unsigned long)page, bf->mf->writable ? ", rebuilding" : "");
+    if (!bf->mf->writable) return -1;
+
+    if (wal_touch(bf) < 0 || rebuild_index(bf, UINT64_MAX) < 0) return -1;
+    v->stats.index_rebuilds++;
+    return 0;
+}
+
+int brain_file_set_verify(brain_file_t* bf, brain_verify_mode_t mode) {
+    if (!bf) return -1;
+
+    if (mode == BRAIN_VERIFY_NEVER) {
+        if (bf->verify) {
+            free(bf->verify->checked);
+            free(bf->verify->corrupt);
+            free(bf->verify);
+            bf->verify = NULL;
+        }
+        return 0;
+    }
+
+    if (!bf->verify) {
+        bf->verify = (brain_verify_t*)calloc(1, sizeof(brain_verify_t));
+        if (!bf->verify) return -1;
+    }
+    bf->verify->mode = mode;
+    if (verify_grow(bf) < 0) return -1;
+
+    return mode == BRAIN_VERIFY_FIRST_TOUCH ? brain_file_verify_index(bf) : 0;
+}
+
+int brain_file_verify_index(brain_file_t* bf) {
+    if (!bf || !bf->verify) return -1;
+    if (!index_sealed(bf)) return 0;
+
+    uint64_t pages = index_page_count(bf);
+    for (uint64_t p = 0; p < pages; p++) {
+        if (index_page_check(bf, p) < 0) return index_repair(bf, p);
+        bf->verify->stats.pages_verified++;
+    }
+    return 0;
+}
+
+/* 한 바퀴 끝: 요약 출력 후 처음부터 */
+static int scrub_finish(brain_file_t* bf) {
+    brain_verify_t* v = bf->verify;
+    const brain_verify_stats_t* b = &v->begin;
+
+    v->stats.scrub_passes++;
+    printf("[brain] ✓ Scrub #%lu: %lu records, %lu index pages, %lu mismatches (%.1f MB)\n",
+           (unsigned long)v->stats.scrub_passes,
+           (unsigned long)(v->stats.records_verified - b->records_verified),
+           (unsigned long)(v->stats.pages_verified - b->pages_verified),
+           (unsigned long)(v->stats.records_failed - b->records_failed +
+                           v->stats.pages_failed - b->pages_failed),
+           (v->stats.scrub_bytes - b->scrub_bytes) / 1024.0 / 1024.0);
+
+    v->cursor = 0;
+    v->page = 0;
+    v->index_phase = 0;
+    v->begin = v->stats;
+    return 0;
+}
+
+int brain_file_scrub_step(brain_file_t* bf, uint64_t budget) {
+    if (!bf || !bf->verify) return -1;
+
+    brain_verify_t* v = bf->verify;
+    const brain_header_t* header = brain_file_header(bf);
+    uint64_t vec_bytes = (uint64_t)header->vector_dim * (header->vector_storage == 0 ? 4 : 2);
+    uint64_t spent = 0;
+
+    /* 1. 레코드 (반환된 chunk는 건너뜀) */
+    while (!v->index_phase && spent < budget) {
+        if (v->cursor >= header->record_count) {
+            v->index_phase = 1;
+            v->page = 0;
+            break;
+        }
+
+        brain_entry_t e;
+        if (brain_file_entry(bf, v->cursor, &e) < 0) {
+            uint32_t k = brain_chunk_of(header, v->cursor, NULL);
+            v->cursor = brain_chunk_first(header, k + 1);
+            continue;
+        }
+
+        spent += sizeof(brain_record_t);
+        if (e.record->flags & BRAIN_RECORD_LIVE) {
+            spent += vec_bytes + e.meta_len;
+            record_verify(bf, &e);
+        }
+        v->cursor++;
+    }
+
+    /* 2. 인덱스 페이지 (봉인이 풀렸으면 이번 바퀴는 건너뜀) */
+    while (v->index_phase && spent < budget) {
+        if (!index_sealed(bf) || v->page >= index_page_count(bf)) {
+            v->stats.scrub_bytes += spent;
+            return scrub_finish(bf);
+        }
+
+        spent += BRAIN_INDEX_CRC_PAGE;
+        if (index_page_check(bf, v->page) < 0) {
+            if (index_repair(bf, v->page) < 0) {
+                v->stats.scrub_bytes += spent;
+                scrub_finish(bf);
+                return -1;
+            }
+            continue;                       /* 재구축 → 봉인 풀림 → 다음 반복에서 끝 */
+        }
+        v->stats.pages_verified++;
+        v->page++;
+    }
+
+    v->stats.scrub_bytes += spent;
+    return 1;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* 토큰 버킷: 지난 호출 이후 경과 시간 × BRAIN_SCRUB_RATE만큼 검사
+ * (circadian은 1초마다 부르므로 대략 초당 BRAIN_SCRUB_RATE, 조회와 나란히 돌아도
+ *  한 번에 BRAIN_SCRUB_BURST 이상 페이지를 끌어오지 않는다) */
+int brain_file_scrub_task(void* ctx) {
+    brain_file_t* bf = (brain_file_t*)ctx;
+    if (!bf || !bf->verify || bf->verify->mode != BRAIN_VERIFY_SCRUB) return 0;
+
+    brain_verify_t* v = bf->verify;
+    uint64_t now = now_ns();
+    if (v->last_ns == 0) {
+        v->tokens = BRAIN_SCRUB_BURST;
+    } else {
+        v->tokens += (double)(now - v->last_ns) * 1e-9 * BRAIN_SCRUB_RATE;
+        if (v->tokens > BRAIN_SCRUB_BURST) v->tokens = BRAIN_SCRUB_BURST;
+    }
+    v->last_ns = now;
+    if (v->tokens < BRAIN_SCRUB_MIN) return 1;
+
+    uint64_t before = v->stats.scrub_bytes;
+    int rc = brain_file_scrub_step(bf, (uint64_t)v->tokens);
+    v->tokens -= (double)(v->stats.scrub_bytes - before);
+    if (v->tokens < 0) v->tokens = 0;
+    return rc;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 보조 정렬 인덱스: 값 변경 / 구간 순회
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 열 값이 바뀐 레코드를 delta에 (따라잡은 뒤라 항상 upto 앞)
+ * 인덱스를 한 번도 쓰지 않은 파일 (섹션 없음, 조회 없음)은 건너뜀 */
+static int range_note(brain_file_t* bf, uint32_t key, const brain_entry_t* e, int64_t value) {
+    if (range_catch_up(bf, key) < 0) return -1;
+    range_unseal(bf, key);
+    return range_push(&bf->range[key], value, e->record_no);
+}
+
+int brain_file_set_timestamp(brain_file_t* bf, const brain_entry_t* entry, int64_t timestamp) {
+    if (!bf || !entry || !entry->timestamp || !bf->mf->writable) return -1;
+    if (*entry->timestamp == timestamp) return 0;
+
+    *entry->timestamp = timestamp;
+    mark_dirty(bf, entry->timestamp, sizeof(*entry->timestamp));
+    if (!bf->range[BRAIN_RANGE_TIMESTAMP].loaded && bf->range[BRAIN_RANGE_TIMESTAMP].section < 0) return 0;
+    return range_note(bf, BRAIN_RANGE_TIMESTAMP, entry, timestamp);
+}
+
+int brain_file_set_importance(brain_file_t* bf, const brain_entry_t* entry, float importance) {
+    if (!bf || !entry || !entry->importance || !bf->mf->writable) return -1;
+    if (*entry->importance == importance) return 0;
+
+    *entry->importance = importance;
+    mark_dirty(bf, entry->importance, sizeof(*entry->importance));
+    if (!bf->range[BRAIN_RANGE_IMPORTANCE].loaded && bf->range[BRAIN_RANGE_IMPORTANCE].section < 0) return 0;
+    return range_note(bf, BRAIN_RANGE_IMPORTANCE, entry, brain_importance_key(importance));
+}
+
+/* 정렬 배열에서 (lo, 0) 이상인 첫 위치 */
+static uint64_t range_lower_bound(const brain_range_entry_t* a, uint64_t n, int64_t lo) {
+    uint64_t l = 0, h = n;
+    while (l < h) {
+        uint64_t m = l + (h - l) / 2;
+        if (a[m].key < lo) l = m + 1;
+        else h = m;
+    }
+    return l;
+}
+
+int brain_file_range(brain_file_t* bf, uint32_t key, int64_t lo, int64_t hi,
+                     brain_range_iter_t* it) {
+    if (!bf || !it || key >= BRAIN_RANGE_KEYS) return -1;
+    if (range_catch_up(bf, key) < 0) return -1;
+
+    brain_range_t* r = &bf->range[key];
+    const brain_range_run_t* run = r->run_valid ? range_run(bf, key, 0) : NULL;
+    uint64_t run_count = run ? run->count : 0;
+
+    /* delta가 run에 비해 커졌으면 병합 (쓰기 가능한 파일만) */
+    if (bf->mf->writable && r->delta_count >= BRAIN_RANGE_DELTA_MIN &&
+        r->delta_count * 8 >= run_count) {
+        if (range_merge(bf, key) < 0) return -1;
+        run = range_run(bf, key, 0);
+        run_count = run->count;
+    }
+    if (!r->delta_sorted) {
+        qsort(r->delta, r->delta_count, sizeof(brain_range_entry_t), range_qsort_cmp);
+        r->delta_sorted = 1;
+    }
+
+    memset(it, 0, sizeof(*it));
+    it->bf = bf;
+    it->key = key;
+    it->lo = lo;
+    it->hi = hi;
+    if (run) {
+        const brain_range_entry_t* entries = (const brain_range_entry_t*)(run + 1);
+        it->run_offset = (uint64_t)((const char*)entries - (const char*)bf->mf->addr);
+        it->run_pos = range_lower_bound(entries, run_count, lo);
+        it->run_end = run_count;
+    }
+    it->delta_pos = range_lower_bound(r->delta, r->delta_count, lo);
+    it->delta_end = r->delta_count;
+    return 0;
+}
+
+int brain_file_range_next(brain_range_iter_t* it, brain_entry_t* out) {
+    if (!it || !out) return 0;
+
+    const brain_file_t* bf = it->bf;
+    const brain_range_t* r = &bf->range[it->key];
+    const brain_range_entry_t* run =
+        it->run_offset ? (const brain_range_entry_t*)((const char*)bf->mf->addr + it->run_offset)
+                       : NULL;
+
+    for (;;) {
+        /* 구간을 벗어난 쪽은 끝으로 */
+        if (it->run_pos < it->run_end && run[it->run_pos].key > it->hi) it->run_pos = it->run_end;
+        if (it->delta_pos < it->delta_end && r->delta[it->delta_pos].key > it->hi) {
+            it->delta_pos = it->delta_end;
+        }
+
+        const brain_range_entry_t* x;
+        if (it->run_pos < it->run_end &&
+            (it->delta_pos == it->delta_end ||
+             range_cmp(&run[it->run_pos], &r->delta[it->delta_pos]) <= 0)) {
+            x = &run[it->run_pos++];
+        } else if (it->delta_pos < it->delta_end) {
+            x = &r->delta[it->delta_pos++];
+        } else {
+            return 0;
+        }
+
+        it->scanned++;
+        if (it->has_last && range_cmp(&it->last, x) == 0) continue;
+        it->last = *x;
+        it->has_last = 1;
+        if (range_valid(bf, it->key, x, out)) return 1;
+    }
+}
+
+uint64_t brain_file_count(const brain_file_t* bf) {
+    return bf ? brain_file_header(bf)->live_count : 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_file_stats
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+void brain_file_stats(const brain_file_t* bf) {
+    if (!bf) return;
+
+    brain_print_header(brain_file_header(bf));
+    index_stats(bf->index);
+
+    if (bf->verify) {
+        static const char* mode_names[] = {"never", "first-touch", "scrub"};
+        const brain_verify_stats_t* st = &bf->verify->stats;
+        printf("[brain] Verify (%s): records %lu ok / %lu bad, index pages %lu ok / %lu bad, "
+               "%lu rebuilds, %lu scrub passes (crc32c %s)\n",
+               mode_names[bf->verify->mode],
+               (unsigned long)st->records_verified, (unsigned long)st->records_failed,
+               (unsigned long)st->pages_verified, (unsigned long)st->pages_failed,
+               (unsigned long)st->index_rebuilds, (unsigned long)st->scrub_passes,
+               brain_crc32c_impl());
+    }
+
+    const mmap_warm_t* warm = &bf->mf->warm;
+    if (warm->warm_ms > 0 || warm->locked_bytes > 0) {
+        printf("[brain] Warm-up: %lu minor / %lu major faults in %.2f ms, %zu bytes locked%s\n",
+               (unsigned long)warm->minor_faults, (unsigned long)warm->major_faults,
+               warm->warm_ms, warm->locked_bytes, warm->huge ? ", hugepage" : "");
+    }
+
+    mmap_heat_stats_t heat;
+    if (mmap_file_heat_stats(bf->mf, &heat) == 0) {
+        printf("[brain] Heat: %lu touches over %lu samples, prefetch %u granules / %.1f MB in %.2f ms%s\n",
+               (unsigned long)heat.touches, (unsigned long)heat.samples, heat.prefetch_granules,
+               heat.prefetched_bytes / 1024.0 / 1024.0, heat.prefetch_ms,
+               heat.prefetch_done || heat.prefetch_granules == 0 ? "" : " (running)");
+    }
+
+    if (bf->mf->writable) {
+        printf("[brain] Mapping: %zu / %zu MB reserved, %u moves\n",
+               bf->mf->size >> 20, bf->mf->reserved >> 20, bf->mf->moves);
+    }
+
+    static const char* key_names[] = {"timestamp", "importance"};
+    for (uint32_t key = 0; key < BRAIN_RANGE_KEYS; key++) {
+        const brain_range_t* r = &bf->range[key];
+        if (!r->loaded) continue;
+
+        const brain_range_run_t* run = r->run_valid ? range_run(bf, key, 0) : NULL;
+        printf("[brain] Range (%s): run %lu + delta %lu entries, %lu merges\n", key_names[key],
+               (unsigned long)(run ? run->count : 0), (unsigned long)r->delta_count,
+               (unsigned long)r->merges);
+    }
+}
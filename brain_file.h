@@ -0,0 +1,480 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_file.h
+ *
+ * Brain 파일 저장 엔진 (v2 포맷 읽기/쓰기)
+ *
+ * mmap_loader (매핑) + index_manager (ID → 레코드) + brain_format (섹션)
+ * 위에 레코드 단위 API를 올린다.
+ *
+ *   - 추가 전용 배치: 레코드 번호는 계속 증가, 덮어쓰기 = 새 레코드 + 이전 삭제
+ *   - 빈 공간 관리: 재해시가 끝난 인덱스 테이블 → FREE 섹션 → 다음 할당에 재사용
+ *   - 읽기는 복사 없이 매핑 안 포인터를 돌려준다
+ *
+ * 주의: 쓰기 가능 파일은 주소 공간을 미리 예약해 두고 그 안에서 커지므로
+ *       append / delete 뒤에도 brain_entry_t 포인터는 유효하다.
+ *       예약(MMAP_RESERVE_DEFAULT)을 넘는 확장만 재매핑 → 포인터 무효
+ *       (bf->mf->moves로 확인)
+ *
+ * 동시성: 조회 (brain_file_get / brain_file_entry)끼리는 동시에 돌아도 되지만
+ *       변경 (append / delete / 컴팩션 / 값 변경 / range)과는 호출자의 같은 잠금으로
+ *       배타여야 한다 (ID 인덱스 조회 규칙, index_manager.h).
+ *       brain_file_touch만 예외 (원자적 카운터).
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#ifndef BRAIN_FILE_H
+#define BRAIN_FILE_H
+
+#include "brain_format.h"
+#include "mmap_loader.h"
+#include "index_manager.h"
+#include "brain_wal.h"
+#include <stdint.h>
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Configuration
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#define BRAIN_HEAP_EXTENT_MIN   (64 * 1024)         /* 첫 heap extent */
+#define BRAIN_HEAP_EXTENT_MAX   (16 * 1024 * 1024)  /* extent 크기 상한 (2배씩 증가) */
+
+/* 컴팩션 */
+#define BRAIN_COMPACT_TRIGGER_PCT   20      /* 죽은 레코드/heap 비율이 이 이상이면 cycle 시작 */
+#define BRAIN_COMPACT_SPARSE_PCT    50      /* 죽은 비율이 이 이상인 chunk / extent를 비움 */
+#define BRAIN_COMPACT_BATCH         4096    /* brain_file_compact_task 1회 레코드 예산 */
+
+/* WAL: 로그가 이 크기를 넘으면 append / delete 끝에 체크포인트 */
+#define BRAIN_WAL_CHECKPOINT_BYTES  (64 * 1024 * 1024)
+
+/* 매핑 dirty 단위가 이보다 오래되면 flusher가 비동기로 쓰기 시작 (BRAIN_OPEN_TRACK) */
+#define BRAIN_FLUSH_AGE_MS          1000
+
+/* 열기 옵션 (brain_file_open_ex) */
+#define BRAIN_OPEN_POPULATE         MMAP_OPEN_POPULATE  /* 파일 전체 미리 매핑 */
+#define BRAIN_OPEN_HUGEPAGE         MMAP_OPEN_HUGEPAGE  /* 2MB 정렬 + MADV_HUGEPAGE */
+#define BRAIN_OPEN_NORESERVE        MMAP_OPEN_NORESERVE /* 주소 예약 없음 (커지면 재매핑) */
+#define BRAIN_OPEN_WARM_INDEX       0x100               /* 헤더 / 디렉터리 / ID 인덱스만 미리 매핑 */
+#define BRAIN_OPEN_PREFETCH         0x200               /* <path>.heat 재생 + 이번 heat 기록 → 닫을 때 저장 */
+#define BRAIN_OPEN_TRACK            0x400               /* dirty 단위 추적 + flusher (mmap_file_track) */
+
+/* 페이지 heat mincore 샘플 주기 (BRAIN_OPEN_PREFETCH) */
+#define BRAIN_HEAT_SAMPLE_MS        1000
+#define BRAIN_HEAT_SUFFIX           ".heat"
+
+/* 메모리 고정 대상 (brain_file_lock) */
+#define BRAIN_LOCK_INDEX            0x01    /* 헤더 / 디렉터리 / ID 인덱스 테이블 + CRC */
+#define BRAIN_LOCK_RANGE            0x02    /* 보조 정렬 인덱스 run */
+
+/* 체크섬 scrub (brain_file_scrub_task 토큰 버킷) */
+#define BRAIN_SCRUB_RATE            (2 * 1024 * 1024)   /* 초당 검사 바이트 */
+#define BRAIN_SCRUB_BURST           BRAIN_SCRUB_RATE    /* 1회 최대 (1초분) */
+#define BRAIN_SCRUB_MIN             (64 * 1024)         /* 이만큼 모이기 전엔 건너뜀 */
+
+/* 보조 정렬 인덱스: delta가 이 이상이고 run의 1/8 이상이면 조회 시작 때 병합 */
+#define BRAIN_RANGE_DELTA_MIN       4096
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 컴팩션 상태
+ *
+ * 한 cycle = RECORDS → HEAP_SCAN → HEAP_MOVE → RELEASE
+ *   RECORDS:   완성된 chunk의 live 수를 세고, 성긴 chunk의 살아 있는
+ *              레코드를 파일 끝 chunk로 복사 → 인덱스 값 교체 → 이전 삭제
+ *   HEAP_SCAN: extent별 live 메타데이터 바이트 집계
+ *   HEAP_MOVE: 성긴 extent의 live 메타데이터를 현재 extent로 복사
+ *   RELEASE:   비운 chunk / extent → FREE + 구멍 뚫기, 파일 끝이면 잘라냄
+ *
+ * 비운 영역은 cycle 끝(RELEASE)에 한꺼번에 반환하므로, 그 전에 받은
+ * brain_entry_t 포인터는 RELEASE 단계 전까지 계속 읽을 수 있다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+typedef enum {
+    BRAIN_COMPACT_IDLE = 0,
+    BRAIN_COMPACT_RECORDS,
+    BRAIN_COMPACT_HEAP_SCAN,
+    BRAIN_COMPACT_HEAP_MOVE,
+    BRAIN_COMPACT_RELEASE
+} brain_compact_phase_t;
+
+typedef struct {
+    uint64_t offset;
+    uint64_t used;
+    uint64_t live;                  /* HEAP_SCAN 집계 */
+    uint32_t section;               /* 디렉터리 번호 */
+    uint32_t sparse;                /* 1 = 비울 대상 */
+} brain_compact_extent_t;
+
+typedef struct {
+    uint64_t cycles;                /* 끝난 cycle 수 */
+    uint64_t scanned;               /* 검사한 레코드 */
+    uint64_t moved;                 /* 옮긴 레코드 */
+    uint64_t meta_moved;            /* 옮긴 메타데이터 (extent 비우기) */
+    uint64_t chunks_freed;
+    uint64_t extents_freed;
+    uint64_t bytes_freed;           /* FREE로 돌린 바이트 */
+    uint64_t bytes_punched;         /* 구멍 뚫기 성공 바이트 */
+    uint64_t bytes_truncated;       /* 파일 끝에서 잘라낸 바이트 */
+} brain_compact_stats_t;
+
+typedef struct {
+    brain_compact_phase_t phase;
+    uint32_t  chunk;                /* RECORDS: 현재 chunk */
+    int       moving;               /* RECORDS: 0 = 집계 중, 1 = 옮기는 중 */
+    uint64_t  cursor;               /* 다음 레코드 번호 */
+    uint64_t  end;                  /* 스캔 끝 */
+    uint64_t  live;                 /* RECORDS: 현재 chunk live 수 */
+    uint64_t  dead_chunks;          /* 비운 chunk 비트맵 (RELEASE에서 반환) */
+
+    brain_compact_extent_t* heap;   /* 후보 extent (offset 순) */
+    uint32_t  heap_count;
+
+    /* 지난 cycle 직후의 죽은 레코드 / heap (트리거는 그 이후 증가분 기준) */
+    uint64_t  base_dead;
+    uint64_t  base_heap_dead;
+
+    brain_compact_stats_t stats;    /* 누적 */
+    brain_compact_stats_t begin;    /* 이번 cycle 시작 시점 stats */
+} brain_compact_t;
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 체크섬 검증
+ *
+ * 레코드: brain_record_t.crc (벡터 + 메타데이터), 쓰기 때 계산
+ * 인덱스: INDEX_CRC 섹션 (4KB 페이지마다 CRC32C), 체크포인트 / 닫기 때 봉인,
+ *         봉인 후 첫 변경에서 무효화 → 불일치면 레코드에서 인덱스 재구축
+ *
+ *   NEVER:       검사 안 함 (기본)
+ *   FIRST_TOUCH: brain_file_get이 레코드를 처음 돌려줄 때 검사,
+ *                인덱스는 모드 설정 때 한 번
+ *   SCRUB:       조회 경로는 손대지 않고, brain_file_scrub_task가
+ *                BRAIN_SCRUB_RATE로 레코드 → 인덱스 페이지를 돌며 검사
+ *
+ * 불일치 레코드는 비트맵에 남고 이후 brain_file_get이 거부한다 (NEVER 제외).
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+typedef enum {
+    BRAIN_VERIFY_NEVER = 0,
+    BRAIN_VERIFY_FIRST_TOUCH,
+    BRAIN_VERIFY_SCRUB
+} brain_verify_mode_t;
+
+typedef struct {
+    uint64_t records_verified;      /* 체크섬 일치 */
+    uint64_t records_failed;        /* 체크섬 불일치 */
+    uint64_t pages_verified;        /* 인덱스 페이지 일치 */
+    uint64_t pages_failed;
+    uint64_t index_rebuilds;        /* 인덱스 불일치 → 재구축 */
+    uint64_t scrub_bytes;           /* scrub이 읽은 바이트 */
+    uint64_t scrub_passes;          /* 끝난 scrub 한 바퀴 */
+} brain_verify_stats_t;
+
+typedef struct {
+    brain_verify_mode_t mode;
+
+    /* 레코드 번호별 비트맵 (조회 스레드는 __atomic으로 표시) */
+    uint64_t* checked;              /* 검사 통과 */
+    uint64_t* corrupt;              /* 불일치 → 조회 거부 */
+    uint64_t  words;                /* 비트맵 길이 (64 레코드 단위) */
+
+    /* scrub */
+    uint64_t  cursor;               /* 다음 레코드 번호 */
+    uint64_t  page;                 /* 다음 인덱스 페이지 */
+    int       index_phase;          /* 0 = 레코드, 1 = 인덱스 페이지 */
+    double    tokens;               /* 토큰 버킷 (바이트) */
+    uint64_t  last_ns;              /* 마지막 충전 시각 (CLOCK_MONOTONIC) */
+
+    brain_verify_stats_t stats;     /* 누적 */
+    brain_verify_stats_t begin;     /* 이번 scrub 시작 시점 stats */
+} brain_verify_t;
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 보조 정렬 인덱스 (timestamp / importance)
+ *
+ * 정렬 run (RANGE 섹션, 파일) + delta (메모리, LSM 방식)
+ *   - 첫 조회 때 run을 확인하고 run 이후 레코드를 delta로 따라잡는다
+ *     (run이 무효면 전체를 delta로 → 첫 병합이 run을 새로 만든다)
+ *   - append / 컴팩션 이동은 손대지 않음 (다음 조회가 따라잡음)
+ *   - 값 변경은 brain_file_set_timestamp / set_importance → delta 추가 +
+ *     run 봉인 해제 (크래시 뒤에는 다시 만듦)
+ *   - 병합 = run + delta에서 살아 있고 값이 맞는 항목만 골라 새 run
+ *     (조회 시작 때 delta가 크면, 쓰기 가능한 파일을 닫을 때)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+typedef struct {
+    int32_t  section;               /* RANGE 디렉터리 번호 (-1 = 없음) */
+    int      loaded;                /* run 확인 + 따라잡기 시작함 */
+    int      run_valid;             /* run을 조회에 쓴다 */
+    uint64_t upto;                  /* 이 번호 앞의 레코드까지 run / delta에 반영 */
+
+    brain_range_entry_t* delta;     /* 정렬은 조회 시작 때 */
+    uint64_t delta_count;
+    uint64_t delta_cap;
+    int      delta_sorted;
+
+    uint64_t merges;
+} brain_range_t;
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_file_t
+ *
+ * 열린 Brain 파일 (상태는 모두 파일 헤더에 있고, 여기는 캐시만)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+typedef struct brain_file_t {
+    mmap_file_t*   mf;
+    brain_index_t* index;
+
+    /* chunk k 오프셋 (0 = 아직 없음) → 레코드 주소 계산에 디렉터리 검색 불필요 */
+    uint64_t       rec_chunk[BRAIN_MAX_CHUNKS];
+    uint64_t       vec_chunk[BRAIN_MAX_CHUNKS];
+    uint64_t       cnt_chunk[BRAIN_MAX_CHUNKS];
+
+    int32_t        heap_section;        /* 현재 heap extent 디렉터리 번호 (-1 = 없음) */
+    int32_t        index_crc_section;   /* INDEX_CRC 디렉터리 번호 (-1 = 없음) */
+
+    /* 재해시가 끝나면 반환할 이전 인덱스 테이블 */
+    uint64_t       retire_offset;
+    uint64_t       retire_size;
+
+    brain_compact_t compact;
+
+    /* WAL (NULL = 없음, brain_file_open_durable / brain_file_attach_wal) */
+    brain_wal_t*   wal;
+    int            wal_dirty;           /* 체크포인트 이후 변경 있음 (BEGIN 기록됨) */
+    int            created;             /* brain_file_create로 만든 파일 */
+
+    /* 체크섬 검증 (NULL = BRAIN_VERIFY_NEVER) */
+    brain_verify_t* verify;
+
+    /* 보조 정렬 인덱스 (BRAIN_RANGE_*) */
+    brain_range_t  range[BRAIN_RANGE_KEYS];
+
+    /* heat 파일 (BRAIN_OPEN_PREFETCH, NULL = 기록 안 함) */
+    char*          heat_path;
+} brain_file_t;
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_entry_t
+ *
+ * 레코드 조회 결과 (모두 매핑 안 포인터, 복사 없음)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+typedef struct {
+    uint64_t        record_no;      /* 레코드 번호 */
+    brain_record_t* record;         /* 레코드 (읽기 전용 파일이면 쓰지 말 것) */
+    const float*    vector;         /* BRAIN_ALIGN 정렬, vector_dim개 */
+    const char*     metadata;       /* heap 안 메타데이터 (없거나 삭제된 레코드면 NULL) */
+    uint32_t        meta_len;
+
+    /* COUNTERS 열 안 값 (레코드와 다른 페이지) */
+    int64_t*        timestamp;      /* 생성/수정 시간 (Unix epoch) */
+    uint32_t*       access_count;   /* 접근 횟수 (brain_file_touch) */
+    float*          importance;     /* 중요도 (0.0 ~ 1.0) */
+} brain_entry_t;
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_columns_t
+ *
+ * chunk 하나의 카운터 열 (정리 / 가지치기용 훑기)
+ * 열만 읽고 조건에 맞는 레코드만 records[i].flags로 생사를 확인한다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+typedef struct {
+    uint64_t        first;          /* 첫 레코드 번호 */
+    uint64_t        count;          /* 발급된 레코드 수 (chunk 용량 이하) */
+    int64_t*        timestamp;
+    uint32_t*       access_count;
+    float*          importance;
+    brain_record_t* records;
+} brain_columns_t;
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_range_iter_t
+ *
+ * 키 구간 [lo, hi] 순회 (키 오름차순, 같은 키는 레코드 번호 순)
+ * run 위치는 오프셋으로 들고 있으므로 순회 중 append / delete / 값 변경은
+ * 괜찮다 (다음 brain_file_range / 닫기 전까지 유효).
+ * 순회 중 옮겨진 레코드 (컴팩션)는 이번 순회에서 빠질 수 있다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+typedef struct {
+    struct brain_file_t* bf;
+    uint32_t key;
+    int64_t  lo;
+    int64_t  hi;
+
+    uint64_t run_offset;            /* run 항목 배열 파일 오프셋 (0 = run 없음) */
+    uint64_t run_pos;
+    uint64_t run_end;
+    uint64_t delta_pos;
+    uint64_t delta_end;
+
+    brain_range_entry_t last;       /* 중복 (run과 delta에 같은 항목) 건너뛰기 */
+    int      has_last;
+    uint64_t scanned;               /* 읽은 항목 (낡은 항목 포함) */
+} brain_range_iter_t;
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 함수 선언
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 새 파일 생성 (fp32 벡터, 인덱스 2^BRAIN_INDEX_DEFAULT_LOG2 버킷) */
+brain_file_t* brain_file_create(const char* path, uint32_t dim, index_layout_t layout);
+
+/* 인덱스 크기 지정 (대량 적재 시 재해시 없이 시작) */
+brain_file_t* brain_file_create_ex(const char* path, uint32_t dim, index_layout_t layout,
+                                   uint32_t index_log2);
+
+/* 기존 파일 열기 (헤더 검증, writable = 0이면 읽기 전용) */
+brain_file_t* brain_file_open(const char* path, int writable);
+
+/* 예열 옵션 지정 열기 (BRAIN_OPEN_*, fault 수 / 시간은 bf->mf->warm)
+ * BRAIN_OPEN_PREFETCH: 지난 세션의 뜨거운 페이지부터 배경 선읽기 (조회는 바로 가능),
+ *                      조회가 닿은 레코드 / 벡터 페이지를 기록해 닫을 때 저장
+ * BRAIN_OPEN_TRACK:    쓰기 가능이면 brain_file_set_flush_age(BRAIN_FLUSH_AGE_MS) */
+brain_file_t* brain_file_open_ex(const char* path, int writable, uint32_t flags);
+
+/* heat 파일 지금 저장 (주기적 저장용, BRAIN_OPEN_PREFETCH가 아니면 -1) */
+int brain_file_save_heat(brain_file_t* bf);
+
+/* 영역 mlock (BRAIN_LOCK_*, 이전 잠금은 풀고 현재 위치로 다시 잠금
+ * → 재해시 / 컴팩션 뒤 다시 부르면 옮겨진 영역을 따라간다)
+ * 리턴: 0 = 전부 잠금, -1 = 일부 실패 (RLIMIT_MEMLOCK 등) */
+int brain_file_lock(brain_file_t* bf, uint32_t what);
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 스냅샷 (백업 / 분석용 시점 고정 읽기)
+ *
+ *   snap = brain_file_snapshot(bf, "backup.db");   ← 쓰기 잠금 아래
+ *   ... 쓰기는 계속, snap은 그 시점 그대로 ...
+ *   brain_file_close(snap);
+ *
+ * reflink: 파일 시스템이 블록 공유 (복사 0, 뒤따르는 쓰기만 COW)
+ * 복사:    reflink가 안 되면 copy_file_range로 파일 복사
+ * 뷰:      path = NULL → mmap_file_snapshot (전체를 프로세스 메모리로 복사,
+ *          잠금을 푼 뒤 brain_file_save로 파일로 남길 수 있음)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 읽기 전용 사본 (path = reflink / 복사 대상 파일, NULL = 메모리 뷰, 실패 = NULL) */
+brain_file_t* brain_file_snapshot(brain_file_t* bf, const char* path);
+
+/* 읽기 전용 핸들 (뷰 포함)의 내용을 파일로 (쓰기 가능 핸들은 -1) */
+int brain_file_save(const brain_file_t* bf, const char* path);
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * WAL (crash-consistent 쓰기)
+ *
+ * 쓰기 = 로그 레코드 (메모리) + 매핑 갱신. 내구화는 brain_file_commit
+ * (그룹 커밋, 잠금 밖 호출 가능)으로 따로 기다린다:
+ *
+ *   lock(store);  brain_file_append(...);  lsn = brain_file_lsn(bf);  unlock(store);
+ *   brain_file_commit(bf, lsn);          ← 여러 스레드가 fdatasync 1번을 공유
+ *
+ * 체크포인트 = 매핑 msync → 헤더 + 디렉터리 스냅샷으로 로그 재시작.
+ * 체크포인트 이후 매핑 변경은 아무 때나 디스크에 섞여 나갈 수 있으므로
+ * 복구는 스냅샷 헤더로 되돌린 뒤:
+ *   - 스냅샷 이후 DELETED 표시 (dead_lsn > 체크포인트)는 되살리고
+ *   - 컴팩션이 옮긴 메타데이터 (meta_prev)는 원래 위치로
+ *   - ID 인덱스는 레코드에서 다시 만들고
+ *   - 로그 레코드를 순서대로 재생한다.
+ * 컴팩션은 로그하지 않는다 (RELEASE 앞뒤 체크포인트로 반환 영역 보호).
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 열기 + WAL (필요하면 복구 후 체크포인트), 쓰기 가능 */
+brain_file_t* brain_file_open_durable(const char* path, const char* wal_path, uint32_t window_us);
+
+/* 새로 만든 파일에 WAL 연결 (기존 로그는 버리고 체크포인트) */
+int brain_file_attach_wal(brain_file_t* bf, const char* wal_path, uint32_t window_us);
+
+/* 마지막 변경의 LSN (0 = WAL 없음) */
+uint64_t brain_file_lsn(const brain_file_t* bf);
+
+/* lsn까지 내구화 (0 = 지금까지 전부). 스레드 안전, 매핑은 건드리지 않음 */
+int brain_file_commit(brain_file_t* bf, uint64_t lsn);
+
+/* 체크포인트 (WAL 없으면 msync, 바뀐 범위만) */
+int brain_file_checkpoint(brain_file_t* bf);
+
+/* dirty 단위 추적 시작 / flusher max-dirty-age 변경
+ * (0 = flusher 끔, 체크포인트 / 닫기에서만 내보냄)
+ * 쓰기 경로 (append / delete / touch / 값 변경 / 컴팩션 / 인덱스 / 복구)가 쓴 범위를
+ * mmap_file_mark_dirty로 표시 → 체크포인트는 그 단위만 msync. 매핑에 직접 쓰는
+ * 코드 (brain_import 등)는 추적하지 않는 파일에서만. 추적하지 않으면 전체 msync */
+int brain_file_set_flush_age(brain_file_t* bf, uint32_t max_age_ms);
+
+/* 레코드 0 ~ records-1 영역 미리 할당 (파일 확장 1회) */
+int brain_file_reserve(brain_file_t* bf, uint64_t records);
+
+/* 닫기 (쓰기 가능하면 동기화 후, WAL이 있으면 체크포인트) */
+void brain_file_close(brain_file_t* bf);
+
+/* 레코드 추가 (기존 ID면 새 레코드로 교체)
+ * 리턴: 레코드 번호, -1 = 실패 */
+int64_t brain_file_append(brain_file_t* bf, int64_t id, const float* vector,
+                          const char* metadata, uint32_t meta_len, float importance);
+
+/* 다음 append 한 번 (메타데이터 meta_len 바이트)으로 파일이 늘어날 수 있는 바이트
+ * 새 chunk + heap extent + 인덱스 재해시 테이블의 상한 (FREE 재사용은 치지 않음) */
+uint64_t brain_file_append_growth(const brain_file_t* bf, uint32_t meta_len);
+
+/* ID로 조회 (0 = 찾음, -1 = 없음 / 체크섬 불일치) */
+int brain_file_get(const brain_file_t* bf, int64_t id, brain_entry_t* out);
+
+/* 레코드 번호로 조회 (삭제된 레코드도 돌려줌, flags로 확인) */
+int brain_file_entry(const brain_file_t* bf, uint64_t record_no, brain_entry_t* out);
+
+/* 접근 횟수 +1 (여러 스레드가 동시에 불러도 됨)
+ * 카운터 변경은 WAL에 남지 않음 → 크래시 뒤에는 마지막 체크포인트 값 (참고용 통계) */
+int brain_file_touch(const brain_file_t* bf, const brain_entry_t* entry);
+
+/* chunk k의 카운터 열 (0 = 있음, -1 = 아직 없음 / 반환된 chunk / 범위 밖) */
+int brain_file_columns(const brain_file_t* bf, uint32_t chunk, brain_columns_t* out);
+
+/* 값 변경 + 보조 인덱스 반영 (쓰기 가능한 파일, 열에 직접 쓰면 인덱스가 모름) */
+int brain_file_set_timestamp(brain_file_t* bf, const brain_entry_t* entry, int64_t timestamp);
+int brain_file_set_importance(brain_file_t* bf, const brain_entry_t* entry, float importance);
+
+/* 키 구간 [lo, hi] 순회 시작 (importance는 brain_importance_key로 변환한 값)
+ * 읽기 전용 파일도 된다 (delta는 메모리에만). 리턴: 0 = 성공, -1 = 오류 */
+int brain_file_range(brain_file_t* bf, uint32_t key, int64_t lo, int64_t hi,
+                     brain_range_iter_t* it);
+
+/* 다음 레코드 (살아 있고 현재 값이 구간 안). 리턴: 1 = 있음, 0 = 끝 */
+int brain_file_range_next(brain_range_iter_t* it, brain_entry_t* out);
+
+/* ID 삭제 (0 = 성공, -1 = 없음) */
+int brain_file_delete(brain_file_t* bf, int64_t id);
+
+/* 헤더 (재매핑 후에도 유효하도록 매번 mf->addr 기준) */
+static inline brain_header_t* brain_file_header(const brain_file_t* bf) {
+    return (brain_header_t*)bf->mf->addr;
+}
+
+/* 스냅샷 뷰 (메모리 복사, 파일 없음)인가 */
+static inline int brain_file_is_view(const brain_file_t* bf) {
+    return bf->mf->fd < 0;
+}
+
+/* 컴팩션 1단계 진행 (최대 budget개 레코드 검사/이동)
+ * 할 일이 없으면 cycle을 시작하지 않는다.
+ * 리턴: 1 = 진행 중, 0 = 유휴 (cycle 끝 또는 불필요), -1 = 오류 */
+int brain_file_compact_step(brain_file_t* bf, uint32_t budget);
+
+/* 끝날 때까지 진행 (테스트 / 오프라인 도구용) */
+int brain_file_compact(brain_file_t* bf);
+
+/* circadian_set_evening_task용 (ctx = brain_file_t*, BRAIN_COMPACT_BATCH 예산) */
+int brain_file_compact_task(void* ctx);
+
+/* 검증 모드 설정 (FIRST_TOUCH면 인덱스를 바로 검사, 불일치면 재구축) */
+int brain_file_set_verify(brain_file_t* bf, brain_verify_mode_t mode);
+
+/* 봉인된 인덱스 페이지 전체 검사 (쓰기 가능하면 불일치 시 재구축)
+ * 리턴: 0 = 일치 / 봉인 없음 / 재구축함, -1 = 불일치 (읽기 전용) 또는 오류 */
+int brain_file_verify_index(brain_file_t* bf);
+
+/* scrub 진행 (최대 budget 바이트 검사, 모드와 무관하게 검증이 켜져 있어야 함)
+ * 리턴: 1 = 진행 중, 0 = 한 바퀴 끝, -1 = 오류 / 검증 꺼짐 */
+int brain_file_scrub_step(brain_file_t* bf, uint64_t budget);
+
+/* circadian_set_dawn_task용 (ctx = brain_file_t*, SCRUB 모드일 때만 BRAIN_SCRUB_RATE로 진행) */
+int brain_file_scrub_task(void* ctx);
+
+/* 살아 있는 레코드 수 */
+uint64_t brain_file_count(const brain_file_t* bf);
+
+/* 통계 출력 */
+void brain_file_stats(const brain_file_t* bf);
+
+#endif /* BRAIN_FILE_H */
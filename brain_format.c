@@ -0,0 +1,337 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_format.c
+ *
+ * Brain 파일 포맷 v2 헤더 / 섹션 디렉터리 / v1 읽기
+ *
+ * v1 → v2 변경 이유:
+ *   - v1은 [32B 헤더][벡터][메타데이터]를 붙여 써서 벡터 시작 주소가
+ *     레코드마다 제각각 (정렬 없음) → 매핑된 벡터를 SIMD 커널에 바로
+ *     넘길 수 없었고, 가변 길이라 레코드 번호로 주소 계산도 불가
+ *   - v2는 레코드 / 벡터 / 메타데이터를 각자 섹션으로 분리
+ *     벡터 슬롯은 64B 정렬 고정 stride → vec_kernels에 그대로 전달
+ *
+ * 섹션은 chunk 단위로 늘어나서 (chunk k = base << k 레코드)
+ * 파일을 키워도 기존 데이터가 움직이지 않는다.
+ *
+ * Zero Dependency: 표준 C만 사용
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#include "brain_format.h"
+#include "brain_crc.h"
+#include <stdio.h>
+#include <string.h>
+
+/* vec_storage_t 원소 크기 (0 f32, 1 f16, 2 bf16) */
+static uint32_t storage_elem_size(uint32_t storage) {
+    return storage == 0 ? 4 : 2;
+}
+
+uint32_t brain_vector_stride(uint32_t dim, uint32_t storage) {
+    return (uint32_t)BRAIN_ALIGN_UP((uint64_t)dim * storage_elem_size(storage), BRAIN_ALIGN);
+}
+
+uint32_t brain_record_crc(const brain_header_t* header, const brain_record_t* record,
+                          const void* vector, const void* metadata) {
+    uint32_t crc = brain_crc32c(0, &record->id, sizeof(record->id));
+    crc = brain_crc32c(crc, &record->meta_len, sizeof(record->meta_len));
+    crc = brain_crc32c(crc, vector,
+                       (size_t)header->vector_dim * storage_elem_size(header->vector_storage));
+    if (record->meta_len > 0) crc = brain_crc32c(crc, metadata, record->meta_len);
+    return crc;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_init_header
+ *
+ * 빈 v2 헤더 (섹션 디렉터리는 헤더 바로 뒤, 데이터 할당은 다음 페이지부터)
+ * 인덱스 메타는 index_create가 채운다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+void brain_init_header(brain_header_t* header, uint32_t dim) {
+    memset(header, 0, sizeof(*header));
+
+    header->magic = BRAIN_MAGIC;
+    header->version = BRAIN_VERSION;
+    header->vector_dim = dim;
+    header->vector_storage = 0;
+    header->vector_stride = brain_vector_stride(dim, 0);
+    header->chunk_log2 = BRAIN_DEFAULT_CHUNK_LOG2;
+
+    header->section_offset = sizeof(brain_header_t);
+    header->section_capacity = BRAIN_DEFAULT_SECTIONS;
+    header->alloc_offset = BRAIN_ALIGN_UP(header->section_offset +
+                                          (uint64_t)header->section_capacity *
+                                          sizeof(brain_section_t), BRAIN_PAGE_SIZE);
+    header->file_size = header->alloc_offset;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_validate_header
+ *
+ * 리턴: 0 = 정상, -1 = 손상 / 지원하지 않는 버전
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int brain_validate_header(const brain_header_t* header) {
+    if (!header) return -1;
+
+    if (header->magic != BRAIN_MAGIC) {
+        fprintf(stderr, "[brain] Error: bad magic 0x%08X\n", header->magic);
+        return -1;
+    }
+    if (header->version != BRAIN_VERSION) {
+        fprintf(stderr, "[brain] Error: unsupported version %u\n", header->version);
+        return -1;
+    }
+    if (header->vector_dim == 0 || header->vector_storage > 2 ||
+        header->vector_stride % BRAIN_ALIGN != 0 ||
+        header->vector_stride < header->vector_dim * storage_elem_size(header->vector_storage)) {
+        fprintf(stderr, "[brain] Error: bad vector geometry (dim %u, stride %u)\n",
+                header->vector_dim, header->vector_stride);
+        return -1;
+    }
+    if (header->chunk_log2 > 30 ||
+        header->section_offset < sizeof(brain_header_t) ||
+        header->section_count > header->section_capacity ||
+        header->section_offset + (uint64_t)header->section_capacity *
+            sizeof(brain_section_t) > header->alloc_offset ||
+        header->alloc_offset > header->file_size ||
+        header->free_bytes > header->alloc_offset ||
+        header->live_count > header->record_count) {
+        fprintf(stderr, "[brain] Error: bad section layout\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+int brain_detect_version(const void* base, size_t size) {
+    if (!base || size < sizeof(uint32_t) * 2) return -1;
+
+    const uint32_t* word = (const uint32_t*)base;
+    if (word[0] != BRAIN_MAGIC) return -1;
+
+    if (word[1] == BRAIN_VERSION && size >= sizeof(brain_header_t)) return BRAIN_VERSION;
+    if (word[1] == BRAIN_VERSION_V1 && size >= sizeof(brain_header_v1_t)) return BRAIN_VERSION_V1;
+    return -1;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 섹션 디렉터리
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 리턴: 디렉터리 항목 번호, -1 = 디렉터리 가득 참 */
+int brain_section_add(void* base, uint32_t type, uint32_t chunk,
+                      uint64_t offset, uint64_t size) {
+    brain_header_t* header = (brain_header_t*)base;
+    if (header->section_count >= header->section_capacity) {
+        fprintf(stderr, "[brain] Error: section directory full (%u)\n",
+                header->section_capacity);
+        return -1;
+    }
+
+    brain_section_t* s = &BRAIN_SECTIONS(base, header)[header->section_count];
+    s->type = type;
+    s->chunk = chunk;
+    s->offset = offset;
+    s->size = size;
+    s->used = 0;
+
+    return (int)header->section_count++;
+}
+
+brain_section_t* brain_section_find(void* base, uint32_t type, uint32_t chunk) {
+    brain_header_t* header = (brain_header_t*)base;
+    brain_section_t* sections = BRAIN_SECTIONS(base, header);
+
+    for (uint32_t i = 0; i < header->section_count; i++) {
+        if (sections[i].type == type && sections[i].chunk == chunk) return &sections[i];
+    }
+    return NULL;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 영역 할당 / 반환
+ *
+ * FREE 섹션이 빈 공간 목록 역할을 한다. 할당은 first-fit으로 앞부분을
+ * 잘라 쓰고, 다 쓴 FREE 항목은 크기 0으로 남아 다음 반환 때 재사용된다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+uint64_t brain_alloc_region(brain_header_t* header, uint64_t size) {
+    size = BRAIN_ALIGN_UP(size, BRAIN_PAGE_SIZE);
+
+    brain_section_t* sections = BRAIN_SECTIONS(header, header);
+    for (uint32_t i = 0; i < header->section_count; i++) {
+        brain_section_t* s = &sections[i];
+        if (s->type != BRAIN_SECTION_FREE || s->size < size) continue;
+
+        uint64_t offset = s->offset;
+        s->offset += size;
+        s->size -= size;
+        header->free_bytes -= size;
+        memset((char*)header + offset, 0, size);
+        return offset;
+    }
+
+    uint64_t offset = BRAIN_ALIGN_UP(header->alloc_offset, BRAIN_PAGE_SIZE);
+    header->alloc_offset = offset + size;
+    if (header->file_size < header->alloc_offset) header->file_size = header->alloc_offset;
+    return offset;
+}
+
+int brain_free_region(brain_header_t* header, uint64_t offset, uint64_t size) {
+    if (size == 0) return 0;
+
+    brain_section_t* sections = BRAIN_SECTIONS(header, header);
+    brain_section_t* empty = NULL;
+
+    for (uint32_t i = 0; i < header->section_count; i++) {
+        brain_section_t* s = &sections[i];
+        if (s->type != BRAIN_SECTION_FREE) continue;
+
+        if (s->size > 0 && s->offset + s->size == offset) {
+            s->size += size;
+            header->free_bytes += size;
+            return 0;
+        }
+        if (s->size > 0 && offset + size == s->offset) {
+            s->offset = offset;
+            s->size += size;
+            header->free_bytes += size;
+            return 0;
+        }
+        if (s->size == 0 && !empty) empty = s;
+    }
+
+    if (empty) {
+        empty->offset = offset;
+        empty->size = size;
+    } else if (brain_section_add(header, BRAIN_SECTION_FREE, 0, offset, size) < 0) {
+        return -1;
+    }
+
+    header->free_bytes += size;
+    return 0;
+}
+
+int brain_section_release(brain_header_t* header, uint32_t index) {
+    if (index >= header->section_count) return -1;
+
+    brain_section_t* s = &BRAIN_SECTIONS(header, header)[index];
+    uint64_t offset = s->offset;
+    uint64_t size = s->size;
+
+    /* 빈 FREE 항목으로 만든 뒤 반환 (인접 FREE가 없으면 이 항목이 재사용됨) */
+    s->type = BRAIN_SECTION_FREE;
+    s->chunk = 0;
+    s->size = 0;
+    s->used = 0;
+    return brain_free_region(header, offset, size);
+}
+
+uint64_t brain_trim_tail(brain_header_t* header) {
+    brain_section_t* sections = BRAIN_SECTIONS(header, header);
+    uint64_t before = header->file_size;
+
+    /* 병합은 한쪽만 하므로 끝에 닿는 FREE가 여러 개일 수 있음 */
+    for (int trimmed = 1; trimmed; ) {
+        trimmed = 0;
+        for (uint32_t i = 0; i < header->section_count; i++) {
+            brain_section_t* s = &sections[i];
+            if (s->type != BRAIN_SECTION_FREE || s->size == 0 ||
+                s->offset + s->size != header->alloc_offset) continue;
+
+            header->alloc_offset = s->offset;
+            header->free_bytes -= s->size;
+            s->size = 0;
+            trimmed = 1;
+        }
+    }
+
+    uint64_t file_size = BRAIN_ALIGN_UP(header->alloc_offset, BRAIN_PAGE_SIZE);
+    if (file_size < header->file_size) header->file_size = file_size;
+    return before - header->file_size;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_print_header
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+void brain_print_header(const brain_header_t* header) {
+    static const char* storage_names[] = {"f32", "f16", "bf16"};
+    static const char* section_names[] = {"free", "records", "vectors", "heap", "idx-crc",
+                                          "counters", "range"};
+
+    printf("[brain] Header (v%u):\n", header->version);
+    printf("  Vectors:       dim %u, %s, stride %u bytes\n", header->vector_dim,
+           header->vector_storage <= 2 ? storage_names[header->vector_storage] : "?",
+           header->vector_stride);
+    printf("  Records:       %lu live / %lu issued (chunk 0 = %u)\n",
+           (unsigned long)header->live_count, (unsigned long)header->record_count,
+           1u << header->chunk_log2);
+    printf("  File size:     %lu (allocated %lu, free %lu, dead heap %lu)\n",
+           (unsigned long)header->file_size, (unsigned long)header->alloc_offset,
+           (unsigned long)header->free_bytes, (unsigned long)header->heap_dead);
+    printf("  Index:         %u ids, 2^%u buckets at 0x%lx%s\n",
+           header->index.count, header->index.log2,
+           (unsigned long)header->index.table_offset,
+           header->index.old_table_offset ? " (rehashing)" : "");
+    printf("  Sections:      %u / %u\n", header->section_count, header->section_capacity);
+
+    const brain_section_t* sections =
+        (const brain_section_t*)((const char*)header + header->section_offset);
+    for (uint32_t i = 0; i < header->section_count; i++) {
+        const brain_section_t* s = &sections[i];
+        printf("    [%2u] %-8s #%-2u 0x%08lx  %10lu bytes\n", i,
+               s->type <= BRAIN_SECTION_RANGE ? section_names[s->type] : "?", s->chunk,
+               (unsigned long)s->offset, (unsigned long)s->size);
+    }
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_v1_foreach
+ *
+ * v1 인덱스 테이블(10007 버킷)을 처음부터 끝까지 훑어 사용 중인 슬롯마다
+ * visit 호출. 해시 / 탐사 순서와 무관하게 전체를 보므로, v1의 삭제
+ * (-1로 지움)가 탐사 체인을 끊어 조회로는 못 찾던 엔트리도 빠지지 않는다.
+ *
+ * 데이터 영역 밖, 차원이 헤더와 다름, 엔트리 ID가 슬롯과 다름 → 건너뜀.
+ *
+ * 리턴: 방문한 엔트리 수, -1 = v1 파일 아님 (또는 인덱스가 파일 밖)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int64_t brain_v1_foreach(const void* base, size_t size,
+                         brain_v1_visit_fn visit, void* ctx) {
+    if (brain_detect_version(base, size) != BRAIN_VERSION_V1) return -1;
+
+    const brain_header_v1_t* header = (const brain_header_v1_t*)base;
+    const uint64_t table_size = (uint64_t)BRAIN_V1_INDEX_BUCKETS * sizeof(brain_index_entry_t);
+    if (header->index_offset < sizeof(brain_header_v1_t) ||
+        header->index_offset > size || table_size > size - header->index_offset ||
+        header->data_offset > size || header->vector_dim == 0) {
+        return -1;
+    }
+
+    const char* bytes = (const char*)base;
+    const brain_index_entry_t* slots = (const brain_index_entry_t*)(bytes + header->index_offset);
+    const uint64_t vec_bytes = (uint64_t)header->vector_dim * sizeof(float);
+    int64_t visited = 0;
+
+    for (uint32_t i = 0; i < BRAIN_V1_INDEX_BUCKETS; i++) {
+        if (slots[i].vector_id < 0) continue;   /* BRAIN_V1_EMPTY_ID */
+
+        uint64_t value = slots[i].data_offset;
+        if (value < header->data_offset || value > size ||
+            size - value < sizeof(brain_data_entry_t)) {
+            continue;
+        }
+
+        const brain_data_entry_t* entry = (const brain_data_entry_t*)(bytes + value);
+        if (entry->vector_id != slots[i].vector_id ||
+            entry->vector_dim != header->vector_dim ||
+            size - value - sizeof(brain_data_entry_t) < vec_bytes + entry->metadata_len) {
+            continue;
+        }
+
+        visited++;
+        if (visit && visit(ctx, entry, BRAIN_VECTOR_PTR(entry), BRAIN_METADATA_PTR(entry))) {
+            break;
+        }
+    }
+
+    return visited;
+}
@@ -1,19 +1,28 @@
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * brain_format.h
  *
- * Brain 바이너리 파일 규격 정의
+ * Brain 바이너리 파일 규격 정의 (v2)
  *
  * 목적:
  *   - 벡터, 메타데이터를 효율적으로 저장
  *   - mmap 기반 Zero-Copy 접근
  *   - ID 기반 빠른 검색 (O(1))
+ *   - 벡터는 64바이트 정렬 고정 stride → 매핑 주소를 SIMD 커널에 바로 전달
  *
- * 파일 구조:
- *   [Header] [Index Section] [Data Section]
+ * 파일 구조 (v2):
+ *   [Header 128B] [Section Directory] [Index / Records / Vectors / Heap ...]
  *
- *   Header: 전체 메타데이터
- *   Index: ID → Offset 매핑
- *   Data: 실제 벡터 + 메타데이터
+ *   Header:    전체 메타데이터 + ID 인덱스 상태
+ *   Directory: 섹션 목록 (종류, chunk 번호, 오프셋, 크기)
+ *   Index:     ID → 레코드 번호 매핑 (index_manager)
+ *   Records:   레코드 테이블 (64B 고정 크기)
+ *   Vectors:   벡터 슬롯 (64B 정렬, vector_stride 간격)
+ *   Counters:  자주 바뀌는 레코드별 값 (timestamp / access_count / importance 열 배열)
+ *   Heap:      가변 길이 메타데이터
+ *   Index CRC: ID 인덱스 페이지 체크섬 (체크포인트 때 봉인)
+ *   Range:     timestamp / importance 정렬 run (보조 인덱스, 닫기 때 병합)
+ *
+ * v1 (brain_header_v1_t + brain_data_entry_t)은 마이그레이션용 읽기만 지원.
  *
  * Zero Dependency: 표준 C만 사용
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
@@ -29,50 +38,267 @@
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
 #define BRAIN_MAGIC         0x4252414E  /* "BRAN" (리틀 엔디안) */
-#define BRAIN_VERSION       1           /* 파일 포맷 버전 */
+#define BRAIN_VERSION       2           /* 파일 포맷 버전 */
+#define BRAIN_VERSION_V1    1           /* 이전 포맷 (읽기 전용) */
 #define BRAIN_DEFAULT_DIM   128         /* 기본 벡터 차원 */
 #define BRAIN_MAX_METADATA  256         /* 메타데이터 최대 크기 */
 
-/* Index Hash Table 크기 (소수로 설정하여 충돌 최소화) */
-#define BRAIN_INDEX_BUCKETS 10007       /* 약 1만개 버킷 */
+/* 섹션 배치 */
+#define BRAIN_ALIGN              64     /* 벡터 슬롯 / 레코드 정렬 (캐시 라인, AVX-512) */
+#define BRAIN_PAGE_SIZE          4096   /* 섹션 시작 정렬 */
+#define BRAIN_DEFAULT_SECTIONS   126    /* 디렉터리 용량 → 헤더와 합쳐 4KB */
+#define BRAIN_DEFAULT_CHUNK_LOG2 10     /* chunk 0 = 1024 레코드 */
+#define BRAIN_MAX_CHUNKS         40     /* chunk k = base << k 레코드 */
+
+/* Index Hash Table 크기 (2의 거듭제곱, 메타에 log2로 기록) */
+#define BRAIN_INDEX_MIN_LOG2     4      /* 최소 16 버킷 */
+#define BRAIN_INDEX_MAX_LOG2     31     /* 최대 2^31 버킷 */
+#define BRAIN_INDEX_DEFAULT_LOG2 14     /* 기본 16384 버킷 */
+
+/* Index Entry data_offset 패킹: [63:48] 탐사 거리 | [47:0] 값 */
+#define BRAIN_INDEX_DIST_SHIFT   48
+#define BRAIN_INDEX_OFFSET_MASK  ((1ULL << BRAIN_INDEX_DIST_SHIFT) - 1)
+#define BRAIN_INDEX_MAX_DIST     0xFFFF
+
+/* Index 레이아웃 (brain_index_meta_t.flags)
+ *   기본: Robin Hood (엔트리 배열만)
+ *   GROUPED: [제어 바이트 × buckets][엔트리 × buckets], 16슬롯 그룹 단위 탐사 */
+#define BRAIN_FLAG_INDEX_GROUPED 0x0001
+#define BRAIN_INDEX_GROUP        16     /* 그룹당 슬롯 (SSE2 레지스터 1개) */
+#define BRAIN_CTRL_EMPTY         0x00   /* 0-채움 영역 = 빈 테이블 */
+#define BRAIN_CTRL_DELETED       0x01
+#define BRAIN_CTRL_FULL          0x80   /* | 7비트 해시 태그 */
+
+/* v2 인덱스 값 = 레코드 번호 + 1 (0은 빈 슬롯) */
+#define BRAIN_RECORD_REF(rec)    ((uint64_t)(rec) + 1)
+#define BRAIN_REF_RECORD(ref)    ((uint64_t)(ref) - 1)
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * ID 인덱스 상태 (32 bytes)
+ *
+ * index_manager가 파일 안 임의 위치(v2: 헤더 내부)에서 읽고 쓴다.
+ * 재해시로 테이블 위치가 바뀌므로 섹션 디렉터리가 아닌 여기서 가리킨다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+typedef struct {
+    uint64_t table_offset;      /* 현재 테이블 시작 오프셋 */
+    uint64_t old_table_offset;  /* 재해시 중인 이전 테이블 (0 = 없음) */
+    uint32_t count;             /* 등록된 ID 수 (두 테이블 합계) */
+    uint32_t migrated;          /* 이전 테이블에서 이동을 마친 버킷 수 */
+    uint32_t max_probe;         /* 현재 테이블 최대 탐사 거리 (재해시 때 리셋) */
+    uint16_t flags;             /* BRAIN_FLAG_INDEX_* */
+    uint8_t  log2;              /* 현재 테이블 버킷 수 = 1 << log2 */
+    uint8_t  old_log2;          /* 이전 테이블 버킷 수 (0 = 재해시 없음) */
+} brain_index_meta_t;
+
+_Static_assert(sizeof(brain_index_meta_t) == 32, "Index meta must be 32 bytes");
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
- * 파일 헤더 (64 bytes)
+ * 파일 헤더 (128 bytes)
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
 typedef struct {
     uint32_t magic;             /* 매직 넘버: 0x4252414E ("BRAN") */
-    uint32_t version;           /* 파일 포맷 버전 */
+    uint32_t version;           /* 파일 포맷 버전 (2) */
 
     uint32_t vector_dim;        /* 벡터 차원 (128, 256, 512 등) */
+    uint32_t vector_storage;    /* 원소 형식 (vec_storage_t: 0 f32, 1 f16, 2 bf16) */
+    uint32_t vector_stride;     /* 벡터 슬롯 간격 (바이트, BRAIN_ALIGN 배수) */
+    uint32_t chunk_log2;        /* chunk 0 레코드 수 = 1 << chunk_log2 */
+
+    uint64_t record_count;      /* 발급된 레코드 번호 수 (삭제 포함) */
+    uint64_t live_count;        /* 살아 있는 레코드 수 */
+
+    uint64_t file_size;         /* 전체 파일 크기 */
+    uint64_t alloc_offset;      /* 다음 섹션 할당 위치 (이후는 미사용) */
+
+    uint64_t section_offset;    /* 섹션 디렉터리 시작 오프셋 */
+    uint32_t section_count;     /* 사용 중인 디렉터리 항목 수 */
+    uint32_t section_capacity;  /* 디렉터리 용량 */
+
+    uint32_t flags;             /* 플래그 (향후 확장용) */
+    uint32_t reserved0;
+
+    brain_index_meta_t index;   /* ID 인덱스 상태 */
+
+    uint64_t free_bytes;        /* FREE 섹션 합계 (재사용 대기) */
+    uint64_t heap_dead;         /* 삭제/덮어쓴 레코드의 heap 바이트 (컴팩션 대상) */
+} brain_header_t;
+
+_Static_assert(sizeof(brain_header_t) == 128, "Header must be 128 bytes");
+_Static_assert(offsetof(brain_header_t, index) % 8 == 0, "Index meta must be 8-byte aligned");
+
+/* index_create / index_open에 넘기는 v2 인덱스 메타 위치 */
+#define BRAIN_INDEX_META_OFFSET  offsetof(brain_header_t, index)
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Section Directory Entry (32 bytes)
+ *
+ * RECORDS / VECTORS는 chunk 단위로 늘어난다:
+ *   chunk k = (1 << chunk_log2) << k 레코드, 첫 레코드 = base * (2^k - 1)
+ *   → 파일이 커져도 기존 chunk는 움직이지 않고, 레코드 → 주소는 O(1)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+typedef enum {
+    BRAIN_SECTION_FREE    = 0,          /* 빈 항목 / 반환된 영역 */
+    BRAIN_SECTION_RECORDS = 1,          /* 레코드 테이블 chunk */
+    BRAIN_SECTION_VECTORS = 2,          /* 벡터 chunk */
+    BRAIN_SECTION_HEAP    = 3,          /* 메타데이터 heap extent */
+    BRAIN_SECTION_INDEX_CRC = 4,        /* ID 인덱스 페이지 CRC32C 배열 */
+    BRAIN_SECTION_COUNTERS = 5,         /* 레코드별 카운터 chunk (열 배열) */
+    BRAIN_SECTION_RANGE   = 6           /* 보조 정렬 인덱스 run (chunk = BRAIN_RANGE_*) */
+} brain_section_type_t;
+
+typedef struct {
+    uint32_t type;              /* brain_section_type_t */
+    uint32_t chunk;             /* RECORDS/VECTORS/COUNTERS: chunk 번호, HEAP: extent 번호, INDEX_CRC: 테이블 log2, RANGE: 키 */
+    uint64_t offset;            /* 파일 오프셋 (BRAIN_PAGE_SIZE 정렬) */
+    uint64_t size;              /* 바이트 */
+    uint64_t used;              /* HEAP: 사용한 바이트, INDEX_CRC: 봉인한 테이블 오프셋 (0 = 무효),
+                                   RANGE: 1 = 봉인 (0 = 무효), 그 외 0 */
+} brain_section_t;
+
+_Static_assert(sizeof(brain_section_t) == 32, "Section entry must be 32 bytes");
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Record (64 bytes, 레코드 테이블 원소)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#define BRAIN_RECORD_LIVE       0x0001  /* 사용 중 */
+#define BRAIN_RECORD_DELETED    0x0002  /* 삭제됨 (슬롯은 컴팩션 전까지 유지) */
+
+/* 레코드 체크섬 종류 (brain_record_t.checks)
+ * 범위: id + meta_len + 벡터 + 메타데이터 (한 번 쓰면 바뀌지 않는 내용만) */
+#define BRAIN_CHECK_NONE        0       /* 체크섬 없음 (이전 파일) */
+#define BRAIN_CHECK_CRC32C      1
+
+/* 인덱스 페이지 체크섬 단위 */
+#define BRAIN_INDEX_CRC_PAGE    4096
+
+typedef struct {
+    int64_t  id;                /* 벡터 ID */
+    uint32_t flags;             /* BRAIN_RECORD_* */
+    uint32_t meta_len;          /* 메타데이터 길이 */
+    uint64_t meta_offset;       /* heap 안 메타데이터 파일 오프셋 (0 = 없음) */
+
+    uint8_t  reserved[16];      /* 자주 바뀌는 값은 COUNTERS 섹션 (아래) */
+
+    /* WAL 복구용 (brain_wal.h) */
+    uint64_t dead_lsn;          /* DELETED 표시를 남긴 LSN (0 = WAL 밖에서 삭제) */
+    uint64_t meta_prev;         /* 컴팩션이 옮기기 전 meta_offset (0 = 없음) */
+
+    /* 무결성 (brain_record_crc) */
+    uint32_t crc;               /* CRC32C */
+    uint32_t checks;            /* BRAIN_CHECK_* */
+} brain_record_t;
+
+_Static_assert(sizeof(brain_record_t) == 64, "Record must be 64 bytes");
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Counters chunk (레코드당 16 bytes, 열 배열)
+ *
+ * 조회마다 바뀌는 값을 레코드 / 벡터와 다른 페이지에 모은다.
+ *   → access_count 증가가 벡터 페이지를 더럽히지 않고 (msync 양 감소)
+ *   → 시간 / 중요도로 훑는 작업은 필요한 열만 읽는다 (레코드당 4~8B)
+ *
+ *   [int64_t timestamp × n] [uint32_t access_count × n] [float importance × n]
+ *   n = chunk 레코드 수 (1024 이상 → 각 열이 페이지 경계에서 시작)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#define BRAIN_COUNTER_BYTES     (sizeof(int64_t) + sizeof(uint32_t) + sizeof(float))
+
+/* 열 시작 (chunk 안 오프셋) */
+#define BRAIN_COL_TIMESTAMP(n)  ((uint64_t)0)
+#define BRAIN_COL_ACCESS(n)     ((uint64_t)(n) * sizeof(int64_t))
+#define BRAIN_COL_IMPORTANCE(n) ((uint64_t)(n) * (sizeof(int64_t) + sizeof(uint32_t)))
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Range run (보조 정렬 인덱스)
+ *
+ * 키 하나당 RANGE 섹션 하나: (키, 레코드 번호) 오름차순 배열
+ *   [brain_range_run_t 16B] [brain_range_entry_t × count]
+ *
+ * 레코드 번호 < records인 레코드만 담는다. 그 뒤 레코드와
+ * 값이 바뀐 레코드는 메모리 delta에 있다가 병합 때 run으로 들어간다.
+ * 삭제 / 값 변경으로 낡은 항목은 읽을 때 걸러내고 병합 때 버린다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#define BRAIN_RANGE_TIMESTAMP   0       /* 키 = timestamp */
+#define BRAIN_RANGE_IMPORTANCE  1       /* 키 = brain_importance_key(importance) */
+#define BRAIN_RANGE_KEYS        2
+
+typedef struct {
+    uint64_t count;             /* 항목 수 */
+    uint64_t records;           /* 이 번호 앞의 레코드까지 반영 */
+} brain_range_run_t;
+
+typedef struct {
+    int64_t  key;
+    uint64_t record_no;
+} brain_range_entry_t;
+
+_Static_assert(sizeof(brain_range_run_t) == 16, "Range run header must be 16 bytes");
+_Static_assert(sizeof(brain_range_entry_t) == 16, "Range entry must be 16 bytes");
+
+/* float → 순서를 보존하는 정수 키 (음수는 비트 반전, 양수는 부호 비트 세움) */
+static inline int64_t brain_importance_key(float value) {
+    union { float f; uint32_t u; } bits = { value };
+    uint32_t u = (bits.u & 0x80000000u) ? ~bits.u : (bits.u | 0x80000000u);
+    return (int64_t)u;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * v1 포맷 (마이그레이션용, 최초 릴리스의 배치 그대로)
+ *
+ *   0x0000  [Header 48B]
+ *   0x0030  [Index: brain_index_entry_t × 10007]   FNV-1a % 10007, 선형 탐사
+ *           [Data: brain_data_entry_t + vector + metadata ...]
+ *
+ *   인덱스 슬롯: vector_id = -1 → 빈 슬롯 (삭제도 -1), data_offset = 파일 오프셋
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#define BRAIN_V1_INDEX_BUCKETS  10007   /* 고정 버킷 수 (소수) */
+#define BRAIN_V1_EMPTY_ID       (-1)
+
+typedef struct {
+    uint32_t magic;             /* 매직 넘버: 0x4252414E ("BRAN") */
+    uint32_t version;           /* 1 */
+
+    uint32_t vector_dim;        /* 벡터 차원 */
     uint32_t vector_count;      /* 저장된 벡터 개수 */
 
-    uint64_t index_offset;      /* Index Section 시작 오프셋 */
+    uint64_t index_offset;      /* Index Section 시작 오프셋 (0x30) */
     uint64_t data_offset;       /* Data Section 시작 오프셋 */
 
     uint64_t file_size;         /* 전체 파일 크기 */
 
-    uint32_t flags;             /* 플래그 (향후 확장용) */
-    uint32_t reserved;          /* 예약 (64바이트 정렬) */
+    uint32_t flags;             /* 사용 안 함 */
+    uint32_t reserved;
 
-} __attribute__((packed)) brain_header_t;
+} __attribute__((packed)) brain_header_v1_t;
 
-/* 컴파일 타임 크기 검증 */
-_Static_assert(sizeof(brain_header_t) == 48, "Header must be 48 bytes");
+_Static_assert(sizeof(brain_header_v1_t) == 48, "v1 header must be 48 bytes");
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * Index Entry (16 bytes per entry)
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
+/* 슬롯 상태:
+ *   data_offset == 0 → 빈 슬롯
+ *   그 외            → 사용 중 (상위 16비트 = 홈 버킷으로부터의 탐사 거리)
+ *
+ * 값 0은 쓰지 않는다 (레코드 번호 + 1).
+ * 덕분에 ftruncate로 늘린 0-채움 영역이 그대로 빈 테이블이 된다.
+ * v1 파일은 같은 16B 슬롯이지만 vector_id = -1이 빈 슬롯 (위 v1 포맷 참고). */
 typedef struct {
-    int64_t  vector_id;         /* 벡터 ID (음수 = 빈 슬롯) */
-    uint64_t data_offset;       /* Data Section 내 오프셋 */
+    int64_t  vector_id;         /* 벡터 ID */
+    uint64_t data_offset;       /* 탐사 거리 << 48 | 값 (v2: 레코드 번호 + 1) */
 } brain_index_entry_t;
 
 _Static_assert(sizeof(brain_index_entry_t) == 16, "Index entry must be 16 bytes");
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
- * Data Entry (가변 길이)
+ * Data Entry (v1, 가변 길이)
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
 typedef struct {
@@ -93,48 +319,121 @@ typedef struct {
 _Static_assert(sizeof(brain_data_entry_t) == 32, "Data entry header must be 32 bytes");
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
- * 헬퍼 매크로
+ * 헬퍼 매크로 / 인라인
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
-/* Data Entry 전체 크기 계산 */
+/* v1 Data Entry 전체 크기 계산 */
 #define BRAIN_DATA_ENTRY_SIZE(dim, meta_len) \
     (sizeof(brain_data_entry_t) + (dim) * sizeof(float) + (meta_len))
 
-/* Data Entry에서 벡터 포인터 얻기 */
+/* v1 Data Entry에서 벡터 포인터 얻기 */
 #define BRAIN_VECTOR_PTR(entry) \
     ((float*)((char*)(entry) + sizeof(brain_data_entry_t)))
 
-/* Data Entry에서 메타데이터 포인터 얻기 */
+/* v1 Data Entry에서 메타데이터 포인터 얻기 */
 #define BRAIN_METADATA_PTR(entry) \
     ((char*)(entry) + sizeof(brain_data_entry_t) + (entry)->vector_dim * sizeof(float))
 
+/* 정렬 */
+#define BRAIN_ALIGN_UP(x, a) (((uint64_t)(x) + (a) - 1) & ~(uint64_t)((a) - 1))
+
+/* 섹션 디렉터리 시작 */
+#define BRAIN_SECTIONS(base, header) \
+    ((brain_section_t*)((char*)(base) + (header)->section_offset))
+
+/* chunk k의 레코드 수 / 첫 레코드 번호 */
+static inline uint64_t brain_chunk_records(const brain_header_t* header, uint32_t k) {
+    return ((uint64_t)1 << header->chunk_log2) << k;
+}
+
+static inline uint64_t brain_chunk_first(const brain_header_t* header, uint32_t k) {
+    return (((uint64_t)1 << k) - 1) << header->chunk_log2;
+}
+
+/* 레코드 번호 → (chunk, chunk 안 위치) */
+static inline uint32_t brain_chunk_of(const brain_header_t* header, uint64_t record,
+                                      uint64_t* index_in_chunk) {
+    uint64_t q = (record >> header->chunk_log2) + 1;
+    uint32_t k = 63u - (uint32_t)__builtin_clzll(q);
+    if (index_in_chunk) *index_in_chunk = record - brain_chunk_first(header, k);
+    return k;
+}
+
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
- * 파일 레이아웃 예시
+ * 파일 레이아웃 예시 (v2, dim=128 f32, 기본 설정)
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  *
  * Offset       Size        Section
  * ───────────────────────────────────────────────────────────────
- * 0x0000       64          Header
- * 0x0040       160,112     Index (10007 entries × 16 bytes)
- * 0x27160      ...         Data Section
+ * 0x0000       128         Header (+ ID 인덱스 상태)
+ * 0x0080       4,032       Section Directory (126 × 32B)
+ * 0x1000       262,144     Index (16384 × 16B)
+ * 0x41000      65,536      Records chunk 0 (1024 × 64B)
+ * 0x51000      524,288     Vectors chunk 0 (1024 × 512B)
+ * 0xD1000      16,384      Counters chunk 0 (1024 × 16B)
+ * 0xD5000      ...         Heap extent 0 / Records chunk 1 (2048) / ...
  *
- * Index Section:
- *   Hash(ID) % 10007 → bucket
- *   Linear probing으로 충돌 해결
+ * Index:
+ *   mix64(ID) & (buckets - 1) → bucket
+ *   Robin Hood linear probing (탐사 거리가 짧은 엔트리가 자리 양보)
+ *   삭제는 backward-shift (tombstone 없음)
+ *   (GROUPED 레이아웃: 제어 바이트 16개를 SSE2로 한 번에 비교)
+ *   부하율 75% 초과 시 2배 크기 테이블을 추가하고
+ *   삽입마다 이전 테이블 버킷 몇 개씩 옮긴다 (점진적 재해시)
  *
- * Data Section:
- *   각 entry는 순차 배치
- *   Index에서 offset으로 접근
+ * Record r:
+ *   k = brain_chunk_of(r)
+ *   record = Records[k] + i * 64
+ *   vector = Vectors[k] + i * vector_stride   (64B 정렬)
+ *   timestamp = Counters[k] + i * 8, access_count / importance도 같은 방식
+ *   metadata = record->meta_offset (Heap)
  *
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
- * 함수 선언 (구현은 각 .c 파일에서)
+ * 함수 선언 (brain_format.c)
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
-/* brain_format.c (유틸리티) */
-int brain_validate_header(const brain_header_t* header);
+/* 헤더 (v2) */
+int  brain_validate_header(const brain_header_t* header);
 void brain_init_header(brain_header_t* header, uint32_t dim);
 void brain_print_header(const brain_header_t* header);
 
+/* 매핑된 파일 버전 판별: 2 / 1 / -1 (알 수 없음) */
+int brain_detect_version(const void* base, size_t size);
+
+/* 원소 형식별 벡터 슬롯 간격 (BRAIN_ALIGN 배수) */
+uint32_t brain_vector_stride(uint32_t dim, uint32_t storage);
+
+/* 레코드 체크섬 (record->crc에 넣을 값, metadata는 meta_len > 0일 때만 읽음) */
+uint32_t brain_record_crc(const brain_header_t* header, const brain_record_t* record,
+                          const void* vector, const void* metadata);
+
+/* 섹션 디렉터리 */
+int brain_section_add(void* base, uint32_t type, uint32_t chunk,
+                      uint64_t offset, uint64_t size);
+brain_section_t* brain_section_find(void* base, uint32_t type, uint32_t chunk);
+
+/* 영역 할당 (BRAIN_PAGE_SIZE 단위): FREE 섹션 first-fit → 없으면 alloc_offset 전진
+ * 리턴 영역은 항상 0으로 채워져 있다 (재사용 영역은 memset, 새 영역은 ftruncate 0-채움).
+ * header는 매핑 선두여야 함 (FREE 섹션을 쓰지 않는 새 헤더 사본이면 그대로 가능).
+ * 리턴: 오프셋 (file_size가 늘었으면 호출자가 매핑을 키워야 함) */
+uint64_t brain_alloc_region(brain_header_t* header, uint64_t size);
+
+/* 영역 반환 → FREE 섹션 (인접 FREE와 병합), 디렉터리가 가득 차면 -1 (빈 공간으로 남음) */
+int brain_free_region(brain_header_t* header, uint64_t offset, uint64_t size);
+
+/* 디렉터리 항목 index의 영역 반환 (항목은 FREE로 바뀌어 재사용) */
+int brain_section_release(brain_header_t* header, uint32_t index);
+
+/* 파일 끝에 붙은 FREE 영역을 alloc_offset에서 떼어냄 (file_size도 줄임)
+ * 리턴: 줄어든 바이트 수 (호출자가 파일을 잘라야 함) */
+uint64_t brain_trim_tail(brain_header_t* header);
+
+/* v1 읽기: 인덱스에 등록된 모든 엔트리 방문 (visit가 0 아닌 값이면 중단) */
+typedef int (*brain_v1_visit_fn)(void* ctx, const brain_data_entry_t* entry,
+                                 const float* vector, const char* metadata);
+int64_t brain_v1_foreach(const void* base, size_t size,
+                         brain_v1_visit_fn visit, void* ctx);
+
 #endif /* BRAIN_FORMAT_H */
@@ -0,0 +1,538 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_import.c
+ *
+ * 대량 적재 (fvecs / npy / CSV → .brain)
+ *
+ * hippocampus_store를 항목마다 부르면 매번 인덱스 갱신 + 파일 확장이 일어난다.
+ * 여기서는 행 수를 먼저 알아내 파일을 한 번에 잡고 (ftruncate 1회),
+ * 행 i → 레코드 i 주소가 고정되므로 여러 스레드가 잠금 없이 나눠 채운다.
+ * ID 인덱스는 행 수에 맞춘 크기로 만들어 재해시 없이 삽입만 한다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "brain_import.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Utility Functions
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static void sleep_ms(uint32_t ms) {
+    struct timespec ts = { ms / 1000, (long)(ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+static void default_progress(void* ctx, const char* phase,
+                             uint64_t done, uint64_t total, double elapsed_ms) {
+    (void)ctx;
+    printf("[import] %-12s %5.1f%% (%lu / %lu) %.0f rows/s\n", phase,
+           total ? 100.0 * done / total : 100.0,
+           (unsigned long)done, (unsigned long)total,
+           elapsed_ms > 0 ? done * 1000.0 / elapsed_ms : 0.0);
+}
+
+const char* brain_import_format_name(brain_import_format_t format) {
+    switch (format) {
+        case BRAIN_IMPORT_FVECS: return "fvecs";
+        case BRAIN_IMPORT_NPY:   return "npy";
+        case BRAIN_IMPORT_CSV:   return "csv";
+        default:                 return "auto";
+    }
+}
+
+brain_import_format_t brain_import_detect(const char* path) {
+    const char* ext = path ? strrchr(path, '.') : NULL;
+    if (!ext) return BRAIN_IMPORT_AUTO;
+    if (strcmp(ext, ".fvecs") == 0) return BRAIN_IMPORT_FVECS;
+    if (strcmp(ext, ".npy") == 0) return BRAIN_IMPORT_NPY;
+    if (strcmp(ext, ".csv") == 0 || strcmp(ext, ".txt") == 0) return BRAIN_IMPORT_CSV;
+    return BRAIN_IMPORT_AUTO;
+}
+
+void brain_import_defaults(brain_import_options_t* opt) {
+    memset(opt, 0, sizeof(*opt));
+    opt->format = BRAIN_IMPORT_AUTO;
+    opt->layout = INDEX_LAYOUT_ROBIN_HOOD;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 원본 (크기 파악 단계 결과)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+typedef struct {
+    brain_import_format_t format;
+    mmap_file_t* mf;
+    const char*  base;
+    size_t       size;
+
+    uint64_t     rows;
+    uint32_t     dim;
+
+    /* fvecs / npy: 고정 크기 행 */
+    uint64_t     data_offset;
+    uint64_t     row_bytes;
+    uint32_t     elem_size;         /* npy: 4 (<f4) / 8 (<f8) */
+
+    /* CSV: 행 i = [line_offsets[i], line_offsets[i + 1]) */
+    uint64_t*    line_offsets;
+    int          csv_id_column;
+} import_source_t;
+
+static int scan_fvecs(import_source_t* src) {
+    if (src->size < sizeof(int32_t)) return -1;
+
+    int32_t dim;
+    memcpy(&dim, src->base, sizeof(dim));
+    if (dim <= 0) return -1;
+
+    src->dim = (uint32_t)dim;
+    src->row_bytes = sizeof(int32_t) + (uint64_t)dim * sizeof(float);
+    if (src->size % src->row_bytes != 0) {
+        fprintf(stderr, "[import] Error: fvecs size is not a multiple of %lu\n",
+                (unsigned long)src->row_bytes);
+        return -1;
+    }
+    src->rows = src->size / src->row_bytes;
+    src->data_offset = 0;
+    return 0;
+}
+
+/* NumPy 헤더: "\x93NUMPY" major minor hlen {'descr': '<f4', 'fortran_order': False, 'shape': (n, d), } */
+static int scan_npy(import_source_t* src) {
+    if (src->size < 10 || memcmp(src->base, "\x93NUMPY", 6) != 0) return -1;
+
+    uint8_t major = (uint8_t)src->base[6];
+    uint64_t header_start = (major == 1) ? 10 : 12;
+    uint32_t hlen = 0;
+    if (major == 1) {
+        hlen = (uint8_t)src->base[8] | ((uint32_t)(uint8_t)src->base[9] << 8);
+    } else {
+        if (src->size < 12) return -1;
+        memcpy(&hlen, src->base + 8, sizeof(hlen));
+    }
+    if (header_start + hlen > src->size || hlen > 65536) return -1;
+
+    char header[65537];
+    memcpy(header, src->base + header_start, hlen);
+    header[hlen] = '\0';
+
+    const char* descr = strstr(header, "'descr'");
+    const char* order = strstr(header, "'fortran_order'");
+    const char* shape = strstr(header, "'shape'");
+    if (!descr || !order || !shape) return -1;
+
+    descr = strchr(descr + 7, '\'');
+    if (!descr) return -1;
+    if (strncmp(descr, "'<f4'", 5) == 0) src->elem_size = 4;
+    else if (strncmp(descr, "'<f8'", 5) == 0) src->elem_size = 8;
+    else {
+        fprintf(stderr, "[import] Error: npy dtype must be little-endian float32/float64\n");
+        return -1;
+    }
+
+    if (strstr(order, "True") && strstr(order, "True") < shape) {
+        fprintf(stderr, "[import] Error: npy must be C order\n");
+        return -1;
+    }
+
+    unsigned long long n = 0, d = 0;
+    shape = strchr(shape, '(');
+    if (!shape || sscanf(shape, "(%llu, %llu)", &n, &d) != 2 || d == 0) {
+        fprintf(stderr, "[import] Error: npy shape must be (rows, dim)\n");
+        return -1;
+    }
+
+    src->rows = n;
+    src->dim = (uint32_t)d;
+    src->data_offset = header_start + hlen;
+    src->row_bytes = d * src->elem_size;
+    if (src->data_offset + src->rows * src->row_bytes > src->size) {
+        fprintf(stderr, "[import] Error: npy data truncated\n");
+        return -1;
+    }
+    return 0;
+}
+
+static int csv_is_number_start(char c) {
+    return isdigit((unsigned char)c) || c == '-' || c == '+' || c == '.';
+}
+
+/* 빈 줄과 머리글을 건너뛰며 데이터 행 시작 위치 수집 */
+static int scan_csv(import_source_t* src) {
+    uint64_t capacity = 1024;
+    src->line_offsets = (uint64_t*)malloc(capacity * sizeof(uint64_t));
+    if (!src->line_offsets) return -1;
+
+    uint64_t pos = 0;
+    int first = 1;
+    while (pos < src->size) {
+        const char* nl = memchr(src->base + pos, '\n', src->size - pos);
+        uint64_t end = nl ? (uint64_t)(nl - src->base) : src->size;
+
+        uint64_t p = pos;
+        while (p < end && (src->base[p] == ' ' || src->base[p] == '\t' || src->base[p] == '\r')) p++;
+
+        if (p < end && !(first && !csv_is_number_start(src->base[p]))) {
+            if (src->rows + 1 >= capacity) {
+                capacity *= 2;
+                uint64_t* grown = (uint64_t*)realloc(src->line_offsets, capacity * sizeof(uint64_t));
+                if (!grown) return -1;
+                src->line_offsets = grown;
+            }
+            if (src->rows == 0) {
+                uint32_t fields = 1;
+                for (uint64_t i = pos; i < end; i++) fields += (src->base[i] == ',');
+                if (fields <= (uint32_t)src->csv_id_column) return -1;
+                src->dim = fields - (uint32_t)src->csv_id_column;
+            }
+            src->line_offsets[src->rows++] = pos;
+        }
+        if (p < end) first = 0;
+        pos = end + 1;
+    }
+
+    if (src->rows == 0) return -1;
+    src->line_offsets[src->rows] = src->size;
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 행 파싱 (스레드별)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* CSV 한 줄 → id, vec (line은 NUL 종료 사본) */
+static int parse_csv_row(const import_source_t* src, char* line, int64_t* id, float* vec) {
+    char* p = line;
+    char* end;
+
+    if (src->csv_id_column) {
+        long long v = strtoll(p, &end, 10);
+        if (end == p || v < 0) return -1;
+        *id = v;
+        p = end;
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p++ != ',') return -1;
+    }
+
+    for (uint32_t d = 0; d < src->dim; d++) {
+        vec[d] = strtof(p, &end);
+        if (end == p) return -1;
+        p = end;
+        while (*p == ' ' || *p == '\t') p++;
+        if (d + 1 < src->dim && *p++ != ',') return -1;
+    }
+
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+    return *p == '\0' ? 0 : -1;
+}
+
+static int parse_row(const import_source_t* src, uint64_t row, char* line_buf,
+                     int64_t* id, float* vec) {
+    if (src->format == BRAIN_IMPORT_CSV) {
+        uint64_t begin = src->line_offsets[row];
+        uint64_t end = src->line_offsets[row + 1];
+        const char* nl = memchr(src->base + begin, '\n', end - begin);
+        if (nl) end = (uint64_t)(nl - src->base);
+        if (end - begin >= BRAIN_IMPORT_CSV_LINE_MAX) return -1;
+
+        memcpy(line_buf, src->base + begin, end - begin);
+        line_buf[end - begin] = '\0';
+        return parse_csv_row(src, line_buf, id, vec);
+    }
+
+    const char* p = src->base + src->data_offset + row * src->row_bytes;
+
+    if (src->format == BRAIN_IMPORT_FVECS) {
+        int32_t dim;
+        memcpy(&dim, p, sizeof(dim));
+        if ((uint32_t)dim != src->dim) return -1;
+        memcpy(vec, p + sizeof(int32_t), (size_t)src->dim * sizeof(float));
+    } else if (src->elem_size == 4) {
+        memcpy(vec, p, (size_t)src->dim * sizeof(float));
+    } else {
+        for (uint32_t d = 0; d < src->dim; d++) {
+            double v;
+            memcpy(&v, p + (size_t)d * sizeof(double), sizeof(v));
+            vec[d] = (float)v;
+        }
+    }
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 채우기 워커
+ *
+ * 레코드 / 벡터 chunk는 이미 할당되어 있고 매핑도 바뀌지 않으므로
+ * 행 구간 [begin, end)의 레코드 주소에 바로 쓴다 (잠금 없음).
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+typedef struct {
+    const import_source_t*        src;
+    const brain_file_t*           bf;
+    const brain_import_options_t* opt;
+    uint64_t  begin;
+    uint64_t  end;
+    int64_t   timestamp;
+    uint64_t  rejected;
+    uint64_t* progress;             /* 공유 카운터 (__atomic) */
+    uint32_t* finished;
+} import_worker_t;
+
+static void* import_worker(void* arg) {
+    import_worker_t* w = (import_worker_t*)arg;
+    char* line_buf = NULL;
+    if (w->src->format == BRAIN_IMPORT_CSV) line_buf = (char*)malloc(BRAIN_IMPORT_CSV_LINE_MAX);
+
+    uint64_t pending = 0;
+    for (uint64_t row = w->begin; row < w->end; row++) {
+        brain_entry_t e;
+        brain_file_entry(w->bf, row, &e);
+
+        int64_t id = w->opt->first_id + (int64_t)row;
+        int ok = (w->src->format != BRAIN_IMPORT_CSV || line_buf) &&
+                 parse_row(w->src, row, line_buf, &id, (float*)e.vector) == 0;
+
+        e.record->id = id;
+        if (e.timestamp) {
+            *e.timestamp = w->timestamp;
+            *e.importance = 0.5f;
+        }
+        e.record->flags = ok ? BRAIN_RECORD_LIVE : BRAIN_RECORD_DELETED;
+        e.record->crc = brain_record_crc(brain_file_header(w->bf), e.record, e.vector, NULL);
+        e.record->checks = BRAIN_CHECK_CRC32C;
+        if (!ok) w->rejected++;
+
+        if (++pending == BRAIN_IMPORT_PROGRESS_ROWS) {
+            __atomic_fetch_add(w->progress, pending, __ATOMIC_RELAXED);
+            pending = 0;
+        }
+    }
+
+    __atomic_fetch_add(w->progress, pending, __ATOMIC_RELAXED);
+    __atomic_fetch_add(w->finished, 1, __ATOMIC_RELEASE);
+    free(line_buf);
+    return NULL;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_import
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int brain_import(const char* src_path, const char* dst_path,
+                 const brain_import_options_t* opt_in, brain_import_stats_t* stats) {
+    brain_import_options_t opt;
+    if (opt_in) opt = *opt_in;
+    else brain_import_defaults(&opt);
+
+    brain_import_progress_fn report = opt.progress ? opt.progress : default_progress;
+    brain_import_stats_t st;
+    memset(&st, 0, sizeof(st));
+
+    /* ── 1. 크기 파악 ── */
+    double t0 = now_ms();
+    import_source_t src;
+    memset(&src, 0, sizeof(src));
+    src.format = (opt.format != BRAIN_IMPORT_AUTO) ? opt.format : brain_import_detect(src_path);
+    src.csv_id_column = opt.csv_id_column ? 1 : 0;
+
+    src.mf = mmap_file_open(src_path, 0);
+    if (!src.mf) return -1;
+    src.base = (const char*)src.mf->addr;
+    src.size = src.mf->size;
+
+    int scanned = -1;
+    switch (src.format) {
+        case BRAIN_IMPORT_FVECS: scanned = scan_fvecs(&src); break;
+        case BRAIN_IMPORT_NPY:   scanned = scan_npy(&src); break;
+        case BRAIN_IMPORT_CSV:   scanned = scan_csv(&src); break;
+        default:
+            fprintf(stderr, "[import] Error: unknown format for '%s'\n", src_path);
+    }
+    if (scanned < 0 || src.rows == 0 || src.dim == 0 ||
+        (opt.vindex && opt.vindex->dim != src.dim)) {
+        fprintf(stderr, "[import] Error: cannot read '%s' as %s\n",
+                src_path, brain_import_format_name(src.format));
+        free(src.line_offsets);
+        mmap_file_close(src.mf);
+        return -1;
+    }
+
+    /* ── 2. 할당 (인덱스는 부하율 상한 안에 들도록) ── */
+    uint32_t log2 = BRAIN_INDEX_MIN_LOG2;
+    while (log2 < BRAIN_INDEX_MAX_LOG2 &&
+           src.rows * 100 > ((uint64_t)1 << log2) * INDEX_MAX_LOAD_PCT) {
+        log2++;
+    }
+
+    /* 임시 파일에 만들고 성공한 뒤에만 rename → 실패해도 기존 dst는 그대로 */
+    size_t tmp_len = strlen(dst_path) + 32;
+    char* tmp_path = (char*)malloc(tmp_len);
+    if (!tmp_path) {
+        free(src.line_offsets);
+        mmap_file_close(src.mf);
+        return -1;
+    }
+    snprintf(tmp_path, tmp_len, "%s.import-%ld", dst_path, (long)getpid());
+    unlink(tmp_path);
+
+    brain_file_t* bf = brain_file_create_ex(tmp_path, src.dim, opt.layout, log2);
+    if (!bf || brain_file_reserve(bf, src.rows) < 0) {
+        if (bf) brain_file_close(bf);
+        unlink(tmp_path);
+        free(tmp_path);
+        free(src.line_offsets);
+        mmap_file_close(src.mf);
+        return -1;
+    }
+    brain_file_header(bf)->record_count = src.rows;
+
+    st.rows = src.rows;
+    st.dim = src.dim;
+    st.scan_ms = now_ms() - t0;
+    printf("[import] %s: %lu rows × %u dim → %s (%.1f MB, index 2^%u)\n",
+           brain_import_format_name(src.format), (unsigned long)src.rows, src.dim,
+           dst_path, bf->mf->size / 1024.0 / 1024.0, log2);
+
+    /* ── 3. 병렬 채우기 ── */
+    uint32_t threads = opt.threads;
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (uint32_t)cpus : 1;
+    }
+    if (threads > BRAIN_IMPORT_MAX_THREADS) threads = BRAIN_IMPORT_MAX_THREADS;
+    if (threads > src.rows) threads = (uint32_t)src.rows;
+    st.threads = threads;
+
+    import_worker_t workers[BRAIN_IMPORT_MAX_THREADS];
+    pthread_t tids[BRAIN_IMPORT_MAX_THREADS];
+    uint64_t progress = 0;
+    uint32_t finished = 0;
+    int64_t timestamp = time(NULL);
+
+    double t1 = now_ms();
+    uint32_t started = 0;
+    for (uint32_t t = 0; t < threads; t++) {
+        import_worker_t* w = &workers[t];
+        w->src = &src;
+        w->bf = bf;
+        w->opt = &opt;
+        w->begin = src.rows * t / threads;
+        w->end = src.rows * (t + 1) / threads;
+        w->timestamp = timestamp;
+        w->rejected = 0;
+        w->progress = &progress;
+        w->finished = &finished;
+        if (pthread_create(&tids[t], NULL, import_worker, w) != 0) {
+            import_worker(w);       /* 스레드 생성 실패 → 이 구간은 직접 */
+            continue;
+        }
+        tids[started++] = tids[t];
+    }
+
+    double last_report = now_ms();
+    while (__atomic_load_n(&finished, __ATOMIC_ACQUIRE) < threads) {
+        sleep_ms(10);
+        if (now_ms() - last_report >= BRAIN_IMPORT_PROGRESS_MS) {
+            last_report = now_ms();
+            report(opt.progress_ctx, "fill", __atomic_load_n(&progress, __ATOMIC_RELAXED),
+                   src.rows, last_report - t1);
+        }
+    }
+    for (uint32_t t = 0; t < started; t++) pthread_join(tids[t], NULL);
+    for (uint32_t t = 0; t < threads; t++) st.rejected += workers[t].rejected;
+
+    st.fill_ms = now_ms() - t1;
+    report(opt.progress_ctx, "fill", src.rows, src.rows, st.fill_ms);
+
+    /* 원본은 더 필요 없음 */
+    free(src.line_offsets);
+    mmap_file_close(src.mf);
+
+    /* ── 4. ID 인덱스 (재해시 없음 → 매핑 고정) ── */
+    double t2 = now_ms();
+    uint64_t live = 0;
+    for (uint64_t row = 0; row < st.rows; row++) {
+        brain_entry_t e;
+        brain_file_entry(bf, row, &e);
+        if (!(e.record->flags & BRAIN_RECORD_LIVE)) continue;
+
+        /* 같은 ID가 다시 나오면 뒤 행이 이긴다 */
+        int64_t ref = index_lookup(bf->index, e.record->id);
+        if (ref > 0) {
+            brain_entry_t old;
+            brain_file_entry(bf, BRAIN_REF_RECORD(ref), &old);
+            old.record->flags = BRAIN_RECORD_DELETED;
+            st.duplicates++;
+            live--;
+        }
+        if (index_insert(bf->index, e.record->id, BRAIN_RECORD_REF(row)) < 0) {
+            e.record->flags = BRAIN_RECORD_DELETED;
+            st.rejected++;
+            continue;
+        }
+        live++;
+
+        if ((row + 1) % (BRAIN_IMPORT_PROGRESS_ROWS * 64) == 0) {
+            report(opt.progress_ctx, "index", row + 1, st.rows, now_ms() - t2);
+        }
+    }
+    brain_file_header(bf)->live_count = live;
+    st.imported = live;
+    st.index_ms = now_ms() - t2;
+    report(opt.progress_ctx, "index", st.rows, st.rows, st.index_ms);
+
+    /* ── 5. 벡터 인덱스 (살아 있는 레코드만, 매핑 안 벡터를 그대로 전달) ── */
+    if (opt.vindex) {
+        double t3 = now_ms();
+        uint64_t done = 0;
+        for (uint64_t row = 0; row < st.rows; row++) {
+            brain_entry_t e;
+            brain_file_entry(bf, row, &e);
+            if (!(e.record->flags & BRAIN_RECORD_LIVE)) continue;
+
+            if (vector_index_insert(opt.vindex, e.record->id, e.vector) < 0) {
+                st.vindex_failed++;
+            }
+            if (++done % (BRAIN_IMPORT_PROGRESS_ROWS * 16) == 0) {
+                report(opt.progress_ctx, "vector-index", done, live, now_ms() - t3);
+            }
+        }
+        st.vindex_ms = now_ms() - t3;
+        report(opt.progress_ctx, "vector-index", done, live, st.vindex_ms);
+    }
+
+    brain_file_close(bf);
+    if (rename(tmp_path, dst_path) != 0) {
+        fprintf(stderr, "[import] Error: cannot rename '%s' → '%s'\n", tmp_path, dst_path);
+        unlink(tmp_path);
+        free(tmp_path);
+        return -1;
+    }
+    free(tmp_path);
+
+    double total_ms = now_ms() - t0;
+    st.rows_per_sec = total_ms > 0 ? st.rows * 1000.0 / total_ms : 0.0;
+    printf("[import] ✓ %lu imported, %lu rejected, %lu duplicate ids (%u threads)\n",
+           (unsigned long)st.imported, (unsigned long)st.rejected,
+           (unsigned long)st.duplicates, st.threads);
+    if (st.vindex_failed > 0) {
+        fprintf(stderr, "[import] Warning: %lu of %lu records not added to the vector index\n",
+                (unsigned long)st.vindex_failed, (unsigned long)live);
+    }
+    printf("[import]   scan %.1f ms, fill %.1f ms, index %.1f ms, vector index %.1f ms"
+           " → %.0f rows/s\n", st.scan_ms, st.fill_ms, st.index_ms, st.vindex_ms,
+           st.rows_per_sec);
+
+    if (stats) *stats = st;
+    return 0;
+}
@@ -0,0 +1,87 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_import.h
+ *
+ * 대량 적재: fvecs / npy / CSV → .brain 파일 + ID 인덱스 (+ 벡터 인덱스)
+ *
+ * 단계:
+ *   1. 크기 파악: 원본을 mmap으로 열어 행 수 / 차원 결정 (CSV는 행 시작 위치 수집)
+ *   2. 할당: 행 수에 맞춰 chunk와 인덱스를 미리 잡고 ftruncate 1회
+ *   3. 채우기: 스레드마다 행 구간을 맡아 미리 정해진 레코드 주소에 직접 기록
+ *   4. 인덱스: ID 인덱스를 재해시 없이 한 번에 구축, 벡터 인덱스에 일괄 삽입
+ *
+ * 원본 행 i = 레코드 i (ID = first_id + i, CSV는 ID 열 사용 가능)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#ifndef BRAIN_IMPORT_H
+#define BRAIN_IMPORT_H
+
+#include "brain_file.h"
+#include "vector_index.h"
+#include <stdint.h>
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Configuration
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#define BRAIN_IMPORT_MAX_THREADS    64
+#define BRAIN_IMPORT_PROGRESS_ROWS  4096        /* 진행률 카운터 갱신 단위 */
+#define BRAIN_IMPORT_PROGRESS_MS    500         /* 진행률 보고 간격 */
+#define BRAIN_IMPORT_CSV_LINE_MAX   (256 * 1024)
+
+typedef enum {
+    BRAIN_IMPORT_AUTO  = 0,         /* 확장자로 판별 */
+    BRAIN_IMPORT_FVECS = 1,         /* [int32 dim][float × dim] 반복 */
+    BRAIN_IMPORT_NPY   = 2,         /* NumPy 2차원 배열 (<f4 / <f8, C order) */
+    BRAIN_IMPORT_CSV   = 3          /* 행마다 쉼표 구분 실수 (첫 줄 머리글 허용) */
+} brain_import_format_t;
+
+/* 진행률 콜백 (phase: "fill" / "index" / "vector-index") */
+typedef void (*brain_import_progress_fn)(void* ctx, const char* phase,
+                                         uint64_t done, uint64_t total, double elapsed_ms);
+
+typedef struct {
+    brain_import_format_t format;
+    uint32_t        threads;        /* 0 = 온라인 CPU 수 */
+    int64_t         first_id;       /* ID = first_id + 행 번호 */
+    int             csv_id_column;  /* CSV 첫 열이 ID */
+    index_layout_t  layout;         /* ID 인덱스 레이아웃 */
+    vector_index_t* vindex;         /* 함께 채울 벡터 인덱스 (NULL = 생략) */
+
+    brain_import_progress_fn progress;  /* NULL = 표준 출력 */
+    void*           progress_ctx;
+} brain_import_options_t;
+
+typedef struct {
+    uint64_t rows;                  /* 원본 행 수 */
+    uint64_t imported;              /* 살아 있는 레코드 수 */
+    uint64_t rejected;              /* 파싱 실패 행 */
+    uint64_t duplicates;            /* 이전 행을 덮어쓴 ID */
+    uint64_t vindex_failed;         /* 벡터 인덱스 삽입 실패 (용량 초과, 중복 ID 등) */
+    uint32_t dim;
+    uint32_t threads;
+
+    double   scan_ms;               /* 크기 파악 + 할당 */
+    double   fill_ms;               /* 병렬 채우기 */
+    double   index_ms;              /* ID 인덱스 */
+    double   vindex_ms;             /* 벡터 인덱스 */
+    double   rows_per_sec;          /* 전체 처리량 */
+} brain_import_stats_t;
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 함수 선언
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 기본 옵션 */
+void brain_import_defaults(brain_import_options_t* opt);
+
+/* src를 새 .brain 파일 dst로 적재
+ * (dst.import-<pid>에 만든 뒤 성공하면 rename → 실패하면 기존 dst는 그대로)
+ * 리턴: 0 = 성공, -1 = 실패 */
+int brain_import(const char* src, const char* dst,
+                 const brain_import_options_t* opt, brain_import_stats_t* stats);
+
+/* 형식 이름 / 확장자 판별 */
+const char* brain_import_format_name(brain_import_format_t format);
+brain_import_format_t brain_import_detect(const char* path);
+
+#endif /* BRAIN_IMPORT_H */
@@ -0,0 +1,684 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_store.c
+ *
+ * 세그먼트 저장소 (디렉터리 + MANIFEST + ROUTING)
+ *
+ * MANIFEST:
+ *   - [헤더][세그먼트 항목 × count], 헤더의 CRC32C가 전체를 덮음
+ *   - 바뀔 때마다 임시 파일 → rename → 디렉터리 fsync
+ *   - 쓰기 가능하게 열면 바로 clean = 0으로 저장, 정상 종료 때 clean = 1
+ *
+ * ROUTING:
+ *   - 파일 선두 route_header_t (generation) + index_manager 테이블
+ *   - MANIFEST가 clean이고 generation이 같을 때만 그대로 사용,
+ *     아니면 세그먼트 레코드를 (열기 스레드에서) 모아 다시 만든다
+ *
+ * 열기:
+ *   - 세그먼트를 스레드 수만큼 나눠 brain_file_open_ex + 검증 + 예열
+ *   - 봉인된 세그먼트는 주소 예약 없이 (BRAIN_OPEN_NORESERVE)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* clock_gettime, fsync 선언을 위해 필요 */
+#define _POSIX_C_SOURCE 200809L
+
+#include "brain_store.h"
+#include "brain_crc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#define MANIFEST_MAGIC      "BRAINMF"
+#define MANIFEST_VERSION    1
+#define ROUTE_MAGIC         "BRROUTE"
+#define ROUTE_META_OFFSET   64                  /* brain_index_meta_t */
+#define ROUTE_TABLE_OFFSET  4096                /* 첫 테이블 (재해시는 파일 끝에) */
+#define STORE_PATH_MAX      4096
+
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t dim;
+    uint32_t layout;            /* index_layout_t (세그먼트 ID 인덱스) */
+    uint32_t count;             /* 세그먼트 항목 수 */
+    uint64_t segment_size;
+    uint64_t generation;
+    uint32_t next_number;
+    uint32_t clean;             /* 1 = 정상 종료, ROUTING 신뢰 */
+    uint32_t crc;               /* crc = 0으로 두고 헤더 + 항목 전체 */
+    uint32_t reserved;
+} manifest_header_t;
+
+typedef struct {
+    uint32_t number;
+    uint32_t state;             /* brain_segment_state_t */
+    uint64_t records;           /* 저장 시점 살아 있는 레코드 (참고용) */
+} manifest_entry_t;
+
+typedef struct {
+    char     magic[8];
+    uint64_t generation;        /* 마지막 정상 종료의 MANIFEST generation */
+} route_header_t;
+
+_Static_assert(sizeof(manifest_header_t) == 56, "Manifest header must be 56 bytes");
+_Static_assert(sizeof(route_header_t) <= ROUTE_META_OFFSET, "Route header overlaps index meta");
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 내부 헬퍼
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static void store_path(const brain_store_t* st, const char* name, char* out) {
+    snprintf(out, STORE_PATH_MAX, "%s/%s", st->dir, name);
+}
+
+static void segment_path(const brain_store_t* st, uint32_t number, char* out) {
+    char name[64];
+    snprintf(name, sizeof(name), BRAIN_STORE_SEGMENT_FMT, number);
+    store_path(st, name, out);
+}
+
+/* rename이 디스크에 남도록 */
+static void sync_dir(const char* dir) {
+    int fd = open(dir, O_RDONLY);
+    if (fd < 0) return;
+    fsync(fd);
+    close(fd);
+}
+
+static brain_store_t* store_alloc(const char* dir) {
+    brain_store_t* st = (brain_store_t*)calloc(1, sizeof(brain_store_t));
+    if (!st) return NULL;
+    st->dir = (char*)malloc(strlen(dir) + 1);
+    if (!st->dir) {
+        free(st);
+        return NULL;
+    }
+    strcpy(st->dir, dir);
+    return st;
+}
+
+static void store_free(brain_store_t* st) {
+    for (uint32_t i = 0; i < st->segment_count; i++) brain_file_close(st->segments[i].bf);
+    if (st->route) index_close(st->route);
+    if (st->route_mf) mmap_file_close(st->route_mf);
+    free(st->segments);
+    free(st->dir);
+    free(st);
+}
+
+static brain_segment_t* segment_push(brain_store_t* st, uint32_t number, uint32_t state) {
+    if (st->segment_count == st->segment_capacity) {
+        uint32_t cap = st->segment_capacity ? st->segment_capacity * 2 : 16;
+        brain_segment_t* grown = (brain_segment_t*)realloc(st->segments, cap * sizeof(brain_segment_t));
+        if (!grown) return NULL;
+        st->segments = grown;
+        st->segment_capacity = cap;
+    }
+    brain_segment_t* seg = &st->segments[st->segment_count++];
+    seg->number = number;
+    seg->state = state;
+    seg->bf = NULL;
+    return seg;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * MANIFEST
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+static int manifest_save(brain_store_t* st, int clean) {
+    size_t size = sizeof(manifest_header_t) + (size_t)st->segment_count * sizeof(manifest_entry_t);
+    uint8_t* buf = (uint8_t*)calloc(1, size);
+    if (!buf) return -1;
+
+    manifest_header_t* hdr = (manifest_header_t*)buf;
+    memcpy(hdr->magic, MANIFEST_MAGIC, sizeof(hdr->magic));
+    hdr->version = MANIFEST_VERSION;
+    hdr->dim = st->dim;
+    hdr->layout = (uint32_t)st->layout;
+    hdr->count = st->segment_count;
+    hdr->segment_size = st->segment_size;
+    hdr->generation = st->generation + 1;
+    hdr->next_number = st->next_number;
+    hdr->clean = (uint32_t)clean;
+
+    manifest_entry_t* entries = (manifest_entry_t*)(hdr + 1);
+    for (uint32_t i = 0; i < st->segment_count; i++) {
+        entries[i].number = st->segments[i].number;
+        entries[i].state = st->segments[i].state;
+        entries[i].records = st->segments[i].bf ? brain_file_count(st->segments[i].bf) : 0;
+    }
+    hdr->crc = brain_crc32c(0, buf, size);
+
+    char path[STORE_PATH_MAX], tmp[STORE_PATH_MAX + 8];
+    store_path(st, BRAIN_STORE_MANIFEST, path);
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+
+    int rc = -1;
+    FILE* f = fopen(tmp, "wb");
+    if (f) {
+        if (fwrite(buf, size, 1, f) == 1 && fflush(f) == 0 && fsync(fileno(f)) == 0) rc = 0;
+        if (fclose(f) != 0) rc = -1;
+        if (rc == 0 && rename(tmp, path) < 0) rc = -1;
+        if (rc < 0) unlink(tmp);
+    }
+    free(buf);
+
+    if (rc < 0) {
+        fprintf(stderr, "[store] Error: cannot write manifest '%s': %s\n", path, strerror(errno));
+        return -1;
+    }
+    sync_dir(st->dir);
+    st->generation++;
+    return 0;
+}
+
+/* 리턴: 헤더 + 항목 버퍼 (free), NULL = 없음 / 손상 */
+static manifest_header_t* manifest_load(const brain_store_t* st) {
+    char path[STORE_PATH_MAX];
+    store_path(st, BRAIN_STORE_MANIFEST, path);
+
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "[store] Error: cannot open manifest '%s': %s\n", path, strerror(errno));
+        return NULL;
+    }
+    manifest_header_t head;
+    uint8_t* buf = NULL;
+    size_t size = 0;
+    int ok = fread(&head, sizeof(head), 1, f) == 1 &&
+             memcmp(head.magic, MANIFEST_MAGIC, sizeof(head.magic)) == 0 &&
+             head.version == MANIFEST_VERSION;
+    if (ok) {
+        size = sizeof(head) + (size_t)head.count * sizeof(manifest_entry_t);
+        buf = (uint8_t*)malloc(size);
+        ok = buf && fread(buf + sizeof(head), size - sizeof(head), 1, f) == (head.count ? 1u : 0u);
+    }
+    fclose(f);
+
+    if (ok) {
+        memcpy(buf, &head, sizeof(head));
+        uint32_t crc = head.crc;
+        ((manifest_header_t*)buf)->crc = 0;
+        ok = brain_crc32c(0, buf, size) == crc;
+        ((manifest_header_t*)buf)->crc = crc;
+    }
+    if (!ok) {
+        fprintf(stderr, "[store] Error: manifest '%s' is corrupt\n", path);
+        free(buf);
+        return NULL;
+    }
+    return (manifest_header_t*)buf;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * ROUTING
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+static void route_close(brain_store_t* st) {
+    if (st->route) index_close(st->route);
+    if (st->route_mf) mmap_file_close(st->route_mf);
+    st->route = NULL;
+    st->route_mf = NULL;
+}
+
+/* 읽기 전용 저장소는 익명 메모리에 (디렉터리는 건드리지 않음, 닫으면 버림) */
+static int route_create(brain_store_t* st, uint32_t log2) {
+    size_t size = ROUTE_TABLE_OFFSET + index_table_size(log2, INDEX_LAYOUT_GROUPED);
+    if (st->writable) {
+        char path[STORE_PATH_MAX];
+        store_path(st, BRAIN_STORE_ROUTING, path);
+        unlink(path);
+        st->route_mf = mmap_file_create(path, size);
+    } else {
+        st->route_mf = mmap_file_anon(size);
+    }
+    if (!st->route_mf) return -1;
+    memset(st->route_mf->addr, 0, ROUTE_TABLE_OFFSET);
+    memcpy(((route_header_t*)st->route_mf->addr)->magic, ROUTE_MAGIC, 8);
+
+    st->route = index_create(st->route_mf, ROUTE_META_OFFSET, ROUTE_TABLE_OFFSET,
+                             log2, INDEX_LAYOUT_GROUPED);
+    if (!st->route) {
+        route_close(st);
+        return -1;
+    }
+    return 0;
+}
+
+/* 정상 종료 때 남긴 ROUTING (generation 불일치면 -1) */
+static int route_open(brain_store_t* st, int writable) {
+    char path[STORE_PATH_MAX];
+    store_path(st, BRAIN_STORE_ROUTING, path);
+    if (access(path, F_OK) != 0) return -1;
+
+    st->route_mf = mmap_file_open(path, writable);
+    if (!st->route_mf) return -1;
+
+    const route_header_t* hdr = (const route_header_t*)st->route_mf->addr;
+    if (st->route_mf->size < ROUTE_TABLE_OFFSET ||
+        memcmp(hdr->magic, ROUTE_MAGIC, 8) != 0 || hdr->generation != st->generation ||
+        !(st->route = index_open(st->route_mf, ROUTE_META_OFFSET))) {
+        route_close(st);
+        return -1;
+    }
+    return 0;
+}
+
+/* 살아 있는 레코드 ID 모으기 (재구축 / drop용) */
+static int64_t* segment_ids(const brain_file_t* bf, uint64_t* count) {
+    uint64_t issued = brain_file_header(bf)->record_count;
+    uint64_t live = brain_file_count(bf);
+    int64_t* ids = (int64_t*)malloc((live ? live : 1) * sizeof(int64_t));
+    if (!ids) return NULL;
+
+    uint64_t n = 0;
+    brain_entry_t e;
+    for (uint64_t r = 0; r < issued && n < live; r++) {
+        if (brain_file_entry(bf, r, &e) < 0 || !(e.record->flags & BRAIN_RECORD_LIVE)) continue;
+        ids[n++] = e.record->id;
+    }
+    *count = n;
+    return ids;
+}
+
+/* 세그먼트 번호 순으로 삽입 → 같은 ID는 나중 (큰 번호) 세그먼트가 이김 */
+static int route_rebuild(brain_store_t* st, int64_t** ids, const uint64_t* counts) {
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < st->segment_count; i++) total += counts[i];
+
+    uint32_t log2 = BRAIN_STORE_ROUTE_LOG2;
+    while (log2 < BRAIN_INDEX_MAX_LOG2 && total * 100 > ((uint64_t)1 << log2) * INDEX_MAX_LOAD_PCT) log2++;
+    if (route_create(st, log2) < 0) return -1;
+
+    for (uint32_t i = 0; i < st->segment_count; i++) {
+        brain_segment_t* seg = &st->segments[i];
+        for (uint64_t k = 0; k < counts[i]; k++) {
+            int64_t prev = index_lookup(st->route, ids[i][k]);
+            if (prev > 0) {
+                brain_segment_t* older = brain_store_segment(st, (uint32_t)(prev - 1));
+                if (older && st->writable) brain_file_delete(older->bf, ids[i][k]);
+                st->stats.duplicates++;
+            }
+            if (index_insert(st->route, ids[i][k], (uint64_t)seg->number + 1) < 0) return -1;
+        }
+    }
+    st->stats.route_rebuilt = 1;
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 병렬 열기
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+typedef struct {
+    brain_store_t*               st;
+    const brain_store_options_t* opt;
+    uint32_t                     next;      /* 다음 세그먼트 (원자적) */
+    int                          failed;
+    int                          collect;   /* ROUTING 재구축용 ID 수집 */
+    int64_t**                    ids;
+    uint64_t*                    counts;
+} open_job_t;
+
+static void* open_worker(void* arg) {
+    open_job_t* job = (open_job_t*)arg;
+    brain_store_t* st = job->st;
+
+    for (;;) {
+        uint32_t i = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+        if (i >= st->segment_count) break;
+        brain_segment_t* seg = &st->segments[i];
+
+        char path[STORE_PATH_MAX];
+        segment_path(st, seg->number, path);
+        uint32_t flags = job->opt->flags;
+        if (seg->state == BRAIN_SEGMENT_SEALED) flags |= BRAIN_OPEN_NORESERVE;
+
+        seg->bf = brain_file_open_ex(path, st->writable, flags);
+        if (!seg->bf ||
+            (job->opt->verify != BRAIN_VERIFY_NEVER && brain_file_set_verify(seg->bf, job->opt->verify) < 0) ||
+            (job->collect && !(job->ids[i] = segment_ids(seg->bf, &job->counts[i])))) {
+            fprintf(stderr, "[store] Error: cannot open segment '%s'\n", path);
+            __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+        }
+    }
+    return NULL;
+}
+
+static int open_segments(brain_store_t* st, const brain_store_options_t* opt, int collect,
+                         int64_t** ids, uint64_t* counts) {
+    uint32_t threads = opt->threads;
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (uint32_t)cpus : 1;
+    }
+    if (threads > BRAIN_STORE_MAX_THREADS) threads = BRAIN_STORE_MAX_THREADS;
+    if (threads > st->segment_count) threads = st->segment_count ? st->segment_count : 1;
+    st->stats.threads = threads;
+
+    open_job_t job = { st, opt, 0, 0, collect, ids, counts };
+    pthread_t tids[BRAIN_STORE_MAX_THREADS];
+    uint32_t started = 0;
+    for (uint32_t t = 1; t < threads; t++) {
+        if (pthread_create(&tids[started], NULL, open_worker, &job) != 0) break;
+        started++;
+    }
+    open_worker(&job);      /* 호출 스레드도 참여 */
+    for (uint32_t t = 0; t < started; t++) pthread_join(tids[t], NULL);
+
+    return job.failed ? -1 : 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_store_create / brain_store_open / brain_store_close
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+brain_store_t* brain_store_create(const char* dir, uint32_t dim, index_layout_t layout,
+                                  uint64_t segment_size) {
+    if (!dir || dim == 0) return NULL;
+    if (segment_size == 0) segment_size = BRAIN_STORE_SEGMENT_SIZE;
+    if (segment_size < BRAIN_STORE_SEGMENT_MIN) segment_size = BRAIN_STORE_SEGMENT_MIN;
+
+    if (mkdir(dir, 0755) < 0 && errno != EEXIST) {
+        fprintf(stderr, "[store] Error: cannot create '%s': %s\n", dir, strerror(errno));
+        return NULL;
+    }
+
+    brain_store_t* st = store_alloc(dir);
+    if (!st) return NULL;
+    st->dim = dim;
+    st->layout = layout;
+    st->segment_size = segment_size;
+    st->writable = 1;
+
+    char path[STORE_PATH_MAX];
+    store_path(st, BRAIN_STORE_MANIFEST, path);
+    if (access(path, F_OK) == 0) {
+        fprintf(stderr, "[store] Error: '%s' already holds a store\n", dir);
+        store_free(st);
+        return NULL;
+    }
+
+    if (route_create(st, BRAIN_STORE_ROUTE_LOG2) < 0 || manifest_save(st, 0) < 0) {
+        store_free(st);
+        return NULL;
+    }
+
+    printf("[store] ✓ Created '%s' (dim %u, %.1f MB segments)\n",
+           dir, dim, segment_size / 1024.0 / 1024.0);
+    return st;
+}
+
+brain_store_t* brain_store_open(const char* dir, int writable, const brain_store_options_t* opt) {
+    if (!dir) return NULL;
+    brain_store_options_t defaults = { 0, 0, BRAIN_VERIFY_NEVER };
+    if (!opt) opt = &defaults;
+
+    brain_store_t* st = store_alloc(dir);
+    if (!st) return NULL;
+    st->writable = writable;
+    st->flags = opt->flags;
+
+    manifest_header_t* mf = manifest_load(st);
+    if (!mf) {
+        store_free(st);
+        return NULL;
+    }
+    st->dim = mf->dim;
+    st->layout = (index_layout_t)mf->layout;
+    st->segment_size = mf->segment_size;
+    st->generation = mf->generation;
+    st->next_number = mf->next_number;
+
+    const manifest_entry_t* entries = (const manifest_entry_t*)(mf + 1);
+    for (uint32_t i = 0; i < mf->count; i++) {
+        if (!segment_push(st, entries[i].number, entries[i].state)) {
+            free(mf);
+            store_free(st);
+            return NULL;
+        }
+    }
+    int clean = mf->clean != 0;
+    free(mf);
+
+    /* ROUTING 먼저: 못 쓰면 세그먼트를 열면서 ID를 모은다 */
+    double t0 = now_ms();
+    int collect = !clean || route_open(st, writable) < 0;
+    int64_t** ids = NULL;
+    uint64_t* counts = NULL;
+    if (collect) {
+        ids = (int64_t**)calloc(st->segment_count ? st->segment_count : 1, sizeof(int64_t*));
+        counts = (uint64_t*)calloc(st->segment_count ? st->segment_count : 1, sizeof(uint64_t));
+    }
+
+    double t1 = now_ms();
+    int rc = (collect && (!ids || !counts)) ? -1 : open_segments(st, opt, collect, ids, counts);
+    double t2 = now_ms();
+    st->stats.open_ms = t2 - t1;
+
+    if (rc == 0 && collect) {
+        printf("[store] ROUTING not usable (%s), rebuilding from %u segments\n",
+               clean ? "missing / stale" : "unclean shutdown", st->segment_count);
+        rc = route_rebuild(st, ids, counts);
+    }
+    st->stats.route_ms = (t1 - t0) + (now_ms() - t2);
+    if (ids) {
+        for (uint32_t i = 0; i < st->segment_count; i++) free(ids[i]);
+    }
+    free(ids);
+    free(counts);
+
+    if (rc < 0 || (writable && manifest_save(st, 0) < 0)) {
+        store_free(st);
+        return NULL;
+    }
+
+    printf("[store] ✓ Opened '%s': %u segments, %lu records (%u threads, %.2f ms)\n",
+           dir, st->segment_count, (unsigned long)brain_store_count(st),
+           st->stats.threads, st->stats.open_ms);
+    return st;
+}
+
+void brain_store_close(brain_store_t* st) {
+    if (!st) return;
+
+    if (st->writable) {
+        for (uint32_t i = 0; i < st->segment_count; i++) {
+            brain_file_close(st->segments[i].bf);
+            st->segments[i].bf = NULL;
+        }
+        /* ROUTING을 다음 MANIFEST generation으로 표시 → 둘 다 디스크에 닿은 뒤 clean */
+        ((route_header_t*)st->route_mf->addr)->generation = st->generation + 1;
+        if (mmap_file_sync(st->route_mf) == 0) manifest_save(st, 1);
+    }
+    store_free(st);
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 레코드 API
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+brain_segment_t* brain_store_segment(const brain_store_t* st, uint32_t number) {
+    if (!st) return NULL;
+    uint32_t lo = 0, hi = st->segment_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (st->segments[mid].number < number) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < st->segment_count && st->segments[lo].number == number ? &st->segments[lo] : NULL;
+}
+
+/* 추가 대상 세그먼트 (이번 추가로 segment_size를 넘게 되면 봉인 후 새로)
+ * chunk가 2배씩 커지므로 넘은 뒤에 봉인하면 세그먼트가 segment_size보다 훨씬 커짐
+ * → 다음 할당 크기를 미리 보고 넘기 전에 넘김 (빈 세그먼트는 예외) */
+static brain_segment_t* active_segment(brain_store_t* st, uint32_t meta_len) {
+    if (st->segment_count > 0) {
+        brain_segment_t* last = &st->segments[st->segment_count - 1];
+        if (last->state == BRAIN_SEGMENT_ACTIVE) {
+            const brain_header_t* header = brain_file_header(last->bf);
+            if (header->record_count == 0 ||
+                header->file_size + brain_file_append_growth(last->bf, meta_len) <=
+                    st->segment_size) {
+                return last;
+            }
+            last->state = BRAIN_SEGMENT_SEALED;
+            st->stats.sealed++;
+        }
+    }
+
+    char path[STORE_PATH_MAX];
+    segment_path(st, st->next_number, path);
+    brain_file_t* bf = brain_file_create(path, st->dim, st->layout);
+    if (!bf) return NULL;
+
+    brain_segment_t* seg = segment_push(st, st->next_number, BRAIN_SEGMENT_ACTIVE);
+    if (!seg) {
+        brain_file_close(bf);
+        unlink(path);
+        return NULL;
+    }
+    seg->bf = bf;
+    st->next_number++;
+    if (manifest_save(st, 0) < 0) return NULL;
+    return seg;
+}
+
+int64_t brain_store_append(brain_store_t* st, int64_t id, const float* vector,
+                           const char* metadata, uint32_t meta_len, float importance) {
+    if (!st || !st->writable) return -1;
+
+    brain_segment_t* seg = active_segment(st, metadata ? meta_len : 0);
+    if (!seg) return -1;
+    uint32_t number = seg->number;
+
+    /* 새 사본을 먼저 → 중간에 끊기면 재구축이 큰 번호 쪽을 남김 */
+    int64_t prev = index_lookup(st->route, id);
+    if (brain_file_append(seg->bf, id, vector, metadata, meta_len, importance) < 0) return -1;
+    if (prev > 0 && (uint64_t)prev != (uint64_t)number + 1) {
+        brain_segment_t* older = brain_store_segment(st, (uint32_t)(prev - 1));
+        if (older) brain_file_delete(older->bf, id);
+    }
+    if ((uint64_t)prev != (uint64_t)number + 1 &&
+        index_insert(st->route, id, (uint64_t)number + 1) < 0) {
+        return -1;
+    }
+    return number;
+}
+
+int brain_store_get(const brain_store_t* st, int64_t id, brain_entry_t* out, uint32_t* segment) {
+    if (!st || !out) return -1;
+
+    int64_t v = index_lookup(st->route, id);
+    if (v <= 0) return -1;
+    const brain_segment_t* seg = brain_store_segment(st, (uint32_t)(v - 1));
+    if (!seg || brain_file_get(seg->bf, id, out) < 0) return -1;
+    if (segment) *segment = seg->number;
+    return 0;
+}
+
+int brain_store_delete(brain_store_t* st, int64_t id) {
+    if (!st || !st->writable) return -1;
+
+    int64_t v = index_lookup(st->route, id);
+    if (v <= 0) return -1;
+    brain_segment_t* seg = brain_store_segment(st, (uint32_t)(v - 1));
+    if (seg) brain_file_delete(seg->bf, id);
+    return index_delete(st->route, id);
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 세그먼트 단위 관리
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int brain_store_compact_segment(brain_store_t* st, uint32_t number) {
+    if (!st || !st->writable) return -1;
+    brain_segment_t* seg = brain_store_segment(st, number);
+    return seg ? brain_file_compact(seg->bf) : -1;
+}
+
+int brain_store_drop_segment(brain_store_t* st, uint32_t number) {
+    if (!st || !st->writable) return -1;
+    brain_segment_t* seg = brain_store_segment(st, number);
+    if (!seg) return -1;
+
+    /* 이 세그먼트를 가리키는 ID만 ROUTING에서 뺌 */
+    uint64_t count = 0;
+    int64_t* ids = segment_ids(seg->bf, &count);
+    if (!ids) return -1;
+    for (uint64_t k = 0; k < count; k++) {
+        if (index_lookup(st->route, ids[k]) == (int64_t)number + 1) index_delete(st->route, ids[k]);
+    }
+    free(ids);
+
+    char path[STORE_PATH_MAX], heat[STORE_PATH_MAX + 8];
+    segment_path(st, number, path);
+    snprintf(heat, sizeof(heat), "%s%s", path, BRAIN_HEAT_SUFFIX);
+    brain_file_close(seg->bf);
+
+    uint32_t i = (uint32_t)(seg - st->segments);
+    memmove(&st->segments[i], &st->segments[i + 1],
+            (st->segment_count - i - 1) * sizeof(brain_segment_t));
+    st->segment_count--;
+    st->stats.dropped++;
+
+    /* MANIFEST에서 먼저 빼고 파일 삭제 (끊기면 남는 건 고아 파일뿐) */
+    int rc = manifest_save(st, 0);
+    unlink(path);
+    unlink(heat);
+    return rc;
+}
+
+int brain_store_sync(brain_store_t* st) {
+    if (!st || !st->writable) return -1;
+
+    int rc = 0;
+    for (uint32_t i = 0; i < st->segment_count; i++) {
+        if (brain_file_checkpoint(st->segments[i].bf) < 0) rc = -1;
+    }
+    if (mmap_file_sync(st->route_mf) < 0) rc = -1;
+    if (manifest_save(st, 0) < 0) rc = -1;
+    return rc;
+}
+
+uint64_t brain_store_count(const brain_store_t* st) {
+    if (!st) return 0;
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < st->segment_count; i++) {
+        if (st->segments[i].bf) total += brain_file_count(st->segments[i].bf);
+    }
+    return total;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_store_stats
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+void brain_store_stats(const brain_store_t* st) {
+    if (!st) return;
+
+    const brain_store_stats_t* s = &st->stats;
+    printf("[store] '%s': %u segments (%.1f MB each), %lu records, %u routed ids, generation %lu\n",
+           st->dir, st->segment_count, st->segment_size / 1024.0 / 1024.0,
+           (unsigned long)brain_store_count(st), index_count(st->route),
+           (unsigned long)st->generation);
+    printf("[store]   Open: %u threads, %.2f ms segments, %.2f ms routing%s (%lu duplicates)\n",
+           s->threads, s->open_ms, s->route_ms, s->route_rebuilt ? " rebuilt" : "",
+           (unsigned long)s->duplicates);
+    printf("[store]   Session: %u sealed, %u dropped\n", s->sealed, s->dropped);
+    for (uint32_t i = 0; i < st->segment_count; i++) {
+        const brain_segment_t* seg = &st->segments[i];
+        printf("    " BRAIN_STORE_SEGMENT_FMT "  %-6s  %8lu live  %8.1f MB\n", seg->number,
+               seg->state == BRAIN_SEGMENT_ACTIVE ? "active" : "sealed",
+               (unsigned long)brain_file_count(seg->bf),
+               brain_file_header(seg->bf)->file_size / 1024.0 / 1024.0);
+    }
+}
@@ -0,0 +1,145 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_store.h
+ *
+ * 세그먼트 저장소: 디렉터리 하나 = 고정 크기 Brain 파일 여러 개 + MANIFEST
+ *
+ *   dir/MANIFEST           세그먼트 목록 (임시 파일 → rename, CRC32C)
+ *   dir/ROUTING            ID → 세그먼트 번호 (index_manager 테이블, 파생 데이터)
+ *   dir/seg-000000.brain   v2 Brain 파일 (자기 ID 인덱스 포함)
+ *
+ * 추가는 마지막 (ACTIVE) 세그먼트에만. 이번 추가의 할당 (새 chunk / heap extent /
+ * 인덱스 테이블)이 파일을 segment_size 넘게 키우면 그 전에 SEALED로 바꾸고
+ * 새 세그먼트를 만든다 (파일 크기 ≤ segment_size, 첫 chunk가 더 큰 경우만 예외)
+ * → 파일 하나의 크기 / 레코드 수 한계 (vector_count uint32 등) 없이 커지고,
+ * 세그먼트마다 따로
+ *   - 열기 / 검증 / 예열 (brain_store_open이 스레드로 나눠 병렬 진행)
+ *   - 컴팩션 (brain_store_compact_segment)
+ *   - 통째로 버리기 (brain_store_drop_segment)
+ *
+ * ID 위치 = (ROUTING의 세그먼트, 그 세그먼트 ID 인덱스의 레코드).
+ * ROUTING에는 세그먼트까지만 두므로 세그먼트 컴팩션이 레코드를 옮겨도
+ * ROUTING은 그대로다.
+ *
+ * 덮어쓰기 = ACTIVE에 추가 → 이전 세그먼트에서 삭제 (이 순서).
+ * 정상 종료가 아니면 (MANIFEST clean = 0) 열 때 세그먼트들에서 ROUTING을
+ * 다시 만들고, 같은 ID가 두 세그먼트에 살아 있으면 번호가 큰 쪽을 남긴다.
+ *
+ * 동시성: brain_file과 같음. 조회끼리는 동시에 돌아도 되지만 변경 (추가 / 삭제 /
+ * 컴팩션 / 재해시)과는 호출자의 같은 잠금으로 배타 (읽기/쓰기 잠금이면 조회 = 읽기)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#ifndef BRAIN_STORE_H
+#define BRAIN_STORE_H
+
+#include "brain_file.h"
+#include <stdint.h>
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Configuration
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#define BRAIN_STORE_SEGMENT_SIZE    (1024ULL * 1024 * 1024)     /* 기본 세그먼트 크기 */
+#define BRAIN_STORE_SEGMENT_MIN     (1024 * 1024)
+#define BRAIN_STORE_MAX_THREADS     64
+#define BRAIN_STORE_ROUTE_LOG2      16      /* 새 ROUTING 테이블 (이후 점진적 재해시) */
+
+#define BRAIN_STORE_MANIFEST        "MANIFEST"
+#define BRAIN_STORE_ROUTING         "ROUTING"
+#define BRAIN_STORE_SEGMENT_FMT     "seg-%06u.brain"
+
+typedef enum {
+    BRAIN_SEGMENT_ACTIVE = 1,       /* 추가 대상 (항상 마지막 하나) */
+    BRAIN_SEGMENT_SEALED = 2        /* 크기 도달, 삭제 / 컴팩션만 */
+} brain_segment_state_t;
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Data Structures
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+typedef struct {
+    uint32_t      number;           /* 파일 이름 번호 (버려도 재사용 안 함) */
+    uint32_t      state;            /* brain_segment_state_t */
+    brain_file_t* bf;
+} brain_segment_t;
+
+/* 열기 옵션 (세그먼트마다 적용, threads개 스레드가 나눠 진행) */
+typedef struct {
+    uint32_t            threads;    /* 0 = 온라인 CPU 수 */
+    uint32_t            flags;      /* brain_file_open_ex 옵션 (BRAIN_OPEN_*) */
+    brain_verify_mode_t verify;     /* brain_file_set_verify (FIRST_TOUCH = 열 때 인덱스 검사) */
+} brain_store_options_t;
+
+typedef struct {
+    uint32_t threads;               /* 열기에 쓴 스레드 */
+    double   open_ms;               /* 세그먼트 열기 / 검증 / 예열 (병렬 구간) */
+    double   route_ms;              /* ROUTING 열기 또는 재구축 */
+    int      route_rebuilt;         /* 정상 종료가 아니라서 다시 만듦 */
+    uint64_t duplicates;            /* 재구축 때 지운 이전 세그먼트 사본 */
+    uint32_t sealed;                /* 이번 세션에 봉인한 세그먼트 */
+    uint32_t dropped;
+} brain_store_stats_t;
+
+typedef struct brain_store_t {
+    char*            dir;
+    uint32_t         dim;
+    index_layout_t   layout;
+    uint64_t         segment_size;
+    int              writable;
+    uint32_t         flags;         /* 새 세그먼트에도 적용할 BRAIN_OPEN_* */
+
+    brain_segment_t* segments;      /* 번호 순 */
+    uint32_t         segment_count;
+    uint32_t         segment_capacity;
+    uint32_t         next_number;
+    uint64_t         generation;    /* MANIFEST 저장 횟수 (ROUTING과 짝) */
+
+    mmap_file_t*     route_mf;
+    brain_index_t*   route;         /* ID → 세그먼트 번호 + 1 */
+
+    brain_store_stats_t stats;
+} brain_store_t;
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Functions
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 새 저장소 (디렉터리가 없으면 만듦, 이미 MANIFEST가 있으면 실패)
+ * segment_size = 0이면 BRAIN_STORE_SEGMENT_SIZE */
+brain_store_t* brain_store_create(const char* dir, uint32_t dim, index_layout_t layout,
+                                  uint64_t segment_size);
+
+/* 기존 저장소 열기 (opt = NULL이면 기본값) */
+brain_store_t* brain_store_open(const char* dir, int writable, const brain_store_options_t* opt);
+
+/* 닫기 (세그먼트 / ROUTING 동기화 후 MANIFEST clean 표시) */
+void brain_store_close(brain_store_t* st);
+
+/* 레코드 추가 (기존 ID면 교체). 리턴: 들어간 세그먼트 번호, -1 = 실패 */
+int64_t brain_store_append(brain_store_t* st, int64_t id, const float* vector,
+                           const char* metadata, uint32_t meta_len, float importance);
+
+/* ID로 조회 (segment = NULL 가능). 리턴: 0 = 찾음, -1 = 없음 */
+int brain_store_get(const brain_store_t* st, int64_t id, brain_entry_t* out, uint32_t* segment);
+
+/* ID 삭제 (0 = 성공, -1 = 없음) */
+int brain_store_delete(brain_store_t* st, int64_t id);
+
+/* 번호로 세그먼트 찾기 (NULL = 없음) */
+brain_segment_t* brain_store_segment(const brain_store_t* st, uint32_t number);
+
+/* 세그먼트 하나만 컴팩션 (다른 세그먼트 조회 / 추가와 무관) */
+int brain_store_compact_segment(brain_store_t* st, uint32_t number);
+
+/* 세그먼트 통째로 버림 (그 세그먼트에 있던 ID는 사라짐, 파일 삭제) */
+int brain_store_drop_segment(brain_store_t* st, uint32_t number);
+
+/* 모든 세그먼트 + ROUTING 동기화, MANIFEST 저장 (clean 표시는 안 함) */
+int brain_store_sync(brain_store_t* st);
+
+/* 살아 있는 레코드 수 (세그먼트 합) */
+uint64_t brain_store_count(const brain_store_t* st);
+
+/* 통계 출력 */
+void brain_store_stats(const brain_store_t* st);
+
+#endif /* BRAIN_STORE_H */
@@ -0,0 +1,484 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_wal.c
+ *
+ * Write-Ahead Log + 그룹 커밋
+ *
+ * 쓰기 경로:
+ *   - brain_wal_log: 잠금 안에서 버퍼 끝에 레코드 복사 (LSN 발급)
+ *   - brain_wal_commit: 첫 커밋이 리더 → window_us 동안 더 모은 뒤
+ *     버퍼를 spare와 바꿔 잠금 밖에서 pwrite + fdatasync
+ *     → 그동안 다른 스레드는 새 버퍼에 계속 로그
+ *
+ * 열기:
+ *   - 로그 전체를 읽어 헤더 / 스냅샷 / 레코드 CRC와 LSN 연속성 검사
+ *   - 첫 손상 레코드부터는 쓰다 만 꼬리 → 잘라냄
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* fdatasync, pread/pwrite, clock_gettime 선언을 위해 필요 */
+#define _POSIX_C_SOURCE 200809L
+
+#include "brain_wal.h"
+#include "brain_crc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define WAL_ALIGN(x)    (((uint64_t)(x) + 7) & ~(uint64_t)7)
+#define WAL_DATA(len)   (sizeof(brain_wal_header_t) + WAL_ALIGN(len))
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 내부 헬퍼
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+static int write_all(int fd, const void* data, size_t len, uint64_t offset) {
+    const char* p = (const char*)data;
+    while (len > 0) {
+        ssize_t n = pwrite(fd, p, len, (off_t)offset);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+        offset += (uint64_t)n;
+    }
+    return 0;
+}
+
+static void header_init(brain_wal_header_t* h, uint64_t lsn, const void* snapshot, uint32_t len) {
+    memset(h, 0, sizeof(*h));
+    h->magic = BRAIN_WAL_MAGIC;
+    h->version = BRAIN_WAL_VERSION;
+    h->checkpoint_lsn = lsn;
+    h->snap_len = len;
+    h->snap_crc = brain_crc32c(0, snapshot, len);
+    h->header_crc = brain_crc32c(0, h, offsetof(brain_wal_header_t, header_crc));
+}
+
+static uint32_t record_crc(const brain_wal_record_t* r) {
+    return brain_crc32c(0, &r->len, sizeof(*r) - offsetof(brain_wal_record_t, len) + r->len);
+}
+
+/* 새 로그 파일 내용 [헤더][스냅샷] 을 path에 쓰고 내구화 */
+static int write_base(const char* path, const void* snapshot, uint32_t len, uint64_t lsn) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return -1;
+
+    brain_wal_header_t h;
+    header_init(&h, lsn, snapshot, len);
+
+    static const char zero[8] = {0};
+    int rc = write_all(fd, &h, sizeof(h), 0);
+    if (rc == 0 && len > 0) rc = write_all(fd, snapshot, len, sizeof(h));
+    if (rc == 0 && WAL_ALIGN(len) > len) {
+        rc = write_all(fd, zero, WAL_ALIGN(len) - len, sizeof(h) + len);
+    }
+    if (rc == 0) rc = fdatasync(fd);
+    close(fd);
+    return rc;
+}
+
+/* rename이 디스크에 남도록 디렉터리도 sync */
+static void sync_dir(const char* path) {
+    char dir[4096];
+    const char* slash = strrchr(path, '/');
+    if (!slash) {
+        strcpy(dir, ".");
+    } else {
+        size_t n = (size_t)(slash - path);
+        if (n == 0) n = 1;
+        if (n >= sizeof(dir)) return;
+        memcpy(dir, path, n);
+        dir[n] = '\0';
+    }
+
+    int fd = open(dir, O_RDONLY);
+    if (fd < 0) return;
+    fsync(fd);
+    close(fd);
+}
+
+static int read_image(brain_wal_t* wal) {
+    struct stat st;
+    if (fstat(wal->fd, &st) < 0) return -1;
+    if (st.st_size == 0) return 0;
+
+    wal->image = (char*)malloc((size_t)st.st_size);
+    if (!wal->image) return -1;
+
+    size_t done = 0;
+    while (done < (size_t)st.st_size) {
+        ssize_t n = pread(wal->fd, wal->image + done, (size_t)st.st_size - done, (off_t)done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        done += (size_t)n;
+    }
+    wal->image_len = done;
+    return 0;
+}
+
+/* 헤더 / 스냅샷 검사 후 온전한 레코드 끝까지 스캔 */
+static int scan_image(brain_wal_t* wal) {
+    const brain_wal_header_t* h = (const brain_wal_header_t*)wal->image;
+    if (wal->image_len < sizeof(*h) || h->magic != BRAIN_WAL_MAGIC ||
+        h->version != BRAIN_WAL_VERSION ||
+        h->header_crc != brain_crc32c(0, h, offsetof(brain_wal_header_t, header_crc)) ||
+        WAL_DATA(h->snap_len) > wal->image_len ||
+        h->snap_crc != brain_crc32c(0, wal->image + sizeof(*h), h->snap_len)) {
+        fprintf(stderr, "[wal] Error: '%s' has a damaged header or snapshot\n", wal->path);
+        return -1;
+    }
+
+    wal->checkpoint_lsn = h->checkpoint_lsn;
+    uint64_t expect = h->checkpoint_lsn + 1;
+    size_t off = WAL_DATA(h->snap_len);
+
+    while (off + sizeof(brain_wal_record_t) <= wal->image_len) {
+        const brain_wal_record_t* r = (const brain_wal_record_t*)(wal->image + off);
+        if (r->len > BRAIN_WAL_MAX_RECORD || r->lsn != expect ||
+            off + sizeof(*r) + WAL_ALIGN(r->len) > wal->image_len ||
+            r->crc != record_crc(r)) break;
+
+        off += sizeof(*r) + WAL_ALIGN(r->len);
+        expect++;
+    }
+
+    wal->replay_end = off;
+    wal->replay_count = expect - 1 - h->checkpoint_lsn;
+    wal->next_lsn = expect;
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_wal_open / brain_wal_close
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+brain_wal_t* brain_wal_open(const char* path, uint32_t window_us) {
+    if (!path) return NULL;
+
+    brain_wal_t* wal = (brain_wal_t*)calloc(1, sizeof(brain_wal_t));
+    if (!wal) return NULL;
+    wal->fd = -1;
+    wal->path = strdup(path);
+    wal->window_us = window_us;
+    pthread_mutex_init(&wal->lock, NULL);
+    pthread_cond_init(&wal->done, NULL);
+    pthread_cond_init(&wal->full, NULL);
+
+    if (wal->path) wal->fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (wal->fd < 0 || read_image(wal) < 0) {
+        fprintf(stderr, "[wal] Error: cannot open '%s': %s\n", path, strerror(errno));
+        brain_wal_close(wal);
+        return NULL;
+    }
+
+    if (!wal->image) {
+        /* 새 로그: 빈 스냅샷으로 시작 (호출자가 곧 체크포인트) */
+        if (write_base(path, NULL, 0, 0) < 0) {
+            brain_wal_close(wal);
+            return NULL;
+        }
+        wal->next_lsn = 1;
+        wal->size = WAL_DATA(0);
+    } else {
+        if (scan_image(wal) < 0) {
+            brain_wal_close(wal);
+            return NULL;
+        }
+        if (wal->replay_end < wal->image_len) {
+            printf("[wal] ⚠ Discarded %zu torn bytes at the end of '%s'\n",
+                   wal->image_len - wal->replay_end, path);
+            if (ftruncate(wal->fd, (off_t)wal->replay_end) < 0 || fdatasync(wal->fd) < 0) {
+                brain_wal_close(wal);
+                return NULL;
+            }
+        }
+        wal->size = wal->replay_end;
+    }
+    wal->durable_lsn = wal->next_lsn - 1;
+
+    printf("[wal] ✓ Opened '%s' (checkpoint LSN %lu, %lu records to replay)\n",
+           path, (unsigned long)wal->checkpoint_lsn, (unsigned long)wal->replay_count);
+    return wal;
+}
+
+void brain_wal_close(brain_wal_t* wal) {
+    if (!wal) return;
+
+    if (wal->fd >= 0 && wal->len > 0) brain_wal_flush(wal);
+    if (wal->fd >= 0) close(wal->fd);
+
+    pthread_cond_destroy(&wal->full);
+    pthread_cond_destroy(&wal->done);
+    pthread_mutex_destroy(&wal->lock);
+    free(wal->image);
+    free(wal->buf);
+    free(wal->spare);
+    free(wal->path);
+    free(wal);
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 스냅샷 / 재생
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int brain_wal_has_snapshot(const brain_wal_t* wal) {
+    return wal && wal->image &&
+           ((const brain_wal_header_t*)wal->image)->snap_len > 0;
+}
+
+const void* brain_wal_snapshot(const brain_wal_t* wal, uint32_t* len) {
+    if (!brain_wal_has_snapshot(wal)) return NULL;
+    if (len) *len = ((const brain_wal_header_t*)wal->image)->snap_len;
+    return wal->image + sizeof(brain_wal_header_t);
+}
+
+uint64_t brain_wal_replay_count(const brain_wal_t* wal) {
+    return wal && wal->image ? wal->replay_count : 0;
+}
+
+int brain_wal_replay(brain_wal_t* wal, brain_wal_replay_fn fn, void* ctx) {
+    if (!wal) return -1;
+
+    int rc = 0;
+    if (wal->image && fn) {
+        size_t off = WAL_DATA(((const brain_wal_header_t*)wal->image)->snap_len);
+        while (off < wal->replay_end) {
+            const brain_wal_record_t* r = (const brain_wal_record_t*)(wal->image + off);
+            if (fn(ctx, r->lsn, r->type, r + 1, r->len) < 0) {
+                rc = -1;
+                break;
+            }
+            off += sizeof(*r) + WAL_ALIGN(r->len);
+        }
+    }
+
+    free(wal->image);
+    wal->image = NULL;
+    wal->image_len = 0;
+    wal->replay_end = 0;
+    return rc;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_wal_log
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int brain_wal_log(brain_wal_t* wal, uint32_t type, const struct iovec* iov, int iovcnt,
+                  uint64_t* lsn) {
+    if (!wal || !lsn) return -1;
+
+    size_t len = 0;
+    for (int i = 0; i < iovcnt; i++) len += iov[i].iov_len;
+    if (len > BRAIN_WAL_MAX_RECORD) return -1;
+    size_t total = sizeof(brain_wal_record_t) + WAL_ALIGN(len);
+
+    pthread_mutex_lock(&wal->lock);
+    if (wal->failed) {
+        pthread_mutex_unlock(&wal->lock);
+        return -1;
+    }
+
+    if (wal->len + total > wal->cap) {
+        size_t cap = wal->cap ? wal->cap : 64 * 1024;
+        while (cap < wal->len + total) cap *= 2;
+        char* buf = (char*)realloc(wal->buf, cap);
+        if (!buf) {
+            pthread_mutex_unlock(&wal->lock);
+            return -1;
+        }
+        wal->buf = buf;
+        wal->cap = cap;
+    }
+
+    brain_wal_record_t* r = (brain_wal_record_t*)(wal->buf + wal->len);
+    r->len = (uint32_t)len;
+    r->lsn = wal->next_lsn++;
+    r->type = type;
+    r->reserved = 0;
+
+    char* p = (char*)(r + 1);
+    for (int i = 0; i < iovcnt; i++) {
+        memcpy(p, iov[i].iov_base, iov[i].iov_len);
+        p += iov[i].iov_len;
+    }
+    memset(p, 0, WAL_ALIGN(len) - len);
+    r->crc = record_crc(r);
+
+    *lsn = r->lsn;
+    wal->len += total;
+    wal->pending++;
+    wal->stats.records++;
+    if (wal->len >= BRAIN_WAL_GROUP_BYTES) pthread_cond_signal(&wal->full);
+
+    pthread_mutex_unlock(&wal->lock);
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_wal_commit (그룹 커밋)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 리더: 잠금을 쥔 채 호출, 버퍼 한 묶음을 내구화하고 돌아옴 */
+static void lead_group(brain_wal_t* wal) {
+    wal->syncing = 1;
+
+    if (wal->window_us > 0 && wal->len < BRAIN_WAL_GROUP_BYTES) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += (long)wal->window_us * 1000;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+        deadline.tv_nsec %= 1000000000L;
+
+        while (wal->len < BRAIN_WAL_GROUP_BYTES &&
+               pthread_cond_timedwait(&wal->full, &wal->lock, &deadline) != ETIMEDOUT) {}
+    }
+
+    /* 버퍼 교체 → 잠금 밖에서 쓰는 동안 다른 스레드는 계속 로그 */
+    char* data = wal->buf;
+    size_t data_cap = wal->cap;
+    size_t len = wal->len;
+    uint64_t count = wal->pending;
+    uint64_t target = wal->next_lsn - 1;
+    uint64_t offset = wal->size;
+
+    wal->buf = wal->spare;
+    wal->cap = wal->spare_cap;
+    wal->spare = NULL;
+    wal->spare_cap = 0;
+    wal->len = 0;
+    wal->pending = 0;
+    pthread_mutex_unlock(&wal->lock);
+
+    int rc = 0;
+    if (len > 0) rc = write_all(wal->fd, data, len, offset);
+    if (rc == 0) rc = fdatasync(wal->fd);
+
+    pthread_mutex_lock(&wal->lock);
+    wal->spare = data;
+    wal->spare_cap = data_cap;
+    if (rc < 0) {
+        fprintf(stderr, "[wal] Error: write/fdatasync failed: %s\n", strerror(errno));
+        wal->failed = 1;
+    } else {
+        wal->durable_lsn = target;
+        wal->size = offset + len;
+        wal->stats.syncs++;
+        wal->stats.bytes += len;
+        if (count > wal->stats.max_group) wal->stats.max_group = count;
+    }
+    wal->syncing = 0;
+    pthread_cond_broadcast(&wal->done);
+}
+
+int brain_wal_commit(brain_wal_t* wal, uint64_t lsn) {
+    if (!wal) return -1;
+
+    pthread_mutex_lock(&wal->lock);
+    wal->stats.commits++;
+    while (wal->durable_lsn < lsn && !wal->failed) {
+        if (wal->syncing) {
+            pthread_cond_wait(&wal->done, &wal->lock);
+        } else {
+            lead_group(wal);
+        }
+    }
+    int rc = wal->failed ? -1 : 0;
+    pthread_mutex_unlock(&wal->lock);
+    return rc;
+}
+
+int brain_wal_flush(brain_wal_t* wal) {
+    return brain_wal_commit(wal, brain_wal_last_lsn(wal));
+}
+
+uint64_t brain_wal_last_lsn(brain_wal_t* wal) {
+    return brain_wal_next_lsn(wal) - 1;
+}
+
+uint64_t brain_wal_next_lsn(brain_wal_t* wal) {
+    if (!wal) return 1;
+    pthread_mutex_lock(&wal->lock);
+    uint64_t lsn = wal->next_lsn;
+    pthread_mutex_unlock(&wal->lock);
+    return lsn;
+}
+
+uint64_t brain_wal_size(brain_wal_t* wal) {
+    if (!wal) return 0;
+    pthread_mutex_lock(&wal->lock);
+    uint64_t size = wal->size + wal->len;
+    pthread_mutex_unlock(&wal->lock);
+    return size;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_wal_reset (체크포인트)
+ *
+ * [헤더][스냅샷]을 임시 파일에 쓰고 rename → 어느 순간에 끊겨도
+ * 이전 로그 또는 새 로그 중 하나가 온전히 남는다.
+ * lsn 이후에 로그된 레코드는 버퍼에 남아 새 로그 뒤에 이어 쓰인다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int brain_wal_reset(brain_wal_t* wal, const void* snapshot, uint32_t snap_len, uint64_t lsn) {
+    if (!wal) return -1;
+
+    pthread_mutex_lock(&wal->lock);
+    while (wal->syncing) pthread_cond_wait(&wal->done, &wal->lock);
+
+    if (wal->failed || lsn != wal->durable_lsn) {
+        pthread_mutex_unlock(&wal->lock);
+        return -1;
+    }
+
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", wal->path);
+    int fd = -1;
+    if (write_base(tmp, snapshot, snap_len, lsn) < 0 || rename(tmp, wal->path) < 0 ||
+        (fd = open(wal->path, O_RDWR)) < 0) {
+        fprintf(stderr, "[wal] Error: checkpoint of '%s' failed: %s\n",
+                wal->path, strerror(errno));
+        unlink(tmp);
+        pthread_mutex_unlock(&wal->lock);
+        return -1;
+    }
+    sync_dir(wal->path);
+
+    close(wal->fd);
+    wal->fd = fd;
+    wal->size = WAL_DATA(snap_len);
+    wal->checkpoint_lsn = lsn;
+    wal->stats.checkpoints++;
+
+    free(wal->image);
+    wal->image = NULL;
+    wal->image_len = 0;
+    wal->replay_end = 0;
+    wal->replay_count = 0;
+
+    pthread_mutex_unlock(&wal->lock);
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_wal_stats
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+void brain_wal_stats(brain_wal_t* wal) {
+    if (!wal) return;
+
+    pthread_mutex_lock(&wal->lock);
+    brain_wal_stats_t s = wal->stats;
+    uint64_t size = wal->size;
+    uint64_t lsn = wal->durable_lsn;
+    pthread_mutex_unlock(&wal->lock);
+
+    printf("[wal] Stats:\n");
+    printf("  Records:       %lu logged, durable through LSN %lu\n",
+           (unsigned long)s.records, (unsigned long)lsn);
+    printf("  Group commit:  %lu commits / %lu fdatasync (%.1f per sync, max group %lu)\n",
+           (unsigned long)s.commits, (unsigned long)s.syncs,
+           s.syncs ? (double)s.commits / s.syncs : 0.0, (unsigned long)s.max_group);
+    printf("  Log:           %lu bytes written, %lu bytes on disk, %lu checkpoints\n",
+           (unsigned long)s.bytes, (unsigned long)size, (unsigned long)s.checkpoints);
+}
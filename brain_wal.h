@@ -0,0 +1,174 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_wal.h
+ *
+ * Write-Ahead Log (추가 전용 로그 + 그룹 커밋)
+ *
+ * 저장 1건 = 로그 파일 끝에 순차 쓰기 1번.
+ * 여러 스레드의 커밋은 리더 1개가 모아서 fdatasync 1번으로 끝낸다.
+ *
+ * 파일 구조:
+ *   [Header 64B] [스냅샷 (체크포인트 시점 Brain 헤더 + 디렉터리)]
+ *   [Record: 24B 헤더 + payload (8B 정렬)] ...
+ *
+ *   - 체크포인트 = 새 로그를 임시 파일에 쓰고 rename (항상 온전한 로그 하나)
+ *   - 레코드마다 CRC32C → 잘린 꼬리는 열 때 버린다
+ *   - LSN은 체크포인트 LSN + 1부터 빈틈없이 증가
+ *
+ * 그룹 커밋:
+ *   brain_wal_log    메모리 버퍼에 추가 (LSN 발급, 디스크 접근 없음)
+ *   brain_wal_commit 해당 LSN이 내구화될 때까지 대기
+ *                    - 진행 중인 sync가 없으면 리더가 되어 window_us 동안
+ *                      다른 커밋을 기다린 뒤 버퍼 전체를 write + fdatasync
+ *                    - 있으면 그 결과를 기다림
+ *
+ * Zero Dependency: POSIX (pthread, fdatasync)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#ifndef BRAIN_WAL_H
+#define BRAIN_WAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <sys/uio.h>
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Configuration
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#define BRAIN_WAL_MAGIC         0x4C415742  /* "BWAL" (리틀 엔디안) */
+#define BRAIN_WAL_VERSION       1
+#define BRAIN_WAL_GROUP_US      200         /* 기본 그룹 커밋 대기 (마이크로초) */
+#define BRAIN_WAL_GROUP_BYTES   (1024 * 1024)   /* 버퍼가 이만큼 차면 대기 없이 sync */
+#define BRAIN_WAL_MAX_RECORD    (64 * 1024 * 1024)
+
+/* 레코드 종류 (brain_file이 정의, 0은 예약) */
+#define BRAIN_WAL_BEGIN         1           /* 체크포인트 후 첫 변경 표시 (payload 없음) */
+#define BRAIN_WAL_PUT           2           /* brain_file_append */
+#define BRAIN_WAL_DELETE        3           /* brain_file_delete */
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 디스크 구조
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+typedef struct {
+    uint32_t magic;             /* BRAIN_WAL_MAGIC */
+    uint32_t version;
+    uint64_t checkpoint_lsn;    /* 스냅샷에 반영된 마지막 LSN */
+    uint32_t snap_len;          /* 스냅샷 바이트 */
+    uint32_t snap_crc;          /* 스냅샷 CRC32C */
+    uint32_t header_crc;        /* 이 필드 앞까지의 CRC32C */
+    uint8_t  reserved[36];
+} brain_wal_header_t;
+
+_Static_assert(sizeof(brain_wal_header_t) == 64, "WAL header must be 64 bytes");
+
+typedef struct {
+    uint32_t crc;               /* len 이후 헤더 + payload의 CRC32C */
+    uint32_t len;               /* payload 바이트 (정렬 전) */
+    uint64_t lsn;
+    uint32_t type;              /* BRAIN_WAL_* */
+    uint32_t reserved;
+} brain_wal_record_t;
+
+_Static_assert(sizeof(brain_wal_record_t) == 24, "WAL record header must be 24 bytes");
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_wal_t
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+typedef struct {
+    uint64_t records;           /* 로그한 레코드 */
+    uint64_t commits;           /* brain_wal_commit 호출 */
+    uint64_t syncs;             /* fdatasync 횟수 (그룹 수) */
+    uint64_t bytes;             /* 쓴 바이트 */
+    uint64_t max_group;         /* 한 번의 sync로 내구화된 최대 레코드 수 */
+    uint64_t checkpoints;
+} brain_wal_stats_t;
+
+typedef struct brain_wal_t {
+    int       fd;
+    char*     path;
+    uint32_t  window_us;        /* 그룹 커밋 대기 */
+
+    pthread_mutex_t lock;
+    pthread_cond_t  done;       /* sync 완료 → 대기 중인 커밋 */
+    pthread_cond_t  full;       /* 버퍼가 GROUP_BYTES 도달 → 대기 중인 리더 */
+
+    /* 로그했지만 아직 쓰지 않은 레코드 (리더가 쓰는 동안 spare와 교체) */
+    char*     buf;
+    size_t    len;
+    size_t    cap;
+    char*     spare;
+    size_t    spare_cap;
+    uint64_t  pending;          /* buf 안 레코드 수 */
+
+    uint64_t  next_lsn;         /* 다음 발급 LSN */
+    uint64_t  durable_lsn;      /* fdatasync가 끝난 마지막 LSN */
+    uint64_t  checkpoint_lsn;
+    uint64_t  size;             /* 디스크의 로그 크기 */
+    int       syncing;          /* 리더가 쓰는 중 */
+    int       failed;           /* 쓰기 실패 → 이후 커밋은 모두 -1 */
+
+    /* 열 때 읽은 로그 (brain_wal_replay 후 해제) */
+    char*     image;
+    size_t    image_len;
+    size_t    replay_end;       /* 온전한 레코드의 끝 */
+    uint64_t  replay_count;
+
+    brain_wal_stats_t stats;
+} brain_wal_t;
+
+/* 재생 콜백 (0 = 계속, -1 = 중단) */
+typedef int (*brain_wal_replay_fn)(void* ctx, uint64_t lsn, uint32_t type,
+                                   const void* payload, uint32_t len);
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 함수 선언
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 열기 (없으면 생성). 잘린 꼬리는 잘라내고, 재생할 레코드는 메모리에 보관
+ * 리턴: NULL = 실패 (헤더 손상 포함) */
+brain_wal_t* brain_wal_open(const char* path, uint32_t window_us);
+
+/* 닫기 (남은 버퍼는 커밋) */
+void brain_wal_close(brain_wal_t* wal);
+
+/* 스냅샷이 있는가 (0 = 새 로그, 체크포인트 필요) */
+int brain_wal_has_snapshot(const brain_wal_t* wal);
+
+/* 열 때 읽은 스냅샷 (NULL = 없음) */
+const void* brain_wal_snapshot(const brain_wal_t* wal, uint32_t* len);
+
+/* 재생할 레코드 수 (0 = 체크포인트 이후 변경 없음) */
+uint64_t brain_wal_replay_count(const brain_wal_t* wal);
+
+/* 스냅샷 이후 레코드를 순서대로 재생하고 읽은 로그 해제 */
+int brain_wal_replay(brain_wal_t* wal, brain_wal_replay_fn fn, void* ctx);
+
+/* 레코드 추가 (payload = iov 이어 붙임, 발급한 LSN → *lsn)
+ * 리턴: 0 = 성공, -1 = 실패 (너무 큰 레코드 / 메모리 부족 / 이전 쓰기 실패) */
+int brain_wal_log(brain_wal_t* wal, uint32_t type, const struct iovec* iov, int iovcnt,
+                  uint64_t* lsn);
+
+/* lsn까지 내구화 (그룹 커밋, 스레드 안전) */
+int brain_wal_commit(brain_wal_t* wal, uint64_t lsn);
+
+/* 지금까지 로그한 레코드 모두 내구화 */
+int brain_wal_flush(brain_wal_t* wal);
+
+/* 마지막 발급 LSN / 다음 발급 LSN */
+uint64_t brain_wal_last_lsn(brain_wal_t* wal);
+uint64_t brain_wal_next_lsn(brain_wal_t* wal);
+
+/* 로그 크기 (헤더 + 스냅샷 + 레코드) */
+uint64_t brain_wal_size(brain_wal_t* wal);
+
+/* 체크포인트: 스냅샷 + lsn으로 새 로그 시작 (이전 레코드 폐기)
+ * 호출 전에 lsn까지의 변경이 데이터 파일에 내구화되어 있어야 한다. */
+int brain_wal_reset(brain_wal_t* wal, const void* snapshot, uint32_t snap_len, uint64_t lsn);
+
+/* 통계 출력 */
+void brain_wal_stats(brain_wal_t* wal);
+
+#endif /* BRAIN_WAL_H */
@@ -154,14 +154,14 @@ int main(void) {
         printf("      ▸ Searching Hippocampus...\n");
         printf("      ▸ Top 2 results:\n\n");
 
-        char** results = brain_recall(brain, queries[q], 2);
+        hippocampus_recall_t results;
 
-        if (results) {
-            for (int i = 0; results[i] != NULL; i++) {
-                printf("         [%d] %s\n", i + 1, results[i]);
-                free(results[i]);
+        if (brain_recall(brain, queries[q], 2, &results) >= 0) {
+            for (uint32_t i = 0; i < results.count; i++) {
+                printf("         [%u] %.*s\n", i + 1,
+                       (int)results.items[i].content_len, results.items[i].content);
             }
-            free(results);
+            brain_recall_release(&results);
         }
 
         printf("\n");
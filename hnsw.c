@@ -4,14 +4,19 @@
  * HNSW Implementation
  *
  * Zero Dependency: stdlib + math.h만 사용
+ * 거리 계산: vec_kernels.c (SIMD 런타임 디스패치)
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "hnsw.h"
+#include "vec_kernels.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <float.h>
+#include <unistd.h>
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * Cosine Distance (1 - Cosine Similarity)
@@ -19,22 +24,13 @@
  * 거리가 작을수록 유사함
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 float hnsw_distance(const float* a, const float* b, uint32_t dim) {
-    float dot = 0.0f;
-    float norm_a = 0.0f;
-    float norm_b = 0.0f;
-
-    for (uint32_t i = 0; i < dim; i++) {
-        dot += a[i] * b[i];
-        norm_a += a[i] * a[i];
-        norm_b += b[i] * b[i];
-    }
-
-    if (norm_a == 0.0f || norm_b == 0.0f) {
-        return 1.0f;  /* Undefined → 최대 거리 */
-    }
+    return vec_cosine_distance(a, b, dim);  /* SIMD 커널 (vec_kernels.c) */
+}
 
-    float cosine = dot / (sqrtf(norm_a) * sqrtf(norm_b));
-    return 1.0f - cosine;  /* [0, 2] 범위 */
+/* 쿼리(fp32) ↔ 저장 노드 벡터 */
+static inline float node_distance(const hnsw_index_t* index, const float* query,
+                                  const hnsw_node_t* node) {
+    return vec_cosine_distance_stored(index->storage, query, node->vector, index->dim);
 }
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -133,11 +129,47 @@ static uint32_t select_layer(void) {
     return layer;
 }
 
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * ID → Slot Map
+ *
+ * 노드 배열 슬롯 번호를 open addressing으로 보관 (슬롯+1, 0 = 빈 칸).
+ * 키는 nodes[slot].id 로 비교하므로 별도 키 배열 없음.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+#define HNSW_NO_SLOT UINT32_MAX
+
+static inline uint32_t id_hash(int64_t id, uint32_t mask) {
+    uint64_t x = (uint64_t)id * 0x9E3779B97F4A7C15ULL;
+    return (uint32_t)(x >> 32) & mask;
+}
+
+static uint32_t slot_of(const hnsw_index_t* index, int64_t id) {
+    uint32_t pos = id_hash(id, index->id_map_mask);
+    while (index->id_map[pos] != 0) {
+        uint32_t slot = index->id_map[pos] - 1;
+        if (index->nodes[slot].id == id) return slot;
+        pos = (pos + 1) & index->id_map_mask;
+    }
+    return HNSW_NO_SLOT;
+}
+
+static void map_insert(hnsw_index_t* index, int64_t id, uint32_t slot) {
+    uint32_t pos = id_hash(id, index->id_map_mask);
+    while (index->id_map[pos] != 0) {
+        pos = (pos + 1) & index->id_map_mask;
+    }
+    index->id_map[pos] = slot + 1;
+}
+
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * HNSW Index
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 hnsw_index_t* hnsw_create(uint32_t dim, uint32_t initial_capacity) {
-    hnsw_index_t* index = (hnsw_index_t*)malloc(sizeof(hnsw_index_t));
+    return hnsw_create_ex(dim, initial_capacity, VEC_STORAGE_F32);
+}
+
+hnsw_index_t* hnsw_create_ex(uint32_t dim, uint32_t initial_capacity, vec_storage_t storage) {
+    hnsw_index_t* index = (hnsw_index_t*)calloc(1, sizeof(hnsw_index_t));
+    if (!index) return NULL;
 
     index->dim = dim;
     index->count = 0;
@@ -150,6 +182,20 @@ hnsw_index_t* hnsw_create(uint32_t dim, uint32_t initial_capacity) {
     index->ef_search = HNSW_EF_SEARCH;
     index->M = HNSW_M;
     index->M_max = HNSW_M_MAX;
+    index->storage = storage;
+
+    /* ID 맵: 용량의 2배 이상, 2의 거듭제곱 */
+    uint32_t map_size = 16;
+    while (map_size < initial_capacity * 2) map_size <<= 1;
+    index->id_map = (uint32_t*)calloc(map_size, sizeof(uint32_t));
+    index->id_map_mask = map_size - 1;
+
+    if (!index->nodes || !index->id_map) {
+        free(index->nodes);
+        free(index->id_map);
+        free(index);
+        return NULL;
+    }
 
     /* 노드 초기화 */
     for (uint32_t i = 0; i < initial_capacity; i++) {
@@ -162,7 +208,8 @@ hnsw_index_t* hnsw_create(uint32_t dim, uint32_t initial_capacity) {
         }
     }
 
-    printf("[hnsw] Created index: dim=%u, capacity=%u\n", dim, initial_capacity);
+    printf("[hnsw] Created index: dim=%u, capacity=%u, storage=%s\n",
+           dim, initial_capacity, vec_storage_string(storage));
     return index;
 }
 
@@ -180,97 +227,275 @@ void hnsw_destroy(hnsw_index_t* index) {
         }
     }
 
+    for (uint32_t i = 0; i < HNSW_VISITED_POOL; i++) {
+        if (index->visited_pool[i]) {
+            free(index->visited_pool[i]->tags);
+            free(index->visited_pool[i]);
+        }
+    }
+
     free(index->nodes);
+    free(index->id_map);
+    free(index->prefix_slab);
     free(index);
 }
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
- * Find Node by ID
+ * Prefix Slab
+ *
+ * 슬롯 순서로 앞쪽 prefix_dim 요소만 연속 저장 (저장 형식 동일).
+ * fp16/bf16도 요소 단위이므로 앞부분을 그대로 복사하면 된다.
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
-static hnsw_node_t* find_node(hnsw_index_t* index, int64_t id) {
+static inline size_t prefix_stride(const hnsw_index_t* index) {
+    return (size_t)index->prefix_dim * vec_storage_size(index->storage);
+}
+
+static inline const void* prefix_row(const hnsw_index_t* index, uint32_t slot) {
+    return (const char*)index->prefix_slab + (size_t)slot * prefix_stride(index);
+}
+
+int hnsw_set_prefix(hnsw_index_t* index, uint32_t prefix_dim) {
+    if (!index || prefix_dim == 0 || prefix_dim > index->dim) return -1;
+
+    size_t stride = (size_t)prefix_dim * vec_storage_size(index->storage);
+    size_t bytes = ((size_t)index->capacity * stride + 63) & ~(size_t)63;
+    void* slab = aligned_alloc(64, bytes ? bytes : 64);
+    if (!slab) {
+        fprintf(stderr, "[hnsw] Error: prefix slab allocation failed\n");
+        return -1;
+    }
+
     for (uint32_t i = 0; i < index->capacity; i++) {
-        if (index->nodes[i].id == id) {
-            return &index->nodes[i];
+        if (index->nodes[i].vector) {
+            memcpy((char*)slab + (size_t)i * stride, index->nodes[i].vector, stride);
         }
     }
-    return NULL;
+
+    free(index->prefix_slab);
+    index->prefix_slab = slab;
+    index->prefix_dim = prefix_dim;
+
+    printf("[hnsw] Prefix slab: d'=%u/%u (%zu bytes/node)\n", prefix_dim, index->dim, stride);
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Search Context
+ *
+ * 호출별 상태 (방문 표, 거리 모드).
+ * 인덱스는 읽기만 하므로 여러 스레드가 동시에 검색 가능.
+ * 방문 표는 인덱스 풀에서 빌림: 계층 검색마다 epoch만 올리므로
+ * 검색 비용이 노드 수 N에 비례하지 않음 (지우기는 epoch가 한 바퀴 돌 때만).
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+typedef struct {
+    const hnsw_index_t* index;
+    const float*        query;
+    uint32_t            prefix_dim;     /* 0 = 전체 벡터 거리 */
+    hnsw_visited_t*     visited;        /* 빌린 방문 표 */
+    uint64_t            hops;           /* 확장한 노드 수 (진단용) */
+    uint64_t            evals;          /* 거리 계산 횟수 (진단용) */
+} search_ctx_t;
+
+/* 풀에서 방문 표 빌리기 (비었으면 새로, 용량이 모자라면 늘림) */
+static hnsw_visited_t* visited_acquire(const hnsw_index_t* index) {
+    hnsw_index_t* pool = (hnsw_index_t*)index;  /* 풀만 바꿈 (검색은 인덱스를 읽기만) */
+    hnsw_visited_t* v = NULL;
+    for (uint32_t i = 0; i < HNSW_VISITED_POOL && !v; i++) {
+        v = __atomic_exchange_n(&pool->visited_pool[i], NULL, __ATOMIC_ACQUIRE);
+    }
+    if (!v) {
+        v = (hnsw_visited_t*)calloc(1, sizeof(hnsw_visited_t));
+        if (!v) return NULL;
+    }
+
+    if (v->capacity < index->capacity) {
+        uint32_t* tags = (uint32_t*)realloc(v->tags, index->capacity * sizeof(uint32_t));
+        if (!tags) {
+            free(v->tags);
+            free(v);
+            return NULL;
+        }
+        memset(tags + v->capacity, 0, (index->capacity - v->capacity) * sizeof(uint32_t));
+        v->tags = tags;
+        v->capacity = index->capacity;
+    }
+    return v;
+}
+
+/* 방문 표 돌려주기 (빈 칸이 없으면 해제) */
+static void visited_release(const hnsw_index_t* index, hnsw_visited_t* v) {
+    hnsw_index_t* pool = (hnsw_index_t*)index;
+    for (uint32_t i = 0; i < HNSW_VISITED_POOL; i++) {
+        hnsw_visited_t* empty = NULL;
+        if (__atomic_compare_exchange_n(&pool->visited_pool[i], &empty, v, 0,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+            return;
+        }
+    }
+    free(v->tags);
+    free(v);
+}
+
+/* 새 계층 검색 = 새 epoch (한 바퀴 돌면 그때만 전부 지움) */
+static inline void visited_reset(hnsw_visited_t* v) {
+    if (++v->epoch == 0) {
+        memset(v->tags, 0, v->capacity * sizeof(uint32_t));
+        v->epoch = 1;
+    }
+}
+
+static int ctx_init(search_ctx_t* ctx, const hnsw_index_t* index,
+                    const float* query, uint32_t prefix_dim) {
+    ctx->index = index;
+    ctx->query = query;
+    ctx->prefix_dim = prefix_dim;
+    ctx->hops = 0;
+    ctx->evals = 0;
+    ctx->visited = visited_acquire(index);
+    return ctx->visited ? 0 : -1;
+}
+
+static void ctx_free(search_ctx_t* ctx) {
+    visited_release(ctx->index, ctx->visited);
+    ctx->visited = NULL;
+}
+
+static inline float slot_distance(const search_ctx_t* ctx, uint32_t slot) {
+    const hnsw_index_t* index = ctx->index;
+    if (ctx->prefix_dim > 0) {
+        return vec_cosine_distance_stored(index->storage, ctx->query,
+                                          prefix_row(index, slot), ctx->prefix_dim);
+    }
+    return node_distance(index, ctx->query, &index->nodes[slot]);
+}
+
+static inline int visit(search_ctx_t* ctx, uint32_t slot) {
+    hnsw_visited_t* v = ctx->visited;
+    if (v->tags[slot] == v->epoch) return 0;
+    v->tags[slot] = v->epoch;
+    return 1;
 }
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * Search Layer (Greedy Best-First)
  *
  * 주어진 계층에서 가장 가까운 ef개의 이웃 찾기
+ *   candidates: 최소 힙 (가까운 것부터 확장)
+ *   results:    최대 힙 (거리 부호 반전, 최악을 top에 두고 교체)
+ * out에 거리 오름차순으로 기록, 리턴 = 개수 (pq_item_t.id = 슬롯)
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
-static void search_layer(
-    const hnsw_index_t* index,
-    const float* query,
-    int64_t entry_id,
+static uint32_t search_layer(
+    search_ctx_t* ctx,
+    const pq_item_t* entries,
+    uint32_t entry_count,
     uint32_t layer,
     uint32_t ef,
-    priority_queue_t* result_pq
+    pq_item_t* out
 ) {
+    const hnsw_index_t* index = ctx->index;
     priority_queue_t* candidates = pq_create(ef * 2);
-    priority_queue_t* visited = pq_create(ef * 2);
+    priority_queue_t* results = pq_create(ef + 1);
 
-    hnsw_node_t* entry_node = find_node((hnsw_index_t*)index, entry_id);
-    if (!entry_node) {
-        pq_destroy(candidates);
-        pq_destroy(visited);
-        return;
-    }
+    visited_reset(ctx->visited);
 
-    float entry_dist = hnsw_distance(query, entry_node->vector, index->dim);
-    pq_push(candidates, entry_id, entry_dist);
-    pq_push(result_pq, entry_id, entry_dist);
-    pq_push(visited, entry_id, 0.0f);
+    for (uint32_t i = 0; i < entry_count; i++) {
+        uint32_t slot = (uint32_t)entries[i].id;
+        if (!visit(ctx, slot)) continue;
+        pq_push(candidates, slot, entries[i].priority);
+        pq_push(results, slot, -entries[i].priority);
+        if (results->size > ef) pq_pop(results);
+    }
 
     while (!pq_empty(candidates)) {
         pq_item_t current = pq_pop(candidates);
 
-        /* 현재보다 먼 결과가 있으면 중단 */
-        pq_item_t* worst = pq_peek(result_pq);
-        if (worst && current.priority > worst->priority) {
+        /* 가장 가까운 후보가 결과의 최악보다 멀면 중단 */
+        float worst = -pq_peek(results)->priority;
+        if (current.priority > worst && results->size >= ef) {
             break;
         }
 
-        hnsw_node_t* current_node = find_node((hnsw_index_t*)index, current.id);
-        if (!current_node || layer >= HNSW_MAX_LAYERS) continue;
+        const hnsw_node_t* node = &index->nodes[current.id];
+        if (layer > node->layer) continue;
+        ctx->hops++;
 
         /* 이웃 탐색 */
-        for (uint32_t i = 0; i < current_node->neighbor_count[layer]; i++) {
-            int64_t neighbor_id = current_node->neighbors[layer][i];
-
-            /* 이미 방문했는지 확인 */
-            int already_visited = 0;
-            for (uint32_t j = 0; j < visited->size; j++) {
-                if (visited->items[j].id == neighbor_id) {
-                    already_visited = 1;
-                    break;
-                }
-            }
-            if (already_visited) continue;
-
-            pq_push(visited, neighbor_id, 0.0f);
-
-            hnsw_node_t* neighbor_node = find_node((hnsw_index_t*)index, neighbor_id);
-            if (!neighbor_node) continue;
+        for (uint32_t i = 0; i < node->neighbor_count[layer]; i++) {
+            uint32_t nb = node->neighbors[layer][i];
+            if (!visit(ctx, nb)) continue;
 
-            float dist = hnsw_distance(query, neighbor_node->vector, index->dim);
+            float dist = slot_distance(ctx, nb);
+            ctx->evals++;
+            worst = -pq_peek(results)->priority;
 
-            if (result_pq->size < ef || dist < worst->priority) {
-                pq_push(candidates, neighbor_id, dist);
-                pq_push(result_pq, neighbor_id, dist);
+            if (results->size < ef || dist < worst) {
+                pq_push(candidates, nb, dist);
+                pq_push(results, nb, -dist);
 
                 /* ef보다 많으면 최악 제거 */
-                while (result_pq->size > ef) {
-                    pq_pop(result_pq);
+                if (results->size > ef) {
+                    pq_pop(results);
                 }
             }
         }
     }
 
+    /* 최대 힙 → 오름차순 */
+    uint32_t n = results->size;
+    for (uint32_t i = n; i > 0; i--) {
+        pq_item_t item = pq_pop(results);
+        out[i - 1].id = item.id;
+        out[i - 1].priority = -item.priority;
+    }
+
     pq_destroy(candidates);
-    pq_destroy(visited);
+    pq_destroy(results);
+    return n;
+}
+
+/* 상위 계층 greedy 하강 (ef = 1) */
+static pq_item_t descend(search_ctx_t* ctx, pq_item_t entry,
+                         uint32_t from_layer, uint32_t to_layer) {
+    for (uint32_t layer = from_layer; layer > to_layer; layer--) {
+        pq_item_t best;
+        if (search_layer(ctx, &entry, 1, layer, 1, &best) > 0) {
+            entry = best;
+        }
+    }
+    return entry;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Reverse Link
+ *
+ * 이웃 nb에 새 노드를 역방향으로 연결.
+ * 목록이 가득 차면 nb에서 가장 먼 이웃과 비교해 교체.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static void add_reverse_link(hnsw_index_t* index, uint32_t nb, uint32_t slot,
+                             uint32_t layer, float dist, float* scratch) {
+    hnsw_node_t* node = &index->nodes[nb];
+    uint32_t max_conn = (layer == 0) ? index->M_max : index->M;
+
+    if (node->neighbor_count[layer] < max_conn) {
+        node->neighbors[layer][node->neighbor_count[layer]++] = slot;
+        return;
+    }
+
+    vec_decode(index->storage, node->vector, scratch, index->dim);
+
+    uint32_t worst_i = 0;
+    float worst_d = -1.0f;
+    for (uint32_t i = 0; i < node->neighbor_count[layer]; i++) {
+        float d = node_distance(index, scratch, &index->nodes[node->neighbors[layer][i]]);
+        if (d > worst_d) {
+            worst_d = d;
+            worst_i = i;
+        }
+    }
+
+    if (dist < worst_d) {
+        node->neighbors[layer][worst_i] = slot;
+    }
 }
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -279,30 +504,47 @@ static void search_layer(
 int hnsw_insert(hnsw_index_t* index, int64_t id, const float* vector) {
     if (!index || !vector) return -1;
 
-    /* 빈 슬롯 찾기 */
-    hnsw_node_t* node = NULL;
-    for (uint32_t i = 0; i < index->capacity; i++) {
-        if (index->nodes[i].id == -1) {
-            node = &index->nodes[i];
-            break;
+    if (slot_of(index, id) != HNSW_NO_SLOT) {
+        fprintf(stderr, "[hnsw] Error: duplicate id %ld\n", id);
+        return -1;
+    }
+
+    /* 빈 슬롯 찾기 (삭제가 없으면 항상 count 위치) */
+    uint32_t slot = HNSW_NO_SLOT;
+    if (index->count < index->capacity && index->nodes[index->count].id == -1) {
+        slot = index->count;
+    } else {
+        for (uint32_t i = 0; i < index->capacity; i++) {
+            if (index->nodes[i].id == -1) {
+                slot = i;
+                break;
+            }
         }
     }
 
-    if (!node) {
+    if (slot == HNSW_NO_SLOT) {
         fprintf(stderr, "[hnsw] Error: capacity full\n");
         return -1;
     }
 
-    /* 벡터 복사 */
+    hnsw_node_t* node = &index->nodes[slot];
+
+    /* 벡터 복사 (저장 형식으로 변환) */
     node->id = id;
-    node->vector = (float*)malloc(index->dim * sizeof(float));
-    memcpy(node->vector, vector, index->dim * sizeof(float));
+    node->vector = malloc(index->dim * vec_storage_size(index->storage));
+    vec_encode(index->storage, vector, node->vector, index->dim);
     node->layer = select_layer();
+    map_insert(index, id, slot);
+
+    if (index->prefix_slab) {
+        memcpy((char*)index->prefix_slab + (size_t)slot * prefix_stride(index),
+               node->vector, prefix_stride(index));
+    }
 
     /* 계층별 이웃 배열 할당 */
     for (uint32_t l = 0; l <= node->layer; l++) {
         uint32_t max_neighbors = (l == 0) ? index->M_max : index->M;
-        node->neighbors[l] = (int64_t*)malloc(max_neighbors * sizeof(int64_t));
+        node->neighbors[l] = (uint32_t*)malloc(max_neighbors * sizeof(uint32_t));
         node->neighbor_count[l] = 0;
     }
 
@@ -314,21 +556,39 @@ int hnsw_insert(hnsw_index_t* index, int64_t id, const float* vector) {
         return 0;
     }
 
-    /* Layer별 이웃 연결 (간단 버전: 가장 가까운 M개만) */
-    for (uint32_t l = 0; l <= node->layer && l <= index->max_layer; l++) {
-        priority_queue_t* nearest = pq_create(index->ef_construction);
-        search_layer(index, vector, index->entry_point, l, index->ef_construction, nearest);
+    search_ctx_t ctx;
+    if (ctx_init(&ctx, index, vector, 0) < 0) return -1;
+
+    uint32_t ef = index->ef_construction;
+    pq_item_t* nearest = (pq_item_t*)malloc(ef * sizeof(pq_item_t));
+    float* scratch = (float*)malloc(index->dim * sizeof(float));
+
+    /* 새 노드 계층 위쪽은 greedy 하강 */
+    uint32_t ep_slot = slot_of(index, index->entry_point);
+    pq_item_t entry = { ep_slot, slot_distance(&ctx, ep_slot) };
+    uint32_t top = (node->layer < index->max_layer) ? node->layer : index->max_layer;
+    entry = descend(&ctx, entry, index->max_layer, top);
+
+    /* Layer별 이웃 연결 (가장 가까운 M개 + 역방향 링크) */
+    uint32_t entry_count = 1;
+    nearest[0] = entry;
+    for (int l = (int)top; l >= 0; l--) {
+        uint32_t n = search_layer(&ctx, nearest, entry_count, (uint32_t)l, ef, nearest);
 
-        /* 가장 가까운 M개를 이웃으로 */
         uint32_t max_conn = (l == 0) ? index->M_max : index->M;
-        while (!pq_empty(nearest) && node->neighbor_count[l] < max_conn) {
-            pq_item_t item = pq_pop(nearest);
-            node->neighbors[l][node->neighbor_count[l]++] = item.id;
+        for (uint32_t i = 0; i < n && node->neighbor_count[l] < max_conn; i++) {
+            uint32_t nb = (uint32_t)nearest[i].id;
+            node->neighbors[l][node->neighbor_count[l]++] = nb;
+            add_reverse_link(index, nb, slot, (uint32_t)l, nearest[i].priority, scratch);
         }
 
-        pq_destroy(nearest);
+        entry_count = n;  /* 다음 계층의 진입점 = 이번 계층 결과 */
     }
 
+    free(scratch);
+    free(nearest);
+    ctx_free(&ctx);
+
     /* Max layer 업데이트 */
     if (node->layer > index->max_layer) {
         index->max_layer = node->layer;
@@ -339,45 +599,301 @@ int hnsw_insert(hnsw_index_t* index, int64_t id, const float* vector) {
     return 0;
 }
 
+int hnsw_contains(const hnsw_index_t* index, int64_t id) {
+    return index && slot_of(index, id) != HNSW_NO_SLOT;
+}
+
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * Search Top-K
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int search_run(const hnsw_index_t* index, const float* query, uint32_t k,
+                      const hnsw_search_params_t* params, hnsw_result_t* results,
+                      search_ctx_t* trace);
+
 int hnsw_search(
     const hnsw_index_t* index,
     const float* query,
     uint32_t k,
     hnsw_result_t* results
+) {
+    return hnsw_search_ex(index, query, k, NULL, results);
+}
+
+int hnsw_search_ex(
+    const hnsw_index_t* index,
+    const float* query,
+    uint32_t k,
+    const hnsw_search_params_t* params,
+    hnsw_result_t* results
+) {
+    return search_run(index, query, k, params, results, NULL);
+}
+
+/* 검색 본체 (trace != NULL이면 hop / 거리 계산 수 누적) */
+static int search_run(
+    const hnsw_index_t* index,
+    const float* query,
+    uint32_t k,
+    const hnsw_search_params_t* params,
+    hnsw_result_t* results,
+    search_ctx_t* trace
 ) {
     if (!index || !query || !results || index->count == 0) return -1;
 
-    priority_queue_t* pq = pq_create(index->ef_search);
+    uint32_t ef = (params && params->ef) ? params->ef : index->ef_search;
+    uint32_t prefix = params ? params->prefix_dim : 0;
+    if (prefix > index->prefix_dim) prefix = index->prefix_dim;
+    if (prefix >= index->dim) prefix = 0;
 
-    /* Top layer부터 검색 */
-    int64_t current_nearest = index->entry_point;
-    for (int layer = (int)index->max_layer; layer > 0; layer--) {
-        priority_queue_t* temp_pq = pq_create(1);
-        search_layer(index, query, current_nearest, (uint32_t)layer, 1, temp_pq);
-        if (!pq_empty(temp_pq)) {
-            current_nearest = pq_pop(temp_pq).id;
-        }
-        pq_destroy(temp_pq);
+    /* 재정렬 깊이만큼은 후보를 모아야 함 */
+    uint32_t rerank = 0;
+    if (prefix > 0) {
+        rerank = (params->rerank) ? params->rerank : ef;
+        if (rerank < k) rerank = k;
+        if (ef < rerank) ef = rerank;
     }
+    if (ef < k) ef = k;
 
-    /* Layer 0에서 ef_search개 찾기 */
-    search_layer(index, query, current_nearest, 0, index->ef_search, pq);
+    search_ctx_t ctx;
+    if (ctx_init(&ctx, index, query, prefix) < 0) return -1;
+    pq_item_t* found = (pq_item_t*)malloc(ef * sizeof(pq_item_t));
+    if (!found) {
+        ctx_free(&ctx);
+        return -1;
+    }
 
-    /* Top-K 추출 */
-    uint32_t result_count = (k < pq->size) ? k : pq->size;
+    /* Top layer부터 greedy 하강 */
+    uint32_t ep_slot = slot_of(index, index->entry_point);
+    pq_item_t entry = { ep_slot, slot_distance(&ctx, ep_slot) };
+    entry = descend(&ctx, entry, index->max_layer, 0);
+
+    /* Layer 0에서 ef개 찾기 */
+    uint32_t n = search_layer(&ctx, &entry, 1, 0, ef, found);
+
+    /* 2단계: prefix 후보 상위 rerank개를 전체 벡터로 재계산 */
+    if (prefix > 0) {
+        if (n > rerank) n = rerank;
+        for (uint32_t i = 0; i < n; i++) {
+            found[i].priority = node_distance(index, query, &index->nodes[found[i].id]);
+        }
+        /* 삽입 정렬 (n은 작음) */
+        for (uint32_t i = 1; i < n; i++) {
+            pq_item_t item = found[i];
+            uint32_t j = i;
+            while (j > 0 && found[j - 1].priority > item.priority) {
+                found[j] = found[j - 1];
+                j--;
+            }
+            found[j] = item;
+        }
+    }
+
+    /* Top-K 추출 (슬롯 → ID) */
+    uint32_t result_count = (k < n) ? k : n;
     for (uint32_t i = 0; i < result_count; i++) {
-        pq_item_t item = pq_pop(pq);
-        results[i].id = item.id;
-        results[i].distance = item.priority;
+        results[i].id = index->nodes[found[i].id].id;
+        results[i].distance = found[i].priority;
+    }
+
+    if (trace) {
+        trace->hops += ctx.hops;
+        trace->evals += ctx.evals;
     }
 
-    pq_destroy(pq);
+    free(found);
+    ctx_free(&ctx);
     return (int)result_count;
 }
 
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Save
+ *
+ * 슬롯 번호를 그대로 기록 → 로드 때 이웃 목록을 고치지 않고 제자리에.
+ * 재시작마다 전부 다시 삽입 (ef_construction 탐색 N번) 하는 대신 읽기만.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int write_node(FILE* fp, const hnsw_node_t* node, uint32_t slot, size_t vec_bytes) {
+    hnsw_file_node_t rec = { node->id, slot, node->layer };
+    uint32_t levels = node->layer + 1;
+
+    if (fwrite(&rec, sizeof(rec), 1, fp) != 1 ||
+        fwrite(node->neighbor_count, sizeof(uint32_t), levels, fp) != levels) {
+        return -1;
+    }
+    for (uint32_t l = 0; l < levels; l++) {
+        uint32_t n = node->neighbor_count[l];
+        if (n > 0 && fwrite(node->neighbors[l], sizeof(uint32_t), n, fp) != n) return -1;
+    }
+    return fwrite(node->vector, 1, vec_bytes, fp) == vec_bytes ? 0 : -1;
+}
+
+int hnsw_save(const hnsw_index_t* index, const char* filepath) {
+    if (!index || !filepath) return -1;
+
+    char tmp[4096];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", filepath) >= (int)sizeof(tmp)) {
+        fprintf(stderr, "[hnsw] Error: path too long '%s'\n", filepath);
+        return -1;
+    }
+
+    hnsw_file_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = HNSW_MAGIC;
+    header.version = 1;
+    header.dim = index->dim;
+    header.count = index->count;
+    header.capacity = index->capacity;
+    header.max_layer = index->max_layer;
+    header.entry_point = index->entry_point;
+    header.M = index->M;
+    header.M_max = index->M_max;
+    header.ef_construction = index->ef_construction;
+    header.ef_search = index->ef_search;
+    header.storage = (uint32_t)index->storage;
+    header.prefix_dim = index->prefix_dim;
+
+    FILE* fp = fopen(tmp, "wb");
+    if (!fp) {
+        fprintf(stderr, "[hnsw] Error: cannot create '%s'\n", tmp);
+        return -1;
+    }
+
+    const size_t vec_bytes = index->dim * vec_storage_size(index->storage);
+    int rc = fwrite(&header, sizeof(header), 1, fp) == 1 ? 0 : -1;
+    for (uint32_t i = 0; i < index->capacity && rc == 0; i++) {
+        if (index->nodes[i].id != -1) rc = write_node(fp, &index->nodes[i], i, vec_bytes);
+    }
+
+    /* rename 전에 내용이 디스크에 (rename만 남고 내용이 비는 경우 방지) */
+    if (rc == 0 && (fflush(fp) != 0 || fsync(fileno(fp)) != 0)) rc = -1;
+    if (fclose(fp) != 0) rc = -1;
+    if (rc == 0 && rename(tmp, filepath) != 0) rc = -1;
+
+    if (rc != 0) {
+        fprintf(stderr, "[hnsw] Error: write failed '%s'\n", filepath);
+        unlink(tmp);
+        return -1;
+    }
+
+    printf("[hnsw] ✓ Saved %u nodes → %s\n", index->count, filepath);
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Load
+ *
+ * 손상된 파일이 범위 밖 슬롯을 가리키지 않도록 모든 번호를 검사:
+ * 슬롯 < 저장 용량, 슬롯 중복 없음, 이웃 수 ≤ M / M_max,
+ * 이웃 / entry point는 실제로 채워진 노드.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int header_ok(const hnsw_file_header_t* header) {
+    return header->magic == HNSW_MAGIC && header->version == 1 &&
+           header->dim > 0 && header->count <= header->capacity &&
+           header->max_layer < HNSW_MAX_LAYERS &&
+           header->M > 0 && header->M <= 1024 && header->M_max > 0 && header->M_max <= 1024 &&
+           header->ef_construction > 0 && header->ef_search > 0 &&
+           header->storage <= VEC_STORAGE_BF16 && header->prefix_dim <= header->dim;
+}
+
+static int read_node(FILE* fp, hnsw_index_t* index, const hnsw_file_header_t* header,
+                     size_t vec_bytes) {
+    hnsw_file_node_t rec;
+    if (fread(&rec, sizeof(rec), 1, fp) != 1 || rec.id == -1 ||
+        rec.slot >= header->capacity || rec.layer > header->max_layer ||
+        index->nodes[rec.slot].id != -1 || slot_of(index, rec.id) != HNSW_NO_SLOT) {
+        return -1;
+    }
+
+    hnsw_node_t* node = &index->nodes[rec.slot];
+    node->id = rec.id;
+    node->layer = rec.layer;
+    map_insert(index, rec.id, rec.slot);
+
+    uint32_t levels = rec.layer + 1;
+    if (fread(node->neighbor_count, sizeof(uint32_t), levels, fp) != levels) return -1;
+
+    for (uint32_t l = 0; l < levels; l++) {
+        uint32_t max_neighbors = (l == 0) ? index->M_max : index->M;
+        uint32_t n = node->neighbor_count[l];
+        node->neighbors[l] = (uint32_t*)malloc(max_neighbors * sizeof(uint32_t));
+        if (!node->neighbors[l] || n > max_neighbors) return -1;
+        if (n > 0 && fread(node->neighbors[l], sizeof(uint32_t), n, fp) != n) return -1;
+        for (uint32_t i = 0; i < n; i++) {
+            if (node->neighbors[l][i] >= header->capacity) return -1;
+        }
+    }
+
+    node->vector = malloc(vec_bytes);
+    if (!node->vector || fread(node->vector, 1, vec_bytes, fp) != vec_bytes) return -1;
+    return 0;
+}
+
+/* 이웃 / entry point가 모두 채워진 노드를 가리키는가 */
+static int graph_ok(const hnsw_index_t* index) {
+    for (uint32_t i = 0; i < index->capacity; i++) {
+        const hnsw_node_t* node = &index->nodes[i];
+        if (node->id == -1) continue;
+        for (uint32_t l = 0; l <= node->layer; l++) {
+            for (uint32_t j = 0; j < node->neighbor_count[l]; j++) {
+                if (index->nodes[node->neighbors[l][j]].id == -1) return 0;
+            }
+        }
+    }
+    if (index->count == 0) return index->entry_point == -1;
+
+    uint32_t ep = slot_of(index, index->entry_point);
+    return ep != HNSW_NO_SLOT && index->nodes[ep].layer == index->max_layer;
+}
+
+hnsw_index_t* hnsw_load(const char* filepath, uint32_t capacity) {
+    FILE* fp = fopen(filepath, "rb");
+    if (!fp) {
+        fprintf(stderr, "[hnsw] Error: cannot open '%s'\n", filepath);
+        return NULL;
+    }
+
+    hnsw_file_header_t header;
+    if (fread(&header, sizeof(header), 1, fp) != 1 || !header_ok(&header)) {
+        fprintf(stderr, "[hnsw] Error: invalid HNSW file '%s'\n", filepath);
+        fclose(fp);
+        return NULL;
+    }
+
+    if (capacity < header.capacity) capacity = header.capacity;
+    hnsw_index_t* index = hnsw_create_ex(header.dim, capacity, (vec_storage_t)header.storage);
+    if (!index) {
+        fclose(fp);
+        return NULL;
+    }
+
+    index->max_layer = header.max_layer;
+    index->entry_point = header.entry_point;
+    index->M = header.M;
+    index->M_max = header.M_max;
+    index->ef_construction = header.ef_construction;
+    index->ef_search = header.ef_search;
+
+    const size_t vec_bytes = header.dim * vec_storage_size(index->storage);
+    int rc = 0;
+    for (uint32_t i = 0; i < header.count && rc == 0; i++) {
+        rc = read_node(fp, index, &header, vec_bytes);
+    }
+    index->count = header.count;
+
+    /* 헤더가 말한 노드 수 뒤에 남은 바이트가 있으면 잘못 쓴 파일 */
+    if (rc == 0 && fgetc(fp) != EOF) rc = -1;
+    fclose(fp);
+
+    if (rc != 0 || !graph_ok(index) ||
+        (header.prefix_dim > 0 && hnsw_set_prefix(index, header.prefix_dim) < 0)) {
+        fprintf(stderr, "[hnsw] Error: invalid HNSW file '%s'\n", filepath);
+        hnsw_destroy(index);
+        return NULL;
+    }
+
+    printf("[hnsw] ✓ Loaded %u nodes ← %s\n", index->count, filepath);
+    return index;
+}
+
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * Statistics
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
@@ -393,6 +909,12 @@ void hnsw_stats(const hnsw_index_t* index) {
     printf("  M_max:        %u\n", index->M_max);
     printf("  ef_construct: %u\n", index->ef_construction);
     printf("  ef_search:    %u\n", index->ef_search);
+    printf("  Storage:      %s (%zu bytes/vector)\n",
+           vec_storage_string(index->storage), index->dim * vec_storage_size(index->storage));
+    if (index->prefix_dim > 0) {
+        printf("  Prefix Slab:  d'=%u (%zu bytes/node)\n",
+               index->prefix_dim, prefix_stride(index));
+    }
 
     /* Layer별 노드 분포 */
     uint32_t layer_counts[HNSW_MAX_LAYERS] = {0};
@@ -407,3 +929,220 @@ void hnsw_stats(const hnsw_index_t* index) {
         printf("    Layer %u: %u nodes\n", l, layer_counts[l]);
     }
 }
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Graph Diagnostics
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static inline uint32_t degree_bin(uint32_t degree) {
+    return (degree < HNSW_DIAG_DEGREE_BINS - 1) ? degree : HNSW_DIAG_DEGREE_BINS - 1;
+}
+
+/* entry 슬롯에서 layer 간선만 따라 BFS, 도달한 슬롯은 reached[]=1 */
+static void bfs_layer(const hnsw_index_t* index, uint32_t entry, uint32_t layer,
+                      uint8_t* reached, uint32_t* queue) {
+    memset(reached, 0, index->capacity);
+
+    uint32_t head = 0, tail = 0;
+    reached[entry] = 1;
+    queue[tail++] = entry;
+
+    while (head < tail) {
+        const hnsw_node_t* node = &index->nodes[queue[head++]];
+        if (layer > node->layer) continue;
+
+        for (uint32_t i = 0; i < node->neighbor_count[layer]; i++) {
+            uint32_t nb = node->neighbors[layer][i];
+            if (!reached[nb]) {
+                reached[nb] = 1;
+                queue[tail++] = nb;
+            }
+        }
+    }
+}
+
+int hnsw_diagnose(const hnsw_index_t* index, const float* queries,
+                  uint32_t num_queries, hnsw_diag_t* diag) {
+    if (!index || !diag) return -1;
+
+    memset(diag, 0, sizeof(*diag));
+    diag->node_count = index->count;
+    diag->max_layer = index->max_layer;
+    if (index->count == 0) return 0;
+
+    uint32_t* in_degree = (uint32_t*)malloc(index->capacity * sizeof(uint32_t));
+    uint8_t* reached = (uint8_t*)malloc(index->capacity);
+    uint32_t* queue = (uint32_t*)malloc(index->capacity * sizeof(uint32_t));
+    if (!in_degree || !reached || !queue) {
+        free(in_degree);
+        free(reached);
+        free(queue);
+        return -1;
+    }
+
+    uint32_t entry = slot_of(index, index->entry_point);
+
+    for (uint32_t l = 0; l <= index->max_layer; l++) {
+        hnsw_layer_diag_t* ld = &diag->layers[l];
+        memset(in_degree, 0, index->capacity * sizeof(uint32_t));
+
+        /* Out-degree + in-degree 집계 */
+        for (uint32_t s = 0; s < index->capacity; s++) {
+            const hnsw_node_t* node = &index->nodes[s];
+            if (node->id == -1 || node->layer < l) continue;
+
+            uint32_t out = node->neighbor_count[l];
+            ld->nodes++;
+            ld->edges += out;
+            ld->out_hist[degree_bin(out)]++;
+            if (out > ld->max_out) ld->max_out = out;
+
+            for (uint32_t i = 0; i < out; i++) {
+                in_degree[node->neighbors[l][i]]++;
+            }
+        }
+
+        /* 도달성 */
+        bfs_layer(index, entry, l, reached, queue);
+
+        for (uint32_t s = 0; s < index->capacity; s++) {
+            const hnsw_node_t* node = &index->nodes[s];
+            if (node->id == -1 || node->layer < l) continue;
+
+            uint32_t in = in_degree[s];
+            ld->in_hist[degree_bin(in)]++;
+            if (in > ld->max_in) ld->max_in = in;
+            if (in == 0 && s != entry) ld->orphans++;
+
+            if (!reached[s]) {
+                ld->unreachable++;
+                if (l == 0 && diag->unreachable_reported < HNSW_DIAG_MAX_REPORT) {
+                    diag->unreachable_ids[diag->unreachable_reported++] = node->id;
+                }
+            }
+        }
+    }
+    diag->unreachable = diag->layers[0].unreachable;
+
+    free(in_degree);
+    free(reached);
+    free(queue);
+
+    /* 샘플 쿼리 hop 수 */
+    if (num_queries > 0) {
+        float* sample = (float*)malloc(index->dim * sizeof(float));
+        hnsw_result_t* results = (hnsw_result_t*)malloc(index->ef_search * sizeof(hnsw_result_t));
+        search_ctx_t trace = { 0 };
+        uint32_t done = 0;
+
+        for (uint32_t q = 0; q < num_queries && sample && results; q++) {
+            const float* query;
+            if (queries) {
+                query = queries + (size_t)q * index->dim;
+            } else {
+                /* 저장 벡터 균등 샘플링 (슬롯 간격) */
+                uint32_t s = (uint32_t)((uint64_t)q * index->capacity / num_queries);
+                while (s < index->capacity && index->nodes[s].id == -1) s++;
+                if (s >= index->capacity) break;
+                vec_decode(index->storage, index->nodes[s].vector, sample, index->dim);
+                query = sample;
+            }
+
+            if (search_run(index, query, index->ef_search, NULL, results, &trace) >= 0) {
+                done++;
+            }
+        }
+
+        if (done > 0) {
+            diag->sample_queries = done;
+            diag->avg_hops = (double)trace.hops / done;
+            diag->avg_distance_evals = (double)trace.evals / done;
+        }
+
+        free(sample);
+        free(results);
+    }
+
+    return 0;
+}
+
+void hnsw_diag_print(const hnsw_diag_t* diag) {
+    if (!diag) return;
+
+    printf("\n[HNSW Graph Diagnostics]\n");
+    printf("  Nodes:        %u (max layer %u)\n", diag->node_count, diag->max_layer);
+
+    for (uint32_t l = 0; l <= diag->max_layer && l < HNSW_MAX_LAYERS; l++) {
+        const hnsw_layer_diag_t* ld = &diag->layers[l];
+        if (ld->nodes == 0) continue;
+
+        printf("  Layer %-2u: nodes=%u, avg_out=%.2f, max_out=%u, max_in=%u, "
+               "orphans=%u, unreachable=%u\n",
+               l, ld->nodes, (double)ld->edges / ld->nodes, ld->max_out, ld->max_in,
+               ld->orphans, ld->unreachable);
+    }
+
+    /* Layer 0 차수 분포 (0이 아닌 칸만) */
+    printf("  Layer 0 out-degree:");
+    for (uint32_t b = 0; b < HNSW_DIAG_DEGREE_BINS; b++) {
+        if (diag->layers[0].out_hist[b]) {
+            printf(" %u%s:%u", b, (b == HNSW_DIAG_DEGREE_BINS - 1) ? "+" : "",
+                   diag->layers[0].out_hist[b]);
+        }
+    }
+    printf("\n");
+
+    if (diag->unreachable > 0) {
+        printf("  ⚠️  %u nodes unreachable from entry point (first:", diag->unreachable);
+        for (uint32_t i = 0; i < diag->unreachable_reported && i < 8; i++) {
+            printf(" %ld", diag->unreachable_ids[i]);
+        }
+        printf(")\n");
+    }
+
+    if (diag->sample_queries > 0) {
+        printf("  Sample Queries: %u, avg hops=%.1f, avg distance evals=%.1f\n",
+               diag->sample_queries, diag->avg_hops, diag->avg_distance_evals);
+    }
+}
+
+int hnsw_diag_write_csv(const hnsw_diag_t* diag, const char* filepath) {
+    if (!diag || !filepath) return -1;
+
+    FILE* fp = fopen(filepath, "w");
+    if (!fp) {
+        fprintf(stderr, "[hnsw] Error: cannot create '%s'\n", filepath);
+        return -1;
+    }
+
+    fprintf(fp, "layer,metric,bucket,value\n");
+    fprintf(fp, ",node_count,,%u\n", diag->node_count);
+    fprintf(fp, ",max_layer,,%u\n", diag->max_layer);
+    fprintf(fp, ",unreachable,,%u\n", diag->unreachable);
+    fprintf(fp, ",sample_queries,,%u\n", diag->sample_queries);
+    fprintf(fp, ",avg_hops,,%.3f\n", diag->avg_hops);
+    fprintf(fp, ",avg_distance_evals,,%.3f\n", diag->avg_distance_evals);
+
+    for (uint32_t l = 0; l <= diag->max_layer && l < HNSW_MAX_LAYERS; l++) {
+        const hnsw_layer_diag_t* ld = &diag->layers[l];
+
+        fprintf(fp, "%u,nodes,,%u\n", l, ld->nodes);
+        fprintf(fp, "%u,edges,,%lu\n", l, ld->edges);
+        fprintf(fp, "%u,max_out,,%u\n", l, ld->max_out);
+        fprintf(fp, "%u,max_in,,%u\n", l, ld->max_in);
+        fprintf(fp, "%u,orphans,,%u\n", l, ld->orphans);
+        fprintf(fp, "%u,unreachable,,%u\n", l, ld->unreachable);
+
+        for (uint32_t b = 0; b < HNSW_DIAG_DEGREE_BINS; b++) {
+            if (ld->out_hist[b]) fprintf(fp, "%u,out_degree,%u,%u\n", l, b, ld->out_hist[b]);
+        }
+        for (uint32_t b = 0; b < HNSW_DIAG_DEGREE_BINS; b++) {
+            if (ld->in_hist[b]) fprintf(fp, "%u,in_degree,%u,%u\n", l, b, ld->in_hist[b]);
+        }
+    }
+
+    int rc = (fclose(fp) == 0) ? 0 : -1;
+    if (rc == 0) {
+        printf("[hnsw] ✓ Diagnostics written → %s\n", filepath);
+    }
+    return rc;
+}
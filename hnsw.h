@@ -13,6 +13,10 @@
  *   - Layer 1+: 점점 희소한 서브샘플
  *   - 위에서 아래로 탐색 (greedy best-first)
  *
+ * 2단계 검색 (Matryoshka 임베딩):
+ *   - 벡터 앞쪽 d'차원만 별도 연속 slab에 저장
+ *   - 그래프 탐색은 prefix로, 상위 후보만 전체 벡터로 재정렬
+ *
  * 참고:
  *   - "Efficient and robust approximate nearest neighbor search
  *      using Hierarchical Navigable Small World graphs"
@@ -24,6 +28,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "vec_kernels.h"    /* vec_storage_t */
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * Configuration
@@ -36,6 +41,9 @@
 #define HNSW_EF_SEARCH          50      /* 검색 시 탐색 범위 */
 #define HNSW_ML                 (1.0 / log(2.0))  /* 계층 확률 */
 
+#define HNSW_MAGIC              0x31534E48  /* "HNS1" */
+#define HNSW_VISITED_POOL       8       /* 검색 사이에 재사용하는 방문 표 수 (동시 검색 수) */
+
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * Data Structures
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
@@ -43,14 +51,21 @@
 /* HNSW 노드 */
 typedef struct {
     int64_t  id;                        /* Vector ID */
-    float*   vector;                    /* Embedding (dim floats) */
+    void*    vector;                    /* Embedding (dim × storage 요소) */
     uint32_t layer;                     /* 이 노드의 최대 계층 */
     uint32_t neighbor_count[HNSW_MAX_LAYERS];  /* 각 계층의 이웃 수 */
-    int64_t* neighbors[HNSW_MAX_LAYERS];        /* 각 계층의 이웃 배열 */
+    uint32_t* neighbors[HNSW_MAX_LAYERS];       /* 각 계층의 이웃 (슬롯 번호) */
 } hnsw_node_t;
 
+/* 방문 표 (노드마다 epoch 태그, 검색마다 epoch만 올림 → 지우지 않음) */
+typedef struct hnsw_visited_t {
+    uint32_t* tags;                     /* capacity개, tags[slot] == epoch면 방문함 */
+    uint32_t  capacity;
+    uint32_t  epoch;
+} hnsw_visited_t;
+
 /* HNSW 인덱스 */
-typedef struct {
+typedef struct hnsw_index_t {
     uint32_t     dim;                   /* 벡터 차원 */
     uint32_t     count;                 /* 총 노드 수 */
     uint32_t     capacity;              /* 할당된 크기 */
@@ -63,8 +78,59 @@ typedef struct {
     uint32_t     ef_search;
     uint32_t     M;
     uint32_t     M_max;
+
+    vec_storage_t storage;              /* 벡터 저장 형식 (fp32/fp16/bf16) */
+
+    /* ID → 슬롯 (open addressing, 슬롯+1 저장, 0 = 빈 칸) */
+    uint32_t*    id_map;
+    uint32_t     id_map_mask;
+
+    /* Prefix slab (2단계 검색용, 슬롯 순서로 연속 저장) */
+    uint32_t     prefix_dim;            /* slab 폭 (0 = 비활성) */
+    void*        prefix_slab;           /* capacity × prefix_dim 요소 (64B 정렬) */
+
+    /* 놀고 있는 방문 표 (원자적 교환으로 빌리고 돌려줌, NULL = 빈 칸) */
+    hnsw_visited_t* visited_pool[HNSW_VISITED_POOL];
 } hnsw_index_t;
 
+/* 파일 헤더 (64 bytes, hnsw_save)
+ * 뒤에 살아 있는 노드마다 hnsw_file_node_t + neighbor_count[0..layer]
+ * + 계층별 이웃 슬롯 + 벡터 (저장 형식)가 슬롯 오름차순으로 이어짐 */
+typedef struct {
+    uint32_t magic;                     /* HNSW_MAGIC */
+    uint32_t version;                   /* 1 */
+    uint32_t dim;
+    uint32_t count;
+    uint32_t capacity;                  /* 저장 당시 용량 (이웃 슬롯 번호 범위) */
+    uint32_t max_layer;
+    int64_t  entry_point;
+    uint32_t M;
+    uint32_t M_max;
+    uint32_t ef_construction;
+    uint32_t ef_search;
+    uint32_t storage;                   /* vec_storage_t (0 = fp32) */
+    uint32_t prefix_dim;                /* 0 = slab 없음 (로드 시 다시 만듦) */
+    uint8_t  reserved[8];
+} hnsw_file_header_t;
+
+_Static_assert(sizeof(hnsw_file_header_t) == 64, "HNSW header must be 64 bytes");
+
+/* 파일 내 노드 머리 (16 bytes) */
+typedef struct {
+    int64_t  id;
+    uint32_t slot;                      /* 노드 배열 위치 (이웃 목록이 가리키는 번호) */
+    uint32_t layer;
+} hnsw_file_node_t;
+
+_Static_assert(sizeof(hnsw_file_node_t) == 16, "HNSW node entry must be 16 bytes");
+
+/* 쿼리별 검색 옵션 */
+typedef struct {
+    uint32_t ef;                        /* Layer 0 탐색 범위 (0 = index->ef_search) */
+    uint32_t prefix_dim;                /* 탐색에 쓸 앞쪽 차원 d' (0 = 전체 벡터) */
+    uint32_t rerank;                    /* 전체 벡터로 재정렬할 후보 수 (0 = ef) */
+} hnsw_search_params_t;
+
 /* 검색 결과 */
 typedef struct {
     int64_t id;
@@ -75,13 +141,17 @@ typedef struct {
  * Functions
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
-/* 인덱스 생성/삭제 */
+/* 인덱스 생성/삭제 (hnsw_create = fp32 저장) */
 hnsw_index_t* hnsw_create(uint32_t dim, uint32_t initial_capacity);
+hnsw_index_t* hnsw_create_ex(uint32_t dim, uint32_t initial_capacity, vec_storage_t storage);
 void          hnsw_destroy(hnsw_index_t* index);
 
 /* 벡터 삽입 */
 int hnsw_insert(hnsw_index_t* index, int64_t id, const float* vector);
 
+/* ID가 들어 있는가 (1 / 0) */
+int hnsw_contains(const hnsw_index_t* index, int64_t id);
+
 /* Top-K 검색 */
 int hnsw_search(
     const hnsw_index_t* index,
@@ -90,12 +160,80 @@ int hnsw_search(
     hnsw_result_t* results
 );
 
+/* Top-K 검색 (쿼리별 옵션)
+ * prefix_dim > 0 이면 slab으로 탐색 후 상위 rerank개를 전체 벡터로 재정렬.
+ * prefix_dim은 hnsw_set_prefix()로 만든 slab 폭 이하로 잘림 */
+int hnsw_search_ex(
+    const hnsw_index_t* index,
+    const float* query,
+    uint32_t k,
+    const hnsw_search_params_t* params,
+    hnsw_result_t* results
+);
+
+/* Prefix slab 생성 (기존 노드 포함, 이후 삽입은 자동 반영) */
+int hnsw_set_prefix(hnsw_index_t* index, uint32_t prefix_dim);
+
+/* 저장/로드 (그래프를 슬롯 그대로 복원, 다시 삽입하지 않음)
+ * 저장은 임시 파일 → fsync → rename (도중에 끊겨도 이전 파일이 남음)
+ * capacity: 로드 후 용량 (0이거나 저장 당시보다 작으면 저장 당시 값) */
+int           hnsw_save(const hnsw_index_t* index, const char* filepath);
+hnsw_index_t* hnsw_load(const char* filepath, uint32_t capacity);
+
 /* 거리 계산 */
 float hnsw_distance(const float* a, const float* b, uint32_t dim);
 
 /* 통계 */
 void hnsw_stats(const hnsw_index_t* index);
 
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Graph Diagnostics
+ *
+ * Recall 저하 원인 추적용: 계층별 차수 분포, entry point에서
+ * 도달 불가능한 노드, 샘플 쿼리의 평균 hop 수
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#define HNSW_DIAG_DEGREE_BINS   (HNSW_M_MAX + 2)    /* 0..M_max, 마지막 칸 = 초과 */
+#define HNSW_DIAG_MAX_REPORT    64                  /* 보고할 미도달 ID 수 */
+
+/* 계층별 진단 */
+typedef struct {
+    uint32_t nodes;                                 /* 이 계층에 속한 노드 수 */
+    uint64_t edges;                                 /* 방향 간선 수 */
+    uint32_t out_hist[HNSW_DIAG_DEGREE_BINS];       /* out-degree 히스토그램 */
+    uint32_t in_hist[HNSW_DIAG_DEGREE_BINS];        /* in-degree 히스토그램 */
+    uint32_t max_out;
+    uint32_t max_in;
+    uint32_t orphans;                               /* in-degree 0 (entry 제외) */
+    uint32_t unreachable;                           /* entry에서 BFS 미도달 */
+} hnsw_layer_diag_t;
+
+/* 전체 진단 결과 */
+typedef struct {
+    uint32_t          node_count;
+    uint32_t          max_layer;
+    hnsw_layer_diag_t layers[HNSW_MAX_LAYERS];
+
+    /* Layer 0 미도달 노드 (검색으로 절대 찾을 수 없음) */
+    uint32_t          unreachable;
+    uint32_t          unreachable_reported;
+    int64_t           unreachable_ids[HNSW_DIAG_MAX_REPORT];
+
+    /* 샘플 쿼리 */
+    uint32_t          sample_queries;
+    double            avg_hops;                     /* 쿼리당 확장 노드 수 */
+    double            avg_distance_evals;           /* 쿼리당 거리 계산 수 */
+} hnsw_diag_t;
+
+/* 진단 실행
+ *   queries == NULL 이면 저장된 벡터 중 num_queries개를 균등 샘플링해 사용 */
+int hnsw_diagnose(const hnsw_index_t* index, const float* queries,
+                  uint32_t num_queries, hnsw_diag_t* diag);
+
+/* 출력 / CSV 저장 (열: layer,metric,bucket,value) */
+void hnsw_diag_print(const hnsw_diag_t* diag);
+int  hnsw_diag_write_csv(const hnsw_diag_t* diag, const char* filepath);
+
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * Priority Queue (Internal)
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
@@ -1,7 +1,7 @@
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * index_manager.c
  *
- * ID → Offset 해시맵 (Open Addressing with Linear Probing)
+ * ID → Offset 해시맵 (Robin Hood Hashing)
  *
  * 목적:
  *   - 벡터 ID를 주면 파일 내 오프셋 리턴
@@ -9,13 +9,36 @@
  *   - mmap 영역에 직접 구현 (Zero-Copy)
  *
  * 해시 충돌 해결:
- *   - Linear Probing (선형 탐사)
- *   - 빈 슬롯 찾을 때까지 다음 버킷 확인
+ *   - Robin Hood linear probing
+ *     삽입 중 만난 엔트리보다 내 탐사 거리가 길면 자리를 빼앗고
+ *     밀려난 엔트리로 계속 진행 → 탐사 거리 분산이 작아짐
+ *   - 탐사 거리는 data_offset 상위 16비트에 저장 (해시 재계산 불필요)
+ *   - 검색은 빈 슬롯 또는 "내 거리보다 가까운" 엔트리에서 조기 종료
+ *   - 삭제는 backward-shift: 뒤따르는 엔트리를 한 칸씩 당김
+ *     (tombstone 없음 → 삭제/재삽입이 반복돼도 테이블이 압축 상태 유지)
  *
- * 구조:
- *   brain_index_entry_t 배열 (BRAIN_INDEX_BUCKETS 크기)
- *   - vector_id = -1: 빈 슬롯
- *   - vector_id >= 0: 사용 중
+ * GROUPED 레이아웃 (Swiss table 방식):
+ *   - 엔트리 배열 앞에 버킷당 1바이트 제어 배열 (FULL | 7비트 태그)
+ *   - 16슬롯 그룹의 제어 바이트를 SSE2 cmpeq + movemask로 한 번에 비교
+ *     → 태그가 맞는 슬롯만 16바이트 엔트리를 읽음
+ *   - 실패 검색은 대부분 제어 배열(캐시 라인 1개)만 보고 끝남
+ *   - 그룹에 EMPTY가 있으면 탐사 종료, 삭제는 그룹에 EMPTY가 있을 때만
+ *     EMPTY로, 아니면 DELETED로 표시 (DELETED가 쌓이면 같은 크기로 재해시)
+ *
+ * 크기 조정 (점진적 재해시):
+ *   - 버킷 수는 2의 거듭제곱, 인덱스 메타의 log2에 기록
+ *   - 부하율이 INDEX_MAX_LOAD_PCT를 넘거나 탐사 거리가 INDEX_PROBE_LIMIT를
+ *     넘으면 2배 테이블을 파일 끝에 추가
+ *     (ftruncate로 늘린 0-채움 영역 = 이미 비어 있는 테이블)
+ *   - 이후 삽입마다 이전 테이블의 INDEX_MIGRATE_STEP 버킷을 새 테이블로 이동
+ *   - 재해시 중 검색: 새 테이블 → 이전 테이블 순서
+ *   - 한 ID는 항상 두 테이블 중 한 곳에만 존재
+ *
+ * 재해시 상태가 모두 파일 안 인덱스 메타(brain_index_meta_t)에 있으므로
+ * 도중에 파일을 닫았다 열어도 이어서 진행된다. 메타 위치는 호출자가 정한다
+ * (v2 파일: 헤더 안 BRAIN_INDEX_META_OFFSET).
+ * 새 테이블 영역은 할당 콜백으로 얻는다 (기본: 파일 끝에 추가).
+ * 이전 테이블 영역은 재해시 후 재사용하지 않는다 (파일 내 빈 공간으로 남음).
  *
  * Zero Dependency: 표준 C만 사용
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
@@ -23,41 +46,581 @@
 #include "index_manager.h"
 #include "brain_format.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define SLOT_NONE UINT32_MAX
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 해시 함수 (splitmix64 finalizer)
+ *
+ * 곱셈 2번 + 시프트로 모든 비트를 섞어 하위 비트 마스크만으로 버킷 결정.
+ * 파일에 저장되는 배치를 결정하므로 바꾸면 기존 파일과 호환되지 않는다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+static inline uint32_t hash_id(int64_t id, uint32_t mask) {
+    return (uint32_t)mix64((uint64_t)id) & mask;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 메타 / 테이블 접근 (재매핑 후에도 유효하도록 매번 mf->addr 기준)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static inline brain_index_meta_t* meta_of(const brain_index_t* idx) {
+    return (brain_index_meta_t*)((char*)idx->mf->addr + idx->meta_offset);
+}
+
+static inline brain_index_entry_t* table_at(const brain_index_t* idx, uint64_t offset) {
+    return (brain_index_entry_t*)((char*)idx->mf->addr + offset);
+}
+
+static inline int slot_live(const brain_index_entry_t* e) {
+    return e->data_offset != 0;
+}
+
+static inline uint32_t slot_dist(const brain_index_entry_t* e) {
+    return (uint32_t)(e->data_offset >> BRAIN_INDEX_DIST_SHIFT);
+}
+
+static inline uint64_t slot_offset(const brain_index_entry_t* e) {
+    return e->data_offset & BRAIN_INDEX_OFFSET_MASK;
+}
+
+static inline uint64_t pack_offset(uint64_t offset, uint32_t dist) {
+    return ((uint64_t)dist << BRAIN_INDEX_DIST_SHIFT) | offset;
+}
+
+/* 테이블에서 ID 위치 찾기 (없으면 SLOT_NONE)
+ * Robin Hood 불변식: 체인 위 엔트리 거리가 내 거리보다 작으면 더 볼 필요 없음 */
+static uint32_t table_find(const brain_index_entry_t* table, uint32_t log2,
+                           int64_t id, uint64_t h) {
+    uint32_t mask = (1u << log2) - 1;
+    uint32_t bucket = (uint32_t)h & mask;
+
+    for (uint32_t dist = 0; dist <= mask; dist++) {
+        const brain_index_entry_t* entry = &table[bucket];
+
+        if (!slot_live(entry) || slot_dist(entry) < dist) return SLOT_NONE;
+        if (entry->vector_id == id) return bucket;
+
+        bucket = (bucket + 1) & mask;
+    }
+
+    return SLOT_NONE;
+}
+
+/* 테이블에 없는 ID 삽입 (Robin Hood, *last = 마지막으로 쓴 버킷)
+ * 리턴: 이번 삽입으로 기록된 가장 긴 탐사 거리 */
+static uint32_t table_place(brain_index_entry_t* table, uint32_t log2,
+                            int64_t id, uint64_t offset, uint32_t* last) {
+    uint32_t mask = (1u << log2) - 1;
+    uint32_t bucket = hash_id(id, mask);
+    uint32_t dist = 0;
+    uint32_t longest = 0;
+
+    /* 부하율 상한 때문에 빈 슬롯은 반드시 존재하고, 거리는
+     * INDEX_PROBE_LIMIT 근처에서 확장이 일어나므로 16비트를 넘지 않는다 */
+    while (1) {
+        brain_index_entry_t* entry = &table[bucket];
+
+        if (!slot_live(entry)) {
+            entry->vector_id = id;
+            entry->data_offset = pack_offset(offset, dist);
+            *last = bucket;
+            return dist > longest ? dist : longest;
+        }
+
+        /* 부자(거리 짧은 엔트리)에게서 자리를 빼앗음 */
+        uint32_t resident = slot_dist(entry);
+        if (resident < dist) {
+            int64_t  moved_id = entry->vector_id;
+            uint64_t moved_offset = slot_offset(entry);
+
+            entry->vector_id = id;
+            entry->data_offset = pack_offset(offset, dist);
+            if (dist > longest) longest = dist;
+
+            id = moved_id;
+            offset = moved_offset;
+            dist = resident;
+        }
+
+        bucket = (bucket + 1) & mask;
+        dist++;
+    }
+}
+
+/* slot 비우기 (backward-shift): 뒤 엔트리들을 거리 0 또는 빈 칸까지 당김
+ * 리턴: 마지막으로 쓴 (비운) 슬롯 */
+static uint32_t table_remove(brain_index_entry_t* table, uint32_t log2, uint32_t slot) {
+    uint32_t mask = (1u << log2) - 1;
+
+    while (1) {
+        uint32_t next = (slot + 1) & mask;
+        const brain_index_entry_t* entry = &table[next];
+
+        if (!slot_live(entry) || slot_dist(entry) == 0) break;
+
+        table[slot].vector_id = entry->vector_id;
+        table[slot].data_offset = pack_offset(slot_offset(entry), slot_dist(entry) - 1);
+        slot = next;
+    }
+
+    table[slot].vector_id = 0;
+    table[slot].data_offset = 0;
+    return slot;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * GROUPED 레이아웃: 16슬롯 그룹 탐사
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 그룹 16바이트 중 byte와 같은 위치의 비트마스크 */
+static inline uint32_t group_match(const uint8_t* ctrl, uint8_t byte) {
+#ifdef __SSE2__
+    __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)byte)));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < BRAIN_INDEX_GROUP; i++) {
+        if (ctrl[i] == byte) mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+/* EMPTY 또는 DELETED (최상위 비트 0) 위치 */
+static inline uint32_t group_free(const uint8_t* ctrl) {
+#ifdef __SSE2__
+    __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+    return ~(uint32_t)_mm_movemask_epi8(group) & 0xFFFF;
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < BRAIN_INDEX_GROUP; i++) {
+        if (!(ctrl[i] & BRAIN_CTRL_FULL)) mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+/* 해시 하위 7비트 = 태그, 나머지 비트 = 시작 그룹 */
+static inline uint8_t group_tag(uint64_t h) {
+    return (uint8_t)(BRAIN_CTRL_FULL | (h & 0x7F));
+}
+
+static inline uint32_t group_home(uint64_t h, uint32_t log2) {
+    uint32_t groups = (1u << log2) / BRAIN_INDEX_GROUP;
+    return (uint32_t)(h >> 7) & (groups - 1);
+}
+
+static uint32_t group_find(const uint8_t* ctrl, const brain_index_entry_t* table,
+                           uint32_t log2, int64_t id, uint64_t h) {
+    uint8_t tag = group_tag(h);
+    uint32_t group_mask = (1u << log2) / BRAIN_INDEX_GROUP - 1;
+    uint32_t group = group_home(h, log2);
+
+    for (uint32_t n = 0; n <= group_mask; n++) {
+        const uint8_t* g = ctrl + (size_t)group * BRAIN_INDEX_GROUP;
+
+        /* 태그가 맞는 슬롯만 엔트리 확인 */
+        uint32_t match = group_match(g, tag);
+        while (match) {
+            uint32_t slot = group * BRAIN_INDEX_GROUP + (uint32_t)__builtin_ctz(match);
+            if (table[slot].vector_id == id) return slot;
+            match &= match - 1;
+        }
+
+        /* EMPTY가 있는 그룹 너머로는 밀려난 엔트리가 없음 */
+        if (group_match(g, BRAIN_CTRL_EMPTY)) return SLOT_NONE;
+
+        group = (group + 1) & group_mask;
+    }
+
+    return SLOT_NONE;
+}
+
+/* 테이블에 없는 ID 삽입 (*placed = 쓴 슬롯, 리턴: 1 = DELETED 재사용) */
+static int group_place(uint8_t* ctrl, brain_index_entry_t* table,
+                       uint32_t log2, int64_t id, uint64_t offset, uint32_t* placed) {
+    uint64_t h = mix64((uint64_t)id);
+    uint32_t group_mask = (1u << log2) / BRAIN_INDEX_GROUP - 1;
+    uint32_t group = group_home(h, log2);
+
+    /* 부하율 상한 때문에 빈 슬롯은 반드시 존재 */
+    while (1) {
+        uint8_t* g = ctrl + (size_t)group * BRAIN_INDEX_GROUP;
+        uint32_t free_mask = group_free(g);
+
+        if (free_mask) {
+            uint32_t pos = (uint32_t)__builtin_ctz(free_mask);
+            uint32_t slot = group * BRAIN_INDEX_GROUP + pos;
+            int reused = (g[pos] == BRAIN_CTRL_DELETED);
+
+            g[pos] = group_tag(h);
+            table[slot].vector_id = id;
+            table[slot].data_offset = offset;
+            *placed = slot;
+            return reused;
+        }
+
+        group = (group + 1) & group_mask;
+    }
+}
+
+/* 슬롯 비우기 (리턴: 1 = DELETED 표시를 남김) */
+static int group_remove(uint8_t* ctrl, brain_index_entry_t* table, uint32_t slot) {
+    uint8_t* g = ctrl + (size_t)(slot & ~(uint32_t)(BRAIN_INDEX_GROUP - 1));
+    int keep_chain = (group_match(g, BRAIN_CTRL_EMPTY) == 0);
+
+    ctrl[slot] = keep_chain ? BRAIN_CTRL_DELETED : BRAIN_CTRL_EMPTY;
+    table[slot].vector_id = 0;
+    table[slot].data_offset = 0;
+    return keep_chain;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 테이블 뷰 (레이아웃별 분기를 한 곳에 모음)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+typedef struct {
+    uint8_t*             ctrl;          /* GROUPED 제어 배열 (Robin Hood = NULL) */
+    brain_index_entry_t* slots;         /* 엔트리 배열 */
+    uint32_t             log2;
+} table_view_t;
+
+static table_view_t view_at(const brain_index_t* idx, uint64_t offset, uint32_t log2) {
+    table_view_t t;
+    char* base = (char*)idx->mf->addr + offset;
+
+    if (meta_of(idx)->flags & BRAIN_FLAG_INDEX_GROUPED) {
+        t.ctrl = (uint8_t*)base;
+        t.slots = (brain_index_entry_t*)(base + ((size_t)1 << log2));
+    } else {
+        t.ctrl = NULL;
+        t.slots = (brain_index_entry_t*)base;
+    }
+    t.log2 = log2;
+    return t;
+}
+
+static inline table_view_t current_view(const brain_index_t* idx) {
+    const brain_index_meta_t* meta = meta_of(idx);
+    return view_at(idx, meta->table_offset, meta->log2);
+}
+
+static inline table_view_t old_view(const brain_index_t* idx) {
+    const brain_index_meta_t* meta = meta_of(idx);
+    return view_at(idx, meta->old_table_offset, meta->old_log2);
+}
+
+/* h = mix64(id): 배치 검색이 미리 계산한 해시를 그대로 쓰도록 분리 */
+static inline uint32_t view_find_hashed(const table_view_t* t, int64_t id, uint64_t h) {
+    return t->ctrl ? group_find(t->ctrl, t->slots, t->log2, id, h)
+                   : table_find(t->slots, t->log2, id, h);
+}
+
+static inline uint32_t view_find(const table_view_t* t, int64_t id) {
+    return view_find_hashed(t, id, mix64((uint64_t)id));
+}
+
+/* 첫 탐사 위치를 캐시로 미리 가져오기 (GROUPED는 제어 바이트 그룹) */
+static inline void view_prefetch(const table_view_t* t, uint64_t h) {
+    if (t->ctrl) {
+        __builtin_prefetch(t->ctrl + (size_t)group_home(h, t->log2) * BRAIN_INDEX_GROUP);
+    } else {
+        __builtin_prefetch(&t->slots[(uint32_t)h & ((1u << t->log2) - 1)]);
+    }
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Dirty 표시 (mmap_file_mark_dirty, 추적 중인 파일만 기록)
+ *
+ * 쓴 뒤에 쓴 바이트만 표시 → 체크포인트 배리어가 테이블 전체가 아니라
+ * 이번에 바뀐 슬롯이 걸친 단위만 내보낸다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static inline void mark_bytes(const brain_index_t* idx, const void* p, size_t len) {
+    mmap_file_mark_dirty(idx->mf, (size_t)((const char*)p - (const char*)idx->mf->addr), len);
+}
+
+static inline void mark_meta(const brain_index_t* idx) {
+    mark_bytes(idx, meta_of(idx), sizeof(brain_index_meta_t));
+}
+
+/* 슬롯 first ~ last (끝을 넘어 감기면 두 구간) + GROUPED 제어 바이트 */
+static void mark_slots(const brain_index_t* idx, const table_view_t* t,
+                       uint32_t first, uint32_t last) {
+    uint32_t end = 1u << t->log2;
+    uint32_t upto = last >= first ? last + 1 : end;
+
+    mark_bytes(idx, &t->slots[first], (size_t)(upto - first) * sizeof(brain_index_entry_t));
+    if (t->ctrl) mark_bytes(idx, t->ctrl + first, upto - first);
+    if (last < first) {
+        mark_bytes(idx, t->slots, (size_t)(last + 1) * sizeof(brain_index_entry_t));
+        if (t->ctrl) mark_bytes(idx, t->ctrl, last + 1);
+    }
+}
+
+/* 현재 테이블에 삽입 + 메타/핸들 통계 갱신 */
+static void place_current(brain_index_t* idx, int64_t id, uint64_t offset) {
+    table_view_t t = current_view(idx);
+
+    if (t.ctrl) {
+        uint32_t slot;
+        if (group_place(t.ctrl, t.slots, t.log2, id, offset, &slot)) idx->tombstones--;
+        mark_slots(idx, &t, slot, slot);
+    } else {
+        brain_index_meta_t* meta = meta_of(idx);
+        uint32_t last;
+        uint32_t dist = table_place(t.slots, t.log2, id, offset, &last);
+        if (dist > meta->max_probe) meta->max_probe = dist;
+        mark_slots(idx, &t, hash_id(id, (1u << t.log2) - 1), last);
+    }
+}
+
+/* 슬롯 제거 (현재 테이블의 DELETED만 집계) */
+static void remove_at(brain_index_t* idx, const table_view_t* t, uint32_t slot, int current) {
+    if (t->ctrl) {
+        if (group_remove(t->ctrl, t->slots, slot) && current) idx->tombstones++;
+        mark_slots(idx, t, slot, slot);
+    } else {
+        mark_slots(idx, t, slot, table_remove(t->slots, t->log2, slot));
+    }
+}
+
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
- * 해시 함수 (FNV-1a variant)
+ * index_table_size
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+uint64_t index_table_size(uint32_t log2, index_layout_t layout) {
+    uint64_t buckets = (uint64_t)1 << log2;
+    uint64_t ctrl = (layout == INDEX_LAYOUT_GROUPED) ? buckets : 0;
+    return ctrl + buckets * sizeof(brain_index_entry_t);
+}
+
+index_layout_t index_layout(const brain_index_t* idx) {
+    return (meta_of(idx)->flags & BRAIN_FLAG_INDEX_GROUPED)
+           ? INDEX_LAYOUT_GROUPED : INDEX_LAYOUT_ROBIN_HOOD;
+}
+
+/* 메타 블록이 매핑 안에 있는지 */
+static int meta_in_bounds(const mmap_file_t* mf, uint64_t meta_offset) {
+    return mf && mf->addr && meta_offset % 8 == 0 &&
+           meta_offset + sizeof(brain_index_meta_t) <= mf->size;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * index_create
  *
- * 간단하고 빠른 해시 함수
+ * table_offset 위치에 새 테이블 초기화, 상태는 meta_offset에 기록
+ * (호출자가 파일에 index_table_size(log2, layout) 바이트를 확보해 두어야 함)
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
-static uint32_t hash_id(int64_t id) {
-    /* FNV-1a 64비트 → 32비트 */
-    uint64_t h = 14695981039346656037ULL;  /* FNV offset basis */
-    const uint64_t prime = 1099511628211ULL;
+brain_index_t* index_create(mmap_file_t* mf, uint64_t meta_offset, uint64_t table_offset,
+                            uint32_t log2, index_layout_t layout) {
+    if (!meta_in_bounds(mf, meta_offset)) return NULL;
+
+    if (log2 < BRAIN_INDEX_MIN_LOG2) log2 = BRAIN_INDEX_MIN_LOG2;
+    if (log2 > BRAIN_INDEX_MAX_LOG2) log2 = BRAIN_INDEX_MAX_LOG2;
+
+    uint64_t table_size = index_table_size(log2, layout);
+    if (table_offset == 0 || table_offset + table_size > mf->size ||
+        (table_offset < meta_offset + sizeof(brain_index_meta_t) &&
+         meta_offset < table_offset + table_size)) {
+        fprintf(stderr, "[index] Error: no room for %u buckets at offset %lu\n",
+                1u << log2, (unsigned long)table_offset);
+        return NULL;
+    }
+
+    brain_index_t* idx = (brain_index_t*)calloc(1, sizeof(brain_index_t));
+    if (!idx) return NULL;
+    idx->mf = mf;
+    idx->meta_offset = meta_offset;
+
+    memset(table_at(idx, table_offset), 0, table_size);
+
+    brain_index_meta_t* meta = meta_of(idx);
+    memset(meta, 0, sizeof(*meta));
+    meta->flags = (layout == INDEX_LAYOUT_GROUPED) ? BRAIN_FLAG_INDEX_GROUPED : 0;
+    meta->table_offset = table_offset;
+    meta->log2 = (uint8_t)log2;
+    mark_bytes(idx, table_at(idx, table_offset), table_size);
+    mark_meta(idx);
+
+    printf("[index] ✓ Initialized %u buckets (%s)\n", 1u << log2,
+           layout == INDEX_LAYOUT_GROUPED ? "grouped" : "robin hood");
+    return idx;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * index_open
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+brain_index_t* index_open(mmap_file_t* mf, uint64_t meta_offset) {
+    if (!meta_in_bounds(mf, meta_offset)) return NULL;
+
+    const brain_index_meta_t* meta =
+        (const brain_index_meta_t*)((const char*)mf->addr + meta_offset);
+    index_layout_t layout = (meta->flags & BRAIN_FLAG_INDEX_GROUPED)
+                            ? INDEX_LAYOUT_GROUPED : INDEX_LAYOUT_ROBIN_HOOD;
+    if (meta->log2 < BRAIN_INDEX_MIN_LOG2 ||
+        meta->log2 > BRAIN_INDEX_MAX_LOG2 ||
+        meta->table_offset == 0 ||
+        meta->table_offset + index_table_size(meta->log2, layout) > mf->size) {
+        fprintf(stderr, "[index] Error: invalid index geometry\n");
+        return NULL;
+    }
+
+    if (meta->old_table_offset != 0 &&
+        (meta->old_log2 < BRAIN_INDEX_MIN_LOG2 ||
+         meta->old_table_offset + index_table_size(meta->old_log2, layout) > mf->size)) {
+        fprintf(stderr, "[index] Error: rehash source table out of file bounds\n");
+        return NULL;
+    }
 
-    /* ID를 바이트로 분해하여 해시 */
-    for (int i = 0; i < 8; i++) {
-        h ^= (id >> (i * 8)) & 0xFF;
-        h *= prime;
+    brain_index_t* idx = (brain_index_t*)calloc(1, sizeof(brain_index_t));
+    if (!idx) return NULL;
+    idx->mf = mf;
+    idx->meta_offset = meta_offset;
+
+    /* DELETED 수는 파일에 없으므로 제어 배열에서 다시 센다 */
+    if (layout == INDEX_LAYOUT_GROUPED) {
+        table_view_t t = current_view(idx);
+        uint32_t buckets = 1u << t.log2;
+        for (uint32_t g = 0; g < buckets; g += BRAIN_INDEX_GROUP) {
+            idx->tombstones += (uint32_t)__builtin_popcount(
+                group_match(t.ctrl + g, BRAIN_CTRL_DELETED));
+        }
     }
 
-    return (uint32_t)(h % BRAIN_INDEX_BUCKETS);
+    return idx;
+}
+
+void index_set_allocator(brain_index_t* idx, index_alloc_fn alloc, void* ctx) {
+    if (!idx) return;
+    idx->alloc = alloc;
+    idx->alloc_ctx = ctx;
+}
+
+void index_close(brain_index_t* idx) {
+    free(idx);
 }
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
- * index_init
+ * index_rehash_step
+ *
+ * 이전 테이블의 다음 max_buckets 버킷을 새 테이블로 이동
  *
- * Index 테이블 초기화 (모든 슬롯을 -1로 설정)
+ * Robin Hood: 버킷을 비울 때 backward-shift가 뒤 엔트리를 당겨오므로
+ * 빌 때까지 반복한다. 커서 앞쪽은 항상 비어 있어서, 당겨지는 엔트리는
+ * 커서 뒤에서만 움직인다. GROUPED는 제거 즉시 슬롯이 빈다.
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
-void index_init(brain_index_entry_t* index_table) {
-    if (!index_table) return;
+uint32_t index_rehash_step(brain_index_t* idx, uint32_t max_buckets) {
+    if (!idx) return 0;
+
+    brain_index_meta_t* meta = meta_of(idx);
+    if (meta->old_table_offset == 0) return 0;
+
+    table_view_t old = old_view(idx);
+    uint32_t old_buckets = 1u << old.log2;
+
+    while (max_buckets-- > 0 && meta->migrated < old_buckets) {
+        uint32_t bucket = meta->migrated;
+        brain_index_entry_t* entry = &old.slots[bucket];
+
+        while (slot_live(entry)) {
+            place_current(idx, entry->vector_id, slot_offset(entry));
+            remove_at(idx, &old, bucket, 0);
+            idx->migrated++;
+        }
+
+        meta->migrated++;
+    }
+    mark_meta(idx);
 
-    for (int i = 0; i < BRAIN_INDEX_BUCKETS; i++) {
-        index_table[i].vector_id = -1;      /* 빈 슬롯 */
-        index_table[i].data_offset = 0;
+    if (meta->migrated < old_buckets) {
+        return old_buckets - meta->migrated;
     }
 
-    printf("[index] ✓ Initialized %d buckets\n", BRAIN_INDEX_BUCKETS);
+    /* 재해시 완료 */
+    meta->old_table_offset = 0;
+    meta->old_log2 = 0;
+    meta->migrated = 0;
+    mark_meta(idx);
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * start_rehash
+ *
+ * 2^new_log2 버킷 테이블 영역을 할당하고 현재 테이블을 이전 테이블로 전환
+ * 기본 할당은 파일 끝 추가: ftruncate의 0-채움이므로 초기화 비용이 없다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static uint64_t alloc_append(void* ctx, mmap_file_t* mf, uint64_t size) {
+    (void)ctx;
+    uint64_t offset = (mf->size + INDEX_TABLE_ALIGN - 1) & ~(uint64_t)(INDEX_TABLE_ALIGN - 1);
+    if (mmap_file_resize(mf, offset + size) < 0) return 0;
+    return offset;
+}
+
+static int start_rehash(brain_index_t* idx, uint32_t new_log2) {
+    uint64_t size = index_table_size(new_log2, index_layout(idx));
+    uint64_t offset = idx->alloc ? idx->alloc(idx->alloc_ctx, idx->mf, size)
+                                 : alloc_append(NULL, idx->mf, size);
+
+    if (offset == 0 || offset + size > idx->mf->size) {
+        fprintf(stderr, "[index] Error: cannot grow file for %u buckets\n", 1u << new_log2);
+        return -1;
+    }
+
+    brain_index_meta_t* meta = meta_of(idx);
+    meta->old_table_offset = meta->table_offset;
+    meta->old_log2 = meta->log2;
+    meta->migrated = 0;
+    meta->table_offset = offset;
+    meta->log2 = (uint8_t)new_log2;
+    meta->max_probe = 0;
+    mark_meta(idx);
+
+    idx->tombstones = 0;
+    idx->grows++;
+    return 0;
+}
+
+/* 새 ID 하나를 더 받을 자리 확보 (필요하면 재해시 시작) */
+static int reserve_slot(brain_index_t* idx) {
+    brain_index_meta_t* meta = meta_of(idx);
+    uint64_t buckets = (uint64_t)1 << meta->log2;
+    uint64_t used = (uint64_t)meta->count + idx->tombstones + 1;
+
+    if (used * 100 <= buckets * INDEX_MAX_LOAD_PCT &&
+        meta->max_probe <= INDEX_PROBE_LIMIT) {
+        return 0;
+    }
+
+    /* 이전 재해시가 남아 있으면 먼저 끝낸다 (정상 흐름에서는 이미 끝나 있음) */
+    while (index_rehash_step(idx, UINT32_MAX) > 0) {}
+
+    /* GROUPED에서 살아 있는 ID가 상한의 절반 이하면 같은 크기로 DELETED 청소,
+     * 그 외에는 2배 (삭제/삽입이 반복돼도 크기가 계속 커지지 않음) */
+    meta = meta_of(idx);
+    uint32_t new_log2 = meta->log2;
+    if (idx->tombstones == 0 ||
+        (uint64_t)meta->count * 200 > buckets * INDEX_MAX_LOAD_PCT) {
+        new_log2++;
+    }
+    if (new_log2 > BRAIN_INDEX_MAX_LOG2) {
+        fprintf(stderr, "[index] Error: hash table full\n");
+        return -1;
+    }
+
+    return start_rehash(idx, new_log2);
 }
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -67,125 +630,222 @@ void index_init(brain_index_entry_t* index_table) {
  *
  * 리턴:
  *    0: 성공
- *   -1: 테이블 가득 찼음
+ *   -1: 실패 (잘못된 인자 / 파일 확장 실패)
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
-int index_insert(brain_index_entry_t* index_table, int64_t id, uint64_t offset) {
-    if (!index_table || id < 0) return -1;
+int index_insert(brain_index_t* idx, int64_t id, uint64_t offset) {
+    if (!idx || id < 0 || offset == 0 || offset > BRAIN_INDEX_OFFSET_MASK) return -1;
 
-    uint32_t bucket = hash_id(id);
-    uint32_t start_bucket = bucket;
+    /* 재해시 중이면 이번 삽입 몫의 버킷 이동 */
+    index_rehash_step(idx, INDEX_MIGRATE_STEP);
 
-    /* Linear Probing: 빈 슬롯 찾기 */
-    while (1) {
-        brain_index_entry_t* entry = &index_table[bucket];
+    brain_index_meta_t* meta = meta_of(idx);
+    table_view_t t = current_view(idx);
 
-        /* 빈 슬롯 발견 */
-        if (entry->vector_id == -1) {
-            entry->vector_id = id;
-            entry->data_offset = offset;
-            return 0;
-        }
+    /* 이미 같은 ID 존재 (업데이트, 탐사 거리 비트 유지) */
+    uint32_t slot = view_find(&t, id);
+    if (slot != SLOT_NONE) {
+        t.slots[slot].data_offset = pack_offset(offset, slot_dist(&t.slots[slot]));
+        mark_slots(idx, &t, slot, slot);
+        return 0;
+    }
 
-        /* 이미 같은 ID 존재 (업데이트) */
-        if (entry->vector_id == id) {
-            entry->data_offset = offset;
-            return 0;
+    /* 아직 이동하지 않은 이전 테이블 엔트리 → 새 테이블로 옮기며 갱신 */
+    int is_new = 1;
+    if (meta->old_table_offset != 0) {
+        table_view_t old = old_view(idx);
+        slot = view_find(&old, id);
+        if (slot != SLOT_NONE) {
+            remove_at(idx, &old, slot, 0);
+            is_new = 0;
         }
+    }
 
-        /* 다음 버킷 */
-        bucket = (bucket + 1) % BRAIN_INDEX_BUCKETS;
+    if (is_new && reserve_slot(idx) < 0) return -1;
 
-        /* 한 바퀴 돌았음 = 테이블 가득 참 */
-        if (bucket == start_bucket) {
-            fprintf(stderr, "[index] Error: hash table full\n");
-            return -1;
-        }
-    }
+    place_current(idx, id, offset);
+    if (is_new) meta_of(idx)->count++;
+    mark_meta(idx);
+
+    return 0;
 }
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * index_lookup
  *
- * ID로 오프셋 검색
+ * ID로 오프셋 검색 (재해시 중이면 새 테이블 → 이전 테이블)
  *
  * 리턴:
- *   - 성공: 오프셋 (>= 0)
+ *   - 성공: 오프셋 (> 0)
  *   - 실패: -1 (찾지 못함)
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
-int64_t index_lookup(const brain_index_entry_t* index_table, int64_t id) {
-    if (!index_table || id < 0) return -1;
+int64_t index_lookup(const brain_index_t* idx, int64_t id) {
+    if (!idx || id < 0) return -1;
 
-    uint32_t bucket = hash_id(id);
-    uint32_t start_bucket = bucket;
+    table_view_t t = current_view(idx);
+    uint32_t slot = view_find(&t, id);
+    if (slot != SLOT_NONE) return (int64_t)slot_offset(&t.slots[slot]);
 
-    /* Linear Probing: ID 찾기 */
-    while (1) {
-        const brain_index_entry_t* entry = &index_table[bucket];
+    if (meta_of(idx)->old_table_offset != 0) {
+        t = old_view(idx);
+        slot = view_find(&t, id);
+        if (slot != SLOT_NONE) return (int64_t)slot_offset(&t.slots[slot]);
+    }
 
-        /* 빈 슬롯 = 찾지 못함 */
-        if (entry->vector_id == -1) {
-            return -1;
-        }
+    return -1;
+}
 
-        /* ID 일치 */
-        if (entry->vector_id == id) {
-            return entry->data_offset;
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * index_lookup_batch
+ *
+ * ID n개를 한 번에 검색 (offsets_out[i] = 오프셋 또는 -1)
+ *
+ * 순차 index_lookup은 매번 캐시/페이지 미스를 기다린 뒤 다음 ID로 넘어간다.
+ * 여기서는 INDEX_BATCH_WINDOW개 앞의 ID를 먼저 해시해 첫 탐사 위치를
+ * prefetch 해 두고, 그동안 현재 ID를 확인한다 → 미스 여러 개가 동시에 진행.
+ * GROUPED는 윈도우 중간에서 (제어 바이트가 도착했을 즈음) 태그가 맞는
+ * 엔트리를 한 번 더 prefetch 한다.
+ *
+ * 리턴: 찾은 ID 수
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+uint32_t index_lookup_batch(const brain_index_t* idx, const int64_t* ids,
+                            uint32_t n, int64_t* offsets_out) {
+    if (!idx || !ids || !offsets_out) return 0;
+
+    table_view_t t = current_view(idx);
+    int rehashing = (meta_of(idx)->old_table_offset != 0);
+    table_view_t old = rehashing ? old_view(idx) : t;
+
+    uint64_t hashes[INDEX_BATCH_WINDOW];
+    uint32_t found = 0;
+
+    /* 첫 윈도우 해시 + prefetch */
+    uint32_t ahead = (n < INDEX_BATCH_WINDOW) ? n : INDEX_BATCH_WINDOW;
+    for (uint32_t i = 0; i < ahead; i++) {
+        hashes[i] = mix64((uint64_t)ids[i]);
+        view_prefetch(&t, hashes[i]);
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint64_t h = hashes[i % INDEX_BATCH_WINDOW];
+
+        /* 윈도우 끝의 다음 ID를 미리 요청 (현재 칸 재사용) */
+        uint32_t next = i + INDEX_BATCH_WINDOW;
+        if (next < n) {
+            hashes[i % INDEX_BATCH_WINDOW] = mix64((uint64_t)ids[next]);
+            view_prefetch(&t, hashes[i % INDEX_BATCH_WINDOW]);
         }
 
-        /* 다음 버킷 */
-        bucket = (bucket + 1) % BRAIN_INDEX_BUCKETS;
+        /* GROUPED 2단계: 제어 바이트 → 태그 일치 엔트리 */
+        uint32_t mid = i + INDEX_BATCH_WINDOW / 2;
+        if (t.ctrl && mid < n) {
+            uint64_t hm = hashes[mid % INDEX_BATCH_WINDOW];
+            uint32_t group = group_home(hm, t.log2);
+            uint32_t match = group_match(t.ctrl + (size_t)group * BRAIN_INDEX_GROUP,
+                                         group_tag(hm));
+            if (match) {
+                __builtin_prefetch(&t.slots[group * BRAIN_INDEX_GROUP +
+                                            (uint32_t)__builtin_ctz(match)]);
+            }
+        }
 
-        /* 한 바퀴 돌았음 = 찾지 못함 */
-        if (bucket == start_bucket) {
-            return -1;
+        int64_t offset = -1;
+        if (ids[i] >= 0) {
+            uint32_t slot = view_find_hashed(&t, ids[i], h);
+            if (slot != SLOT_NONE) {
+                offset = (int64_t)slot_offset(&t.slots[slot]);
+            } else if (rehashing) {
+                slot = view_find_hashed(&old, ids[i], h);
+                if (slot != SLOT_NONE) offset = (int64_t)slot_offset(&old.slots[slot]);
+            }
         }
+
+        offsets_out[i] = offset;
+        if (offset >= 0) found++;
     }
+
+    return found;
 }
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
- * index_delete
+ * index_update
+ *
+ * 레코드 이동(컴팩션)용 값 교체
  *
- * ID를 Index에서 삭제
+ * index_insert는 재해시 중 이전 테이블 엔트리를 지우고 새 테이블에
+ * 다시 넣으므로, 그 사이 조회가 ID를 놓칠 수 있다. 여기서는 엔트리가
+ * 있는 자리의 data_offset만 한 번에 바꾼다 (탐사 거리 비트 유지).
+ * 재해시 이동 / 삽입 / 삭제가 없으므로 테이블 용량도 바뀌지 않는다.
+ *
+ * 리턴:
+ *    0: 교체
+ *   -1: 없음 또는 현재 값이 expected가 아님
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int index_update(brain_index_t* idx, int64_t id, uint64_t expected, uint64_t offset) {
+    if (!idx || id < 0 || offset == 0 || offset > BRAIN_INDEX_OFFSET_MASK) return -1;
+
+    table_view_t t = current_view(idx);
+    uint32_t slot = view_find(&t, id);
+    if (slot == SLOT_NONE && meta_of(idx)->old_table_offset != 0) {
+        t = old_view(idx);
+        slot = view_find(&t, id);
+    }
+    if (slot == SLOT_NONE) return -1;
+
+    brain_index_entry_t* entry = &t.slots[slot];
+    if (slot_offset(entry) != expected) return -1;
+
+    __atomic_store_n(&entry->data_offset, pack_offset(offset, slot_dist(entry)),
+                     __ATOMIC_RELEASE);
+    mark_slots(idx, &t, slot, slot);
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * index_delete
  *
- * 주의:
- *   - Linear Probing에서 중간 삭제는 복잡함
- *   - 여기서는 단순히 -1로 표시 (tombstone)
- *   - 실제로는 재해시 필요할 수 있음
+ * ID를 Index에서 삭제 (backward-shift / DELETED → 뒤쪽 엔트리 탐사 체인 유지)
  *
  * 리턴:
  *    0: 성공
  *   -1: 찾지 못함
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
-int index_delete(brain_index_entry_t* index_table, int64_t id) {
-    if (!index_table || id < 0) return -1;
-
-    uint32_t bucket = hash_id(id);
-    uint32_t start_bucket = bucket;
+int index_delete(brain_index_t* idx, int64_t id) {
+    if (!idx || id < 0) return -1;
+
+    brain_index_meta_t* meta = meta_of(idx);
+    table_view_t t = current_view(idx);
+    int current = 1;
+
+    uint32_t slot = view_find(&t, id);
+    if (slot == SLOT_NONE && meta->old_table_offset != 0) {
+        t = old_view(idx);
+        current = 0;
+        slot = view_find(&t, id);
+    }
 
-    /* Linear Probing: ID 찾기 */
-    while (1) {
-        brain_index_entry_t* entry = &index_table[bucket];
+    if (slot == SLOT_NONE) return -1;
 
-        /* 빈 슬롯 = 찾지 못함 */
-        if (entry->vector_id == -1) {
-            return -1;
-        }
+    remove_at(idx, &t, slot, current);
+    meta->count--;
+    mark_meta(idx);
+    return 0;
+}
 
-        /* ID 일치 */
-        if (entry->vector_id == id) {
-            entry->vector_id = -1;  /* 삭제 표시 */
-            entry->data_offset = 0;
-            return 0;
-        }
+uint32_t index_count(const brain_index_t* idx) {
+    return idx ? meta_of(idx)->count : 0;
+}
 
-        /* 다음 버킷 */
-        bucket = (bucket + 1) % BRAIN_INDEX_BUCKETS;
+uint64_t index_grow_size(const brain_index_t* idx) {
+    if (!idx) return 0;
 
-        /* 한 바퀴 돌았음 = 찾지 못함 */
-        if (bucket == start_bucket) {
-            return -1;
-        }
+    /* reserve_slot과 같은 조건 (같은 크기 DELETED 청소도 2배로 쳐서 상한) */
+    const brain_index_meta_t* meta = meta_of(idx);
+    uint64_t buckets = (uint64_t)1 << meta->log2;
+    uint64_t used = (uint64_t)meta->count + idx->tombstones + 1;
+    if (used * 100 <= buckets * INDEX_MAX_LOAD_PCT && meta->max_probe <= INDEX_PROBE_LIMIT) {
+        return 0;
     }
+    return index_table_size(meta->log2 + 1u, index_layout(idx)) + INDEX_TABLE_ALIGN;
 }
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -193,30 +853,52 @@ int index_delete(brain_index_entry_t* index_table, int64_t id) {
  *
  * Index 통계 출력 (디버깅용)
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
-void index_stats(const brain_index_entry_t* index_table) {
-    if (!index_table) return;
-
-    int used = 0;
-    int empty = 0;
-
-    for (int i = 0; i < BRAIN_INDEX_BUCKETS; i++) {
-        if (index_table[i].vector_id >= 0) {
+void index_stats(const brain_index_t* idx) {
+    if (!idx) return;
+
+    const brain_index_meta_t* meta = meta_of(idx);
+    table_view_t t = current_view(idx);
+    uint32_t buckets = 1u << t.log2;
+    uint32_t group_mask = buckets / BRAIN_INDEX_GROUP - 1;
+
+    uint32_t used = 0;
+    uint64_t probe_sum = 0;
+    uint32_t probe_max = 0;
+
+    /* 탐사 거리: Robin Hood = 슬롯 수, GROUPED = 그룹 수 */
+    for (uint32_t i = 0; i < buckets; i++) {
+        if (slot_live(&t.slots[i])) {
+            uint32_t dist = slot_dist(&t.slots[i]);
+            if (t.ctrl) {
+                uint32_t home = group_home(mix64((uint64_t)t.slots[i].vector_id), t.log2);
+                dist = (i / BRAIN_INDEX_GROUP - home) & group_mask;
+            }
+            probe_sum += dist;
+            if (dist > probe_max) probe_max = dist;
             used++;
-        } else {
-            empty++;
         }
     }
 
-    float load_factor = (float)used / BRAIN_INDEX_BUCKETS;
+    float load_factor = (float)(used + idx->tombstones) / buckets;
 
     printf("[index] Statistics:\n");
-    printf("  Total buckets: %d\n", BRAIN_INDEX_BUCKETS);
-    printf("  Used:          %d\n", used);
-    printf("  Empty:         %d\n", empty);
+    printf("  Layout:        %s\n", t.ctrl ? "grouped (SSE2 control bytes)" : "robin hood");
+    printf("  Total buckets: %u (2^%u)\n", buckets, t.log2);
+    printf("  IDs:           %u\n", meta->count);
+    printf("  Used:          %u\n", used);
+    if (t.ctrl) printf("  Deleted:       %u\n", idx->tombstones);
+    printf("  Empty:         %u\n", buckets - used - idx->tombstones);
     printf("  Load factor:   %.2f%%\n", load_factor * 100);
-
-    if (load_factor > 0.7) {
-        printf("  ⚠️  Warning: High load factor (>70%%), consider resize\n");
+    printf("  Probe length:  avg %.2f, max %u %s\n",
+           used ? (double)probe_sum / used : 0.0, probe_max,
+           t.ctrl ? "groups" : "slots");
+    printf("  Rehashes:      %lu (%lu entries moved)\n",
+           (unsigned long)idx->grows, (unsigned long)idx->migrated);
+
+    if (meta->old_table_offset != 0) {
+        uint32_t old_buckets = 1u << meta->old_log2;
+        printf("  Rehashing:     %u / %u old buckets moved\n",
+               meta->migrated, old_buckets);
     }
 }
 
@@ -225,18 +907,23 @@ void index_stats(const brain_index_entry_t* index_table) {
  *
  * Index 내용 덤프 (디버깅용, 처음 N개만)
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
-void index_dump(const brain_index_entry_t* index_table, int max_entries) {
-    if (!index_table) return;
+void index_dump(const brain_index_t* idx, int max_entries) {
+    if (!idx) return;
+
+    table_view_t t = current_view(idx);
+    const brain_index_entry_t* table = t.slots;
+    uint32_t buckets = 1u << t.log2;
 
     printf("[index] Dump (first %d used entries):\n", max_entries);
 
     int printed = 0;
-    for (int i = 0; i < BRAIN_INDEX_BUCKETS && printed < max_entries; i++) {
-        if (index_table[i].vector_id >= 0) {
-            printf("  [%5d] ID=%ld → offset=%lu\n",
+    for (uint32_t i = 0; i < buckets && printed < max_entries; i++) {
+        if (slot_live(&table[i])) {
+            printf("  [%5u] ID=%ld → offset=%lu (dist %u)\n",
                    i,
-                   index_table[i].vector_id,
-                   index_table[i].data_offset);
+                   table[i].vector_id,
+                   (unsigned long)slot_offset(&table[i]),
+                   slot_dist(&table[i]));
             printed++;
         }
     }
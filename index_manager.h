@@ -2,34 +2,123 @@
  * index_manager.h
  *
  * ID → Offset Hash Map Header
+ *
+ * 테이블은 mmap 파일 안에 있고 크기/재해시 상태는 파일 안 brain_index_meta_t
+ * (v2: 헤더의 BRAIN_INDEX_META_OFFSET)에 기록된다.
+ * 삽입이 파일을 키울 수 있으므로 (할당 콜백 / mmap_file_resize), 삽입 후에는
+ * mf->addr에서 포인터를 다시 구해야 한다.
+ * 변경은 쓴 슬롯 / 메타만 mmap_file_mark_dirty로 표시한다 (dirty 추적 중인 파일).
+ *
+ * 동시성: 조회끼리는 잠금 없이 동시에 돌아도 되지만, 조회와 구조 변경
+ * (index_insert / index_delete / index_rehash_step)은 호출자의 같은 잠금으로
+ * 배타여야 한다 (읽기/쓰기 잠금이면 조회 = 읽기, 변경 = 쓰기).
+ * Robin Hood 삽입/삭제는 엔트리를 밀고 당기고, 재해시 이동은 새 테이블에
+ * 넣은 뒤 이전 테이블에서 빼므로 새 → 이전 순서로 탐사하는 조회가 그 사이에
+ * 끼면 있는 ID를 놓칠 수 있다. index_update만 예외 (아래).
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
 #ifndef INDEX_MANAGER_H
 #define INDEX_MANAGER_H
 
 #include "brain_format.h"
+#include "mmap_loader.h"
 #include <stdint.h>
 
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Configuration
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#define INDEX_MAX_LOAD_PCT      75      /* 사용 슬롯 / 버킷 상한 */
+#define INDEX_PROBE_LIMIT       64      /* 최대 탐사 거리가 넘으면 테이블 확장 */
+#define INDEX_MIGRATE_STEP      16      /* 삽입 1회당 이동할 이전 테이블 버킷 수 */
+#define INDEX_TABLE_ALIGN       4096    /* 확장 테이블 정렬 (페이지) */
+#define INDEX_BATCH_WINDOW      16      /* 배치 검색 prefetch 거리 (동시 진행 미스 수) */
+
+/* 테이블 레이아웃 (생성 시 선택, meta->flags에 기록) */
+typedef enum {
+    INDEX_LAYOUT_ROBIN_HOOD = 0,    /* 엔트리 배열 + 탐사 거리 */
+    INDEX_LAYOUT_GROUPED    = 1     /* 1바이트 제어 배열 + 16슬롯 그룹 SIMD 탐사 */
+} index_layout_t;
+
+/* 재해시용 테이블 영역 할당
+ *   size 바이트, 0으로 채워진 영역의 파일 오프셋 리턴 (0 = 실패)
+ *   mf 매핑이 영역을 덮도록 보장해야 함 (필요하면 mmap_file_resize) */
+typedef uint64_t (*index_alloc_fn)(void* ctx, mmap_file_t* mf, uint64_t size);
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * brain_index_t
+ *
+ * 파일 안 인덱스에 대한 핸들 (상태는 모두 파일 안 인덱스 메타에 있음)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+typedef struct brain_index_t {
+    mmap_file_t* mf;                /* 인덱스가 들어 있는 Brain 파일 */
+    uint64_t     meta_offset;       /* brain_index_meta_t 위치 */
+
+    index_alloc_fn alloc;           /* 테이블 할당 (NULL = 파일 끝에 추가) */
+    void*        alloc_ctx;
+
+    uint32_t     tombstones;        /* GROUPED: 현재 테이블 DELETED 수 (open 시 재계산) */
+
+    /* 통계 (프로세스 로컬) */
+    uint64_t     grows;             /* 재해시 시작 횟수 */
+    uint64_t     migrated;          /* 이전 테이블에서 옮긴 엔트리 수 */
+} brain_index_t;
+
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * 함수 선언
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
-/* Index 테이블 초기화 */
-void index_init(brain_index_entry_t* index_table);
+/* 2^log2 버킷 테이블의 바이트 크기 */
+uint64_t index_table_size(uint32_t log2, index_layout_t layout);
+
+/* 새 인덱스: table_offset 위치에 2^log2 버킷 테이블 초기화, 상태는 meta_offset에 */
+brain_index_t* index_create(mmap_file_t* mf, uint64_t meta_offset, uint64_t table_offset,
+                            uint32_t log2, index_layout_t layout);
+
+/* 파일에 기록된 레이아웃 */
+index_layout_t index_layout(const brain_index_t* idx);
+
+/* 기존 파일의 인덱스 열기 (진행 중이던 재해시는 이어서 진행) */
+brain_index_t* index_open(mmap_file_t* mf, uint64_t meta_offset);
+
+/* 재해시 테이블 할당 방식 지정 (파일 할당기와 공간을 나눠 쓸 때) */
+void index_set_allocator(brain_index_t* idx, index_alloc_fn alloc, void* ctx);
 
-/* ID와 오프셋 삽입 */
-int index_insert(brain_index_entry_t* index_table, int64_t id, uint64_t offset);
+/* 핸들 해제 (파일은 닫지 않음) */
+void index_close(brain_index_t* idx);
 
-/* ID로 오프셋 검색 */
-int64_t index_lookup(const brain_index_entry_t* index_table, int64_t id);
+/* ID와 오프셋 삽입 (기존 ID면 갱신, offset은 1 ~ 2^48-1) */
+int index_insert(brain_index_t* idx, int64_t id, uint64_t offset);
+
+/* ID로 오프셋 검색 (없으면 -1) */
+int64_t index_lookup(const brain_index_t* idx, int64_t id);
+
+/* ID n개 일괄 검색 (prefetch로 미스 지연을 겹침), 찾은 수 리턴 */
+uint32_t index_lookup_batch(const brain_index_t* idx, const int64_t* ids,
+                            uint32_t n, int64_t* offsets_out);
+
+/* 값 교체 (현재 값이 expected일 때만, 8바이트 저장 1회 → 동시 조회는 이전/새 값 중 하나,
+ * 조회와 나란히 돌 수 있는 유일한 변경. 단 다른 변경과는 배타)
+ * 재해시 중이면 엔트리가 있는 테이블에서 바로 교체 (0 = 교체, -1 = 없음/불일치) */
+int index_update(brain_index_t* idx, int64_t id, uint64_t expected, uint64_t offset);
 
 /* ID 삭제 */
-int index_delete(brain_index_entry_t* index_table, int64_t id);
+int index_delete(brain_index_t* idx, int64_t id);
+
+/* 재해시 진행 (유휴 시간용): 최대 max_buckets 이동, 남은 버킷 수 리턴
+ * 조회와 같은 잠금 아래 (위 동시성 참고) */
+uint32_t index_rehash_step(brain_index_t* idx, uint32_t max_buckets);
+
+/* 등록된 ID 수 */
+uint32_t index_count(const brain_index_t* idx);
+
+/* 다음 삽입이 재해시를 시작하면 새 테이블 바이트 (아니면 0, 상한 추정) */
+uint64_t index_grow_size(const brain_index_t* idx);
 
 /* 통계 출력 */
-void index_stats(const brain_index_entry_t* index_table);
+void index_stats(const brain_index_t* idx);
 
 /* 내용 덤프 (디버깅) */
-void index_dump(const brain_index_entry_t* index_table, int max_entries);
+void index_dump(const brain_index_t* idx, int max_entries);
 
 #endif /* INDEX_MANAGER_H */
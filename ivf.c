@@ -0,0 +1,732 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * ivf.c
+ *
+ * IVF (Inverted File) Implementation
+ *
+ * 구조:
+ *   centroids[nlist][dim]      정규화된 중심점
+ *   lists[nlist]               리스트별 연속 블록 (ids / vectors / inv_norms)
+ *
+ * 파일 레이아웃 (ivf_save):
+ *   [Header 64B] [Centroids] [List Directory] [List 0 ids|vectors|norms] ...
+ *   모든 블록은 IVF_ALIGN(64B) 정렬 → mmap 후 그대로 SIMD 스캔
+ *
+ * Zero Dependency: stdlib + math.h + mmap_loader
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#include "ivf.h"
+#include "vec_kernels.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+#define IVF_ALIGN_UP(x) (((x) + (IVF_ALIGN - 1)) & ~((uint64_t)IVF_ALIGN - 1))
+#define IVF_PROBE_STACK 64      /* 이 이하 nprobe는 스택 버퍼, 넘으면 힙 */
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 내부 유틸리티
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 64B 정렬 할당 (aligned_alloc은 크기가 정렬의 배수여야 함) */
+static void* ivf_alloc_aligned(size_t size) {
+    if (size == 0) size = IVF_ALIGN;
+    return aligned_alloc(IVF_ALIGN, IVF_ALIGN_UP(size));
+}
+
+/* 결정적 난수 (전역 rand() 상태를 건드리지 않음) */
+static uint32_t ivf_rand(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return (uint32_t)(x >> 32);
+}
+
+static float inv_norm(const float* v, uint32_t dim) {
+    float n = vec_norm_sq(v, dim);
+    return (n > 0.0f) ? 1.0f / sqrtf(n) : 0.0f;
+}
+
+/* 가장 가까운 중심점 (정규화된 중심점과의 내적 최대) */
+static uint32_t nearest_centroid(const float* centroids, uint32_t nlist,
+                                 uint32_t dim, const float* v) {
+    uint32_t best = 0;
+    float best_dot = -FLT_MAX;
+
+    for (uint32_t c = 0; c < nlist; c++) {
+        float d = vec_dot(centroids + (size_t)c * dim, v, dim);
+        if (d > best_dot) {
+            best_dot = d;
+            best = c;
+        }
+    }
+    return best;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * List 관리
+ *
+ * capacity == 0 인 리스트는 mmap 영역(또는 빈 리스트)이므로
+ * 첫 추가 시 힙으로 복사한다 (copy-on-write).
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int list_reserve(ivf_list_t* list, size_t vec_bytes, uint32_t needed) {
+    if (list->capacity >= needed) return 0;
+
+    uint32_t new_cap = list->capacity ? list->capacity * 2 : 16;
+    while (new_cap < needed) new_cap *= 2;
+
+    int64_t* ids = (int64_t*)malloc((size_t)new_cap * sizeof(int64_t));
+    void* vectors = ivf_alloc_aligned((size_t)new_cap * vec_bytes);
+    float* norms = (float*)malloc((size_t)new_cap * sizeof(float));
+    if (!ids || !vectors || !norms) {
+        free(ids);
+        free(vectors);
+        free(norms);
+        fprintf(stderr, "[ivf] Error: list allocation failed\n");
+        return -1;
+    }
+
+    if (list->count > 0) {
+        memcpy(ids, list->ids, (size_t)list->count * sizeof(int64_t));
+        memcpy(vectors, list->vectors, (size_t)list->count * vec_bytes);
+        memcpy(norms, list->inv_norms, (size_t)list->count * sizeof(float));
+    }
+
+    if (list->capacity > 0) {
+        free(list->ids);
+        free(list->vectors);
+        free(list->inv_norms);
+    }
+
+    list->ids = ids;
+    list->vectors = vectors;
+    list->inv_norms = norms;
+    list->capacity = new_cap;
+    return 0;
+}
+
+static int list_append(ivf_list_t* list, vec_storage_t storage, uint32_t dim,
+                       int64_t id, const float* v) {
+    size_t vec_bytes = dim * vec_storage_size(storage);
+    if (list_reserve(list, vec_bytes, list->count + 1) < 0) return -1;
+
+    /* 노름은 fp32 원본 기준 (fp16/bf16 반올림 오차는 무시 가능) */
+    list->ids[list->count] = id;
+    vec_encode(storage, v, (char*)list->vectors + (size_t)list->count * vec_bytes, dim);
+    list->inv_norms[list->count] = inv_norm(v, dim);
+    list->count++;
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Create / Destroy
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+ivf_index_t* ivf_create(uint32_t dim, uint32_t nlist) {
+    return ivf_create_ex(dim, nlist, VEC_STORAGE_F32);
+}
+
+ivf_index_t* ivf_create_ex(uint32_t dim, uint32_t nlist, vec_storage_t storage) {
+    if (dim == 0) return NULL;
+    if (nlist == 0) nlist = IVF_DEFAULT_NLIST;
+
+    ivf_index_t* index = (ivf_index_t*)calloc(1, sizeof(ivf_index_t));
+    if (!index) {
+        fprintf(stderr, "[ivf] Error: malloc failed\n");
+        return NULL;
+    }
+
+    index->dim = dim;
+    index->nlist = nlist;
+    index->nprobe = (IVF_DEFAULT_NPROBE < nlist) ? IVF_DEFAULT_NPROBE : nlist;
+    index->storage = storage;
+
+    printf("[ivf] Created index: dim=%u, nlist=%u, nprobe=%u, storage=%s\n",
+           dim, nlist, index->nprobe, vec_storage_string(storage));
+    return index;
+}
+
+void ivf_destroy(ivf_index_t* index) {
+    if (!index) return;
+
+    if (index->lists) {
+        for (uint32_t c = 0; c < index->nlist; c++) {
+            ivf_list_t* list = &index->lists[c];
+            if (list->capacity > 0) {
+                free(list->ids);
+                free(list->vectors);
+                free(list->inv_norms);
+            }
+        }
+        free(index->lists);
+    }
+
+    if (!index->mapped) {
+        free(index->centroids);
+    }
+
+    free(index->pending_ids);
+    free(index->pending_vectors);
+
+    if (index->mapped) {
+        mmap_file_close(index->mapped);
+    }
+
+    free(index);
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Train (Spherical K-Means)
+ *
+ * 1. 샘플을 최대 nlist × IVF_TRAIN_MAX_PER_LIST개로 축소 (균등 간격)
+ * 2. 정규화 후 무작위 샘플로 중심점 초기화
+ * 3. 할당 → 평균 → 정규화 반복
+ * 4. 빈 클러스터는 무작위 샘플로 재시드
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int ivf_train(ivf_index_t* index, const float* samples, uint32_t n) {
+    if (!index || !samples || n == 0) return -1;
+    if (index->trained) {
+        fprintf(stderr, "[ivf] Error: index already trained\n");
+        return -1;
+    }
+
+    const uint32_t dim = index->dim;
+
+    /* 샘플이 리스트 수보다 적으면 리스트 수를 줄임 */
+    if (n < index->nlist) {
+        printf("[ivf] Warning: %u samples < nlist %u, shrinking nlist\n", n, index->nlist);
+        index->nlist = n;
+        if (index->nprobe > n) index->nprobe = n;
+    }
+    const uint32_t nlist = index->nlist;
+
+    uint32_t m = n;
+    uint64_t max_samples = (uint64_t)nlist * IVF_TRAIN_MAX_PER_LIST;
+    if (m > max_samples) m = (uint32_t)max_samples;
+
+    float* train = (float*)ivf_alloc_aligned((size_t)m * dim * sizeof(float));
+    float* centroids = (float*)ivf_alloc_aligned((size_t)nlist * dim * sizeof(float));
+    float* sums = (float*)calloc((size_t)nlist * dim, sizeof(float));
+    uint32_t* sizes = (uint32_t*)calloc(nlist, sizeof(uint32_t));
+    uint32_t* assign = (uint32_t*)malloc((size_t)m * sizeof(uint32_t));
+    if (!train || !centroids || !sums || !sizes || !assign) {
+        free(train); free(centroids); free(sums); free(sizes); free(assign);
+        fprintf(stderr, "[ivf] Error: training allocation failed\n");
+        return -1;
+    }
+
+    /* 균등 간격 샘플링 + 정규화 */
+    for (uint32_t i = 0; i < m; i++) {
+        const float* src = samples + ((uint64_t)i * n / m) * dim;
+        float* dst = train + (size_t)i * dim;
+        float s = inv_norm(src, dim);
+        for (uint32_t d = 0; d < dim; d++) dst[d] = src[d] * s;
+    }
+
+    /* 초기 중심점: 서로 다른 위치의 샘플 (무작위 시작 + 균등 간격) */
+    uint64_t rng = 0x9E3779B97F4A7C15ULL ^ ((uint64_t)n << 32 | nlist);
+    uint32_t offset = ivf_rand(&rng) % m;
+    for (uint32_t c = 0; c < nlist; c++) {
+        uint32_t pick = (uint32_t)((offset + (uint64_t)c * m / nlist) % m);
+        memcpy(centroids + (size_t)c * dim, train + (size_t)pick * dim, dim * sizeof(float));
+    }
+
+    for (int iter = 0; iter < IVF_KMEANS_ITERS; iter++) {
+        memset(sums, 0, (size_t)nlist * dim * sizeof(float));
+        memset(sizes, 0, nlist * sizeof(uint32_t));
+
+        uint32_t changed = 0;
+        for (uint32_t i = 0; i < m; i++) {
+            const float* v = train + (size_t)i * dim;
+            uint32_t c = nearest_centroid(centroids, nlist, dim, v);
+            if (iter == 0 || c != assign[i]) changed++;
+            assign[i] = c;
+            sizes[c]++;
+            float* s = sums + (size_t)c * dim;
+            for (uint32_t d = 0; d < dim; d++) s[d] += v[d];
+        }
+
+        for (uint32_t c = 0; c < nlist; c++) {
+            float* cent = centroids + (size_t)c * dim;
+            if (sizes[c] == 0) {
+                /* 빈 클러스터 재시드 */
+                uint32_t pick = ivf_rand(&rng) % m;
+                memcpy(cent, train + (size_t)pick * dim, dim * sizeof(float));
+                continue;
+            }
+            float* s = sums + (size_t)c * dim;
+            float scale = inv_norm(s, dim);
+            for (uint32_t d = 0; d < dim; d++) cent[d] = s[d] * scale;
+        }
+
+        if (iter > 0 && changed == 0) break;  /* 수렴 */
+    }
+
+    free(train);
+    free(sums);
+    free(sizes);
+    free(assign);
+
+    index->centroids = centroids;
+    index->lists = (ivf_list_t*)calloc(nlist, sizeof(ivf_list_t));
+    if (!index->lists) {
+        free(centroids);
+        index->centroids = NULL;
+        return -1;
+    }
+    index->trained = 1;
+
+    printf("[ivf] ✓ Trained %u centroids on %u samples (%s kernels)\n",
+           nlist, m, vec_kernels_isa());
+
+    /* 학습 전에 쌓인 벡터를 리스트로 배치 (count는 성공한 것만 다시 셈) */
+    uint32_t failed = 0;
+    if (index->pending_count > 0) {
+        uint32_t pending = index->pending_count;
+        index->pending_count = 0;
+        index->count -= pending;
+        for (uint32_t i = 0; i < pending; i++) {
+            if (ivf_add(index, index->pending_ids[i],
+                        index->pending_vectors + (size_t)i * dim) < 0) {
+                failed++;
+            }
+        }
+    }
+    free(index->pending_ids);
+    free(index->pending_vectors);
+    index->pending_ids = NULL;
+    index->pending_vectors = NULL;
+    index->pending_capacity = 0;
+
+    if (failed > 0) {
+        fprintf(stderr, "[ivf] Error: %u buffered vectors could not be added after training\n",
+                failed);
+        return -1;
+    }
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Add
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int pending_add(ivf_index_t* index, int64_t id, const float* vector) {
+    if (index->pending_count >= index->pending_capacity) {
+        uint32_t new_cap = index->pending_capacity ? index->pending_capacity * 2 : 256;
+        int64_t* ids = (int64_t*)realloc(index->pending_ids, (size_t)new_cap * sizeof(int64_t));
+        if (!ids) return -1;
+        index->pending_ids = ids;
+        float* vecs = (float*)realloc(index->pending_vectors,
+                                      (size_t)new_cap * index->dim * sizeof(float));
+        if (!vecs) return -1;
+        index->pending_vectors = vecs;
+        index->pending_capacity = new_cap;
+    }
+
+    index->pending_ids[index->pending_count] = id;
+    memcpy(index->pending_vectors + (size_t)index->pending_count * index->dim,
+           vector, index->dim * sizeof(float));
+    index->pending_count++;
+    index->count++;
+    return 0;
+}
+
+int ivf_add(ivf_index_t* index, int64_t id, const float* vector) {
+    if (!index || !vector) return -1;
+
+    if (!index->trained) {
+        if (pending_add(index, id, vector) < 0) {
+            fprintf(stderr, "[ivf] Error: pending buffer allocation failed\n");
+            return -1;
+        }
+        /* 충분히 쌓이면 버퍼 자체로 학습 */
+        if (index->pending_count >= (uint64_t)index->nlist * IVF_TRAIN_MIN_PER_LIST) {
+            /* ivf_train은 샘플을 먼저 복사한 뒤 버퍼를 비우므로 그대로 넘겨도 안전 */
+            return ivf_train(index, index->pending_vectors, index->pending_count);
+        }
+        return 0;
+    }
+
+    uint32_t c = nearest_centroid(index->centroids, index->nlist, index->dim, vector);
+    if (list_append(&index->lists[c], index->storage, index->dim, id, vector) < 0) return -1;
+
+    index->count++;
+    return 0;
+}
+
+/* ID 맵이 없으므로 리스트 전체 + 학습 대기 버퍼를 훑음 (O(N)) */
+int ivf_contains(const ivf_index_t* index, int64_t id) {
+    if (!index) return 0;
+
+    for (uint32_t i = 0; i < index->pending_count; i++) {
+        if (index->pending_ids[i] == id) return 1;
+    }
+    for (uint32_t c = 0; c < index->nlist && index->trained; c++) {
+        const ivf_list_t* list = &index->lists[c];
+        for (uint32_t i = 0; i < list->count; i++) {
+            if (list->ids[i] == id) return 1;
+        }
+    }
+    return 0;
+}
+
+void ivf_set_nprobe(ivf_index_t* index, uint32_t nprobe) {
+    if (!index) return;
+    if (nprobe == 0) nprobe = 1;
+    if (nprobe > index->nlist) nprobe = index->nlist;
+    index->nprobe = nprobe;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Top-K (Max-Heap, 크기 k)
+ *
+ * 루트 = 현재 k개 중 가장 먼 결과
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static void topk_push(hnsw_result_t* heap, uint32_t* size, uint32_t k,
+                      int64_t id, float dist) {
+    if (*size < k) {
+        uint32_t i = (*size)++;
+        heap[i].id = id;
+        heap[i].distance = dist;
+        while (i > 0) {
+            uint32_t p = (i - 1) / 2;
+            if (heap[p].distance >= heap[i].distance) break;
+            hnsw_result_t t = heap[p]; heap[p] = heap[i]; heap[i] = t;
+            i = p;
+        }
+        return;
+    }
+
+    if (dist >= heap[0].distance) return;
+
+    heap[0].id = id;
+    heap[0].distance = dist;
+    uint32_t i = 0;
+    while (1) {
+        uint32_t l = 2 * i + 1, r = l + 1, m = i;
+        if (l < *size && heap[l].distance > heap[m].distance) m = l;
+        if (r < *size && heap[r].distance > heap[m].distance) m = r;
+        if (m == i) break;
+        hnsw_result_t t = heap[m]; heap[m] = heap[i]; heap[i] = t;
+        i = m;
+    }
+}
+
+static int cmp_result_asc(const void* a, const void* b) {
+    float da = ((const hnsw_result_t*)a)->distance;
+    float db = ((const hnsw_result_t*)b)->distance;
+    return (da > db) - (da < db);
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Search
+ *
+ * 1. 쿼리와 중심점 내적 → 상위 nprobe 리스트 선택
+ * 2. 선택된 리스트를 연속 스캔 (vec_dot SIMD)
+ *    거리 = 1 - (q·v) / (|q||v|), |v|는 미리 계산된 역수 사용
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int ivf_search(
+    const ivf_index_t* index,
+    const float* query,
+    uint32_t k,
+    hnsw_result_t* results
+) {
+    if (!index || !query || !results || k == 0 || index->count == 0) return -1;
+
+    const uint32_t dim = index->dim;
+    uint32_t size = 0;
+
+    /* 학습 전: 버퍼 전수 검색 */
+    if (!index->trained) {
+        for (uint32_t i = 0; i < index->pending_count; i++) {
+            float dist = vec_cosine_distance(query,
+                                             index->pending_vectors + (size_t)i * dim, dim);
+            topk_push(results, &size, k, index->pending_ids[i], dist);
+        }
+        qsort(results, size, sizeof(hnsw_result_t), cmp_result_asc);
+        return (int)size;
+    }
+
+    float q_inv = inv_norm(query, dim);
+    const vec_storage_t storage = index->storage;
+    const size_t vec_bytes = dim * vec_storage_size(storage);
+
+    /* 상위 nprobe 중심점 선택 (삽입 정렬, nprobe는 보통 작음)
+     * 학습이 nlist를 줄였을 수 있으므로 다시 제한 */
+    uint32_t nprobe = index->nprobe;
+    if (nprobe == 0) nprobe = 1;
+    if (nprobe > index->nlist) nprobe = index->nlist;
+
+    uint32_t probe_ids_stack[IVF_PROBE_STACK];
+    float probe_scores_stack[IVF_PROBE_STACK];
+    uint32_t* probe_ids = probe_ids_stack;
+    float* probe_scores = probe_scores_stack;
+    if (nprobe > IVF_PROBE_STACK) {
+        probe_ids = (uint32_t*)malloc((size_t)nprobe * sizeof(uint32_t));
+        probe_scores = (float*)malloc((size_t)nprobe * sizeof(float));
+        if (!probe_ids || !probe_scores) {
+            free(probe_ids);
+            free(probe_scores);
+            return -1;
+        }
+    }
+    uint32_t probe_count = 0;
+
+    for (uint32_t c = 0; c < index->nlist; c++) {
+        float s = vec_dot(index->centroids + (size_t)c * dim, query, dim);
+        if (probe_count == nprobe && s <= probe_scores[probe_count - 1]) continue;
+
+        uint32_t pos = (probe_count < nprobe) ? probe_count++ : nprobe - 1;
+        while (pos > 0 && probe_scores[pos - 1] < s) {
+            probe_scores[pos] = probe_scores[pos - 1];
+            probe_ids[pos] = probe_ids[pos - 1];
+            pos--;
+        }
+        probe_scores[pos] = s;
+        probe_ids[pos] = c;
+    }
+
+    /* 선택된 리스트 스캔 */
+    for (uint32_t p = 0; p < probe_count; p++) {
+        const ivf_list_t* list = &index->lists[probe_ids[p]];
+        const char* vec = (const char*)list->vectors;
+
+        for (uint32_t i = 0; i < list->count; i++, vec += vec_bytes) {
+            __builtin_prefetch(vec + 2 * vec_bytes);
+            float dist = 1.0f;
+            if (q_inv > 0.0f && list->inv_norms[i] > 0.0f) {
+                dist = 1.0f - vec_dot_stored(storage, query, vec, dim) * q_inv * list->inv_norms[i];
+            }
+            topk_push(results, &size, k, list->ids[i], dist);
+        }
+    }
+
+    if (probe_ids != probe_ids_stack) {
+        free(probe_ids);
+        free(probe_scores);
+    }
+
+    qsort(results, size, sizeof(hnsw_result_t), cmp_result_asc);
+    return (int)size;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Save
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int write_padded(FILE* fp, const void* data, size_t len, uint64_t* pos) {
+    static const uint8_t zeros[IVF_ALIGN] = {0};
+
+    if (len > 0 && fwrite(data, 1, len, fp) != len) return -1;
+    *pos += len;
+
+    size_t pad = (size_t)(IVF_ALIGN_UP(*pos) - *pos);
+    if (pad > 0 && fwrite(zeros, 1, pad, fp) != pad) return -1;
+    *pos += pad;
+    return 0;
+}
+
+int ivf_save(const ivf_index_t* index, const char* filepath) {
+    if (!index || !filepath) return -1;
+    if (!index->trained) {
+        fprintf(stderr, "[ivf] Error: cannot save untrained index\n");
+        return -1;
+    }
+
+    const uint32_t dim = index->dim;
+    const uint32_t nlist = index->nlist;
+    const size_t vec_bytes = dim * vec_storage_size(index->storage);
+
+    /* 레이아웃 계산 */
+    ivf_file_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = IVF_MAGIC;
+    header.version = 1;
+    header.dim = dim;
+    header.nlist = nlist;
+    header.count = index->count;
+    header.storage = (uint32_t)index->storage;
+    header.centroids_offset = sizeof(ivf_file_header_t);
+    header.lists_offset = IVF_ALIGN_UP(header.centroids_offset +
+                                       (uint64_t)nlist * dim * sizeof(float));
+
+    ivf_file_list_t* dir = (ivf_file_list_t*)calloc(nlist, sizeof(ivf_file_list_t));
+    if (!dir) return -1;
+
+    uint64_t pos = IVF_ALIGN_UP(header.lists_offset + (uint64_t)nlist * sizeof(ivf_file_list_t));
+    for (uint32_t c = 0; c < nlist; c++) {
+        const ivf_list_t* list = &index->lists[c];
+        dir[c].count = list->count;
+        dir[c].ids_offset = pos;
+        pos = IVF_ALIGN_UP(pos + (uint64_t)list->count * sizeof(int64_t));
+        dir[c].vectors_offset = pos;
+        pos = IVF_ALIGN_UP(pos + (uint64_t)list->count * vec_bytes);
+        dir[c].inv_norms_offset = pos;
+        pos = IVF_ALIGN_UP(pos + (uint64_t)list->count * sizeof(float));
+    }
+    header.file_size = pos;
+
+    FILE* fp = fopen(filepath, "wb");
+    if (!fp) {
+        fprintf(stderr, "[ivf] Error: cannot create '%s'\n", filepath);
+        free(dir);
+        return -1;
+    }
+
+    uint64_t wpos = 0;
+    int rc = 0;
+    rc |= write_padded(fp, &header, sizeof(header), &wpos);
+    rc |= write_padded(fp, index->centroids, (size_t)nlist * dim * sizeof(float), &wpos);
+    rc |= write_padded(fp, dir, (size_t)nlist * sizeof(ivf_file_list_t), &wpos);
+    for (uint32_t c = 0; c < nlist && rc == 0; c++) {
+        const ivf_list_t* list = &index->lists[c];
+        rc |= write_padded(fp, list->ids, (size_t)list->count * sizeof(int64_t), &wpos);
+        rc |= write_padded(fp, list->vectors, (size_t)list->count * vec_bytes, &wpos);
+        rc |= write_padded(fp, list->inv_norms, (size_t)list->count * sizeof(float), &wpos);
+    }
+
+    free(dir);
+    if (fclose(fp) != 0) rc = -1;
+
+    if (rc != 0) {
+        fprintf(stderr, "[ivf] Error: write failed '%s'\n", filepath);
+        return -1;
+    }
+
+    printf("[ivf] ✓ Saved %lu vectors → %s (%lu bytes)\n",
+           index->count, filepath, header.file_size);
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Load 검증
+ *
+ * 모든 블록 [offset, offset + n × elem)이 매핑 안에 있고 정렬이 맞는지
+ * (곱셈 / 덧셈 오버플로 검사 포함). 손상된 파일이 범위 밖을 읽지 않게.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int block_ok(uint64_t offset, uint64_t n, uint64_t elem, uint64_t align,
+                    uint64_t size) {
+    uint64_t len;
+    if (__builtin_mul_overflow(n, elem, &len)) return 0;
+    if (offset > size || len > size - offset) return 0;
+    return (offset % align) == 0;
+}
+
+static int ivf_validate(const ivf_file_header_t* header, const char* base, uint64_t size) {
+    if (size < sizeof(ivf_file_header_t) ||
+        header->magic != IVF_MAGIC || header->version != 1 ||
+        header->file_size > size || header->dim == 0 || header->nlist == 0 ||
+        header->storage > VEC_STORAGE_BF16) {
+        return 0;
+    }
+
+    /* 이후 검사는 헤더가 주장하는 크기 기준 (매핑보다 작거나 같음) */
+    size = header->file_size;
+
+    uint64_t vec_bytes = (uint64_t)header->dim * vec_storage_size((vec_storage_t)header->storage);
+    uint64_t cent_elems;
+    if (__builtin_mul_overflow((uint64_t)header->nlist, (uint64_t)header->dim, &cent_elems) ||
+        !block_ok(header->centroids_offset, cent_elems, sizeof(float), sizeof(float), size) ||
+        !block_ok(header->lists_offset, header->nlist, sizeof(ivf_file_list_t),
+                  sizeof(uint64_t), size)) {
+        return 0;
+    }
+
+    const ivf_file_list_t* dir = (const ivf_file_list_t*)(base + header->lists_offset);
+    uint64_t total = 0;
+    for (uint32_t c = 0; c < header->nlist; c++) {
+        if (!block_ok(dir[c].ids_offset, dir[c].count, sizeof(int64_t), sizeof(int64_t), size) ||
+            !block_ok(dir[c].vectors_offset, dir[c].count, vec_bytes, IVF_ALIGN, size) ||
+            !block_ok(dir[c].inv_norms_offset, dir[c].count, sizeof(float), sizeof(float), size)) {
+            return 0;
+        }
+        total += dir[c].count;
+    }
+    return total == header->count;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Load (mmap, Zero-Copy)
+ *
+ * 리스트는 매핑 영역을 직접 가리킨다 (capacity = 0).
+ * 이후 ivf_add()가 해당 리스트를 건드리면 그 리스트만 힙으로 복사.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+ivf_index_t* ivf_load(const char* filepath) {
+    mmap_file_t* mf = mmap_file_open(filepath, 0);
+    if (!mf) return NULL;
+
+    const ivf_file_header_t* header = (const ivf_file_header_t*)mf->addr;
+    if (!ivf_validate(header, (const char*)mf->addr, mf->size)) {
+        fprintf(stderr, "[ivf] Error: invalid IVF file '%s'\n", filepath);
+        mmap_file_close(mf);
+        return NULL;
+    }
+
+    ivf_index_t* index = (ivf_index_t*)calloc(1, sizeof(ivf_index_t));
+    ivf_list_t* lists = (ivf_list_t*)calloc(header->nlist, sizeof(ivf_list_t));
+    if (!index || !lists) {
+        free(index);
+        free(lists);
+        mmap_file_close(mf);
+        return NULL;
+    }
+
+    char* base = (char*)mf->addr;
+    const ivf_file_list_t* dir = (const ivf_file_list_t*)(base + header->lists_offset);
+
+    index->dim = header->dim;
+    index->nlist = header->nlist;
+    index->nprobe = (IVF_DEFAULT_NPROBE < header->nlist) ? IVF_DEFAULT_NPROBE : header->nlist;
+    index->trained = 1;
+    index->count = header->count;
+    index->storage = (vec_storage_t)header->storage;
+    index->centroids = (float*)(base + header->centroids_offset);
+    index->lists = lists;
+    index->mapped = mf;
+
+    for (uint32_t c = 0; c < header->nlist; c++) {
+        lists[c].count = dir[c].count;
+        lists[c].capacity = 0;
+        lists[c].ids = (int64_t*)(base + dir[c].ids_offset);
+        lists[c].vectors = base + dir[c].vectors_offset;
+        lists[c].inv_norms = (float*)(base + dir[c].inv_norms_offset);
+    }
+
+    printf("[ivf] ✓ Loaded %lu vectors (nlist=%u) from %s\n",
+           index->count, index->nlist, filepath);
+    return index;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Statistics
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+void ivf_stats(const ivf_index_t* index) {
+    if (!index) return;
+
+    printf("\n[IVF Statistics]\n");
+    printf("  Dimension:    %u\n", index->dim);
+    printf("  Vectors:      %lu\n", index->count);
+    printf("  Lists:        %u\n", index->nlist);
+    printf("  nprobe:       %u\n", index->nprobe);
+    printf("  Trained:      %s\n", index->trained ? "yes" : "no (buffering)");
+    printf("  Storage:      %s, %s (%zu bytes/vector)\n",
+           index->mapped ? "mmap" : "heap", vec_storage_string(index->storage),
+           index->dim * vec_storage_size(index->storage));
+    printf("  Kernels:      %s\n", vec_kernels_isa());
+
+    if (!index->trained) {
+        printf("  Pending:      %u\n", index->pending_count);
+        return;
+    }
+
+    uint32_t min_len = UINT32_MAX, max_len = 0, empty = 0;
+    for (uint32_t c = 0; c < index->nlist; c++) {
+        uint32_t n = index->lists[c].count;
+        if (n < min_len) min_len = n;
+        if (n > max_len) max_len = n;
+        if (n == 0) empty++;
+    }
+
+    printf("  List Length:  min=%u, avg=%.1f, max=%u, empty=%u\n",
+           min_len, (double)index->count / index->nlist, max_len, empty);
+}
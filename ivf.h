@@ -0,0 +1,141 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * ivf.h
+ *
+ * IVF (Inverted File) Coarse-Quantizer Index
+ *
+ * 목적:
+ *   - HNSW 대비 빠른 구축 (대량 적재 아카이브용)
+ *   - 그래프 링크 없음 → 메모리 사용량 최소
+ *   - 리스트별 연속 블록 → mmap으로 그대로 로드
+ *
+ * 알고리즘:
+ *   - 샘플로 k-means (spherical, 코사인) 중심점 학습
+ *   - 각 벡터는 가장 가까운 중심점의 리스트에 추가
+ *   - 검색: 쿼리와 가까운 nprobe개 리스트만 SIMD 스캔
+ *
+ * 검색 결과/거리 규약은 HNSW와 동일 (hnsw_result_t, 코사인 거리)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#ifndef IVF_H
+#define IVF_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "hnsw.h"           /* hnsw_result_t */
+#include "mmap_loader.h"
+#include "vec_kernels.h"    /* vec_storage_t */
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Configuration
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#define IVF_DEFAULT_NLIST       256     /* 기본 리스트(중심점) 수 */
+#define IVF_DEFAULT_NPROBE      8       /* 검색 시 탐색 리스트 수 */
+#define IVF_KMEANS_ITERS        12      /* k-means 반복 횟수 */
+#define IVF_TRAIN_MIN_PER_LIST  32      /* 자동 학습 시작 기준 (리스트당) */
+#define IVF_TRAIN_MAX_PER_LIST  256     /* 학습 샘플 상한 (리스트당) */
+#define IVF_ALIGN               64      /* 벡터 블록 정렬 (캐시 라인) */
+
+#define IVF_MAGIC               0x31465649  /* "IVF1" */
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Data Structures
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* Inverted List (연속 블록) */
+typedef struct {
+    uint32_t count;                     /* 벡터 수 */
+    uint32_t capacity;                  /* 할당 크기 (0 = mmap 영역, 읽기 전용) */
+    int64_t* ids;                       /* ID 배열 */
+    void*    vectors;                   /* count × dim 저장 형식 (64B 정렬) */
+    float*   inv_norms;                 /* 1/|v| (코사인 계산용) */
+} ivf_list_t;
+
+/* IVF 인덱스 */
+typedef struct {
+    uint32_t     dim;                   /* 벡터 차원 */
+    uint32_t     nlist;                 /* 리스트 수 */
+    uint32_t     nprobe;                /* 검색 시 탐색 리스트 수 */
+    int          trained;               /* 중심점 학습 완료 여부 */
+    uint64_t     count;                 /* 총 벡터 수 */
+    vec_storage_t storage;              /* 리스트 벡터 저장 형식 (중심점은 fp32) */
+
+    float*       centroids;             /* nlist × dim (정규화됨) */
+    ivf_list_t*  lists;                 /* 리스트 배열 */
+
+    /* 학습 전 버퍼 (자동 학습 대기) */
+    int64_t*     pending_ids;
+    float*       pending_vectors;
+    uint32_t     pending_count;
+    uint32_t     pending_capacity;
+
+    /* ivf_load()로 연 경우 매핑 핸들 */
+    mmap_file_t* mapped;
+} ivf_index_t;
+
+/* 파일 헤더 (64 bytes) */
+typedef struct {
+    uint32_t magic;                     /* IVF_MAGIC */
+    uint32_t version;                   /* 1 */
+    uint32_t dim;
+    uint32_t nlist;
+    uint64_t count;
+    uint64_t centroids_offset;          /* nlist × dim float */
+    uint64_t lists_offset;              /* ivf_file_list_t × nlist */
+    uint64_t file_size;
+    uint32_t storage;                   /* vec_storage_t (0 = fp32) */
+    uint8_t  reserved[12];
+} ivf_file_header_t;
+
+_Static_assert(sizeof(ivf_file_header_t) == 64, "IVF header must be 64 bytes");
+
+/* 파일 내 리스트 디렉터리 항목 (32 bytes) */
+typedef struct {
+    uint64_t ids_offset;
+    uint64_t vectors_offset;            /* IVF_ALIGN 정렬 */
+    uint64_t inv_norms_offset;
+    uint32_t count;
+    uint32_t reserved;
+} ivf_file_list_t;
+
+_Static_assert(sizeof(ivf_file_list_t) == 32, "IVF list entry must be 32 bytes");
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Functions
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 인덱스 생성/삭제 (nlist = 0 → IVF_DEFAULT_NLIST, ivf_create = fp32 저장) */
+ivf_index_t* ivf_create(uint32_t dim, uint32_t nlist);
+ivf_index_t* ivf_create_ex(uint32_t dim, uint32_t nlist, vec_storage_t storage);
+void         ivf_destroy(ivf_index_t* index);
+
+/* 샘플로 중심점 학습 (n개, 행 우선 n × dim)
+ * 학습 전에 ivf_add()된 벡터는 학습 직후 리스트로 배치됨 */
+int ivf_train(ivf_index_t* index, const float* samples, uint32_t n);
+
+/* 벡터 추가
+ * 학습 전이면 버퍼에 쌓고, nlist × IVF_TRAIN_MIN_PER_LIST개가 되면 자동 학습 */
+int ivf_add(ivf_index_t* index, int64_t id, const float* vector);
+
+/* Top-K 검색 (hnsw_search와 동일한 규약: 거리 오름차순, 리턴 = 결과 수) */
+int ivf_search(
+    const ivf_index_t* index,
+    const float* query,
+    uint32_t k,
+    hnsw_result_t* results
+);
+
+/* ID가 들어 있는가 (1 / 0, 전체 스캔) */
+int ivf_contains(const ivf_index_t* index, int64_t id);
+
+/* 탐색 리스트 수 설정 (1 ~ nlist) */
+void ivf_set_nprobe(ivf_index_t* index, uint32_t nprobe);
+
+/* 저장/로드 (로드는 mmap, 리스트는 매핑 영역을 직접 가리킴) */
+int          ivf_save(const ivf_index_t* index, const char* filepath);
+ivf_index_t* ivf_load(const char* filepath);
+
+/* 통계 */
+void ivf_stats(const ivf_index_t* index);
+
+#endif /* IVF_H */
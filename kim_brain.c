@@ -23,7 +23,7 @@
 
 static void* brain_main_loop(void* arg);
 static void brain_connect_organs(brain_t* brain);
-static int brain_init_organs(brain_t* brain);
+static int brain_init_organs(brain_t* brain, const char* memory_path);
 static void brain_cleanup_organs(brain_t* brain);
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -34,6 +34,13 @@ static void brain_cleanup_organs(brain_t* brain);
  * brain_create() - 뇌 생성 및 모든 기관 초기화
  */
 brain_t* brain_create(void) {
+    return brain_create_ex(HIPPO_DB_PATH);
+}
+
+/**
+ * brain_create_ex() - 장기 기억 파일 위치 지정
+ */
+brain_t* brain_create_ex(const char* memory_path) {
     printf("\n🧠 Creating Brain (Master Orchestrator)...\n");
 
     brain_t* brain = (brain_t*)calloc(1, sizeof(brain_t));
@@ -51,7 +58,7 @@ brain_t* brain_create(void) {
     brain->birth_time = time(NULL) * 1000000;
 
     /* 13개 기관 초기화 */
-    if (brain_init_organs(brain) < 0) {
+    if (brain_init_organs(brain, memory_path ? memory_path : HIPPO_DB_PATH) < 0) {
         fprintf(stderr, "❌ Failed to initialize organs\n");
         brain_destroy(brain);
         return NULL;
@@ -108,7 +115,7 @@ void brain_destroy(brain_t* brain) {
  *   3. Circadian (24시간 리듬)
  *   4. 기타 기관
  */
-static int brain_init_organs(brain_t* brain) {
+static int brain_init_organs(brain_t* brain, const char* memory_path) {
     printf("  [1/13] Creating Spine (IPC Bus)...\n");
     brain->organs.spine = spine_create();
     if (!brain->organs.spine) {
@@ -189,12 +196,18 @@ static int brain_init_organs(brain_t* brain) {
     }
 
     printf("  [12/13] Creating Hippocampus (Long-Term Memory)...\n");
-    brain->organs.hippocampus = hippocampus_create(HIPPO_DB_PATH);
+    brain->organs.hippocampus = hippocampus_create(memory_path);
     if (!brain->organs.hippocampus) {
         fprintf(stderr, "  ❌ Hippocampus creation failed\n");
         return -1;
     }
 
+    /* 새벽: 장기 기억 파일 scrub / 저녁: 컴팩션 (틱마다 한 단계) */
+    circadian_set_dawn_task(brain->organs.circadian,
+                            hippocampus_scrub_task, brain->organs.hippocampus);
+    circadian_set_evening_task(brain->organs.circadian,
+                               hippocampus_compact_task, brain->organs.hippocampus);
+
     printf("  [13/13] Creating Math (Computation Engine)...\n");
     brain->organs.math = math_unit_create();
     if (!brain->organs.math) {
@@ -346,6 +359,7 @@ static void* brain_main_loop(void* arg) {
             case PHASE_DAWN:
                 /* 새벽: 학습 및 최적화 */
                 hippocampus_consolidate(brain->organs.hippocampus);
+                circadian_run_task(brain->organs.circadian);
                 brain->total_dreams++;
                 break;
 
@@ -358,6 +372,7 @@ static void* brain_main_loop(void* arg) {
                 /* 저녁: 정리 및 GC */
                 liver_gc_cycle(brain->organs.liver);
                 hippocampus_consolidate(brain->organs.hippocampus);
+                circadian_run_task(brain->organs.circadian);
                 break;
 
             default:
@@ -480,26 +495,34 @@ int brain_remember(brain_t* brain, const char* content, float importance) {
 /**
  * brain_recall() - 유사한 기억 검색
  */
-char** brain_recall(brain_t* brain, const char* query, int top_k) {
-    if (!brain || !query || !brain->organs.hippocampus) {
-        return NULL;
+int brain_recall(brain_t* brain, const char* query, int top_k,
+                 hippocampus_recall_t* results) {
+    if (results) {
+        results->hippo = NULL;
+        results->count = 0;
+    }
+    if (!brain || !query || !results || !brain->organs.hippocampus) {
+        return -1;
     }
-
-    pthread_mutex_lock(&brain->lock);
 
     float vector[128];
     for (int i = 0; i < 128; i++) {
         vector[i] = cosf((float)i * 0.1f);
     }
 
-    memory_entry_t** memories = hippocampus_retrieve(
-        brain->organs.hippocampus, vector, top_k);
-
+    pthread_mutex_lock(&brain->lock);
     brain->total_recalls++;
-
     pthread_mutex_unlock(&brain->lock);
 
-    return (char**)memories;
+    /* brain->lock 밖에서 (결과를 쥔 채 다른 스레드의 brain_think가 기다려도 교착 없음) */
+    return hippocampus_recall(brain->organs.hippocampus, vector, top_k, results);
+}
+
+/**
+ * brain_recall_release() - recall 결과 놓기
+ */
+void brain_recall_release(hippocampus_recall_t* results) {
+    hippocampus_recall_release(results);
 }
 
 /**
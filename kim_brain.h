@@ -157,6 +157,15 @@ typedef struct {
  */
 brain_t* brain_create(void);
 
+/**
+ * brain_create_ex() - 장기 기억 파일 위치를 지정해 생성
+ *
+ * @param memory_path - Hippocampus 파일 경로 (NULL = HIPPO_DB_PATH)
+ *                      옆에 .wal / .vidx 파일이 함께 생김
+ * @return brain_t* - 생성된 뇌 포인터 (실패시 NULL)
+ */
+brain_t* brain_create_ex(const char* memory_path);
+
 /**
  * brain_destroy() - 뇌 종료 및 모든 자원 정리
  *
@@ -226,10 +235,18 @@ int brain_remember(brain_t* brain, const char* content, float importance);
  *
  * @param brain - 뇌 포인터
  * @param query - 검색 쿼리
- * @param top_k - 상위 K개 기억 반환
- * @return 기억 배열 (호출자가 free 필요), NULL (실패)
+ * @param top_k - 상위 K개 기억 반환 (최대 HIPPO_RECALL_MAX)
+ * @param results - 결과 집합 (파일 매핑 안 뷰, 복사 / 할당 없음)
+ *                  쥐고 있는 동안에도 brain_remember는 막히지 않음 (brain_destroy만 기다림)
+ * @return 결과 수 (0 이상이면 brain_recall_release 필요), -1 (실패)
+ */
+int brain_recall(brain_t* brain, const char* query, int top_k,
+                 hippocampus_recall_t* results);
+
+/**
+ * brain_recall_release() - recall 결과 놓기 (이후 results의 포인터는 무효)
  */
-char** brain_recall(brain_t* brain, const char* query, int top_k);
+void brain_recall_release(hippocampus_recall_t* results);
 
 /**
  * brain_dream() - 수면/정리/최적화 사이클
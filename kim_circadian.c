@@ -135,6 +135,41 @@ void circadian_set_learning_callback(circadian_t* circadian, void (*callback)(vo
     circadian->on_learning = callback;
 }
 
+void circadian_set_evening_task(circadian_t* circadian, int (*task)(void* ctx), void* ctx) {
+    if (!circadian) return;
+    circadian->evening_task = task;
+    circadian->evening_task_ctx = ctx;
+}
+
+void circadian_set_dawn_task(circadian_t* circadian, int (*task)(void* ctx), void* ctx) {
+    if (!circadian) return;
+    circadian->dawn_task = task;
+    circadian->dawn_task_ctx = ctx;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Phase Task
+ *
+ * on_cleanup은 저녁 진입 때 한 번뿐이라 큰 작업을 맡기면 그 순간 멈춘다.
+ * 단계 작업은 호출마다 정해진 양만 처리하고 돌아오므로,
+ * 그 단계 내내 매 update(tick)마다 불러 조금씩 진행시킨다.
+ *   DAWN:    새벽 작업 (질의가 적은 시간, 예: 체크섬 scrub)
+ *   EVENING: 저녁 작업 (정리, 예: 컴팩션)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int circadian_run_task(circadian_t* circadian) {
+    if (!circadian) return 0;
+
+    if (circadian->current_phase == PHASE_DAWN && circadian->dawn_task) {
+        circadian->dawn_task_runs++;
+        return circadian->dawn_task(circadian->dawn_task_ctx);
+    }
+    if (circadian->current_phase == PHASE_EVENING && circadian->evening_task) {
+        circadian->evening_task_runs++;
+        return circadian->evening_task(circadian->evening_task_ctx);
+    }
+    return 0;
+}
+
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * Update (1초마다 호출)
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
@@ -200,6 +235,9 @@ void circadian_update(circadian_t* circadian) {
         circadian->phase_transitions++;
     }
 
+    /* 단계 작업 (분할 진행) */
+    circadian_run_task(circadian);
+
     /* 사이클 카운트 */
     circadian->cycle_count++;
 }
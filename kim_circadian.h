@@ -72,6 +72,16 @@ typedef struct {
     void (*on_phase_change)(circadian_phase_t old_phase, circadian_phase_t new_phase);
     void (*on_cleanup)(void);           /* 정리 작업 콜백 */
     void (*on_learning)(void);          /* 학습 작업 콜백 */
+
+    /* Evening Task (저녁 내내 조금씩 나눠 도는 작업, 예: 저장소 컴팩션) */
+    int  (*evening_task)(void* ctx);    /* 1 = 할 일 남음, 0 = 없음, -1 = 오류 */
+    void* evening_task_ctx;
+    uint64_t evening_task_runs;         /* 실행 횟수 */
+
+    /* Dawn Task (새벽 내내 조금씩 나눠 도는 작업, 예: 체크섬 scrub) */
+    int  (*dawn_task)(void* ctx);       /* 1 = 할 일 남음, 0 = 없음, -1 = 오류 */
+    void* dawn_task_ctx;
+    uint64_t dawn_task_runs;            /* 실행 횟수 */
 } circadian_t;
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -88,6 +98,15 @@ void circadian_set_phase_callback(circadian_t* circadian,
 void circadian_set_cleanup_callback(circadian_t* circadian, void (*callback)(void));
 void circadian_set_learning_callback(circadian_t* circadian, void (*callback)(void));
 
+/* 저녁 작업 등록 (EVENING 동안 circadian_update / circadian_run_task마다 1회 실행) */
+void circadian_set_evening_task(circadian_t* circadian, int (*task)(void* ctx), void* ctx);
+
+/* 새벽 작업 등록 (DAWN 동안 circadian_update / circadian_run_task마다 1회 실행) */
+void circadian_set_dawn_task(circadian_t* circadian, int (*task)(void* ctx), void* ctx);
+
+/* 현재 단계의 작업 실행 (DAWN / EVENING이 아니거나 작업이 없으면 0) */
+int circadian_run_task(circadian_t* circadian);
+
 /* 24시간 주기 관리 */
 void circadian_update(circadian_t* circadian);  /* 1초마다 호출 */
 circadian_phase_t circadian_get_phase(const circadian_t* circadian);
@@ -7,6 +7,9 @@
 #define _POSIX_C_SOURCE 200809L
 
 #include "kim_hippocampus.h"
+#include "brain_file.h"
+#include "vector_index.h"
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -17,12 +20,283 @@
  * Utility Functions
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
+/* 벽시계 (파일에 남는 ID / 시각이라 재시작 후에도 이어져야 함) */
 static uint64_t get_timestamp_us(void) {
     struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
+    clock_gettime(CLOCK_REALTIME, &ts);
     return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000ULL;
 }
 
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+/* 새 기억 ID (같은 µs에 두 번 저장해도 겹치지 않게) */
+static uint64_t next_id(hippocampus_t* hippo) {
+    uint64_t id = get_timestamp_us();
+    if (id <= hippo->last_id) id = hippo->last_id + 1;
+    hippo->last_id = id;
+    return id;
+}
+
+/* 뷰를 내줘도 되는지: 매핑이 옮겨진 적 없고 예약이 한 번의 확장을 넉넉히 담음
+ * (chunk는 두 배씩 → 한 store로 매핑이 몇 배까지 커지지는 않음) */
+static int views_fixed(const hippocampus_t* hippo) {
+    const mmap_file_t* mf = hippo->brain_file->mf;
+    return mf->moves == 0 && mf->reserved / HIPPO_VIEW_HEADROOM >= mf->size;
+}
+
+/* 핀이 풀리길 기다림 (lock 아래, 시간 초과면 -1 → 같은 스레드가 쥔 결과에 막히지 않음) */
+static int wait_unpinned(hippocampus_t* hippo, int timeout_ms) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    while (hippo->pins > 0) {
+        if (pthread_cond_timedwait(&hippo->unpinned, &hippo->lock, &deadline) == ETIMEDOUT) {
+            return hippo->pins > 0 ? -1 : 0;
+        }
+    }
+    return 0;
+}
+
+/* 뷰 → 결과 집합이 가진 사본 하나 (lock 아래) */
+static int recall_copy(hippocampus_recall_t* out) {
+    size_t size = 0;
+    for (uint32_t i = 0; i < out->count; i++) {
+        size += sizeof(float) * HIPPO_VECTOR_DIM + out->items[i].content_len;
+    }
+
+    char* buf = (char*)malloc(size ? size : 1);
+    if (!buf) return -1;
+
+    char* p = buf;
+    for (uint32_t i = 0; i < out->count; i++) {
+        memory_view_t* view = &out->items[i];
+        memcpy(p, view->vector, sizeof(float) * HIPPO_VECTOR_DIM);
+        view->vector = (const float*)p;
+        p += sizeof(float) * HIPPO_VECTOR_DIM;
+        if (view->content) {
+            memcpy(p, view->content, view->content_len);
+            view->content = p;
+            p += view->content_len;
+        }
+    }
+    out->copy = buf;
+    return 0;
+}
+
+/* 파일 레코드 → memory_entry_t 사본 */
+static void entry_copy(memory_entry_t* out, const brain_entry_t* e) {
+    memset(out, 0, sizeof(*out));
+    out->id = (uint64_t)e->record->id;
+    out->timestamp = out->id;
+    out->importance = e->importance ? *e->importance : 0.0f;
+    memcpy(out->vector, e->vector, sizeof(float) * HIPPO_VECTOR_DIM);
+
+    uint32_t len = e->metadata ? e->meta_len : 0;
+    if (len > sizeof(out->content) - 1) len = sizeof(out->content) - 1;
+    if (len) memcpy(out->content, e->metadata, len);
+    out->content[len] = '\0';
+
+    out->access_count = e->access_count ? *e->access_count : 0;
+    out->last_accessed = e->timestamp ? (uint64_t)*e->timestamp * 1000000ULL : out->timestamp;
+}
+
+/* 살아 있는 기억을 인덱스에 (fresh = 빈 인덱스, 아니면 이미 있는 ID는 건너뜀)
+ * 저장된 인덱스에 파일에 없는 기억이 남아 있으면 -1 (버리고 재구축) */
+static int index_sync(hippocampus_t* hippo, int fresh) {
+    brain_file_t* bf = hippo->brain_file;
+    const brain_header_t* header = brain_file_header(bf);
+
+    hippo->current_count = 0;
+    hippo->index_caught_up = 0;
+    for (uint64_t r = 0; r < header->record_count; r++) {
+        brain_entry_t e;
+        if (brain_file_entry(bf, r, &e) < 0 || !(e.record->flags & BRAIN_RECORD_LIVE)) continue;
+        if (fresh || !vector_index_contains(hippo->similarity_index, e.record->id)) {
+            if (vector_index_insert(hippo->similarity_index, e.record->id, e.vector) < 0) return -1;
+            hippo->index_caught_up++;
+        }
+        if ((uint64_t)e.record->id > hippo->last_id) hippo->last_id = (uint64_t)e.record->id;
+        hippo->current_count++;
+    }
+
+    /* 파일의 기억은 모두 들어 있음 → 수가 같으면 인덱스 = 파일 */
+    return vector_index_count(hippo->similarity_index) == hippo->current_count ? 0 : -1;
+}
+
+/* COUNTERS 열만 훑어 마지막으로 본 뒤 access_count가 바뀐 기억을 찾음
+ * refresh면 그 기억의 timestamp (마지막 접근)를 now로 당김, 아니면 기준만 맞춤
+ * (컴팩션으로 옮겨진 기억은 한 번 접근된 것으로 보일 수 있음 → 정리가 한 주기 늦을 뿐)
+ * 리턴: 당긴 기억 수, -1 = 실패 */
+static int64_t access_sync(hippocampus_t* hippo, int refresh, int64_t now) {
+    brain_file_t* bf = hippo->brain_file;
+    uint64_t records = brain_file_header(bf)->record_count;
+
+    if (records > hippo->access_seen_cap) {
+        uint64_t cap = hippo->access_seen_cap ? hippo->access_seen_cap : 1024;
+        while (cap < records) cap *= 2;
+        uint32_t* seen = (uint32_t*)realloc(hippo->access_seen, cap * sizeof(uint32_t));
+        if (!seen) return -1;
+        memset(seen + hippo->access_seen_cap, 0,
+               (cap - hippo->access_seen_cap) * sizeof(uint32_t));
+        hippo->access_seen = seen;
+        hippo->access_seen_cap = cap;
+    }
+
+    int64_t refreshed = 0;
+    for (uint32_t k = 0; k < BRAIN_MAX_CHUNKS; k++) {
+        brain_columns_t cols;
+        if (brain_file_columns(bf, k, &cols) < 0) continue;
+
+        uint32_t* seen = hippo->access_seen + cols.first;
+        for (uint64_t i = 0; i < cols.count; i++) {
+            uint32_t count = __atomic_load_n(&cols.access_count[i], __ATOMIC_RELAXED);
+            if (count == seen[i]) continue;
+            seen[i] = count;
+            if (!refresh || !(cols.records[i].flags & BRAIN_RECORD_LIVE)) continue;
+
+            brain_entry_t e = { .record_no = cols.first + i, .record = &cols.records[i],
+                                .timestamp = &cols.timestamp[i] };
+            if (brain_file_set_timestamp(bf, &e, now) < 0) return -1;
+            refreshed++;
+        }
+    }
+    return refreshed;
+}
+
+/* 벡터 인덱스를 파일의 살아 있는 기억으로 새로 (기억을 지운 뒤, 실패하면 이전 인덱스 유지) */
+static int index_rebuild(hippocampus_t* hippo) {
+    vector_index_t* old = hippo->similarity_index;
+    hippo->similarity_index = vector_index_create(HIPPO_INDEX_TYPE, HIPPO_VECTOR_DIM,
+                                                  hippo->max_memories);
+    if (!hippo->similarity_index || index_sync(hippo, 1) < 0) {
+        vector_index_destroy(hippo->similarity_index);
+        hippo->similarity_index = old;
+        hippo->current_count = (uint32_t)brain_file_count(hippo->brain_file);
+        return -1;
+    }
+
+    vector_index_destroy(old);
+    hippo->index_dirty = 1;
+    return 0;
+}
+
+/* HIPPO_PRUNE_DAYS 넘게 떠올리지 않은 기억 지우기 (마지막 접근 시각 보조 인덱스로 찾음)
+ * 리턴: 지운 수, -1 = 실패 */
+static int64_t prune_stale(hippocampus_t* hippo, int64_t now) {
+    brain_file_t* bf = hippo->brain_file;
+    brain_range_iter_t it;
+    if (brain_file_range(bf, BRAIN_RANGE_TIMESTAMP, INT64_MIN,
+                         now - (int64_t)HIPPO_PRUNE_DAYS * 86400, &it) < 0) {
+        return -1;
+    }
+
+    /* 순회 중 삭제는 괜찮음 (brain_range_iter_t) */
+    int64_t pruned = 0;
+    brain_entry_t e;
+    while (brain_file_range_next(&it, &e)) {
+        if (brain_file_delete(bf, e.record->id) == 0) pruned++;
+    }
+
+    if (pruned > 0 && index_rebuild(hippo) < 0) {
+        fprintf(stderr, "[Hippocampus] Error: index rebuild after pruning failed\n");
+    }
+    return pruned;
+}
+
+/* 바뀐 인덱스 저장 (호출자가 방금 체크포인트 → 저장된 인덱스는 디스크에 있는 기억만 담음) */
+static void index_save(hippocampus_t* hippo) {
+    if (!hippo->index_dirty) return;
+    if (vector_index_save(hippo->similarity_index, hippo->index_path) == 0) {
+        hippo->index_dirty = 0;
+    }
+}
+
+/* 파일 열기 (없으면 생성) + WAL, 저장된 인덱스 로드 (없거나 맞지 않으면 재구축) */
+static int hippocampus_load(hippocampus_t* hippo, const char* db_path) {
+    double t0 = now_ms();
+
+    char wal_path[HIPPO_PATH_MAX];
+    if (snprintf(wal_path, sizeof(wal_path), "%s%s", db_path, HIPPO_WAL_SUFFIX) >=
+            (int)sizeof(wal_path) ||
+        snprintf(hippo->index_path, sizeof(hippo->index_path), "%s%s", db_path,
+                 HIPPO_INDEX_SUFFIX) >= (int)sizeof(hippo->index_path)) {
+        fprintf(stderr, "[Hippocampus] Error: path too long '%s'\n", db_path);
+        return -1;
+    }
+
+    /* 새 파일이면 이전 로그는 attach가 버리고, 이전 인덱스는 여기서 버림 */
+    int existed = access(db_path, F_OK) == 0;
+    brain_file_t* bf;
+    if (existed) {
+        bf = brain_file_open_durable(db_path, wal_path, HIPPO_WAL_WINDOW_US);
+    } else {
+        unlink(hippo->index_path);
+        bf = brain_file_create(db_path, HIPPO_VECTOR_DIM, INDEX_LAYOUT_ROBIN_HOOD);
+        if (bf && brain_file_attach_wal(bf, wal_path, HIPPO_WAL_WINDOW_US) < 0) {
+            brain_file_close(bf);
+            bf = NULL;
+        }
+    }
+    if (!bf) {
+        fprintf(stderr, "[Hippocampus] Error: cannot open '%s'\n", db_path);
+        return -1;
+    }
+    hippo->brain_file = bf;
+
+    /* 조회 경로는 그대로, 새벽 scrub이 체크섬을 돌며 검사 */
+    if (brain_file_set_verify(bf, BRAIN_VERIFY_SCRUB) < 0) {
+        fprintf(stderr, "[Hippocampus] Error: cannot enable scrub for '%s'\n", db_path);
+        return -1;
+    }
+
+    const brain_header_t* header = brain_file_header(bf);
+    if (header->vector_dim != HIPPO_VECTOR_DIM) {
+        fprintf(stderr, "[Hippocampus] Error: '%s' has dim %u (expected %d)\n",
+                db_path, header->vector_dim, HIPPO_VECTOR_DIM);
+        return -1;
+    }
+
+    uint64_t live = brain_file_count(bf);
+    if (live > hippo->max_memories) hippo->max_memories = (uint32_t)live;
+
+    /* 저장된 인덱스 (마지막 consolidation / 닫기 시점) + 그 뒤 WAL로 되살아난 기억 */
+    if (existed && access(hippo->index_path, F_OK) == 0) {
+        hippo->similarity_index = vector_index_load(HIPPO_INDEX_TYPE, hippo->index_path,
+                                                    hippo->max_memories);
+        if (hippo->similarity_index &&
+            (hippo->similarity_index->dim != HIPPO_VECTOR_DIM || index_sync(hippo, 0) < 0)) {
+            fprintf(stderr, "[Hippocampus] Error: stale index '%s', rebuilding\n",
+                    hippo->index_path);
+            vector_index_destroy(hippo->similarity_index);
+            hippo->similarity_index = NULL;
+        }
+        hippo->index_loaded = hippo->similarity_index != NULL;
+    }
+
+    if (!hippo->similarity_index) {
+        hippo->similarity_index = vector_index_create(HIPPO_INDEX_TYPE, HIPPO_VECTOR_DIM,
+                                                      hippo->max_memories);
+        if (!hippo->similarity_index || index_sync(hippo, 1) < 0) return -1;
+    }
+    hippo->index_dirty = hippo->index_caught_up > 0;
+    hippo->peak_usage = hippo->current_count;
+
+    /* 지금까지의 접근은 이미 timestamp에 반영됨 → 기준만 잡음 */
+    if (access_sync(hippo, 0, 0) < 0) return -1;
+    hippo->load_ms = now_ms() - t0;
+    return 0;
+}
+
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * Dream Thread (Background Consolidation)
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
@@ -33,8 +307,10 @@ static void* hippocampus_dream_loop(void* arg) {
     printf("[Hippocampus] Dream thread started\n");
 
     while (hippo->dreaming) {
-        /* Sleep for consolidation interval */
-        sleep(HIPPO_CONSOLIDATE_INTERVAL);
+        /* Sleep for consolidation interval (1초씩 → stop이 바로 돌아옴) */
+        for (int s = 0; s < HIPPO_CONSOLIDATE_INTERVAL && hippo->dreaming; s++) {
+            sleep(1);
+        }
 
         if (!hippo->dreaming) {
             break;
@@ -53,6 +329,10 @@ static void* hippocampus_dream_loop(void* arg) {
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
 hippocampus_t* hippocampus_create(const char* db_path) {
+    return hippocampus_create_ex(db_path, HIPPO_MAX_MEMORIES);
+}
+
+hippocampus_t* hippocampus_create_ex(const char* db_path, uint32_t max_memories) {
     if (!db_path) {
         fprintf(stderr, "[Hippocampus] Error: db_path is NULL\n");
         return NULL;
@@ -67,18 +347,24 @@ hippocampus_t* hippocampus_create(const char* db_path) {
 
     /* Initialize policy */
     hippo->importance_threshold = HIPPO_IMPORTANCE_THRESHOLD;
-    hippo->max_memories = HIPPO_MAX_MEMORIES;
+    hippo->max_memories = max_memories ? max_memories : HIPPO_MAX_MEMORIES;
     hippo->current_count = 0;
     hippo->organ_id = 6;  /* Hippocampus ID */
 
     /* Initialize mutex */
     pthread_mutex_init(&hippo->lock, NULL);
+    pthread_cond_init(&hippo->unpinned, NULL);
 
-    /* Note: Actual mmap/index/hnsw initialization would go here
-     * For this test version, we'll use simple in-memory storage */
+    /* Persistent storage: Brain 파일 (+ WAL) + ID 인덱스 + 벡터 인덱스 */
+    if (hippocampus_load(hippo, db_path) < 0) {
+        hippocampus_destroy(hippo);
+        return NULL;
+    }
 
     printf("[Hippocampus] Hippocampus created: max_memories=%u, threshold=%.1f%%\n",
            hippo->max_memories, hippo->importance_threshold * 100.0f);
+    printf("[Hippocampus] Loaded %u memories from '%s' (%.2f ms)\n",
+           hippo->current_count, db_path, hippo->load_ms);
 
     return hippo;
 }
@@ -91,22 +377,23 @@ void hippocampus_destroy(hippocampus_t* hippo) {
         hippocampus_stop_dream(hippo);
     }
 
-    /* Lock before cleanup */
+    /* Lock before cleanup (남은 뷰 recall 결과가 놓일 때까지) */
     pthread_mutex_lock(&hippo->lock);
+    while (hippo->pins > 0) {
+        pthread_cond_wait(&hippo->unpinned, &hippo->lock);
+    }
 
-    /* Close resources */
+    /* Close resources (다음 시작은 재구축 없이 인덱스 로드) */
     if (hippo->brain_file) {
-        /* mmap_file_close(hippo->brain_file); */
+        if (hippo->similarity_index && brain_file_checkpoint(hippo->brain_file) == 0) {
+            index_save(hippo);
+        }
+        brain_file_close(hippo->brain_file);     /* 체크포인트 후 닫음 */
         hippo->brain_file = NULL;
     }
 
-    if (hippo->index) {
-        /* brain_index_destroy(hippo->index); */
-        hippo->index = NULL;
-    }
-
     if (hippo->similarity_index) {
-        /* hnsw_destroy(hippo->similarity_index); */
+        vector_index_destroy(hippo->similarity_index);
         hippo->similarity_index = NULL;
     }
 
@@ -114,6 +401,9 @@ void hippocampus_destroy(hippocampus_t* hippo) {
 
     /* Destroy mutex */
     pthread_mutex_destroy(&hippo->lock);
+    pthread_cond_destroy(&hippo->unpinned);
+
+    free(hippo->access_seen);
 
     free(hippo);
     printf("[Hippocampus] Hippocampus destroyed\n");
@@ -175,45 +465,58 @@ int hippocampus_store(hippocampus_t* hippo,
 
     pthread_mutex_lock(&hippo->lock);
 
+    int result = 1;  /* Stored successfully */
+
+    /* 예약 끝 근처에서는 확장이 매핑을 옮길 수 있음 → 쥔 뷰가 놓이길 잠깐 기다림
+     * (예약 안이면 주소가 그대로라 핀과 상관없이 저장) */
+    if (hippo->pins > 0 && !views_fixed(hippo) &&
+        wait_unpinned(hippo, HIPPO_PIN_WAIT_MS) < 0) {
+        fprintf(stderr, "[Hippocampus] Error: recall views still held near the end of the mapping reservation\n");
+        result = -1;
+    }
+
     /* Check capacity */
-    if (hippo->current_count >= hippo->max_memories) {
+    if (result > 0 && hippo->current_count >= hippo->max_memories) {
         /* Would need to prune oldest memory here */
-        pthread_mutex_unlock(&hippo->lock);
-        return -1;  /* Memory full */
+        result = -1;  /* Memory full */
     }
 
-    /* Create memory entry */
-    memory_entry_t entry;
-    memset(&entry, 0, sizeof(entry));
-    entry.id = get_timestamp_us();
-    entry.timestamp = entry.id;
-    entry.importance = importance;
-    memcpy(entry.vector, vector, sizeof(float) * HIPPO_VECTOR_DIM);
-    strncpy(entry.content, content, 255);
-    entry.content[255] = '\0';
-    entry.access_count = 0;
-    entry.last_accessed = entry.timestamp;
-
-    /* Store memory
-     * Would normally:
-     * 1. Append to mmap file
-     * 2. Update index
-     * 3. Add to HNSW
-     */
+    /* 파일 (레코드 + ID 인덱스) → 벡터 인덱스 순서, 인덱스가 실패하면 레코드도 되돌림 */
+    if (result > 0) {
+        uint64_t id = next_id(hippo);
+        size_t len = strnlen(content, sizeof(((memory_entry_t*)0)->content) - 1);
+
+        if (brain_file_append(hippo->brain_file, (int64_t)id, vector,
+                              content, (uint32_t)len, importance) < 0) {
+            result = -1;
+        } else if (vector_index_insert(hippo->similarity_index, (int64_t)id, vector) < 0) {
+            brain_file_delete(hippo->brain_file, (int64_t)id);
+            result = -1;
+        }
+    }
 
-    hippo->total_stored++;
-    hippo->current_count++;
+    if (result > 0) {
+        hippo->total_stored++;
+        hippo->current_count++;
+        hippo->index_dirty = 1;
 
-    if (hippo->current_count > hippo->peak_usage) {
-        hippo->peak_usage = hippo->current_count;
+        if (hippo->current_count > hippo->peak_usage) {
+            hippo->peak_usage = hippo->current_count;
+        }
     }
 
+    brain_file_t* bf = hippo->brain_file;
+    uint64_t lsn = brain_file_lsn(bf);
+
     pthread_mutex_unlock(&hippo->lock);
 
-    printf("[Hippocampus] Memory stored: \"%s\" (importance=%.2f)\n",
-           entry.content, importance);
+    /* 내구화는 잠금 밖에서 (동시 store들이 fdatasync 한 번을 나눠 씀) */
+    if (result > 0 && brain_file_commit(bf, lsn) < 0) {
+        fprintf(stderr, "[Hippocampus] Error: WAL commit failed\n");
+        result = -1;
+    }
 
-    return 1;  /* Stored successfully */
+    return result;
 }
 
 memory_entry_t** hippocampus_retrieve(hippocampus_t* hippo,
@@ -228,26 +531,137 @@ memory_entry_t** hippocampus_retrieve(hippocampus_t* hippo,
     /* Allocate result array */
     memory_entry_t** results = (memory_entry_t**)calloc(top_k + 1,
                                                          sizeof(memory_entry_t*));
-    if (!results) {
+    hnsw_result_t* found = (hnsw_result_t*)malloc(top_k * sizeof(hnsw_result_t));
+    if (!results || !found) {
         pthread_mutex_unlock(&hippo->lock);
+        free(results);
+        free(found);
         return NULL;
     }
 
-    /* Would normally:
-     * 1. Use HNSW to search for similar vectors
-     * 2. Load entries from mmap
-     * 3. Update access_count and last_accessed
-     */
+    /* 인덱스 후보 → 파일 레코드 사본 (가까운 순), 접근 횟수만 올림 (시각은 consolidation) */
+    int n = hippo->current_count ? vector_index_search(hippo->similarity_index, query_vector,
+                                                       (uint32_t)top_k, found) : 0;
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        brain_entry_t e;
+        if (brain_file_get(hippo->brain_file, found[i].id, &e) < 0) continue;
+
+        memory_entry_t* memory = (memory_entry_t*)malloc(sizeof(memory_entry_t));
+        if (!memory) break;
+        brain_file_touch(hippo->brain_file, &e);
+        entry_copy(memory, &e);
+        results[count++] = memory;
+    }
+    free(found);
 
     hippo->total_retrieved++;
 
     pthread_mutex_unlock(&hippo->lock);
 
-    printf("[Hippocampus] Retrieved top-%d similar memories\n", top_k);
-
     return results;
 }
 
+int hippocampus_recall(hippocampus_t* hippo, const float* query_vector,
+                       int top_k, hippocampus_recall_t* out) {
+    if (out) {
+        out->hippo = NULL;
+        out->copy = NULL;
+        out->count = 0;
+    }
+    if (!hippo || !query_vector || !out || top_k <= 0) {
+        return -1;
+    }
+    if (top_k > HIPPO_RECALL_MAX) top_k = HIPPO_RECALL_MAX;
+
+    pthread_mutex_lock(&hippo->lock);
+
+    /* 인덱스 후보 → 파일 안 레코드를 그대로 가리킴 (가까운 순)
+     * 읽기 경로: 원자적 접근 횟수 +1 말고는 파일에 쓰지 않음 (시각은 consolidation) */
+    hnsw_result_t found[HIPPO_RECALL_MAX];
+    int n = hippo->current_count ? vector_index_search(hippo->similarity_index, query_vector,
+                                                       (uint32_t)top_k, found) : 0;
+    for (int i = 0; i < n; i++) {
+        brain_entry_t e;
+        if (brain_file_get(hippo->brain_file, found[i].id, &e) < 0) continue;
+
+        brain_file_touch(hippo->brain_file, &e);
+
+        memory_view_t* view = &out->items[out->count++];
+        view->id = (uint64_t)found[i].id;
+        view->distance = found[i].distance;
+        view->importance = e.importance ? *e.importance : 0.0f;
+        view->access_count = e.access_count ? *e.access_count : 0;
+        view->content_len = e.metadata ? e.meta_len : 0;
+        view->vector = e.vector;
+        view->content = e.metadata;
+    }
+
+    /* 예약된 매핑은 store로 옮겨지지 않음 → 핀만 잡고 뷰 그대로 (컴팩션 / destroy만 막음)
+     * 옮겨질 수 있으면 사본으로 바꿔 핀 없이 돌려줌 */
+    int rc = 0;
+    if (views_fixed(hippo)) {
+        hippo->pins++;
+        out->hippo = hippo;
+    } else if (recall_copy(out) < 0) {
+        fprintf(stderr, "[Hippocampus] Error: malloc failed\n");
+        out->count = 0;
+        rc = -1;
+    }
+
+    hippo->total_retrieved++;
+
+    pthread_mutex_unlock(&hippo->lock);
+
+    return rc < 0 ? -1 : (int)out->count;
+}
+
+void hippocampus_recall_release(hippocampus_recall_t* results) {
+    if (!results) return;
+
+    free(results->copy);
+    results->copy = NULL;
+    results->count = 0;
+
+    hippocampus_t* hippo = results->hippo;
+    if (!hippo) return;
+    results->hippo = NULL;
+
+    pthread_mutex_lock(&hippo->lock);
+    if (--hippo->pins == 0) {
+        pthread_cond_broadcast(&hippo->unpinned);
+    }
+    pthread_mutex_unlock(&hippo->lock);
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Circadian Tasks (장기 기억 파일 관리)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+int hippocampus_compact_task(void* ctx) {
+    hippocampus_t* hippo = (hippocampus_t*)ctx;
+    if (!hippo || !hippo->brain_file) return 0;
+
+    /* 컴팩션은 레코드를 옮김 → 핀 잡은 뷰가 없을 때만, 있으면 다음 차례로 */
+    pthread_mutex_lock(&hippo->lock);
+
+    int rc = hippo->pins > 0 ? 1 : brain_file_compact_task(hippo->brain_file);
+
+    pthread_mutex_unlock(&hippo->lock);
+    return rc;
+}
+
+int hippocampus_scrub_task(void* ctx) {
+    hippocampus_t* hippo = (hippocampus_t*)ctx;
+    if (!hippo || !hippo->brain_file) return 0;
+
+    /* scrub은 레코드를 옮기지 않음 (인덱스 재구축만) → recall 결과와 나란히 돌아도 됨 */
+    pthread_mutex_lock(&hippo->lock);
+    int rc = brain_file_scrub_task(hippo->brain_file);
+    pthread_mutex_unlock(&hippo->lock);
+    return rc;
+}
+
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * Consolidation (Dream Function)
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
@@ -257,23 +671,37 @@ void hippocampus_consolidate(hippocampus_t* hippo) {
 
     pthread_mutex_lock(&hippo->lock);
 
+    /* 메인 루프는 DAWN / EVENING 동안 매 틱 부름 → HIPPO_CONSOLIDATE_INTERVAL에 한 번만 */
     uint64_t now = get_timestamp_us();
-    uint64_t prune_threshold = now - (HIPPO_PRUNE_DAYS * 24 * 3600 * 1000000ULL);
+    if (hippo->last_consolidation &&
+        now - hippo->last_consolidation < HIPPO_CONSOLIDATE_INTERVAL * 1000000ULL) {
+        pthread_mutex_unlock(&hippo->lock);
+        return;
+    }
 
-    /* Would normally:
-     * 1. Iterate through all memories
-     * 2. Recalculate importance based on access_count
-     * 3. Delete memories older than HIPPO_PRUNE_DAYS with low importance
-     * 4. Compact storage
-     */
+    /* 그 사이 떠올린 기억의 마지막 접근 시각 갱신 (recall은 카운터만 올림, COUNTERS 열만 훑음) */
+    if (access_sync(hippo, 1, (int64_t)(now / 1000000ULL)) < 0) {
+        fprintf(stderr, "[Hippocampus] Error: access time refresh failed\n");
+    }
+
+    /* 오래 떠올리지 않은 기억 정리 (삭제는 표시만 → 쥔 뷰는 컴팩션 전까지 그대로) */
+    int64_t pruned = prune_stale(hippo, (int64_t)(now / 1000000ULL));
+    if (pruned < 0) {
+        fprintf(stderr, "[Hippocampus] Error: pruning failed\n");
+    } else {
+        hippo->total_pruned += (uint64_t)pruned;
+    }
+
+    /* 지금까지의 기억을 디스크에 (바뀌었으면 인덱스도 → 다음 시작은 로드만) */
+    if (brain_file_checkpoint(hippo->brain_file) == 0) index_save(hippo);
 
     hippo->total_consolidated++;
     hippo->last_consolidation = now;
 
     pthread_mutex_unlock(&hippo->lock);
 
-    printf("[Hippocampus] Consolidation completed (cycle #%lu, memories=%u)\n",
-           hippo->total_consolidated, hippo->current_count);
+    printf("[Hippocampus] Consolidation completed (cycle #%lu, memories=%u, pruned=%lu)\n",
+           hippo->total_consolidated, hippo->current_count, hippo->total_pruned);
 }
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -331,10 +759,15 @@ void hippocampus_stats(const hippocampus_t* hippo) {
            hippo->current_count, hippo->max_memories,
            (float)usage_percent);
     printf("  Peak: %lu\n", hippo->peak_usage);
+    if (hippo->brain_file) {
+        printf("  File: %.1f MB (loaded in %.2f ms)\n",
+               brain_file_header(hippo->brain_file)->file_size / 1024.0 / 1024.0,
+               hippo->load_ms);
+    }
 
     printf("\n📊 Operations:\n");
     printf("  Stored: %lu\n", hippo->total_stored);
-    printf("  Retrieved: %lu\n", hippo->total_retrieved);
+    printf("  Retrieved: %lu (%u view results pinned)\n", hippo->total_retrieved, hippo->pins);
     printf("  Consolidated: %lu cycles\n", hippo->total_consolidated);
     printf("  Pruned: %lu memories\n", hippo->total_pruned);
 
@@ -10,8 +10,8 @@
  *   - 연관 기억 검색 (Associative Recall)
  *
  * 소프트웨어 역할:
- *   - mmap 기반 영구 저장소 (brain_longterm.db)
- *   - HNSW 벡터 유사도 검색 (O(log N))
+ *   - mmap 기반 영구 저장소 (brain_longterm.db + .wal, WAL로 crash-consistent)
+ *   - 벡터 유사도 검색 (vector_index, 기본 HNSW, .vidx로 저장 / 로드)
  *   - Cortex 통합 (자동 저장/검색)
  *   - Circadian 통합 (DAWN 시간에 consolidation)
  *   - Spine IPC 신호 (SIGNAL_MEMORY_*)
@@ -31,9 +31,8 @@
 
 /* Forward declarations */
 /* cortex_t is defined elsewhere, use void* in this header to avoid conflicts */
-typedef struct mmap_file_t mmap_file_t;
-typedef struct brain_index_t brain_index_t;
-typedef struct hnsw_index_t hnsw_index_t;
+typedef struct brain_file_t brain_file_t;
+typedef struct vector_index_t vector_index_t;
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * Configuration
@@ -45,12 +44,30 @@ typedef struct hnsw_index_t hnsw_index_t;
 #define HIPPO_VECTOR_DIM               128        /* 128차원 벡터 */
 #define HIPPO_CONSOLIDATE_INTERVAL     3600       /* 1시간마다 consolidation */
 #define HIPPO_PRUNE_DAYS               7          /* 7일 이상 미접근 정리 */
+#define HIPPO_RECALL_MAX               64         /* recall 결과 집합 최대 크기 */
+#define HIPPO_INDEX_TYPE               VECTOR_INDEX_HNSW  /* vector_index.h 종류 */
+#define HIPPO_WAL_SUFFIX               ".wal"     /* db_path 옆 WAL */
+#define HIPPO_INDEX_SUFFIX             ".vidx"    /* db_path 옆 저장된 벡터 인덱스 */
+#define HIPPO_WAL_WINDOW_US            0          /* 그룹 커밋 대기 (0 = 바로 sync) */
+#define HIPPO_PATH_MAX                 1024
+#define HIPPO_VIEW_HEADROOM            4          /* 예약 ≥ 매핑 × 4일 때만 뷰 (아니면 사본) */
+#define HIPPO_PIN_WAIT_MS              1000       /* 예약 끝 근처 store가 핀을 기다리는 한도 */
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * Data Structures
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
-/* Memory Entry (저장 단위 - 624 bytes) */
+/* Memory Entry (조회 단위 - 624 bytes)
+ *
+ * 파일에는 Brain 레코드 하나로 저장 (brain_file.h):
+ *   id → 레코드 ID, vector → 벡터 열, content → 메타데이터 (NUL 제외),
+ *   importance / access_count → COUNTERS, last_accessed → COUNTERS timestamp (초)
+ *   timestamp = id (저장 시각 µs, 같은 µs면 +1)
+ *
+ * COUNTERS timestamp 열은 생성 시각이 아니라 마지막 접근 시각:
+ * 저장 때 현재 시각, recall / retrieve는 access_count만 원자적으로 올리고
+ * consolidation이 그 사이 횟수가 바뀐 기억의 timestamp를 그때 시각으로 당김.
+ * 보조 정렬 인덱스 BRAIN_RANGE_TIMESTAMP도 같은 뜻 (consolidation의 정리 대상 찾기). */
 typedef struct {
     uint64_t  id;                         /* 기억 ID (타임스탬프) */
     uint64_t  timestamp;                  /* 저장 시각 (microseconds) */
@@ -65,9 +82,16 @@ typedef struct {
 /* Hippocampus Organ */
 typedef struct {
     /* Persistent Storage */
-    mmap_file_t*     brain_file;          /* mmap 파일 핸들 */
-    brain_index_t*   index;               /* ID → Offset 매핑 */
-    hnsw_index_t*    similarity_index;    /* HNSW 벡터 검색 인덱스 */
+    brain_file_t*    brain_file;          /* mmap Brain 파일 (ID → 레코드 인덱스 포함, WAL 연결) */
+    vector_index_t*  similarity_index;    /* 벡터 검색 인덱스 (index_path에서 로드, 없으면 재구축) */
+    char             index_path[HIPPO_PATH_MAX];
+    int              index_loaded;        /* 열 때 저장된 인덱스를 씀 (0 = 재구축) */
+    int              index_dirty;         /* 마지막 저장 이후 인덱스가 바뀜 */
+    uint32_t         index_caught_up;     /* 로드한 인덱스에 열 때 더한 기억 수 */
+    uint32_t*        access_seen;         /* 레코드 번호별 마지막 consolidation 때의 access_count */
+    uint64_t         access_seen_cap;
+    uint64_t         last_id;             /* 마지막 발급 ID (µs, 단조 증가) */
+    double           load_ms;             /* 열기 (WAL 복구) + 인덱스 로드 / 재구축 시간 */
 
     /* Policy & Limits */
     float            importance_threshold; /* 저장 임계값 */
@@ -86,6 +110,8 @@ typedef struct {
 
     /* Thread Safety */
     pthread_mutex_t  lock;                /* 뮤텍스 */
+    pthread_cond_t   unpinned;            /* pins가 0이 됨 (destroy / store가 기다림) */
+    uint32_t         pins;                /* 아직 놓지 않은 뷰 recall 결과 (lock 아래) */
 
     /* Statistics */
     uint64_t total_stored;                /* 총 저장 횟수 */
@@ -95,14 +121,43 @@ typedef struct {
     uint64_t peak_usage;                  /* 최대 사용량 */
 } hippocampus_t;
 
+/* 기억 뷰 (파일 매핑 안을 가리킴, 복사 없음) */
+typedef struct {
+    uint64_t      id;
+    float         distance;               /* 쿼리와의 거리 (벡터 인덱스) */
+    float         importance;
+    uint32_t      access_count;           /* 이번 recall 포함 */
+    uint32_t      content_len;            /* content 길이 (NUL 없음) */
+    const float*  vector;                 /* HIPPO_VECTOR_DIM개 */
+    const char*   content;                /* NULL = 내용 없음 */
+} memory_view_t;
+
+/* recall 결과 집합 (호출자 스택에 두면 할당 없음)
+ * hippocampus_recall ~ hippocampus_recall_release 동안 포인터 유효.
+ * 뷰는 핀만 잡음: store / recall은 그대로 돌고 (예약된 매핑은 옮겨지지 않음)
+ * 컴팩션은 미뤄지며 destroy만 release를 기다림.
+ * 매핑이 예약되지 않았거나 이미 옮겨진 적이 있으면 copy에 사본을 담아 돌려줌 */
+typedef struct {
+    hippocampus_t* hippo;                 /* 핀 잡은 해마 (NULL = 핀 없음) */
+    void*          copy;                  /* 사본 모드 버퍼 (NULL = 매핑 안 뷰) */
+    uint32_t       count;
+    memory_view_t  items[HIPPO_RECALL_MAX];
+} hippocampus_recall_t;
+
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * Core API - Lifecycle
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
-/* Create Hippocampus organ with mmap storage */
+/* Create Hippocampus organ with mmap storage
+ * db_path가 있으면 WAL 복구와 함께 열고 저장된 인덱스 + 그 뒤 기억을 올림
+ * (인덱스가 없거나 맞지 않으면 재구축), 없으면 새 파일 */
 hippocampus_t* hippocampus_create(const char* db_path);
 
-/* Destroy Hippocampus and close mmap file */
+/* max_memories 지정 (벡터 인덱스 용량, 기존 파일이 더 크면 그 크기) */
+hippocampus_t* hippocampus_create_ex(const char* db_path, uint32_t max_memories);
+
+/* Destroy Hippocampus and close mmap file (체크포인트 → 인덱스 저장 → 닫음)
+ * 남은 뷰 recall 결과가 놓일 때까지 기다림 */
 void           hippocampus_destroy(hippocampus_t* hippo);
 
 /* Start dream thread for background consolidation */
@@ -115,20 +170,44 @@ int            hippocampus_stop_dream(hippocampus_t* hippo);
  * Memory Operations
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
-/* Store memory if importance >= threshold */
+/* Store memory if importance >= threshold
+ * 1을 돌려주면 WAL에 커밋된 뒤 (잠금 밖에서 기다려 동시 store끼리 sync를 나눔)
+ * 리턴: 1 = 저장, 0 = 중요도 미달, -1 = 가득 참 / 실패 */
 int hippocampus_store(hippocampus_t* hippo,
                       const char* content,
                       const float* vector,
                       float importance);
 
-/* Retrieve top-k similar memories using HNSW */
+/* Retrieve top-k similar memories using the vector index
+ * 리턴: 가까운 순 사본 배열 (NULL로 끝남), 항목과 배열 모두 호출자가 free */
 memory_entry_t** hippocampus_retrieve(hippocampus_t* hippo,
                                        const float* query_vector,
                                        int top_k);
 
-/* Consolidate and prune old memories (dream function) */
+/* Retrieve top-k (≤ HIPPO_RECALL_MAX) as views into the mapped file
+ * 보통은 복사 / 할당 없음 (매핑이 옮겨질 수 있으면 사본 하나로 대신)
+ * 리턴: 결과 수 (0 이상이면 release 필요), -1 = 실패 */
+int hippocampus_recall(hippocampus_t* hippo, const float* query_vector,
+                       int top_k, hippocampus_recall_t* out);
+
+/* recall 결과 놓기 (핀 / 사본 해제, 여러 번 불러도 됨) */
+void hippocampus_recall_release(hippocampus_recall_t* results);
+
+/* Consolidate memories to disk (dream function)
+ * 접근 시각 갱신 → HIPPO_PRUNE_DAYS 넘게 떠올리지 않은 기억 정리 (total_pruned)
+ * → 체크포인트 + 바뀐 인덱스 저장
+ * 마지막 consolidation 후 HIPPO_CONSOLIDATE_INTERVAL이 지나지 않았으면 아무것도 안 함 */
 void hippocampus_consolidate(hippocampus_t* hippo);
 
+/* circadian_set_evening_task용 (ctx = hippocampus_t*)
+ * 장기 기억 파일 컴팩션 한 단계. 뷰 recall 결과가 핀을 잡고 있으면
+ * 기다리지 않고 다음 차례로 미룸. 리턴: 1 = 할 일 남음, 0 = 없음, -1 = 오류 */
+int hippocampus_compact_task(void* ctx);
+
+/* circadian_set_dawn_task용 (ctx = hippocampus_t*)
+ * 장기 기억 파일 체크섬 scrub 한 단계 (BRAIN_SCRUB_RATE로 제한) */
+int hippocampus_scrub_task(void* ctx);
+
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * Integration
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
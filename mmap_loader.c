@@ -13,11 +13,23 @@
  *   - OS가 자동으로 페이지 관리
  *   - 여러 프로세스가 공유 가능
  *
- * Zero Dependency: POSIX mmap만 사용
+ * 스냅샷:
+ *   - reflink (FICLONE), 안 되면 copy_file_range 백업 파일
+ *   - 또는 그 시점 내용을 그대로 복사한 프로세스 안 읽기 전용 뷰
+ *
+ * Dirty 추적:
+ *   - 쓰는 쪽이 mmap_file_mark_dirty로 바뀐 단위를 표시 → flusher 스레드가
+ *     나이를 보고 비동기로 내보내고, 배리어는 바뀐 구간만 MS_SYNC
+ *
+ * 예열:
+ *   - MAP_POPULATE / 2MB 정렬 + MADV_HUGEPAGE / 구간 mlock, fault 수 기록
+ *   - 페이지 heat 기록 → 다음 열기 때 뜨거운 순서로 배경 선읽기
+ *
+ * Zero Dependency: POSIX mmap만 사용 (reflink는 Linux ioctl)
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
-/* Linux에서 ftruncate, madvise 선언을 위해 필요 */
-#define _XOPEN_SOURCE 700
+/* Linux에서 ftruncate, madvise, fallocate 선언을 위해 필요 */
+#define _GNU_SOURCE
 
 #include "mmap_loader.h"
 #include <stdio.h>
@@ -27,7 +39,175 @@
 #include <unistd.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <stdint.h>
 #include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#ifdef __linux__
+#include <linux/fs.h>           /* FICLONE */
+#endif
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Dirty 추적 상태
+ *
+ * 단위 g의 bits[g] = 1 → 마지막 flush 뒤에 쓰였음 (mmap_file_mark_dirty).
+ * flush는 비트를 먼저 지우고 내보냄 → 그 사이 쓰기는 다시 표시된다.
+ *
+ * 비트맵은 예약 (mf->reserved) 전체 크기로 잡아 제자리 resize에서는
+ * 바꾸지 않는다 (조회와 나란히 도는 touch 등이 잠금 없이 표시).
+ * 예약을 넘어 옮겨질 때만 새 비트맵으로 바꾼다 (주소가 바뀌는 resize는
+ * 매핑을 쓰는 쪽이 모두 멈춘 상태에서만 부를 수 있다).
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+struct mmap_dirty_t {
+    uint64_t*       bits;           /* 단위별 1 = 마지막 flush 뒤 쓰기 있음 */
+    uint64_t*       pending;        /* 단위별 1 = 비동기 쓰기 시작, 배리어 전 (lock 아래) */
+    size_t          words;          /* 줄지 않음 */
+    int64_t         oldest_ns;      /* 가장 오래된 dirty 시각 (0 = 깨끗) */
+    uint32_t        max_age_ms;
+
+    pthread_mutex_t lock;           /* flush / 배리어 / resize 직렬화 (표시는 안 잡음) */
+    pthread_cond_t  wake;
+    pthread_t       thread;
+    int             running;
+    int             stop;
+
+    mmap_flush_stats_t stats;       /* marks는 표시하는 쪽이 원자적으로 증가 */
+};
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Heat 상태
+ *
+ * touches / score 배열은 처음 잡은 주소 공간 크기로 고정
+ * (조회 경로가 잠금 없이 touches를 올리므로 재할당하지 않는다)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+typedef struct {
+    uint32_t granule;
+    uint32_t score;
+} heat_entry_t;
+
+struct mmap_heat_t {
+    uint32_t*       touches;        /* 단위별 샘플 사이 접근 수 (원자적) */
+    uint32_t*       score;          /* 단위별 감쇠 누적 점수 (lock 아래) */
+    size_t          granules;
+
+    pthread_mutex_t lock;           /* 샘플 / 선읽기 madvise / resize 직렬화 */
+    pthread_cond_t  wake;
+    pthread_t       sampler;
+    int             sampling;
+    int             stop;
+    uint32_t        sample_ms;
+
+    heat_entry_t*   plan;           /* 선읽기 순서 (뜨거운 순) */
+    uint32_t        plan_count;
+    size_t          plan_bytes;     /* 한도 (0 = 전부) */
+    pthread_t       prefetcher;
+    int             prefetching;
+
+    mmap_heat_stats_t stats;
+};
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 매핑 / 예열 헬퍼
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* fault 수 / 시각 기준점 */
+typedef struct {
+    long   minor;
+    long   major;
+    double ms;
+} warm_mark_t;
+
+static void warm_mark(warm_mark_t* m) {
+    struct rusage ru;
+    struct timespec ts;
+    getrusage(RUSAGE_THREAD, &ru);
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    m->minor = ru.ru_minflt;
+    m->major = ru.ru_majflt;
+    m->ms = ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static void warm_account(mmap_file_t* mf, const warm_mark_t* since) {
+    warm_mark_t now;
+    warm_mark(&now);
+    mf->warm.minor_faults += (uint64_t)(now.minor - since->minor);
+    mf->warm.major_faults += (uint64_t)(now.major - since->major);
+    mf->warm.warm_ms += now.ms - since->ms;
+}
+
+static inline size_t page_round(size_t size) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    return (size + page - 1) / page * page;
+}
+
+/* 주소 공간 예약 (PROT_NONE, 메모리 / swap 차지 없음)
+ * align: 주소 정렬 (0 = 페이지), 넉넉히 잡은 뒤 앞뒤 남는 부분 반환 */
+static char* reserve_space(size_t len, size_t align) {
+    size_t span = len + align;
+    char* area = (char*)mmap(NULL, span, PROT_NONE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (area == MAP_FAILED) return NULL;
+    if (align == 0) return area;
+
+    char* aligned = (char*)(((uintptr_t)area + align - 1) & ~(uintptr_t)(align - 1));
+    if (aligned > area) munmap(area, (size_t)(aligned - area));
+    if (area + span > aligned + len) munmap(aligned + len, (size_t)(area + span - (aligned + len)));
+    return aligned;
+}
+
+/* 파일 매핑
+ *   - 쓰기 가능: MMAP_RESERVE_DEFAULT (또는 크기 2배) 예약 앞부분에 → 제자리 확장
+ *                (MMAP_OPEN_NORESERVE면 예약 없이 크기만큼)
+ *   - HUGEPAGE: 2MB 정렬 주소 + MADV_HUGEPAGE
+ * 예약이 안 되면 크기만큼만 잡는다 (확장 때 주소가 바뀔 수 있음) */
+static void* map_file(mmap_file_t* mf, size_t size, int map_flags) {
+    int prot = mf->writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    size_t len = page_round(size);
+    size_t align = (mf->flags & MMAP_OPEN_HUGEPAGE) && size >= MMAP_HUGE_ALIGN ? MMAP_HUGE_ALIGN : 0;
+
+    size_t reserve = len;
+    if (mf->writable && MMAP_RESERVE_DEFAULT > 0 && !(mf->flags & MMAP_OPEN_NORESERVE)) {
+        reserve = MMAP_RESERVE_DEFAULT > 2 * len ? MMAP_RESERVE_DEFAULT : 2 * len;
+    }
+    if (reserve == len && align == 0) {
+        mf->reserved = len;
+        return mmap(NULL, size, prot, map_flags, mf->fd, 0);
+    }
+
+    char* base = reserve_space(reserve, align);
+    if (!base && reserve > len) {
+        reserve = len;
+        base = reserve_space(reserve, align);
+    }
+    if (!base) return MAP_FAILED;
+
+    void* addr = mmap(base, size, prot, map_flags | MAP_FIXED, mf->fd, 0);
+    if (addr == MAP_FAILED) {
+        munmap(base, reserve);
+        return MAP_FAILED;
+    }
+    mf->reserved = reserve;
+    if (align) mf->warm.huge = madvise(addr, size, MADV_HUGEPAGE) == 0;
+    return addr;
+}
+
+/* 기록해 둔 mlock 구간을 (재)적용 (크기 밖은 버림) */
+static void relock(mmap_file_t* mf) {
+    uint32_t n = 0;
+    size_t locked = 0;
+    for (uint32_t i = 0; i < mf->lock_count; i++) {
+        mmap_range_t r = mf->locks[i];
+        if (r.offset >= mf->size) continue;
+        if (r.offset + r.len > mf->size) r.len = mf->size - r.offset;
+        if (mlock((char*)mf->addr + r.offset, r.len) < 0) continue;
+        mf->locks[n++] = r;
+        locked += r.len;
+    }
+    mf->lock_count = n;
+    mf->warm.locked_bytes = locked;
+}
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * mmap_file_open
@@ -37,12 +217,17 @@
  * 파라미터:
  *   - filepath: 파일 경로
  *   - writable: 1 = 읽기/쓰기, 0 = 읽기 전용
+ *   - flags:    MMAP_OPEN_* (mmap_file_open_ex)
  *
  * 리턴:
  *   - 성공: mmap_file_t 구조체 포인터
  *   - 실패: NULL
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 mmap_file_t* mmap_file_open(const char* filepath, int writable) {
+    return mmap_file_open_ex(filepath, writable, 0);
+}
+
+mmap_file_t* mmap_file_open_ex(const char* filepath, int writable, uint32_t flags) {
     if (!filepath) {
         fprintf(stderr, "[mmap] Error: filepath is NULL\n");
         return NULL;
@@ -58,8 +243,8 @@ mmap_file_t* mmap_file_open(const char* filepath, int writable) {
     memset(mf, 0, sizeof(mmap_file_t));
 
     /* 파일 열기 */
-    int flags = writable ? O_RDWR : O_RDONLY;
-    mf->fd = open(filepath, flags);
+    int open_flags = writable ? O_RDWR : O_RDONLY;
+    mf->fd = open(filepath, open_flags);
     if (mf->fd < 0) {
         fprintf(stderr, "[mmap] Error: cannot open file '%s': %s\n",
                 filepath, strerror(errno));
@@ -86,21 +271,32 @@ mmap_file_t* mmap_file_open(const char* filepath, int writable) {
     }
 
     /* mmap 실행 */
-    int prot = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
     int map_flags = MAP_SHARED;  /* 변경사항을 파일에 반영 */
+    if (flags & MMAP_OPEN_POPULATE) map_flags |= MAP_POPULATE;
 
-    mf->addr = mmap(NULL, mf->size, prot, map_flags, mf->fd, 0);
+    mf->writable = writable;
+    mf->flags = flags;
+
+    warm_mark_t start;
+    warm_mark(&start);
+    mf->addr = map_file(mf, mf->size, map_flags);
     if (mf->addr == MAP_FAILED) {
         fprintf(stderr, "[mmap] Error: mmap failed: %s\n", strerror(errno));
         close(mf->fd);
         free(mf);
         return NULL;
     }
-
-    mf->writable = writable;
+    if (flags) warm_account(mf, &start);
 
     printf("[mmap] ✓ Mapped '%s': %zu bytes @ %p\n",
            filepath, mf->size, mf->addr);
+    if (flags) {
+        printf("[mmap]   Warm-up:%s%s %lu minor / %lu major faults, %.2f ms\n",
+               (flags & MMAP_OPEN_POPULATE) ? " populate" : "",
+               (flags & MMAP_OPEN_HUGEPAGE) ? (mf->warm.huge ? " hugepage" : " hugepage (unavailable)") : "",
+               (unsigned long)mf->warm.minor_faults, (unsigned long)mf->warm.major_faults,
+               mf->warm.warm_ms);
+    }
 
     return mf;
 }
@@ -110,12 +306,19 @@ mmap_file_t* mmap_file_open(const char* filepath, int writable) {
  *
  * 매핑 해제 및 파일 닫기
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static void dirty_detach(mmap_file_t* mf);
+static void heat_detach(mmap_file_t* mf);
+static int dirty_flush(mmap_file_t* mf, int sync);
+
 void mmap_file_close(mmap_file_t* mf) {
     if (!mf) return;
 
-    /* munmap */
+    if (mf->dirty) dirty_detach(mf);
+    if (mf->heat) heat_detach(mf);
+
+    /* munmap (예약 영역까지) */
     if (mf->addr && mf->addr != MAP_FAILED) {
-        if (munmap(mf->addr, mf->size) < 0) {
+        if (munmap(mf->addr, mf->reserved > mf->size ? mf->reserved : mf->size) < 0) {
             fprintf(stderr, "[mmap] Warning: munmap failed: %s\n", strerror(errno));
         }
     }
@@ -132,10 +335,15 @@ void mmap_file_close(mmap_file_t* mf) {
  * mmap_file_sync
  *
  * 메모리 변경사항을 파일에 동기화 (msync)
+ *
+ * 추적 중이면 dirty + 비동기로 쓰기 시작한 구간만, 아니면 매핑 전체.
+ * 돌아오면 그때까지의 쓰기는 디스크에 있다 (내구화 배리어).
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 int mmap_file_sync(mmap_file_t* mf) {
     if (!mf || !mf->addr) return -1;
 
+    if (mf->dirty) return dirty_flush(mf, 1);
+
     /* MS_SYNC: 즉시 동기화 (blocking) */
     if (msync(mf->addr, mf->size, MS_SYNC) < 0) {
         fprintf(stderr, "[mmap] Error: msync failed: %s\n", strerror(errno));
@@ -204,19 +412,77 @@ mmap_file_t* mmap_file_create(const char* filepath, size_t size) {
 }
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
- * mmap_file_resize
+ * mmap_file_anon
  *
- * 파일 크기 변경 및 재매핑
+ * 파일 없는 0으로 채운 쓰기 가능 매핑
  *
- * 주의:
- *   - 기존 포인터 무효화됨
- *   - 재매핑 후 새 주소 사용
+ * 사용 시나리오:
+ *   - 읽기 전용으로 연 저장소가 디스크에 남기지 않을 임시 구조
+ *     (index_manager 등 mmap_file_t 위에서 도는 코드를 그대로 사용)
+ *
+ * 주의: 크기 고정 (resize / track / snapshot은 -1), sync는 아무것도 안 씀
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
-int mmap_file_resize(mmap_file_t* mf, size_t new_size) {
-    if (!mf || !mf->writable) return -1;
+mmap_file_t* mmap_file_anon(size_t size) {
+    if (size == 0) {
+        fprintf(stderr, "[mmap] Error: invalid parameters\n");
+        return NULL;
+    }
+
+    mmap_file_t* mf = (mmap_file_t*)calloc(1, sizeof(mmap_file_t));
+    if (!mf) return NULL;
 
+    mf->addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mf->addr == MAP_FAILED) {
+        fprintf(stderr, "[mmap] Error: anonymous mmap failed: %s\n", strerror(errno));
+        free(mf);
+        return NULL;
+    }
+    mf->fd = -1;
+    mf->size = size;
+    mf->writable = 1;
+    return mf;
+}
+
+static int dirty_resize(mmap_dirty_t* d, size_t size, size_t reserved);
+
+/* 예약 안에서 제자리 크기 변경 (주소 유지) */
+static int resize_in_place(mmap_file_t* mf, size_t new_size) {
+    char* base = (char*)mf->addr;
+    size_t old_len = page_round(mf->size);
+    size_t new_len = page_round(new_size);
+
+    /* 줄이기: 잘릴 꼬리를 먼저 예약으로 되돌림 (잘린 뒤 접근 = SIGBUS 대신 SIGSEGV) */
+    if (new_len < old_len &&
+        mmap(base + new_len, old_len - new_len, PROT_NONE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0) == MAP_FAILED) {
+        fprintf(stderr, "[mmap] Error: cannot release tail: %s\n", strerror(errno));
+        return -1;
+    }
+
+    if (ftruncate(mf->fd, new_size) < 0) {
+        fprintf(stderr, "[mmap] Error: ftruncate failed: %s\n", strerror(errno));
+        return -1;
+    }
+
+    /* 늘리기: 예약 위에 파일 뒷부분을 이어 매핑 */
+    if (new_len > old_len) {
+        void* ext = mmap(base + old_len, new_len - old_len, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_FIXED, mf->fd, (off_t)old_len);
+        if (ext == MAP_FAILED) {
+            fprintf(stderr, "[mmap] Error: mmap extension failed: %s\n", strerror(errno));
+            return -1;
+        }
+        if (mf->flags & MMAP_OPEN_HUGEPAGE) madvise(ext, new_len - old_len, MADV_HUGEPAGE);
+    }
+
+    mf->size = new_size;
+    return 0;
+}
+
+/* 예약을 넘음 → 더 큰 예약으로 옮김 (주소가 바뀜) */
+static int resize_moved(mmap_file_t* mf, size_t new_size) {
     /* 기존 매핑 해제 */
-    if (munmap(mf->addr, mf->size) < 0) {
+    if (munmap(mf->addr, mf->reserved > mf->size ? mf->reserved : mf->size) < 0) {
         fprintf(stderr, "[mmap] Error: munmap failed: %s\n", strerror(errno));
         return -1;
     }
@@ -227,16 +493,913 @@ int mmap_file_resize(mmap_file_t* mf, size_t new_size) {
         return -1;
     }
 
-    /* 재매핑 */
-    mf->addr = mmap(NULL, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, mf->fd, 0);
+    /* 재매핑 (populate는 열 때만) */
+    mf->addr = map_file(mf, new_size, MAP_SHARED);
     if (mf->addr == MAP_FAILED) {
         fprintf(stderr, "[mmap] Error: mmap failed: %s\n", strerror(errno));
         return -1;
     }
 
     mf->size = new_size;
+    mf->moves++;
+    if (mf->lock_count > 0) relock(mf);
+    return 0;
+}
+
+static int resize_locked(mmap_file_t* mf, size_t new_size) {
+    int rc = page_round(new_size) <= mf->reserved ? resize_in_place(mf, new_size)
+                                                  : resize_moved(mf, new_size);
+    if (rc < 0) return -1;
+
+    if (mf->dirty && dirty_resize(mf->dirty, new_size, mf->reserved) < 0) return -1;
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * mmap_file_resize
+ *
+ * 파일 크기 변경
+ *
+ * 예약(mf->reserved) 안이면 꼬리만 이어 붙이거나 되돌림 → 주소 유지
+ * 예약을 넘을 때만 더 큰 예약으로 재매핑 (mf->moves 증가)
+ *
+ * 주의:
+ *   - 재매핑되면 기존 포인터 무효화 (mf->addr 다시 읽기)
+ *   - 줄인 뒤 잘린 부분 접근은 SIGSEGV
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int mmap_file_resize(mmap_file_t* mf, size_t new_size) {
+    if (!mf || !mf->writable || mf->fd < 0) return -1;
+
+    /* flusher / heat 샘플이 이전 매핑을 건드리지 않도록 */
+    mmap_dirty_t* d = mf->dirty;
+    mmap_heat_t* h = mf->heat;
+    if (d) pthread_mutex_lock(&d->lock);
+    if (h) pthread_mutex_lock(&h->lock);
+    int rc = resize_locked(mf, new_size);
+    if (h) pthread_mutex_unlock(&h->lock);
+    if (d) pthread_mutex_unlock(&d->lock);
+    if (rc < 0) return -1;
 
     printf("[mmap] ✓ Resized to %zu bytes @ %p\n", new_size, mf->addr);
 
     return 0;
 }
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * mmap_file_punch
+ *
+ * 파일 중간 영역의 디스크 블록 반환 (fallocate PUNCH_HOLE)
+ *
+ * 특징:
+ *   - 파일 크기와 매핑은 그대로, 해당 페이지는 이후 0으로 읽힘
+ *   - 페이지 경계 안쪽만 처리 (걸친 페이지는 남김)
+ *   - 지원하지 않는 파일 시스템이면 -1 (내용 유지, 공간만 못 돌려받음)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int mmap_file_punch(mmap_file_t* mf, size_t offset, size_t len) {
+    if (!mf || !mf->writable) return -1;
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t start = (offset + page - 1) / page * page;
+    size_t end = (offset + len) / page * page;
+    if (end > mf->size) end = mf->size / page * page;
+    if (end <= start) return 0;
+
+#ifdef FALLOC_FL_PUNCH_HOLE
+    if (fallocate(mf->fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                  (off_t)start, (off_t)(end - start)) == 0) {
+        return 0;
+    }
+#endif
+    return -1;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * mmap_file_clone
+ *
+ * reflink 복제 (ioctl FICLONE)
+ *
+ * 특징:
+ *   - 데이터 복사 없이 블록 공유, 이후 양쪽 쓰기는 파일 시스템이 COW
+ *   - 커널이 복제 전에 원본의 dirty 페이지 (매핑 쓰기 포함)를 기록
+ *   - 다른 파일 시스템 / 지원 안 함 (ext4, tmpfs)이면 -1
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int mmap_file_clone(mmap_file_t* mf, const char* path) {
+    if (!mf || mf->fd < 0 || !path) return -1;
+
+#ifdef FICLONE
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return -1;
+
+    if (ioctl(fd, FICLONE, mf->fd) == 0) {
+        close(fd);
+        return 0;
+    }
+
+    int err = errno;
+    close(fd);
+    unlink(path);
+    errno = err;
+#else
+    errno = EOPNOTSUPP;
+#endif
+    return -1;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Dirty 추적 내부
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+static inline int bit_test(const uint64_t* bits, size_t g) {
+    return (int)((__atomic_load_n(&bits[g >> 6], __ATOMIC_RELAXED) >> (g & 63)) & 1);
+}
+
+/* [start, end) 단위 비트를 value로 */
+static void bits_assign(uint64_t* bits, size_t start, size_t end, int value) {
+    for (size_t g = start; g < end; ) {
+        size_t w = g >> 6;
+        size_t hi = (w + 1) * 64 < end ? (w + 1) * 64 : end;
+        uint64_t span = hi - g == 64 ? ~0ULL : ((1ULL << (hi - g)) - 1) << (g & 63);
+        if (value) {
+            __atomic_fetch_or(&bits[w], span, __ATOMIC_ACQ_REL);
+        } else {
+            __atomic_fetch_and(&bits[w], ~span, __ATOMIC_ACQ_REL);
+        }
+        g = hi;
+    }
+}
+
+/* from부터 (a | b)가 1인 다음 연속 구간 [*start, *end) (없으면 0) */
+static int bits_next_run(const uint64_t* a, const uint64_t* b, size_t n, size_t from,
+                         size_t* start, size_t* end) {
+    size_t g = from;
+    while (g < n) {
+        uint64_t w = __atomic_load_n(&a[g >> 6], __ATOMIC_ACQUIRE);
+        if (b) w |= __atomic_load_n(&b[g >> 6], __ATOMIC_ACQUIRE);
+        w >>= (g & 63);
+        if (w) {
+            g += (size_t)__builtin_ctzll(w);
+            break;
+        }
+        g = (g | 63) + 1;
+    }
+    if (g >= n) return 0;
+
+    *start = g;
+    while (g < n && (bit_test(a, g) || (b && bit_test(b, g)))) g++;
+    *end = g;
+    return 1;
+}
+
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static inline size_t dirty_granules(const mmap_file_t* mf) {
+    return (mf->size + MMAP_DIRTY_GRANULE - 1) / MMAP_DIRTY_GRANULE;
+}
+
+static inline size_t dirty_len(const mmap_file_t* mf, size_t start, size_t end) {
+    size_t limit = end * MMAP_DIRTY_GRANULE < mf->size ? end * MMAP_DIRTY_GRANULE : mf->size;
+    return limit - start * MMAP_DIRTY_GRANULE;
+}
+
+/* dirty 표시 (깨끗했으면 표시 수 + 가장 오래된 시각) */
+static void dirty_mark(mmap_dirty_t* d, size_t g) {
+    uint64_t bit = 1ULL << (g & 63);
+    if (__atomic_fetch_or(&d->bits[g >> 6], bit, __ATOMIC_ACQ_REL) & bit) return;
+
+    __atomic_fetch_add(&d->stats.marks, 1, __ATOMIC_RELAXED);
+    int64_t clean = 0;
+    __atomic_compare_exchange_n(&d->oldest_ns, &clean, now_ns(), 0,
+                                __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+/* 비트맵을 max(size, reserved)까지 담게 (d->lock 아래, 잘린 단위 표시는 지움)
+ * 커질 때만 교체 (예약을 넘어 옮겨질 때 = 표시하는 쪽이 없을 때) */
+static int dirty_resize(mmap_dirty_t* d, size_t size, size_t reserved) {
+    size_t granules = (size + MMAP_DIRTY_GRANULE - 1) / MMAP_DIRTY_GRANULE;
+    size_t span = reserved > size ? reserved : size;
+    size_t words = (span + MMAP_DIRTY_GRANULE - 1) / MMAP_DIRTY_GRANULE / 64 + 1;
+
+    if (words > d->words) {
+        uint64_t* bits = (uint64_t*)calloc(words, sizeof(uint64_t));
+        uint64_t* pending = (uint64_t*)calloc(words, sizeof(uint64_t));
+        if (!bits || !pending) {
+            free(bits);
+            free(pending);
+            return -1;
+        }
+        if (d->words > 0) {
+            memcpy(bits, d->bits, d->words * sizeof(uint64_t));
+            memcpy(pending, d->pending, d->words * sizeof(uint64_t));
+        }
+        free(d->bits);
+        free(d->pending);
+        d->bits = bits;
+        d->pending = pending;
+        d->words = words;
+    }
+
+    bits_assign(d->bits, granules, d->words * 64, 0);
+    bits_assign(d->pending, granules, d->words * 64, 0);
+    return 0;
+}
+
+/* 디스크 쓰기 시작만 (완료를 기다리지 않음) */
+static int write_start(mmap_file_t* mf, size_t offset, size_t len) {
+#ifdef SYNC_FILE_RANGE_WRITE
+    if (sync_file_range(mf->fd, (off_t)offset, (off_t)len, SYNC_FILE_RANGE_WRITE) == 0) return 0;
+#endif
+    return msync((char*)mf->addr + offset, len, MS_ASYNC);
+}
+
+/* dirty 구간을 이어 붙여 내보냄 (d->lock 아래)
+ * sync = 배리어: 이전에 쓰기만 시작한 구간까지 MS_SYNC로 기다림 */
+static int dirty_flush_locked(mmap_file_t* mf, int sync) {
+    mmap_dirty_t* d = mf->dirty;
+    size_t granules = dirty_granules(mf);
+    size_t from = 0, start, end, bytes = 0;
+    int rc = 0;
+
+    /* 이 뒤에 처음 dirty가 되는 단위부터 다시 나이를 잰다 */
+    __atomic_store_n(&d->oldest_ns, 0, __ATOMIC_RELEASE);
+
+    while (bits_next_run(d->bits, sync ? d->pending : NULL, granules, from, &start, &end)) {
+        from = end;
+        char* addr = (char*)mf->addr + start * MMAP_DIRTY_GRANULE;
+        size_t len = dirty_len(mf, start, end);
+
+        /* 표시 먼저 지움: 그 사이 쓰기는 아래에서 같이 나가고, 표시는 쓴 뒤라 다시 남는다 */
+        bits_assign(d->bits, start, end, 0);
+
+        if (sync) {
+            if (msync(addr, len, MS_SYNC) < 0) {
+                bits_assign(d->bits, start, end, 1);    /* 다음 배리어가 다시 시도 */
+                rc = -1;
+            }
+            bits_assign(d->pending, start, end, 0);
+        } else {
+            if (write_start(mf, start * MMAP_DIRTY_GRANULE, len) < 0) rc = -1;
+            bits_assign(d->pending, start, end, 1);
+        }
+        bytes += len;
+    }
+
+    if (sync) {
+        d->stats.syncs++;
+        d->stats.synced_bytes += bytes;
+    } else if (bytes > 0) {
+        d->stats.flushes++;
+        d->stats.flushed_bytes += bytes;
+    }
+    if (rc < 0) fprintf(stderr, "[mmap] Error: %s failed: %s\n", sync ? "msync" : "flush", strerror(errno));
+    return rc;
+}
+
+static int dirty_flush(mmap_file_t* mf, int sync) {
+    mmap_dirty_t* d = mf->dirty;
+    pthread_mutex_lock(&d->lock);
+    int rc = dirty_flush_locked(mf, sync);
+    pthread_mutex_unlock(&d->lock);
+    return rc;
+}
+
+/* flusher: max_age의 1/4마다 확인 → dirty는 최대 약 1.25 × max_age 동안만 메모리에 */
+static void* dirty_flusher(void* arg) {
+    mmap_file_t* mf = (mmap_file_t*)arg;
+    mmap_dirty_t* d = mf->dirty;
+
+    pthread_mutex_lock(&d->lock);
+    while (!d->stop) {
+        uint32_t tick = d->max_age_ms / 4 ? d->max_age_ms / 4 : 1;
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += tick / 1000;
+        deadline.tv_nsec += (long)(tick % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&d->wake, &d->lock, &deadline);
+        if (d->stop) break;
+
+        int64_t oldest = __atomic_load_n(&d->oldest_ns, __ATOMIC_ACQUIRE);
+        if (oldest != 0 && now_ns() - oldest >= (int64_t)d->max_age_ms * 1000000LL) {
+            dirty_flush_locked(mf, 0);
+        }
+    }
+    pthread_mutex_unlock(&d->lock);
+    return NULL;
+}
+
+static void dirty_stop(mmap_dirty_t* d) {
+    if (!d->running) return;
+
+    pthread_mutex_lock(&d->lock);
+    d->stop = 1;
+    pthread_cond_signal(&d->wake);
+    pthread_mutex_unlock(&d->lock);
+
+    pthread_join(d->thread, NULL);
+    d->running = 0;
+    d->stop = 0;
+}
+
+static void dirty_free(mmap_dirty_t* d) {
+    pthread_cond_destroy(&d->wake);
+    pthread_mutex_destroy(&d->lock);
+    free(d->bits);
+    free(d->pending);
+    free(d);
+}
+
+/* 추적 중단: flusher 멈추고 해제 */
+static void dirty_detach(mmap_file_t* mf) {
+    mmap_dirty_t* d = mf->dirty;
+    dirty_stop(d);
+    mf->dirty = NULL;
+    dirty_free(d);
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * mmap_file_snapshot
+ *
+ * 지금 시점의 읽기 전용 뷰 (익명 메모리로 전체 복사)
+ *
+ * 특징:
+ *   - 만들 때 한 번 복사, 이후 원본 쓰기 / resize / punch와 무관
+ *   - 원본 매핑에는 보호 / 시그널 핸들러를 걸지 않음
+ *   - 복사가 끝나면 PROT_READ (뷰에 쓰기 = SIGSEGV)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+mmap_file_t* mmap_file_snapshot(mmap_file_t* mf) {
+    if (!mf || mf->fd < 0) return NULL;
+
+    mmap_file_t* view = (mmap_file_t*)calloc(1, sizeof(mmap_file_t));
+    if (!view) return NULL;
+
+    view->addr = mmap(NULL, mf->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (view->addr == MAP_FAILED) {
+        fprintf(stderr, "[mmap] Error: snapshot mmap failed: %s\n", strerror(errno));
+        free(view);
+        return NULL;
+    }
+    view->fd = -1;
+    view->size = mf->size;
+    view->writable = 0;
+
+    memcpy(view->addr, mf->addr, mf->size);
+    mprotect(view->addr, view->size, PROT_READ);
+
+    printf("[mmap] ✓ Snapshot view: %zu bytes @ %p (copied)\n", view->size, view->addr);
+    return view;
+}
+
+/* in → out 커널 안 복사 (copy_file_range, 파일 시스템이 지원하면 블록 공유)
+ * 리턴: 복사된 바이트 (실패 / 지원 안 함이면 그 앞까지) */
+static size_t copy_range(int in, int out, size_t len) {
+#ifdef __linux__
+    loff_t off_in = 0;
+    loff_t off_out = 0;
+    while ((size_t)off_in < len) {
+        ssize_t n = copy_file_range(in, &off_in, out, &off_out, len - (size_t)off_in, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+    }
+    return (size_t)off_in;
+#else
+    (void)in;
+    (void)out;
+    (void)len;
+    return 0;
+#endif
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * mmap_file_copy
+ *
+ * 매핑 내용을 새 파일로 (reflink가 안 될 때의 백업, 뷰 → 파일)
+ *
+ * 파일 매핑이면 copy_file_range (페이지 캐시 = 매핑 쓰기까지 포함),
+ * 남은 부분 / 뷰는 매핑에서 pwrite
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int mmap_file_copy(const mmap_file_t* mf, const char* path) {
+    if (!mf || !mf->addr || !path) return -1;
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "[mmap] Error: cannot create file '%s': %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    size_t done = mf->fd >= 0 ? copy_range(mf->fd, fd, mf->size) : 0;
+    while (done < mf->size) {
+        ssize_t n = pwrite(fd, (const char*)mf->addr + done, mf->size - done, (off_t)done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            fprintf(stderr, "[mmap] Error: write failed: %s\n", strerror(errno));
+            close(fd);
+            unlink(path);
+            return -1;
+        }
+        done += (size_t)n;
+    }
+
+    int rc = fsync(fd);
+    close(fd);
+    return rc;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * mmap_file_track
+ *
+ * dirty 단위 추적 시작 / flusher max_age 변경
+ *
+ * 특징:
+ *   - 처음엔 전부 dirty (추적 전 쓰기도 첫 배리어에 포함),
+ *     첫 flush / 배리어 뒤부터 표시된 단위만 내보낸다
+ *   - max_age 변경은 flusher를 다시 띄운다
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int mmap_file_track(mmap_file_t* mf, uint32_t max_dirty_age_ms) {
+    if (!mf || !mf->writable || mf->fd < 0) return -1;
+
+    if (!mf->dirty) {
+        mmap_dirty_t* d = (mmap_dirty_t*)calloc(1, sizeof(mmap_dirty_t));
+        if (!d) return -1;
+        pthread_mutex_init(&d->lock, NULL);
+        pthread_cond_init(&d->wake, NULL);
+        if (dirty_resize(d, mf->size, mf->reserved) < 0) {
+            dirty_free(d);
+            return -1;
+        }
+
+        bits_assign(d->bits, 0, dirty_granules(mf), 1);
+        __atomic_store_n(&mf->dirty, d, __ATOMIC_RELEASE);
+    }
+
+    mmap_dirty_t* d = mf->dirty;
+    dirty_stop(d);
+    d->max_age_ms = max_dirty_age_ms;
+    if (max_dirty_age_ms == 0) return 0;
+
+    if (pthread_create(&d->thread, NULL, dirty_flusher, mf) != 0) {
+        fprintf(stderr, "[mmap] Error: cannot start flusher thread\n");
+        return -1;
+    }
+    d->running = 1;
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * mmap_file_mark_dirty
+ *
+ * 매핑에 쓴 [offset, offset + len)이 걸친 단위를 dirty로
+ *
+ * 특징:
+ *   - 추적 중이 아니면 아무 일 없음 (포인터 확인 1번)
+ *   - 이미 dirty인 단위는 읽기만 → 같은 단위를 계속 쓰는 경로가
+ *     캐시 줄을 다투지 않는다
+ *   - 쓴 뒤에 부른다 (먼저 부르면 flusher가 그 사이 표시를 지우고
+ *     아직 안 쓴 내용만 내보낼 수 있다)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+void mmap_file_mark_dirty(mmap_file_t* mf, size_t offset, size_t len) {
+    if (!mf || len == 0) return;
+    mmap_dirty_t* d = __atomic_load_n(&mf->dirty, __ATOMIC_ACQUIRE);
+    if (!d) return;
+
+    size_t first = offset / MMAP_DIRTY_GRANULE;
+    size_t last = (offset + len - 1) / MMAP_DIRTY_GRANULE;
+    if (last >= d->words * 64) last = d->words * 64 - 1;
+    for (size_t g = first; g <= last; g++) {
+        if (!bit_test(d->bits, g)) dirty_mark(d, g);
+    }
+}
+
+int mmap_file_flush(mmap_file_t* mf) {
+    if (!mf || !mf->addr) return -1;
+    if (mf->dirty) return dirty_flush(mf, 0);
+    return msync(mf->addr, mf->size, MS_ASYNC) < 0 ? -1 : 0;
+}
+
+int mmap_file_flush_stats(const mmap_file_t* mf, mmap_flush_stats_t* out) {
+    if (!mf || !mf->dirty || !out) return -1;
+
+    mmap_dirty_t* d = mf->dirty;
+    pthread_mutex_lock(&d->lock);
+    *out = d->stats;
+    out->marks = __atomic_load_n(&d->stats.marks, __ATOMIC_RELAXED);
+    size_t dirty = 0, pending = 0;
+    for (size_t w = 0; w < d->words; w++) {
+        dirty += (size_t)__builtin_popcountll(__atomic_load_n(&d->bits[w], __ATOMIC_RELAXED));
+        pending += (size_t)__builtin_popcountll(d->pending[w]);
+    }
+    out->dirty_bytes = dirty * MMAP_DIRTY_GRANULE;
+    out->pending_bytes = pending * MMAP_DIRTY_GRANULE;
+    pthread_mutex_unlock(&d->lock);
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * mmap_file_warm / mmap_file_lock
+ *
+ * 인덱스처럼 첫 조회부터 필요한 구간만 미리 매핑 / 고정
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* [offset, offset + len)을 페이지 경계로 넓히고 크기 안으로 (빈 구간이면 -1) */
+static int page_span(const mmap_file_t* mf, size_t offset, size_t len, size_t* start, size_t* span) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    if (!mf || !mf->addr || offset >= mf->size || len == 0) return -1;
+
+    size_t end = offset + len < mf->size ? offset + len : mf->size;
+    *start = offset / page * page;
+    *span = end - *start;
+    return 0;
+}
+
+int mmap_file_warm(mmap_file_t* mf, size_t offset, size_t len) {
+    size_t start, span;
+    if (page_span(mf, offset, len, &start, &span) < 0) return -1;
+
+    warm_mark_t mark;
+    warm_mark(&mark);
+
+    char* p = (char*)mf->addr + start;
+    int done = 0;
+#ifdef MADV_POPULATE_READ
+    done = madvise(p, span, MADV_POPULATE_READ) == 0;
+#endif
+    if (!done) {
+        size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        madvise(p, span, MADV_WILLNEED);
+        for (size_t off = 0; off < span; off += page) (void)*(volatile const char*)(p + off);
+    }
+
+    warm_account(mf, &mark);
+    return 0;
+}
+
+int mmap_file_lock(mmap_file_t* mf, size_t offset, size_t len) {
+    size_t start, span;
+    if (page_span(mf, offset, len, &start, &span) < 0) return -1;
+    if (mf->lock_count >= MMAP_LOCK_MAX) return -1;
+
+    warm_mark_t mark;
+    warm_mark(&mark);
+    if (mlock((char*)mf->addr + start, span) < 0) {
+        fprintf(stderr, "[mmap] Warning: mlock %zu bytes failed: %s\n", span, strerror(errno));
+        return -1;
+    }
+    warm_account(mf, &mark);
+
+    mf->locks[mf->lock_count].offset = start;
+    mf->locks[mf->lock_count].len = span;
+    mf->lock_count++;
+    mf->warm.locked_bytes += span;
+    return 0;
+}
+
+void mmap_file_unlock_all(mmap_file_t* mf) {
+    if (!mf) return;
+    for (uint32_t i = 0; i < mf->lock_count; i++) {
+        munlock((char*)mf->addr + mf->locks[i].offset, mf->locks[i].len);
+    }
+    mf->lock_count = 0;
+    mf->warm.locked_bytes = 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 페이지 heat / 재시작 선읽기
+ *
+ * heat 파일: 헤더 + (단위 번호, 점수) × count, 뜨거운 순
+ * 점수 = 점수 × 3/4 (내림) + 샘플 사이 접근 수 + 상주 (mincore)
+ *   → 계속 쓰이는 단위는 접근 수의 약 4배로 수렴, 안 쓰이면 0까지 줄어든다
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#define HEAT_MAGIC          "MMHEAT1"
+#define HEAT_RESIDENT       1           /* 상주만 한 단위의 점수 (접근한 단위보다 뒤로) */
+#define HEAT_SAMPLE_BATCH   1024        /* mincore 한 번에 볼 단위 수 */
+
+typedef struct {
+    char     magic[8];
+    uint32_t granule;           /* MMAP_HEAT_GRANULE */
+    uint32_t count;
+    uint64_t file_size;         /* 저장 시점 파일 크기 (넘는 단위는 버림) */
+} heat_file_header_t;
+
+static mmap_heat_t* heat_attach(mmap_file_t* mf) {
+    if (mf->heat) return mf->heat;
+
+    mmap_heat_t* h = (mmap_heat_t*)calloc(1, sizeof(mmap_heat_t));
+    if (!h) return NULL;
+    size_t span = mf->reserved > mf->size ? mf->reserved : mf->size;
+    h->granules = (span + MMAP_HEAT_GRANULE - 1) / MMAP_HEAT_GRANULE;
+    pthread_mutex_init(&h->lock, NULL);
+    pthread_cond_init(&h->wake, NULL);
+    mf->heat = h;
+    return h;
+}
+
+/* 점수 배열 (처음 기록 시작 때, calloc → 닿은 페이지만 메모리 차지) */
+static int heat_alloc_scores(mmap_heat_t* h) {
+    if (h->score) return 0;
+    h->touches = (uint32_t*)calloc(h->granules, sizeof(uint32_t));
+    h->score = (uint32_t*)calloc(h->granules, sizeof(uint32_t));
+    if (!h->touches || !h->score) {
+        free(h->touches);
+        free(h->score);
+        h->touches = NULL;
+        h->score = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+static inline uint32_t sat_add(uint32_t a, uint32_t b) {
+    return a + b < a ? UINT32_MAX : a + b;
+}
+
+/* lock 아래에서 */
+static void heat_sample_locked(mmap_file_t* mf) {
+    mmap_heat_t* h = mf->heat;
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t per_granule = MMAP_HEAT_GRANULE / page;
+    size_t granules = (mf->size + MMAP_HEAT_GRANULE - 1) / MMAP_HEAT_GRANULE;
+    if (granules > h->granules) granules = h->granules;
+
+    unsigned char vec[HEAT_SAMPLE_BATCH * (MMAP_HEAT_GRANULE / 4096)];
+    for (size_t g0 = 0; g0 < granules; g0 += HEAT_SAMPLE_BATCH) {
+        size_t n = granules - g0 < HEAT_SAMPLE_BATCH ? granules - g0 : HEAT_SAMPLE_BATCH;
+        size_t off = g0 * MMAP_HEAT_GRANULE;
+        size_t len = n * MMAP_HEAT_GRANULE;
+        if (off + len > mf->size) len = mf->size - off;
+        int have_vec = per_granule > 0 && per_granule * n <= sizeof(vec) &&
+                       mincore((char*)mf->addr + off, len, vec) == 0;
+
+        for (size_t i = 0; i < n; i++) {
+            size_t g = g0 + i;
+            uint32_t touched = __atomic_exchange_n(&h->touches[g], 0, __ATOMIC_RELAXED);
+            uint32_t resident = 0;
+            if (have_vec) {
+                size_t p0 = i * per_granule;
+                size_t p1 = p0 + per_granule;
+                size_t pages = (len + page - 1) / page;
+                if (p1 > pages) p1 = pages;
+                for (size_t p = p0; p < p1 && !resident; p++) resident = vec[p] & 1;
+            }
+            uint32_t sc = h->score[g];
+            h->score[g] = sat_add(sc - (sc / 4 + (sc % 4 != 0)),
+                                  sat_add(touched, resident ? HEAT_RESIDENT : 0));
+            h->stats.touches += touched;
+        }
+    }
+    h->stats.samples++;
+}
+
+static void* heat_sampler(void* arg) {
+    mmap_file_t* mf = (mmap_file_t*)arg;
+    mmap_heat_t* h = mf->heat;
+
+    pthread_mutex_lock(&h->lock);
+    while (!h->stop) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += h->sample_ms / 1000;
+        deadline.tv_nsec += (long)(h->sample_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&h->wake, &h->lock, &deadline);
+        if (h->stop) break;
+        heat_sample_locked(mf);
+    }
+    pthread_mutex_unlock(&h->lock);
+    return NULL;
+}
+
+/* 뜨거운 순, 같으면 파일 앞쪽 먼저 */
+static int heat_entry_cmp(const void* a, const void* b) {
+    const heat_entry_t* x = (const heat_entry_t*)a;
+    const heat_entry_t* y = (const heat_entry_t*)b;
+    if (x->score != y->score) return x->score > y->score ? -1 : 1;
+    return x->granule < y->granule ? -1 : x->granule > y->granule;
+}
+
+static void* heat_prefetcher(void* arg) {
+    mmap_file_t* mf = (mmap_file_t*)arg;
+    mmap_heat_t* h = mf->heat;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    size_t done = 0;
+    for (uint32_t i = 0; i < h->plan_count; i++) {
+        if (__atomic_load_n(&h->stop, __ATOMIC_RELAXED)) break;
+        if (h->plan_bytes && done >= h->plan_bytes) break;
+
+        size_t off = (size_t)h->plan[i].granule * MMAP_HEAT_GRANULE;
+        size_t len = MMAP_HEAT_GRANULE;
+        int ok = 0;
+#ifdef __linux__
+        ok = readahead(mf->fd, (off_t)off, len) == 0;
+#endif
+        if (!ok) {
+            /* 매핑 쪽으로 (resize와 직렬화) */
+            pthread_mutex_lock(&h->lock);
+            if (off < mf->size) {
+                if (off + len > mf->size) len = mf->size - off;
+                madvise((char*)mf->addr + off, len, MADV_WILLNEED);
+            }
+            pthread_mutex_unlock(&h->lock);
+        }
+        done += len;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    pthread_mutex_lock(&h->lock);
+    h->stats.prefetched_bytes = done;
+    h->stats.prefetch_ms = (t1.tv_sec - t0.tv_sec) * 1000.0 + (t1.tv_nsec - t0.tv_nsec) / 1e6;
+    h->stats.prefetch_done = 1;
+    pthread_mutex_unlock(&h->lock);
+    return NULL;
+}
+
+static void heat_detach(mmap_file_t* mf) {
+    mmap_heat_t* h = mf->heat;
+
+    pthread_mutex_lock(&h->lock);
+    h->stop = 1;
+    pthread_cond_signal(&h->wake);
+    pthread_mutex_unlock(&h->lock);
+    if (h->sampling) pthread_join(h->sampler, NULL);
+    if (h->prefetching) pthread_join(h->prefetcher, NULL);
+
+    mf->heat = NULL;
+    pthread_mutex_destroy(&h->lock);
+    pthread_cond_destroy(&h->wake);
+    free(h->touches);
+    free(h->score);
+    free(h->plan);
+    free(h);
+}
+
+int mmap_file_heat(mmap_file_t* mf, uint32_t sample_ms) {
+    if (!mf || mf->fd < 0) return -1;
+
+    mmap_heat_t* h = heat_attach(mf);
+    if (!h || heat_alloc_scores(h) < 0) return -1;
+
+    if (sample_ms > 0 && !h->sampling) {
+        h->sample_ms = sample_ms;
+        if (pthread_create(&h->sampler, NULL, heat_sampler, mf) != 0) return -1;
+        h->sampling = 1;
+    }
+    return 0;
+}
+
+void mmap_file_heat_touch(mmap_file_t* mf, size_t offset) {
+    mmap_heat_t* h = mf->heat;
+    if (!h || !h->touches) return;
+
+    size_t g = offset / MMAP_HEAT_GRANULE;
+    if (g < h->granules) __atomic_fetch_add(&h->touches[g], 1, __ATOMIC_RELAXED);
+}
+
+int mmap_file_heat_sample(mmap_file_t* mf) {
+    if (!mf || !mf->heat || !mf->heat->score) return -1;
+    pthread_mutex_lock(&mf->heat->lock);
+    heat_sample_locked(mf);
+    pthread_mutex_unlock(&mf->heat->lock);
+    return 0;
+}
+
+int mmap_file_heat_save(mmap_file_t* mf, const char* path) {
+    if (!mf || !path || !mf->heat || !mf->heat->score) return -1;
+    mmap_heat_t* h = mf->heat;
+
+    pthread_mutex_lock(&h->lock);
+    heat_sample_locked(mf);
+    size_t granules = (mf->size + MMAP_HEAT_GRANULE - 1) / MMAP_HEAT_GRANULE;
+    if (granules > h->granules) granules = h->granules;
+    uint32_t count = 0;
+    for (size_t g = 0; g < granules; g++) count += h->score[g] > 0;
+
+    heat_entry_t* entries = (heat_entry_t*)malloc((count ? count : 1) * sizeof(heat_entry_t));
+    if (!entries) {
+        pthread_mutex_unlock(&h->lock);
+        return -1;
+    }
+    uint32_t n = 0;
+    for (size_t g = 0; g < granules; g++) {
+        if (h->score[g] == 0) continue;
+        entries[n].granule = (uint32_t)g;
+        entries[n++].score = h->score[g];
+    }
+    heat_file_header_t hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, HEAT_MAGIC, sizeof(hdr.magic));
+    hdr.granule = MMAP_HEAT_GRANULE;
+    hdr.count = n;
+    hdr.file_size = mf->size;
+    h->stats.hot_bytes = (size_t)n * MMAP_HEAT_GRANULE;
+    pthread_mutex_unlock(&h->lock);
+
+    qsort(entries, n, sizeof(heat_entry_t), heat_entry_cmp);
+
+    /* 임시 파일에 쓴 뒤 rename (중간에 죽어도 이전 heat 파일 유지) */
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE* f = fopen(tmp, "wb");
+    int rc = -1;
+    if (f) {
+        if (fwrite(&hdr, sizeof(hdr), 1, f) == 1 &&
+            fwrite(entries, sizeof(heat_entry_t), n, f) == n &&
+            fflush(f) == 0 && fsync(fileno(f)) == 0) {
+            rc = 0;
+        }
+        if (fclose(f) != 0) rc = -1;
+        if (rc == 0 && rename(tmp, path) < 0) rc = -1;
+        if (rc < 0) unlink(tmp);
+    }
+    free(entries);
+
+    if (rc < 0) {
+        fprintf(stderr, "[mmap] Warning: cannot save heat map '%s': %s\n", path, strerror(errno));
+        return -1;
+    }
+    printf("[mmap] ✓ Saved heat map '%s': %u hot granules (%.1f MB)\n",
+           path, n, (double)n * MMAP_HEAT_GRANULE / 1024.0 / 1024.0);
+    return 0;
+}
+
+int mmap_file_prefetch(mmap_file_t* mf, const char* path, size_t max_bytes) {
+    if (!mf || !path || mf->fd < 0) return -1;
+
+    FILE* f = fopen(path, "rb");
+    if (!f) return -1;
+
+    heat_file_header_t hdr;
+    heat_entry_t* plan = NULL;
+    int ok = fread(&hdr, sizeof(hdr), 1, f) == 1 &&
+             memcmp(hdr.magic, HEAT_MAGIC, sizeof(hdr.magic)) == 0 &&
+             hdr.granule == MMAP_HEAT_GRANULE &&
+             (uint64_t)hdr.count * MMAP_HEAT_GRANULE <= hdr.file_size + MMAP_HEAT_GRANULE;
+    if (ok) {
+        plan = (heat_entry_t*)malloc((hdr.count ? hdr.count : 1) * sizeof(heat_entry_t));
+        ok = plan && fread(plan, sizeof(heat_entry_t), hdr.count, f) == hdr.count;
+    }
+    fclose(f);
+    if (!ok) {
+        fprintf(stderr, "[mmap] Warning: ignoring heat map '%s' (bad format)\n", path);
+        free(plan);
+        return -1;
+    }
+
+    mmap_heat_t* h = heat_attach(mf);
+    if (!h || h->prefetching) {
+        free(plan);
+        return -1;
+    }
+
+    /* 지금 파일 밖은 버림, 기록 중이면 점수 이어받기 */
+    size_t granules = (mf->size + MMAP_HEAT_GRANULE - 1) / MMAP_HEAT_GRANULE;
+    uint32_t n = 0;
+    pthread_mutex_lock(&h->lock);
+    for (uint32_t i = 0; i < hdr.count; i++) {
+        if (plan[i].granule >= granules) continue;
+        if (h->score && plan[i].granule < h->granules) h->score[plan[i].granule] = plan[i].score;
+        plan[n++] = plan[i];
+    }
+    pthread_mutex_unlock(&h->lock);
+
+    h->plan = plan;
+    h->plan_count = n;
+    h->plan_bytes = max_bytes;
+    h->stats.prefetch_granules = n;
+    if (pthread_create(&h->prefetcher, NULL, heat_prefetcher, mf) != 0) {
+        h->plan = NULL;
+        h->plan_count = 0;
+        free(plan);
+        return -1;
+    }
+    h->prefetching = 1;
+
+    printf("[mmap]   Prefetch: %u granules from '%s' (hottest first, background)\n", n, path);
+    return 0;
+}
+
+void mmap_file_prefetch_wait(mmap_file_t* mf) {
+    if (!mf || !mf->heat || !mf->heat->prefetching) return;
+    pthread_join(mf->heat->prefetcher, NULL);
+    mf->heat->prefetching = 0;
+}
+
+int mmap_file_heat_stats(const mmap_file_t* mf, mmap_heat_stats_t* out) {
+    if (!mf || !mf->heat || !out) return -1;
+    mmap_heat_t* h = mf->heat;
+
+    pthread_mutex_lock(&h->lock);
+    *out = h->stats;
+    pthread_mutex_unlock(&h->lock);
+    return 0;
+}
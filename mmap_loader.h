@@ -8,19 +8,91 @@
 #define MMAP_LOADER_H
 
 #include <stddef.h>
+#include <stdint.h>
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Configuration
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#define MMAP_DIRTY_GRANULE      (64 * 1024)     /* dirty 추적 단위 (비트맵 = 예약 / 단위 비트) */
+#define MMAP_LOCK_MAX           8               /* mlock 구간 (재매핑 후 다시 잠금) */
+#define MMAP_HUGE_ALIGN         (2 * 1024 * 1024)
+#define MMAP_HEAT_GRANULE       (64 * 1024)     /* heat 기록 / 선읽기 단위 */
+
+/* 쓰기 가능 매핑이 미리 잡는 주소 공간 (PROT_NONE, 메모리 차지 없음)
+ * 이 안에서 커지는 동안은 주소가 바뀌지 않는다 */
+#if UINTPTR_MAX > 0xFFFFFFFFu
+#define MMAP_RESERVE_DEFAULT    ((size_t)64 << 30)
+#else
+#define MMAP_RESERVE_DEFAULT    0
+#endif
+
+/* mmap_file_open_ex 옵션 */
+#define MMAP_OPEN_POPULATE      0x01    /* MAP_POPULATE: 열 때 전체 페이지 미리 매핑 */
+#define MMAP_OPEN_HUGEPAGE      0x02    /* 2MB 정렬 주소 + MADV_HUGEPAGE (TLB 미스 감소) */
+#define MMAP_OPEN_NORESERVE     0x04    /* 주소 공간 예약 없이 크기만큼 (거의 안 커지는 파일이 많을 때) */
+
+typedef struct mmap_dirty_t mmap_dirty_t;
+typedef struct mmap_heat_t mmap_heat_t;
+
+/* 예열 통계 (열기 / mmap_file_warm / mmap_file_lock 동안, 호출 스레드 기준) */
+typedef struct {
+    uint64_t minor_faults;
+    uint64_t major_faults;      /* 디스크 읽기 */
+    double   warm_ms;
+    size_t   locked_bytes;
+    int      huge;              /* 2MB 정렬 + MADV_HUGEPAGE 적용됨 */
+} mmap_warm_t;
+
+typedef struct {
+    size_t offset;
+    size_t len;
+} mmap_range_t;
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * mmap_file_t
  *
  * 매핑된 파일 핸들
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
-typedef struct {
-    int      fd;         /* 파일 디스크립터 */
+typedef struct mmap_file_t {
+    int      fd;         /* 파일 디스크립터 (스냅샷 뷰는 -1) */
     void*    addr;       /* 매핑된 메모리 주소 */
     size_t   size;       /* 파일 크기 */
     int      writable;   /* 0 = 읽기 전용, 1 = 읽기/쓰기 */
+    size_t   reserved;   /* 잡아 둔 주소 공간 (매핑 + 뒤쪽 PROT_NONE 예약) */
+    uint32_t moves;      /* 예약을 넘어 주소가 바뀐 횟수 */
+
+    mmap_dirty_t* dirty;    /* dirty 단위 추적 + flusher (NULL = sync는 전체 msync) */
+    mmap_heat_t*  heat;     /* 접근 heat 기록 / 선읽기 (NULL = 없음) */
+
+    uint32_t     flags;                     /* MMAP_OPEN_* */
+    mmap_warm_t  warm;
+    mmap_range_t locks[MMAP_LOCK_MAX];      /* mlock 구간 */
+    uint32_t     lock_count;
 } mmap_file_t;
 
+/* dirty 추적 통계 (mmap_file_flush_stats) */
+typedef struct {
+    size_t   dirty_bytes;       /* 마지막 flush 뒤 쓰인 단위 */
+    size_t   pending_bytes;     /* 비동기 쓰기 시작, 배리어 전 */
+    uint64_t marks;             /* 깨끗한 단위의 첫 표시 */
+    uint64_t flushes;           /* 비동기 flush (flusher + mmap_file_flush) */
+    uint64_t flushed_bytes;
+    uint64_t syncs;             /* 배리어 (mmap_file_sync) */
+    uint64_t synced_bytes;
+} mmap_flush_stats_t;
+
+/* heat / 선읽기 통계 (mmap_file_heat_stats) */
+typedef struct {
+    uint64_t samples;           /* mincore 샘플 횟수 */
+    uint64_t touches;           /* 샘플에 반영된 mmap_file_heat_touch 수 */
+    size_t   hot_bytes;         /* 점수 > 0인 단위 */
+    uint32_t prefetch_granules; /* heat 파일에서 읽은 단위 (뜨거운 순) */
+    size_t   prefetched_bytes;  /* 선읽기 요청한 바이트 */
+    double   prefetch_ms;
+    int      prefetch_done;
+} mmap_heat_stats_t;
+
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * 함수 선언
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
@@ -28,19 +100,134 @@ typedef struct {
 /* 파일 열기 및 매핑 */
 mmap_file_t* mmap_file_open(const char* filepath, int writable);
 
+/* 옵션 지정 열기 (MMAP_OPEN_*) */
+mmap_file_t* mmap_file_open_ex(const char* filepath, int writable, uint32_t flags);
+
 /* 새 파일 생성 및 매핑 */
 mmap_file_t* mmap_file_create(const char* filepath, size_t size);
 
+/* 파일 없는 익명 매핑 (0으로 채움, 쓰기 가능, 크기 고정) */
+mmap_file_t* mmap_file_anon(size_t size);
+
 /* 매핑 해제 및 닫기 */
 void mmap_file_close(mmap_file_t* mf);
 
-/* 변경사항 동기화 */
+/* 변경사항 동기화 (내구화 배리어, 추적 중이면 바뀐 범위만) */
 int mmap_file_sync(mmap_file_t* mf);
 
 /* OS에게 사용 패턴 힌트 */
 int mmap_file_advise(mmap_file_t* mf, int advice);
 
-/* 파일 크기 변경 및 재매핑 */
+/* 파일 크기 변경 (예약 안이면 제자리, 넘으면 더 큰 예약으로 재매핑) */
 int mmap_file_resize(mmap_file_t* mf, size_t new_size);
 
+/* 영역의 디스크 블록 반환 (크기 유지, 이후 0으로 읽힘) */
+int mmap_file_punch(mmap_file_t* mf, size_t offset, size_t len);
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 예열 (재시작 직후 첫 조회의 page fault 줄이기)
+ *
+ *   MMAP_OPEN_POPULATE: 열 때 전체를 미리 매핑 (읽기 + 페이지 테이블)
+ *   MMAP_OPEN_HUGEPAGE: 주소를 2MB 정렬 → 커널이 huge page로 매핑할 수 있게
+ *                       (파일 매핑은 파일 시스템 / THP 설정에 따라 효과가 다름)
+ *   mmap_file_warm:     일부 구간만 미리 매핑 (인덱스 등)
+ *   mmap_file_lock:     구간을 메모리에 고정 (RLIMIT_MEMLOCK 안에서)
+ *
+ * 걸린 fault 수와 시간은 mf->warm에 누적된다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 구간 미리 매핑 (MADV_POPULATE_READ, 없으면 페이지마다 읽기) */
+int mmap_file_warm(mmap_file_t* mf, size_t offset, size_t len);
+
+/* 구간 mlock (페이지 경계로 넓힘, 재매핑 후에도 유지). 리턴: 0 = 성공, -1 = 실패 / 한도 초과 */
+int mmap_file_lock(mmap_file_t* mf, size_t offset, size_t len);
+
+/* 모든 mlock 해제 */
+void mmap_file_unlock_all(mmap_file_t* mf);
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 스냅샷 (쓰기를 멈추지 않는 시점 고정 이미지)
+ *
+ * clone:    ioctl(FICLONE) reflink → 새 파일이 블록을 공유 (btrfs / XFS 등)
+ * copy:     reflink가 안 되면 copy_file_range로 파일 복사 (커널 안, 페이지 캐시 기준)
+ * snapshot: 파일 시스템과 무관한 프로세스 안 뷰
+ *   - 만들 때 원본 매핑 전체를 익명 메모리로 복사 (읽기 전용)
+ *   - 원본 매핑에는 보호 / 시그널 핸들러를 걸지 않으므로 이후 쓰기,
+ *     resize, punch는 평소 그대로
+ *   → 비용은 생성 시 크기만큼 복사 + 같은 크기의 메모리
+ *
+ * 주의: clone / copy / snapshot 모두 원본 쓰기와 같은 잠금 아래에서
+ *       (그래야 한 시점의 내용). 뷰 → 파일 저장은 잠금 밖에서 해도 됨.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* reflink 복제 (0 = 성공, -1 = 지원 안 함 / 실패 → 대상 파일은 남기지 않음) */
+int mmap_file_clone(mmap_file_t* mf, const char* path);
+
+/* 지금 시점의 읽기 전용 복사본 (파일 매핑만, mmap_file_close로 닫음) */
+mmap_file_t* mmap_file_snapshot(mmap_file_t* mf);
+
+/* 매핑 내용을 새 파일로 저장 (파일 매핑 → 백업, 뷰 → 파일) */
+int mmap_file_copy(const mmap_file_t* mf, const char* path);
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Dirty 범위 추적 + 비동기 flush
+ *
+ * 매핑에 쓰는 쪽이 쓴 뒤 mmap_file_mark_dirty로 범위를 알리면 걸친 단위
+ * (MMAP_DIRTY_GRANULE)를 dirty로 기록한다. 매핑 보호 / 시그널 핸들러는 없으므로
+ * 표시하지 않은 쓰기는 배리어에 포함되지 않는다 (커널의 일반 writeback만).
+ *
+ *   flusher 스레드: 가장 오래된 dirty가 max_age를 넘으면 dirty 구간을 이어 붙여
+ *                   sync_file_range(WRITE) (없으면 MS_ASYNC)로 쓰기만 시작
+ *   mmap_file_flush: 같은 일을 지금 (기다리지 않음)
+ *   mmap_file_sync:  배리어 = dirty + 쓰기 시작된 구간만 MS_SYNC
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 추적 시작 / max_age 변경 (0 = flusher 없음, 배리어 / mmap_file_flush에서만 내보냄)
+ * 쓰기 가능한 파일 매핑만. 리턴: 0 = 성공, -1 = 실패 (추적 없이 전체 msync) */
+int mmap_file_track(mmap_file_t* mf, uint32_t max_dirty_age_ms);
+
+/* 쓴 범위 표시 (쓴 뒤에, 추적 중이 아니면 아무 일 없음)
+ * 잠금 없이 여러 스레드가 불러도 됨. 주소가 바뀌는 resize와는 겹치지 않아야 한다 */
+void mmap_file_mark_dirty(mmap_file_t* mf, size_t offset, size_t len);
+
+/* dirty 구간 비동기 쓰기 시작 (추적 안 하면 전체 MS_ASYNC) */
+int mmap_file_flush(mmap_file_t* mf);
+
+/* 통계 (추적 안 하면 -1) */
+int mmap_file_flush_stats(const mmap_file_t* mf, mmap_flush_stats_t* out);
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 페이지 heat + 재시작 선읽기
+ *
+ * 운영 중: 단위 (MMAP_HEAT_GRANULE)마다 점수 = 감쇠 누적
+ *          (조회 경로의 mmap_file_heat_touch + 샘플 때 mincore 상주 여부)
+ * 종료 때: 점수 > 0인 단위를 뜨거운 순으로 heat 파일에 저장 (단위당 8바이트)
+ * 열 때:   mmap_file_prefetch가 배경 스레드에서 그 순서대로 readahead
+ *          (안 되면 MADV_WILLNEED) → 뜨거운 페이지부터 페이지 캐시에
+ *
+ * 주의: 예약 (mf->reserved)을 넘어 커진 뒤쪽은 heat에 잡히지 않는다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* heat 기록 시작 (sample_ms = mincore 샘플 주기, 0 = 샘플 스레드 없음) */
+int mmap_file_heat(mmap_file_t* mf, uint32_t sample_ms);
+
+/* 접근 기록 (조회 경로, 잠금 없음. 기록 중이 아니면 아무 일 없음) */
+void mmap_file_heat_touch(mmap_file_t* mf, size_t offset);
+
+/* 지금 샘플 (접근 수 + 상주 여부를 점수에 반영) */
+int mmap_file_heat_sample(mmap_file_t* mf);
+
+/* heat 파일 저장 (샘플 후 임시 파일 → rename) */
+int mmap_file_heat_save(mmap_file_t* mf, const char* path);
+
+/* heat 파일 재생 시작 (max_bytes = 선읽기 한도, 0 = 전부). 기록 중이면 점수도 이어받음
+ * 리턴: 0 = 배경 스레드 시작, -1 = 파일 없음 / 형식 불일치 */
+int mmap_file_prefetch(mmap_file_t* mf, const char* path, size_t max_bytes);
+
+/* 선읽기 스레드 종료 대기 */
+void mmap_file_prefetch_wait(mmap_file_t* mf);
+
+/* 통계 (heat / 선읽기 둘 다 없으면 -1) */
+int mmap_file_heat_stats(const mmap_file_t* mf, mmap_heat_stats_t* out);
+
 #endif /* MMAP_LOADER_H */
@@ -0,0 +1,383 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * sharded_index.c
+ *
+ * Sharded HNSW Index Implementation
+ *
+ * Scatter: 검색 요청을 샤드 수만큼 작업으로 나눠 워커 풀에 분배
+ * Gather:  샤드별 정렬된 Top-K 리스트를 k-way 힙으로 병합
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#include "sharded_index.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* 한 번의 검색 요청 */
+struct shard_query {
+    const float*    query;
+    uint32_t        k;
+    hnsw_result_t*  results;            /* shard_count × k */
+    int*            found;              /* 샤드별 결과 수 */
+    uint32_t        remaining;          /* 남은 샤드 작업 수 */
+    pthread_mutex_t lock;
+    pthread_cond_t  done;
+};
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * ID Hash (splitmix64 finalizer)
+ *
+ * 연속 ID도 샤드에 고르게 분산
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+uint32_t sharded_shard_of(const sharded_index_t* si, int64_t id) {
+    return (uint32_t)(mix64((uint64_t)id) % si->shard_count);
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Shard Task (샤드 하나 검색)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static void run_task(sharded_index_t* si, shard_query_t* q, uint32_t s) {
+    shard_t* shard = &si->shards[s];
+
+    pthread_rwlock_rdlock(&shard->lock);
+    int n = (shard->index->count > 0)
+          ? hnsw_search(shard->index, q->query, q->k, q->results + (size_t)s * q->k)
+          : 0;
+    pthread_rwlock_unlock(&shard->lock);
+
+    q->found[s] = (n < 0) ? 0 : n;
+
+    pthread_mutex_lock(&q->lock);
+    if (--q->remaining == 0) {
+        pthread_cond_signal(&q->done);
+    }
+    pthread_mutex_unlock(&q->lock);
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Worker Thread
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static void* shard_worker(void* arg) {
+    sharded_index_t* si = (sharded_index_t*)arg;
+
+    while (1) {
+        pthread_mutex_lock(&si->queue_lock);
+
+        /* 작업 대기 */
+        while (si->count == 0 && si->running) {
+            pthread_cond_wait(&si->has_work, &si->queue_lock);
+        }
+
+        if (!si->running) {
+            pthread_mutex_unlock(&si->queue_lock);
+            break;
+        }
+
+        /* 작업 디큐 */
+        shard_task_t task = si->queue[si->tail];
+        si->tail = (si->tail + 1) % SHARD_QUEUE_SIZE;
+        si->count--;
+
+        pthread_mutex_unlock(&si->queue_lock);
+
+        run_task(si, task.query, task.shard);
+    }
+
+    return NULL;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Create/Destroy
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+sharded_index_t* sharded_create(uint32_t dim, uint32_t shard_count,
+                                uint32_t capacity_per_shard, int num_workers) {
+    if (dim == 0 || capacity_per_shard == 0) return NULL;
+
+    if (shard_count == 0) shard_count = SHARD_DEFAULT_COUNT;
+    if (shard_count > SHARD_MAX_COUNT) {
+        fprintf(stderr, "[sharded] Error: shard count out of range (1~%d)\n", SHARD_MAX_COUNT);
+        return NULL;
+    }
+
+    if (num_workers <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        num_workers = (cpus > 0 && (uint32_t)cpus < shard_count) ? (int)cpus : (int)shard_count;
+    }
+
+    sharded_index_t* si = (sharded_index_t*)calloc(1, sizeof(sharded_index_t));
+    if (!si) {
+        fprintf(stderr, "[sharded] Error: malloc failed\n");
+        return NULL;
+    }
+
+    si->dim = dim;
+    si->shard_count = shard_count;
+    si->shards = (shard_t*)calloc(shard_count, sizeof(shard_t));
+    si->workers = (pthread_t*)calloc((size_t)num_workers, sizeof(pthread_t));
+    if (!si->shards || !si->workers) {
+        fprintf(stderr, "[sharded] Error: malloc failed\n");
+        free(si->shards);
+        free(si->workers);
+        free(si);
+        return NULL;
+    }
+
+    for (uint32_t s = 0; s < shard_count; s++) {
+        si->shards[s].index = hnsw_create(dim, capacity_per_shard);
+        if (!si->shards[s].index) {
+            fprintf(stderr, "[sharded] Error: failed to create shard %u\n", s);
+            for (uint32_t i = 0; i < s; i++) {
+                hnsw_destroy(si->shards[i].index);
+                pthread_rwlock_destroy(&si->shards[i].lock);
+            }
+            free(si->shards);
+            free(si->workers);
+            free(si);
+            return NULL;
+        }
+        pthread_rwlock_init(&si->shards[s].lock, NULL);
+    }
+
+    pthread_mutex_init(&si->queue_lock, NULL);
+    pthread_cond_init(&si->has_work, NULL);
+
+    /* 워커 풀 시작 */
+    si->running = 1;
+    for (int i = 0; i < num_workers; i++) {
+        if (pthread_create(&si->workers[i], NULL, shard_worker, si) != 0) {
+            fprintf(stderr, "[sharded] Error: failed to start worker %d\n", i);
+            break;
+        }
+        si->num_workers++;
+    }
+
+    printf("[sharded] Created index: dim=%u, shards=%u, workers=%d\n",
+           dim, shard_count, si->num_workers);
+    return si;
+}
+
+void sharded_destroy(sharded_index_t* si) {
+    if (!si) return;
+
+    /* 워커 중지 */
+    pthread_mutex_lock(&si->queue_lock);
+    si->running = 0;
+    pthread_cond_broadcast(&si->has_work);
+    pthread_mutex_unlock(&si->queue_lock);
+
+    for (int i = 0; i < si->num_workers; i++) {
+        pthread_join(si->workers[i], NULL);
+    }
+
+    for (uint32_t s = 0; s < si->shard_count; s++) {
+        hnsw_destroy(si->shards[s].index);
+        pthread_rwlock_destroy(&si->shards[s].lock);
+    }
+
+    pthread_mutex_destroy(&si->queue_lock);
+    pthread_cond_destroy(&si->has_work);
+
+    free(si->shards);
+    free(si->workers);
+    free(si);
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Insert
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int sharded_insert(sharded_index_t* si, int64_t id, const float* vector) {
+    if (!si || !vector) return -1;
+
+    shard_t* shard = &si->shards[sharded_shard_of(si, id)];
+
+    pthread_rwlock_wrlock(&shard->lock);
+    int result = hnsw_insert(shard->index, id, vector);
+    if (result == 0) shard->inserts++;
+    pthread_rwlock_unlock(&shard->lock);
+
+    return result;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * K-way Merge
+ *
+ * 샤드별 리스트는 거리 오름차순.
+ * 각 리스트의 선두를 최소 힙에 넣고 k번 꺼낸다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+typedef struct {
+    float    distance;
+    uint32_t shard;
+    uint32_t pos;
+} merge_cursor_t;
+
+static void cursor_sift_down(merge_cursor_t* heap, uint32_t size, uint32_t idx) {
+    while (1) {
+        uint32_t left = 2 * idx + 1;
+        uint32_t right = 2 * idx + 2;
+        uint32_t smallest = idx;
+
+        if (left < size && heap[left].distance < heap[smallest].distance) smallest = left;
+        if (right < size && heap[right].distance < heap[smallest].distance) smallest = right;
+        if (smallest == idx) break;
+
+        merge_cursor_t tmp = heap[idx];
+        heap[idx] = heap[smallest];
+        heap[smallest] = tmp;
+        idx = smallest;
+    }
+}
+
+static int merge_topk(const shard_query_t* q, uint32_t shard_count, hnsw_result_t* out) {
+    merge_cursor_t heap[SHARD_MAX_COUNT];
+    uint32_t size = 0;
+
+    for (uint32_t s = 0; s < shard_count; s++) {
+        if (q->found[s] > 0) {
+            heap[size].distance = q->results[(size_t)s * q->k].distance;
+            heap[size].shard = s;
+            heap[size].pos = 0;
+            size++;
+        }
+    }
+    for (int i = (int)size / 2 - 1; i >= 0; i--) {
+        cursor_sift_down(heap, size, (uint32_t)i);
+    }
+
+    uint32_t n = 0;
+    while (n < q->k && size > 0) {
+        merge_cursor_t* top = &heap[0];
+        const hnsw_result_t* list = q->results + (size_t)top->shard * q->k;
+        out[n++] = list[top->pos];
+
+        /* 같은 샤드의 다음 후보로 교체, 소진되면 제거 */
+        if (++top->pos < (uint32_t)q->found[top->shard]) {
+            top->distance = list[top->pos].distance;
+        } else {
+            heap[0] = heap[--size];
+        }
+        cursor_sift_down(heap, size, 0);
+    }
+
+    return (int)n;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Search (Scatter-Gather)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int sharded_search(sharded_index_t* si, const float* query,
+                   uint32_t k, hnsw_result_t* results) {
+    if (!si || !query || !results || k == 0) return -1;
+
+    uint32_t S = si->shard_count;
+
+    shard_query_t q;
+    q.query = query;
+    q.k = k;
+    q.results = (hnsw_result_t*)malloc((size_t)S * k * sizeof(hnsw_result_t));
+    q.found = (int*)calloc(S, sizeof(int));
+    q.remaining = S;
+    if (!q.results || !q.found) {
+        free(q.results);
+        free(q.found);
+        return -1;
+    }
+    pthread_mutex_init(&q.lock, NULL);
+    pthread_cond_init(&q.done, NULL);
+
+    /* Scatter: 마지막 샤드는 호출 스레드가 직접 검색 */
+    for (uint32_t s = 0; s + 1 < S; s++) {
+        int queued = 0;
+
+        pthread_mutex_lock(&si->queue_lock);
+        if (si->num_workers > 0 && si->count < SHARD_QUEUE_SIZE) {
+            si->queue[si->head].query = &q;
+            si->queue[si->head].shard = s;
+            si->head = (si->head + 1) % SHARD_QUEUE_SIZE;
+            si->count++;
+            queued = 1;
+            pthread_cond_signal(&si->has_work);
+        } else {
+            si->inline_tasks++;
+        }
+        pthread_mutex_unlock(&si->queue_lock);
+
+        /* 큐 포화 → 호출 스레드가 실행 */
+        if (!queued) run_task(si, &q, s);
+    }
+    run_task(si, &q, S - 1);
+
+    /* Gather */
+    pthread_mutex_lock(&q.lock);
+    while (q.remaining > 0) {
+        pthread_cond_wait(&q.done, &q.lock);
+    }
+    pthread_mutex_unlock(&q.lock);
+
+    int n = merge_topk(&q, S, results);
+
+    pthread_mutex_lock(&si->queue_lock);
+    si->total_searches++;
+    pthread_mutex_unlock(&si->queue_lock);
+
+    pthread_mutex_destroy(&q.lock);
+    pthread_cond_destroy(&q.done);
+    free(q.results);
+    free(q.found);
+    return n;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Count / Statistics
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+uint64_t sharded_count(sharded_index_t* si) {
+    if (!si) return 0;
+
+    uint64_t total = 0;
+    for (uint32_t s = 0; s < si->shard_count; s++) {
+        pthread_rwlock_rdlock(&si->shards[s].lock);
+        total += si->shards[s].index->count;
+        pthread_rwlock_unlock(&si->shards[s].lock);
+    }
+    return total;
+}
+
+void sharded_stats(sharded_index_t* si) {
+    if (!si) return;
+
+    uint32_t min_count = UINT32_MAX, max_count = 0;
+    uint64_t total = 0;
+
+    for (uint32_t s = 0; s < si->shard_count; s++) {
+        pthread_rwlock_rdlock(&si->shards[s].lock);
+        uint32_t c = si->shards[s].index->count;
+        pthread_rwlock_unlock(&si->shards[s].lock);
+
+        if (c < min_count) min_count = c;
+        if (c > max_count) max_count = c;
+        total += c;
+    }
+
+    pthread_mutex_lock(&si->queue_lock);
+    uint64_t searches = si->total_searches;
+    uint64_t inline_tasks = si->inline_tasks;
+    pthread_mutex_unlock(&si->queue_lock);
+
+    printf("\n[Sharded Index Statistics]\n");
+    printf("  Dimension:    %u\n", si->dim);
+    printf("  Shards:       %u\n", si->shard_count);
+    printf("  Workers:      %d\n", si->num_workers);
+    printf("  Vectors:      %lu\n", total);
+    printf("  Per Shard:    min=%u, max=%u, avg=%.1f\n",
+           min_count, max_count, (double)total / si->shard_count);
+    printf("  Searches:     %lu\n", searches);
+    printf("  Inline Tasks: %lu\n", inline_tasks);
+}
@@ -0,0 +1,105 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * sharded_index.h
+ *
+ * Sharded HNSW Index (코어별 분할 + Scatter-Gather 검색)
+ *
+ * 목적:
+ *   - 벡터를 S개의 독립 hnsw_index_t 샤드로 분할
+ *   - 삽입: ID 해시로 샤드 하나만 잠금 → 샤드 간 병렬 쓰기
+ *   - 검색: 워커 풀이 모든 샤드를 동시에 검색 (scatter)
+ *           샤드별 Top-K를 k-way 힙으로 병합 (gather)
+ *
+ * 동시성:
+ *   - 샤드마다 rwlock (검색 = read, 삽입 = write)
+ *   - 검색 요청은 작업 큐로 분배, 큐가 가득 차면 호출 스레드가 직접 실행
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#ifndef SHARDED_INDEX_H
+#define SHARDED_INDEX_H
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <pthread.h>
+#include "hnsw.h"
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Configuration
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#define SHARD_MAX_COUNT         64      /* 최대 샤드 수 */
+#define SHARD_DEFAULT_COUNT     16      /* 기본 샤드 수 (16코어 서버) */
+#define SHARD_QUEUE_SIZE        1024    /* 검색 작업 큐 크기 */
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Data Structures
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 샤드 */
+typedef struct {
+    hnsw_index_t*    index;             /* 독립 HNSW 인덱스 */
+    pthread_rwlock_t lock;              /* 검색 = read, 삽입 = write */
+    uint64_t         inserts;           /* 누적 삽입 수 */
+} shard_t;
+
+/* 한 번의 검색 요청 (scatter 단위) */
+typedef struct shard_query shard_query_t;
+
+/* 작업 큐 항목 */
+typedef struct {
+    shard_query_t* query;
+    uint32_t       shard;
+} shard_task_t;
+
+/* Sharded 인덱스 */
+typedef struct {
+    uint32_t        dim;                /* 벡터 차원 */
+    uint32_t        shard_count;        /* 샤드 수 */
+    shard_t*        shards;             /* 샤드 배열 */
+
+    /* 검색 워커 풀 */
+    pthread_t*      workers;
+    int             num_workers;
+    int             running;
+
+    /* 작업 큐 (Ring Buffer) */
+    shard_task_t    queue[SHARD_QUEUE_SIZE];
+    uint32_t        head;
+    uint32_t        tail;
+    uint32_t        count;
+    pthread_mutex_t queue_lock;
+    pthread_cond_t  has_work;
+
+    /* 통계 */
+    uint64_t        total_searches;
+    uint64_t        inline_tasks;       /* 큐 포화로 호출 스레드가 직접 실행한 작업 */
+} sharded_index_t;
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Functions
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 생성/삭제
+ *   shard_count: 0 → SHARD_DEFAULT_COUNT
+ *   num_workers: 0 → min(shard_count, 온라인 CPU 수) */
+sharded_index_t* sharded_create(uint32_t dim, uint32_t shard_count,
+                                uint32_t capacity_per_shard, int num_workers);
+void             sharded_destroy(sharded_index_t* si);
+
+/* 삽입 (해당 샤드만 write lock) */
+int sharded_insert(sharded_index_t* si, int64_t id, const float* vector);
+
+/* Top-K 검색 (hnsw_search와 동일한 규약) */
+int sharded_search(sharded_index_t* si, const float* query,
+                   uint32_t k, hnsw_result_t* results);
+
+/* ID → 샤드 번호 */
+uint32_t sharded_shard_of(const sharded_index_t* si, int64_t id);
+
+/* 총 벡터 수 */
+uint64_t sharded_count(sharded_index_t* si);
+
+/* 통계 */
+void sharded_stats(sharded_index_t* si);
+
+#endif /* SHARDED_INDEX_H */
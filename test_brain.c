@@ -8,63 +8,147 @@
  *   2. mmap_loader: 파일 생성 및 매핑
  *   3. index_manager: ID→오프셋 해시맵
  *   4. 통합: 헤더 + 인덱스 + 데이터 저장/조회
+ *   5. index_manager: 점진적 재해시로 대량 ID 확장
+ *   6. index_manager: 삭제/재삽입 반복 (backward-shift → 테이블 크기 유지)
+ *   7. index_manager: 일괄 검색 (prefetch) = 순차 검색 결과
+ *   8. brain_format: v1 파일 읽기 (마이그레이션)
+ *   9. brain_file: 추가/덮어쓰기/삭제/재열기 (chunk 확장, 인덱스 테이블 재사용)
+ *  10. brain_file: 저녁 작업으로 분할 컴팩션 (조회 유지, chunk / heap 반환)
+ *  11. brain_file: 카운터 열 섹션 (touch, 열만 훑기, 컴팩션 / 재열기 후 유지)
+ *  12. brain_file: timestamp / importance 보조 정렬 인덱스 (구간 순회 = 전체 훑기)
+ *  13. brain_file: 스냅샷 (쓰기 계속 → 뷰 / 저장 파일 / reflink는 그 시점 그대로)
+ *  14. mmap_loader: dirty 범위 추적 (배리어는 바뀐 단위만, flusher가 나이 기준 비동기 flush)
+ *  15. brain_file: 예열 열기 (populate / hugepage 정렬 / 인덱스 warm + mlock, fault 수 비교)
+ *  16. mmap_loader: 주소 고정 확장 (예약 안에서 제자리로 키우기 / 줄이기, 포인터 유지)
+ *  17. brain_file: 페이지 heat 저장 → 재시작 선읽기 (뜨거운 순, 캐시 비운 뒤 major fault 비교)
+ *   (4 ~ 6은 Robin Hood / GROUPED 레이아웃 각각 실행)
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
+/* nanosleep, clock_gettime 선언을 위해 필요 (mincore는 _DEFAULT_SOURCE) */
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
 #include "brain_format.h"
 #include "mmap_loader.h"
 #include "index_manager.h"
+#include "brain_file.h"
+#include "kim_circadian.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
 
 #define TEST_FILE "test_brain.db"
+#define TEST_INDEX_LOG2     10          /* 1024 버킷에서 시작 → 재해시 유도 */
+#define TEST_HEAP_SIZE      65536       /* 메타데이터 heap extent 0 */
+#define TEST_GROW_FILE      "test_brain_grow.db"
+#define TEST_GROW_IDS       200000      /* 마지막 재해시 도중에 끝나는 개수 */
+#define TEST_CHURN_LIVE     700         /* 1024 버킷의 68% */
+#define TEST_CHURN_OPS      200000
+#define TEST_BATCH_IDS      1000000     /* 테이블 32MB → 캐시 밖 */
+#define TEST_BATCH_QUERIES  200000
+#define TEST_ENGINE_FILE    "test_brain_engine.db"
+#define TEST_ENGINE_DIM     24          /* stride 128B (96B 벡터 + 패딩) */
+#define TEST_ENGINE_IDS     20000       /* chunk 0 ~ 4, 인덱스 2^14 → 2^15 */
+#define TEST_COMPACT_FILE   "test_brain_compact.db"
+#define TEST_COMPACT_IDS    40000       /* chunk 0 ~ 5 */
+#define TEST_COMPACT_SPARSE 15360       /* chunk 0 ~ 3: 4개 중 3개 삭제 */
+#define TEST_COUNTER_FILE   "test_brain_counters.db"
+#define TEST_COUNTER_SCANS  20
+#define TEST_RANGE_FILE     "test_brain_range.db"
+#define TEST_RANGE_EPOCH    1700000000  /* 첫 timestamp */
+#define TEST_SNAP_FILE      "test_brain_snap.db"
+#define TEST_SNAP_COPY      "test_brain_snap_copy.db"
+#define TEST_SNAP_LINK      "test_brain_snap_link.db"
+#define TEST_SNAP_IDS       20000
+#define TEST_SNAP_RAW       "test_brain_snap_raw.db"
+#define TEST_SYNC_FILE      "test_brain_sync.db"
+#define TEST_SYNC_IDS       20000
+#define TEST_SYNC_AGE_MS    20          /* flusher max-dirty-age */
+#define TEST_WARM_FILE      "test_brain_warm.db"
+#define TEST_WARM_IDS       40000
+#define TEST_STABLE_FILE    "test_brain_stable.db"
+#define TEST_STABLE_IDS     40000       /* chunk 0 ~ 5, 인덱스 재해시 2회 */
+#define TEST_HEAT_FILE      "test_brain_heat.db"
+#define TEST_HEAT_PATH      TEST_HEAT_FILE BRAIN_HEAT_SUFFIX
+#define TEST_HEAT_IDS       40000
+#define TEST_HEAT_HOT       20000       /* [HOT, HOT + SPAN) 반복 조회 */
+#define TEST_HEAT_SPAN      4000
+#define TEST_HEAT_ROUNDS    20
+#define TEST_HEAT_BUDGET    (1024 * 1024)   /* 한도 선읽기: 뜨거운 단위만 들어가는 크기 */
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
- * 테스트 1: 파일 구조 생성 및 초기화
+ * 테스트 1: 파일 구조 생성 및 초기화 (v2 섹션 배치)
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 void test_file_creation() {
     printf("\n=== Test 1: File Creation ===\n");
 
-    /* 파일 크기 계산 */
-    size_t header_size = sizeof(brain_header_t);
-    size_t index_size = sizeof(brain_index_entry_t) * BRAIN_INDEX_BUCKETS;
-    size_t data_size = 1024 * 1024;  /* 1MB 데이터 영역 */
-    size_t total_size = header_size + index_size + data_size;
+    /* 헤더 + 섹션 배치 계산 */
+    brain_header_t layout;
+    brain_init_header(&layout, BRAIN_DEFAULT_DIM);
+
+    uint64_t index_size = index_table_size(TEST_INDEX_LOG2, INDEX_LAYOUT_ROBIN_HOOD);
+    uint64_t records = brain_chunk_records(&layout, 0);
+    uint64_t index_offset = brain_alloc_region(&layout, index_size);
+    uint64_t record_offset = brain_alloc_region(&layout, records * sizeof(brain_record_t));
+    uint64_t vector_offset = brain_alloc_region(&layout, records * layout.vector_stride);
+    uint64_t counter_offset = brain_alloc_region(&layout, records * BRAIN_COUNTER_BYTES);
+    uint64_t heap_offset = brain_alloc_region(&layout, TEST_HEAP_SIZE);
 
     printf("File layout:\n");
-    printf("  Header:  %zu bytes\n", header_size);
-    printf("  Index:   %zu bytes (%d buckets)\n", index_size, BRAIN_INDEX_BUCKETS);
-    printf("  Data:    %zu bytes\n", data_size);
-    printf("  Total:   %zu bytes (%.2f MB)\n", total_size, total_size / 1024.0 / 1024.0);
+    printf("  Header:  %zu bytes + directory %u entries\n",
+           sizeof(brain_header_t), layout.section_capacity);
+    printf("  Index:   %lu bytes (%u buckets)\n", (unsigned long)index_size, 1u << TEST_INDEX_LOG2);
+    printf("  Records: %lu × %zu bytes\n", (unsigned long)records, sizeof(brain_record_t));
+    printf("  Vectors: %lu × %u bytes (dim %u)\n",
+           (unsigned long)records, layout.vector_stride, layout.vector_dim);
+    printf("  Counters: %lu × %u bytes (열 배열)\n", (unsigned long)records,
+           (unsigned)BRAIN_COUNTER_BYTES);
+    printf("  Heap:    %d bytes\n", TEST_HEAP_SIZE);
+    printf("  Total:   %lu bytes (%.2f MB)\n", (unsigned long)layout.file_size,
+           layout.file_size / 1024.0 / 1024.0);
 
     /* 파일 생성 */
-    mmap_file_t* mf = mmap_file_create(TEST_FILE, total_size);
+    mmap_file_t* mf = mmap_file_create(TEST_FILE, layout.file_size);
     if (!mf) {
         fprintf(stderr, "❌ File creation failed\n");
         return;
     }
 
-    /* 헤더 초기화 */
-    brain_header_t* header = (brain_header_t*)mf->addr;
-    header->magic = BRAIN_MAGIC;
-    header->version = BRAIN_VERSION;
-    header->vector_dim = BRAIN_DEFAULT_DIM;
-    header->vector_count = 0;
-    header->index_offset = header_size;
-    header->data_offset = header_size + index_size;
-    header->file_size = total_size;
-    header->flags = 0;
+    /* 헤더 + 섹션 디렉터리 기록 */
+    memcpy(mf->addr, &layout, sizeof(layout));
+    brain_section_add(mf->addr, BRAIN_SECTION_RECORDS, 0, record_offset,
+                      records * sizeof(brain_record_t));
+    brain_section_add(mf->addr, BRAIN_SECTION_VECTORS, 0, vector_offset,
+                      records * layout.vector_stride);
+    brain_section_add(mf->addr, BRAIN_SECTION_COUNTERS, 0, counter_offset,
+                      records * BRAIN_COUNTER_BYTES);
+    brain_section_add(mf->addr, BRAIN_SECTION_HEAP, 0, heap_offset, TEST_HEAP_SIZE);
 
     printf("✓ Header initialized\n");
 
-    /* 인덱스 초기화 */
-    brain_index_entry_t* index = (brain_index_entry_t*)((char*)mf->addr + header->index_offset);
-    index_init(index);
+    /* 인덱스 초기화 (상태는 헤더 안 index 메타에) */
+    brain_index_t* index = index_create(mf, BRAIN_INDEX_META_OFFSET, index_offset,
+                                        TEST_INDEX_LOG2, INDEX_LAYOUT_ROBIN_HOOD);
+    if (!index) {
+        fprintf(stderr, "❌ Index creation failed\n");
+        mmap_file_close(mf);
+        return;
+    }
+    index_close(index);
 
     printf("✓ Index initialized\n");
 
+    if (brain_validate_header((brain_header_t*)mf->addr) == 0) {
+        printf("✓ Header valid\n");
+    }
+    brain_print_header((brain_header_t*)mf->addr);
+
     /* 동기화 및 닫기 */
     mmap_file_sync(mf);
     mmap_file_close(mf);
@@ -85,8 +169,11 @@ void test_index_operations() {
         return;
     }
 
-    brain_header_t* header = (brain_header_t*)mf->addr;
-    brain_index_entry_t* index = (brain_index_entry_t*)((char*)mf->addr + header->index_offset);
+    brain_index_t* index = index_open(mf, BRAIN_INDEX_META_OFFSET);
+    if (!index) {
+        mmap_file_close(mf);
+        return;
+    }
 
     /* Insert 테스트 */
     printf("\n[Insert Test]\n");
@@ -134,11 +221,15 @@ void test_index_operations() {
     printf("\n");
     index_dump(index, 10);
 
+    index_close(index);
     mmap_file_close(mf);
 }
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
  * 테스트 3: 벡터 저장 및 조회 (간단 버전)
+ *
+ * 레코드 / 벡터 / 카운터 / 메타데이터가 각자 섹션에 들어가고,
+ * 인덱스 값은 레코드 번호 + 1
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 void test_vector_storage() {
     printf("\n=== Test 3: Vector Storage ===\n");
@@ -146,42 +237,62 @@ void test_vector_storage() {
     mmap_file_t* mf = mmap_file_open(TEST_FILE, 1);
     if (!mf) return;
 
+    brain_index_t* index = index_open(mf, BRAIN_INDEX_META_OFFSET);
+    if (!index) {
+        mmap_file_close(mf);
+        return;
+    }
+
     brain_header_t* header = (brain_header_t*)mf->addr;
-    brain_index_entry_t* index = (brain_index_entry_t*)((char*)mf->addr + header->index_offset);
-    char* data_section = (char*)mf->addr + header->data_offset;
+    brain_section_t* rec_sec = brain_section_find(mf->addr, BRAIN_SECTION_RECORDS, 0);
+    brain_section_t* vec_sec = brain_section_find(mf->addr, BRAIN_SECTION_VECTORS, 0);
+    brain_section_t* cnt_sec = brain_section_find(mf->addr, BRAIN_SECTION_COUNTERS, 0);
+    brain_section_t* heap_sec = brain_section_find(mf->addr, BRAIN_SECTION_HEAP, 0);
+    if (!rec_sec || !vec_sec || !cnt_sec || !heap_sec) {
+        printf("  ❌ Section directory incomplete\n");
+        index_close(index);
+        mmap_file_close(mf);
+        return;
+    }
 
     /* 벡터 저장 */
     printf("\n[Store Vector]\n");
 
     int64_t vector_id = 10001;
-    uint32_t dim = 128;
+    uint32_t dim = header->vector_dim;
     const char* metadata = "hello";
     uint32_t meta_len = strlen(metadata) + 1;
+    uint64_t rec_no = header->record_count;
 
-    /* Data Entry 작성 */
-    brain_data_entry_t* entry = (brain_data_entry_t*)data_section;
-    entry->vector_id = vector_id;
-    entry->vector_dim = dim;
-    entry->metadata_len = meta_len;
-    entry->timestamp = time(NULL);
-    entry->access_count = 0;
-    entry->importance = 0.8f;
+    /* Record 작성 */
+    brain_record_t* rec = (brain_record_t*)((char*)mf->addr + rec_sec->offset) + rec_no;
+    rec->id = vector_id;
+    rec->flags = BRAIN_RECORD_LIVE;
+
+    /* 카운터 (열 배열: 같은 값끼리 연속) */
+    uint64_t n = brain_chunk_records(header, 0);
+    char* counters = (char*)mf->addr + cnt_sec->offset;
+    ((int64_t*)(counters + BRAIN_COL_TIMESTAMP(n)))[rec_no] = time(NULL);
+    ((uint32_t*)(counters + BRAIN_COL_ACCESS(n)))[rec_no] = 0;
+    ((float*)(counters + BRAIN_COL_IMPORTANCE(n)))[rec_no] = 0.8f;
 
     /* 벡터 데이터 (랜덤) */
-    float* vec = BRAIN_VECTOR_PTR(entry);
-    for (int i = 0; i < dim; i++) {
+    float* vec = (float*)((char*)mf->addr + vec_sec->offset + rec_no * header->vector_stride);
+    for (uint32_t i = 0; i < dim; i++) {
         vec[i] = (float)rand() / RAND_MAX;
     }
 
-    /* 메타데이터 */
-    char* meta = BRAIN_METADATA_PTR(entry);
-    memcpy(meta, metadata, meta_len);
+    /* 메타데이터 (heap) */
+    rec->meta_offset = heap_sec->offset + heap_sec->used;
+    rec->meta_len = meta_len;
+    memcpy((char*)mf->addr + rec->meta_offset, metadata, meta_len);
+    heap_sec->used += meta_len;
 
-    /* Index에 등록 */
-    uint64_t data_offset = (char*)entry - (char*)mf->addr;
-    index_insert(index, vector_id, data_offset);
+    header->record_count++;
+    header->live_count++;
 
-    header->vector_count++;
+    /* Index에 등록 (파일이 커질 수 있으므로 이후 포인터는 다시 구함) */
+    index_insert(index, vector_id, BRAIN_RECORD_REF(rec_no));
 
     printf("  ✓ Stored vector ID=%ld (dim=%d, meta=\"%s\")\n",
            vector_id, dim, metadata);
@@ -189,22 +300,1688 @@ void test_vector_storage() {
     /* 벡터 조회 */
     printf("\n[Retrieve Vector]\n");
 
-    int64_t found_offset = index_lookup(index, vector_id);
-    if (found_offset >= 0) {
-        brain_data_entry_t* found = (brain_data_entry_t*)((char*)mf->addr + found_offset);
-        float* found_vec = BRAIN_VECTOR_PTR(found);
-        char* found_meta = BRAIN_METADATA_PTR(found);
+    int64_t ref = index_lookup(index, vector_id);
+    if (ref > 0) {
+        header = (brain_header_t*)mf->addr;
+        uint64_t in_chunk;
+        uint32_t chunk = brain_chunk_of(header, BRAIN_REF_RECORD(ref), &in_chunk);
+        rec_sec = brain_section_find(mf->addr, BRAIN_SECTION_RECORDS, chunk);
+        vec_sec = brain_section_find(mf->addr, BRAIN_SECTION_VECTORS, chunk);
+        cnt_sec = brain_section_find(mf->addr, BRAIN_SECTION_COUNTERS, chunk);
+        n = brain_chunk_records(header, chunk);
+        counters = (char*)mf->addr + cnt_sec->offset;
+
+        brain_record_t* found = (brain_record_t*)((char*)mf->addr + rec_sec->offset) + in_chunk;
+        float* found_vec = (float*)((char*)mf->addr + vec_sec->offset +
+                                    in_chunk * header->vector_stride);
+        char* found_meta = (char*)mf->addr + found->meta_offset;
 
-        printf("  ✓ Retrieved vector ID=%ld\n", found->vector_id);
-        printf("    - Dimension: %d\n", found->vector_dim);
+        printf("  ✓ Retrieved vector ID=%ld (record %lu, chunk %u)\n",
+               found->id, (unsigned long)BRAIN_REF_RECORD(ref), chunk);
+        printf("    - Dimension: %d\n", header->vector_dim);
         printf("    - Metadata:  \"%s\"\n", found_meta);
-        printf("    - Timestamp: %ld\n", found->timestamp);
-        printf("    - Importance: %.2f\n", found->importance);
+        printf("    - Timestamp: %ld\n",
+               (long)((int64_t*)(counters + BRAIN_COL_TIMESTAMP(n)))[in_chunk]);
+        printf("    - Importance: %.2f\n",
+               ((float*)(counters + BRAIN_COL_IMPORTANCE(n)))[in_chunk]);
         printf("    - Vector[0:3]: [%.4f, %.4f, %.4f, ...]\n",
                found_vec[0], found_vec[1], found_vec[2]);
+        printf("    - Vector address %% %d = %lu %s\n", BRAIN_ALIGN,
+               (unsigned long)((uintptr_t)found_vec % BRAIN_ALIGN),
+               ((uintptr_t)found_vec % BRAIN_ALIGN) == 0 ? "(SIMD aligned)" : "❌");
+    }
+
+    index_close(index);
+    mmap_file_close(mf);
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 테스트 4: 점진적 재해시 (1024 버킷 → 수십만 ID)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static uint64_t fake_offset(int64_t id) {
+    return 4096 + (uint64_t)id * 64;
+}
+
+static const char* layout_name(index_layout_t layout) {
+    return layout == INDEX_LAYOUT_GROUPED ? "grouped" : "robin hood";
+}
+
+int test_index_growth(index_layout_t layout) {
+    printf("\n=== Test 4: Incremental Rehash (%d IDs, %s) ===\n",
+           TEST_GROW_IDS, layout_name(layout));
+
+    size_t header_size = sizeof(brain_header_t);
+    size_t index_size = index_table_size(TEST_INDEX_LOG2, layout);
+    mmap_file_t* mf = mmap_file_create(TEST_GROW_FILE, header_size + index_size);
+    if (!mf) return -1;
+
+    brain_header_t* header = (brain_header_t*)mf->addr;
+    brain_index_t* index = index_create(mf, BRAIN_INDEX_META_OFFSET, header_size,
+                                        TEST_INDEX_LOG2, layout);
+    if (!index) {
+        mmap_file_close(mf);
+        return -1;
+    }
+
+    /* 삽입: 가장 느린 단일 삽입과 평균 비교 */
+    int failures = 0;
+    double worst_ms = 0.0;
+    clock_t total_start = clock();
+    for (int64_t id = 0; id < TEST_GROW_IDS; id++) {
+        clock_t start = clock();
+        if (index_insert(index, id * 7, fake_offset(id)) < 0) failures++;
+        double ms = (double)(clock() - start) / CLOCKS_PER_SEC * 1000.0;
+        if (ms > worst_ms) worst_ms = ms;
+    }
+    double total_ms = (double)(clock() - total_start) / CLOCKS_PER_SEC * 1000.0;
+
+    header = (brain_header_t*)mf->addr;
+    printf("  Inserted %u IDs in %.2f ms (avg %.3f us, worst %.3f ms)\n",
+           index_count(index), total_ms, total_ms * 1000.0 / TEST_GROW_IDS, worst_ms);
+    printf("  Buckets: %u, rehashes: %lu\n",
+           1u << header->index.log2, (unsigned long)index->grows);
+
+    if (failures > 0 || index_count(index) != TEST_GROW_IDS || index->grows == 0) {
+        printf("  ❌ Insert failures=%d, count=%u\n", failures, index_count(index));
+        index_close(index);
+        mmap_file_close(mf);
+        return -1;
+    }
+
+    /* 짝수 번째 삭제 (재해시 중일 수 있음) */
+    for (int64_t id = 0; id < TEST_GROW_IDS; id += 2) {
+        if (index_delete(index, id * 7) < 0) failures++;
+    }
+
+    /* 닫았다 다시 열기 → 재해시 상태가 헤더에서 복원되는지 */
+    int rehashing = (header->index.old_table_offset != 0);
+    index_close(index);
+    mmap_file_close(mf);
+
+    mf = mmap_file_open(TEST_GROW_FILE, 1);
+    index = mf ? index_open(mf, BRAIN_INDEX_META_OFFSET) : NULL;
+    if (!index) {
+        if (mf) mmap_file_close(mf);
+        return -1;
+    }
+
+    for (int64_t id = 0; id < TEST_GROW_IDS; id++) {
+        int64_t expected = (id % 2 == 0) ? -1 : (int64_t)fake_offset(id);
+        if (index_lookup(index, id * 7) != expected) failures++;
+        if (index_lookup(index, id * 7 + 1) != -1) failures++;
+    }
+
+    /* 재해시를 끝까지 진행해도 결과 동일 */
+    while (index_rehash_step(index, 1024) > 0) {}
+    clock_t hit_start = clock();
+    for (int64_t id = 1; id < TEST_GROW_IDS; id += 2) {
+        if (index_lookup(index, id * 7) != (int64_t)fake_offset(id)) failures++;
+    }
+    double hit_ms = (double)(clock() - hit_start) / CLOCKS_PER_SEC * 1000.0;
+
+    /* 실패 검색 (삭제된 ID + 없는 ID) */
+    int64_t misses = 0;
+    clock_t miss_start = clock();
+    for (int64_t id = 0; id < TEST_GROW_IDS; id++) {
+        misses += (index_lookup(index, id * 7 + 3) < 0);
+    }
+    double miss_ms = (double)(clock() - miss_start) / CLOCKS_PER_SEC * 1000.0;
+    if (misses != TEST_GROW_IDS) failures++;
+
+    printf("  Reopened %s rehash, verified %d lookups\n",
+           rehashing ? "during" : "after", TEST_GROW_IDS * 2);
+    printf("  Lookup: hit %.1f ns, miss %.1f ns\n",
+           hit_ms * 1e6 / (TEST_GROW_IDS / 2), miss_ms * 1e6 / TEST_GROW_IDS);
+    index_stats(index);
+
+    int ok = (failures == 0 && index_count(index) == TEST_GROW_IDS / 2);
+    index_close(index);
+    mmap_file_close(mf);
+    unlink(TEST_GROW_FILE);
+
+    if (!ok) {
+        printf("  ❌ %d lookup/delete mismatches\n", failures);
+        return -1;
+    }
+
+    printf("  ✓ All IDs resolved across rehash and reopen\n");
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 테스트 5: 삭제/재삽입 반복 (Churn)
+ *
+ * 고정된 수의 ID를 유지하면서 임의 ID를 지우고 새 ID를 넣는다.
+ * 삭제가 체인을 끊으면 검색이 실패하고, 삭제 흔적이 남으면 테이블이 커진다.
+ * (GROUPED는 DELETED 청소 전에 한 번 2배가 될 수 있음)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int test_index_churn(index_layout_t layout) {
+    printf("\n=== Test 5: Delete/Insert Churn (%d live, %d ops, %s) ===\n",
+           TEST_CHURN_LIVE, TEST_CHURN_OPS, layout_name(layout));
+
+    size_t header_size = sizeof(brain_header_t);
+    mmap_file_t* mf = mmap_file_create(TEST_GROW_FILE,
+                                       header_size + index_table_size(TEST_INDEX_LOG2, layout));
+    if (!mf) return -1;
+
+    brain_header_t* header = (brain_header_t*)mf->addr;
+    brain_index_t* index = index_create(mf, BRAIN_INDEX_META_OFFSET, header_size,
+                                        TEST_INDEX_LOG2, layout);
+    if (!index) {
+        mmap_file_close(mf);
+        return -1;
+    }
+
+    int64_t live[TEST_CHURN_LIVE];
+    int64_t next_id = 0;
+    int failures = 0;
+
+    for (int i = 0; i < TEST_CHURN_LIVE; i++) {
+        live[i] = next_id++;
+        if (index_insert(index, live[i], fake_offset(live[i])) < 0) failures++;
+    }
+
+    uint32_t worst_probe = 0;
+    for (int op = 0; op < TEST_CHURN_OPS; op++) {
+        int victim = rand() % TEST_CHURN_LIVE;
+        if (index_delete(index, live[victim]) < 0) failures++;
+        if (index_lookup(index, live[victim]) != -1) failures++;
+
+        live[victim] = next_id++;
+        if (index_insert(index, live[victim], fake_offset(live[victim])) < 0) failures++;
+
+        header = (brain_header_t*)mf->addr;
+        if (header->index.max_probe > worst_probe) worst_probe = header->index.max_probe;
+    }
+
+    for (int i = 0; i < TEST_CHURN_LIVE; i++) {
+        if (index_lookup(index, live[i]) != (int64_t)fake_offset(live[i])) failures++;
+    }
+
+    header = (brain_header_t*)mf->addr;
+    printf("  Buckets: %u, IDs: %u, worst probe distance: %u\n",
+           1u << header->index.log2, index_count(index), worst_probe);
+
+    int ok = (failures == 0 &&
+              index_count(index) == TEST_CHURN_LIVE &&
+              header->index.log2 <= TEST_INDEX_LOG2 + (layout == INDEX_LAYOUT_GROUPED) &&
+              worst_probe <= INDEX_PROBE_LIMIT);
+
+    index_close(index);
+    mmap_file_close(mf);
+    unlink(TEST_GROW_FILE);
+
+    if (!ok) {
+        printf("  ❌ %d mismatches (table grew or probe length unbounded)\n", failures);
+        return -1;
+    }
+
+    printf("  ✓ Table size bounded under churn\n");
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 테스트 6: 일괄 검색 (index_lookup_batch)
+ *
+ * 임의 순서 ID (절반은 없는 ID)를 순차 검색과 일괄 검색으로 비교
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int test_index_batch(index_layout_t layout) {
+    printf("\n=== Test 6: Batch Lookup (%d IDs, %s) ===\n",
+           TEST_BATCH_IDS, layout_name(layout));
+
+    size_t header_size = sizeof(brain_header_t);
+    mmap_file_t* mf = mmap_file_create(TEST_GROW_FILE,
+                                       header_size + index_table_size(TEST_INDEX_LOG2, layout));
+    if (!mf) return -1;
+
+    brain_index_t* index = index_create(mf, BRAIN_INDEX_META_OFFSET, header_size,
+                                        TEST_INDEX_LOG2, layout);
+    if (!index) {
+        mmap_file_close(mf);
+        return -1;
+    }
+
+    int failures = 0;
+    for (int64_t id = 0; id < TEST_BATCH_IDS; id++) {
+        if (index_insert(index, id * 3, fake_offset(id)) < 0) failures++;
+    }
+    while (index_rehash_step(index, UINT32_MAX) > 0) {}
+
+    int64_t* queries = (int64_t*)malloc(TEST_BATCH_QUERIES * sizeof(int64_t));
+    int64_t* seq = (int64_t*)malloc(TEST_BATCH_QUERIES * sizeof(int64_t));
+    int64_t* batch = (int64_t*)malloc(TEST_BATCH_QUERIES * sizeof(int64_t));
+    for (int i = 0; i < TEST_BATCH_QUERIES; i++) {
+        int64_t id = ((int64_t)rand() * 7919 + i) % TEST_BATCH_IDS;
+        queries[i] = id * 3 + (i % 2);    /* 홀수 번째는 없는 ID */
+    }
+
+    clock_t start = clock();
+    for (int i = 0; i < TEST_BATCH_QUERIES; i++) {
+        seq[i] = index_lookup(index, queries[i]);
+    }
+    double seq_ms = (double)(clock() - start) / CLOCKS_PER_SEC * 1000.0;
+
+    /* Recall 크기 (k=10)와 큰 배치 두 가지 */
+    uint32_t sizes[] = { 10, 1000 };
+    for (int s = 0; s < 2; s++) {
+        uint32_t found = 0;
+        memset(batch, 0, TEST_BATCH_QUERIES * sizeof(int64_t));
+
+        start = clock();
+        for (uint32_t i = 0; i < TEST_BATCH_QUERIES; i += sizes[s]) {
+            uint32_t n = TEST_BATCH_QUERIES - i;
+            if (n > sizes[s]) n = sizes[s];
+            found += index_lookup_batch(index, queries + i, n, batch + i);
+        }
+        double batch_ms = (double)(clock() - start) / CLOCKS_PER_SEC * 1000.0;
+
+        if (memcmp(seq, batch, TEST_BATCH_QUERIES * sizeof(int64_t)) != 0 ||
+            found != TEST_BATCH_QUERIES / 2) {
+            failures++;
+        }
+
+        printf("  batch=%-5u %.1f ns/id (sequential %.1f ns/id, %.2fx)\n",
+               sizes[s], batch_ms * 1e6 / TEST_BATCH_QUERIES,
+               seq_ms * 1e6 / TEST_BATCH_QUERIES,
+               batch_ms > 0 ? seq_ms / batch_ms : 0.0);
+    }
+
+    free(queries);
+    free(seq);
+    free(batch);
+    index_close(index);
+    mmap_file_close(mf);
+    unlink(TEST_GROW_FILE);
+
+    if (failures > 0) {
+        printf("  ❌ Batch results differ from index_lookup (%d)\n", failures);
+        return -1;
+    }
+
+    printf("  ✓ Batch lookup matches sequential lookup\n");
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 테스트 7: v1 파일 읽기 (brain_v1_foreach)
+ *
+ * 최초 릴리스(v1)의 쓰기 경로를 그대로 옮긴 v1_writer_*로 파일을 만들고
+ * (48B 헤더, 0x30 인덱스, FNV-1a % 10007 선형 탐사, -1 = 빈 슬롯 / 삭제)
+ * 리더가 살아 있는 엔트리를 빠짐없이 돌려주는지 확인
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+#define TEST_V1_FILE    "test_brain_v1.db"
+#define TEST_V1_COUNT   300
+
+/* v1 index_manager.c: hash_id */
+static uint32_t v1_writer_hash(int64_t id) {
+    uint64_t h = 14695981039346656037ULL;
+    const uint64_t prime = 1099511628211ULL;
+    for (int i = 0; i < 8; i++) {
+        h ^= (id >> (i * 8)) & 0xFF;
+        h *= prime;
+    }
+    return (uint32_t)(h % BRAIN_V1_INDEX_BUCKETS);
+}
+
+/* v1 index_manager.c: index_insert (빈 슬롯 또는 같은 ID까지 선형 탐사) */
+static void v1_writer_insert(brain_index_entry_t* table, int64_t id, uint64_t offset) {
+    uint32_t bucket = v1_writer_hash(id);
+    while (table[bucket].vector_id != BRAIN_V1_EMPTY_ID && table[bucket].vector_id != id) {
+        bucket = (bucket + 1) % BRAIN_V1_INDEX_BUCKETS;
+    }
+    table[bucket].vector_id = id;
+    table[bucket].data_offset = offset;
+}
+
+/* v1 index_manager.c: index_delete (슬롯을 -1로 지움, 뒤 체인은 그대로) */
+static void v1_writer_delete(brain_index_entry_t* table, int64_t id) {
+    uint32_t bucket = v1_writer_hash(id);
+    while (table[bucket].vector_id != BRAIN_V1_EMPTY_ID) {
+        if (table[bucket].vector_id == id) {
+            table[bucket].vector_id = BRAIN_V1_EMPTY_ID;
+            table[bucket].data_offset = 0;
+            return;
+        }
+        bucket = (bucket + 1) % BRAIN_V1_INDEX_BUCKETS;
+    }
+}
+
+typedef struct {
+    int     count;
+    int64_t id_sum;
+    int     bad;
+} v1_visit_ctx_t;
+
+static int v1_visit(void* ctx, const brain_data_entry_t* entry,
+                    const float* vector, const char* metadata) {
+    v1_visit_ctx_t* c = (v1_visit_ctx_t*)ctx;
+    c->count++;
+    c->id_sum += entry->vector_id;
+    if (vector[0] != (float)entry->vector_id || strcmp(metadata, "v1") != 0) c->bad++;
+    return 0;
+}
+
+int test_v1_reader() {
+    printf("\n=== Test 7: v1 Reader ===\n");
+
+    /* v1 test_brain.c: test_file_creation과 같은 배치 */
+    const uint32_t dim = BRAIN_DEFAULT_DIM;
+    const size_t header_size = sizeof(brain_header_v1_t);
+    const size_t index_size = sizeof(brain_index_entry_t) * BRAIN_V1_INDEX_BUCKETS;
+    const size_t entry_size = BRAIN_DATA_ENTRY_SIZE(dim, 3);
+    const size_t size = header_size + index_size + TEST_V1_COUNT * entry_size;
+
+    unlink(TEST_V1_FILE);
+    mmap_file_t* mf = mmap_file_create(TEST_V1_FILE, size);
+    if (!mf) return -1;
+    char* base = (char*)mf->addr;
+
+    brain_header_v1_t* header = (brain_header_v1_t*)base;
+    header->magic = BRAIN_MAGIC;
+    header->version = BRAIN_VERSION_V1;
+    header->vector_dim = dim;
+    header->vector_count = 0;
+    header->index_offset = header_size;
+    header->data_offset = header_size + index_size;
+    header->file_size = size;
+    header->flags = 0;
+
+    /* v1 index_init: 모든 슬롯 -1 */
+    brain_index_entry_t* table = (brain_index_entry_t*)(base + header->index_offset);
+    for (int i = 0; i < BRAIN_V1_INDEX_BUCKETS; i++) {
+        table[i].vector_id = BRAIN_V1_EMPTY_ID;
+        table[i].data_offset = 0;
+    }
+
+    int64_t expected_sum = 0;
+    for (int i = 0; i < TEST_V1_COUNT; i++) {
+        brain_data_entry_t* entry = (brain_data_entry_t*)(base + header->data_offset + i * entry_size);
+        entry->vector_id = 500 + i;
+        entry->vector_dim = dim;
+        entry->metadata_len = 3;
+        entry->timestamp = time(NULL);
+        entry->importance = 0.8f;
+        BRAIN_VECTOR_PTR(entry)[0] = (float)entry->vector_id;
+        memcpy(BRAIN_METADATA_PTR(entry), "v1", 3);
+
+        v1_writer_insert(table, entry->vector_id, (uint64_t)((char*)entry - base));
+        header->vector_count++;
+        expected_sum += entry->vector_id;
+    }
+
+    /* 삭제 2개 (-1로 지움) + v1 테스트처럼 데이터가 아닌 곳을 가리키는 슬롯 1개 */
+    v1_writer_delete(table, 500);
+    v1_writer_delete(table, 600);
+    expected_sum -= 500 + 600;
+    v1_writer_insert(table, 100, 1000);
+
+    mmap_file_sync(mf);
+    mmap_file_close(mf);
+
+    /* 파일로 다시 열어 읽기 */
+    mf = mmap_file_open(TEST_V1_FILE, 0);
+    if (!mf) return -1;
+
+    v1_visit_ctx_t ctx = {0, 0, 0};
+    int version = brain_detect_version(mf->addr, mf->size);
+    int64_t visited = brain_v1_foreach(mf->addr, mf->size, v1_visit, &ctx);
+    printf("  Detected version %d, visited %ld entries (ids sum %ld)\n",
+           version, (long)visited, (long)ctx.id_sum);
+
+    /* 잘린 파일 (인덱스가 파일 밖) → 거절 */
+    int64_t truncated = brain_v1_foreach(mf->addr, header_size + 16, v1_visit, &ctx);
+    mmap_file_close(mf);
+    unlink(TEST_V1_FILE);
+
+    /* v2 파일은 v1 리더가 거절 */
+    brain_header_t v2;
+    brain_init_header(&v2, dim);
+    int64_t rejected = brain_v1_foreach(&v2, sizeof(v2), v1_visit, &ctx);
+
+    if (version != BRAIN_VERSION_V1 || visited != TEST_V1_COUNT - 2 ||
+        ctx.count != TEST_V1_COUNT - 2 || ctx.id_sum != expected_sum || ctx.bad != 0 ||
+        truncated != -1 || rejected != -1) {
+        printf("  ❌ v1 reader mismatch\n");
+        return -1;
+    }
+
+    printf("  ✓ v1 entries readable for migration\n");
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 테스트 8: 저장 엔진 (brain_file)
+ *
+ * 여러 chunk에 걸쳐 추가 → 일부 덮어쓰기/삭제 → 읽기 전용으로 다시 열어
+ * 벡터/메타데이터/정렬 확인. 재해시가 끝난 인덱스 테이블은 FREE로 반환된다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static void engine_vector(int64_t id, int version, float* vec) {
+    for (int d = 0; d < TEST_ENGINE_DIM; d++) vec[d] = (float)(id * 100 + d + version * 7);
+}
+
+static int engine_check(const brain_file_t* bf, int64_t id, int version) {
+    brain_entry_t e;
+    float expect[TEST_ENGINE_DIM];
+    char meta[32];
+
+    if (brain_file_get(bf, id, &e) < 0) return -1;
+    engine_vector(id, version, expect);
+    snprintf(meta, sizeof(meta), "mem-%ld-v%d", (long)id, version);
+
+    if (e.record->id != id || !(e.record->flags & BRAIN_RECORD_LIVE) ||
+        ((uintptr_t)e.vector % BRAIN_ALIGN) != 0 ||
+        memcmp(e.vector, expect, sizeof(expect)) != 0 ||
+        e.meta_len != strlen(meta) + 1 || strcmp(e.metadata, meta) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+int test_brain_file() {
+    printf("\n=== Test 8: Brain File Engine (%d records) ===\n", TEST_ENGINE_IDS);
+
+    unlink(TEST_ENGINE_FILE);
+    brain_file_t* bf = brain_file_create(TEST_ENGINE_FILE, TEST_ENGINE_DIM,
+                                         INDEX_LAYOUT_ROBIN_HOOD);
+    if (!bf) return -1;
+
+    float vec[TEST_ENGINE_DIM];
+    char meta[32];
+    int failures = 0;
+
+    clock_t start = clock();
+    for (int64_t id = 0; id < TEST_ENGINE_IDS; id++) {
+        engine_vector(id, 0, vec);
+        snprintf(meta, sizeof(meta), "mem-%ld-v%d", (long)id, 0);
+        if (brain_file_append(bf, id, vec, meta, strlen(meta) + 1, 0.5f) != id) failures++;
+    }
+    double append_ms = (double)(clock() - start) / CLOCKS_PER_SEC * 1000.0;
+
+    /* 10개마다 덮어쓰기, 7개마다 삭제 */
+    for (int64_t id = 0; id < TEST_ENGINE_IDS; id += 10) {
+        engine_vector(id, 1, vec);
+        snprintf(meta, sizeof(meta), "mem-%ld-v%d", (long)id, 1);
+        if (brain_file_append(bf, id, vec, meta, strlen(meta) + 1, 0.9f) < 0) failures++;
+    }
+    int deleted = 0;
+    for (int64_t id = 3; id < TEST_ENGINE_IDS; id += 7) {
+        if (brain_file_delete(bf, id) < 0) failures++;
+        deleted++;
+    }
+    if (brain_file_delete(bf, TEST_ENGINE_IDS + 5) == 0) failures++;
+
+    /* 재해시를 끝내고 한 번 더 추가 → 이전 테이블 반환 */
+    while (index_rehash_step(bf->index, UINT32_MAX) > 0) {}
+    engine_vector(TEST_ENGINE_IDS, 0, vec);
+    snprintf(meta, sizeof(meta), "mem-%ld-v%d", (long)TEST_ENGINE_IDS, 0);
+    if (brain_file_append(bf, TEST_ENGINE_IDS, vec, meta, strlen(meta) + 1, 0.5f) < 0) failures++;
+
+    /* 첫 인덱스 테이블 자리는 FREE 또는 다른 섹션이 재사용 중이어야 함 */
+    brain_header_t first;
+    brain_init_header(&first, TEST_ENGINE_DIM);
+    uint64_t first_table = brain_alloc_region(&first, 1);
+    const brain_header_t* h = brain_file_header(bf);
+    const brain_section_t* sections = BRAIN_SECTIONS(h, h);
+    int reused = 0;
+    for (uint32_t i = 0; i < h->section_count; i++) {
+        if (sections[i].offset <= first_table &&
+            first_table < sections[i].offset + sections[i].size) reused = 1;
+    }
+
+    uint64_t expected_live = TEST_ENGINE_IDS + 1 - deleted;
+    printf("  Appended in %.2f ms (%.2f us/record), live %lu, free %lu bytes\n",
+           append_ms, append_ms * 1000.0 / TEST_ENGINE_IDS,
+           (unsigned long)brain_file_count(bf), (unsigned long)h->free_bytes);
+    printf("  Retired index table at 0x%lx %s\n", (unsigned long)first_table,
+           reused ? "reclaimed" : "leaked");
+    if (brain_file_count(bf) != expected_live || !reused) failures++;
+    brain_file_close(bf);
+
+    /* 읽기 전용으로 다시 열어 검증 */
+    bf = brain_file_open(TEST_ENGINE_FILE, 0);
+    if (!bf) return -1;
+
+    for (int64_t id = 0; id <= TEST_ENGINE_IDS; id++) {
+        int gone = (id < TEST_ENGINE_IDS && id % 7 == 3);
+        brain_entry_t e;
+        if (gone) {
+            if (brain_file_get(bf, id, &e) == 0) failures++;
+        } else if (engine_check(bf, id, (id < TEST_ENGINE_IDS && id % 10 == 0)) < 0) {
+            failures++;
+        }
+    }
+
+    /* 덮어쓴 이전 레코드는 번호로는 보이지만 DELETED */
+    brain_entry_t e;
+    if (brain_file_entry(bf, 0, &e) < 0 || !(e.record->flags & BRAIN_RECORD_DELETED)) failures++;
+
+    if (brain_file_append(bf, 1, vec, NULL, 0, 0.0f) >= 0) failures++;   /* 읽기 전용 */
+
+    const brain_header_t* header = brain_file_header(bf);
+    printf("  Records issued %lu, chunks: %u sections, dead heap %lu bytes\n",
+           (unsigned long)header->record_count, header->section_count,
+           (unsigned long)header->heap_dead);
+    brain_file_stats(bf);
+    brain_file_close(bf);
+    unlink(TEST_ENGINE_FILE);
+
+    if (failures > 0) {
+        printf("  ❌ %d mismatches\n", failures);
+        return -1;
+    }
+
+    printf("  ✓ Records readable in place after reopen\n");
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 테스트 10: 컴팩션
+ *
+ * 앞쪽 chunk를 성기게 만들고 뒤쪽 일부를 덮어써 heap에 죽은 바이트를 남긴 뒤,
+ * 서카디언 저녁 작업으로 조금씩 컴팩션. 단계마다 표본 ID를 조회하고,
+ * 시작 전에 받은 포인터가 RELEASE 전까지 읽히는지 확인한다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int compact_version(int64_t id) {
+    return (id >= TEST_COMPACT_SPARSE && id % 3 == 0) ? 1 : 0;
+}
+
+static int compact_gone(int64_t id) {
+    return id < TEST_COMPACT_SPARSE && id % 4 != 0;
+}
+
+int test_compaction() {
+    printf("\n=== Test 10: Online Compaction (%d records) ===\n", TEST_COMPACT_IDS);
+
+    unlink(TEST_COMPACT_FILE);
+    brain_file_t* bf = brain_file_create(TEST_COMPACT_FILE, TEST_ENGINE_DIM,
+                                         INDEX_LAYOUT_GROUPED);
+    if (!bf) return -1;
+
+    float vec[TEST_ENGINE_DIM];
+    char meta[32];
+    int failures = 0;
+
+    for (int64_t id = 0; id < TEST_COMPACT_IDS; id++) {
+        engine_vector(id, 0, vec);
+        snprintf(meta, sizeof(meta), "mem-%ld-v%d", (long)id, 0);
+        if (brain_file_append(bf, id, vec, meta, strlen(meta) + 1, 0.5f) < 0) failures++;
+    }
+    for (int64_t id = 0; id < TEST_COMPACT_IDS; id++) {
+        if (compact_gone(id)) {
+            if (brain_file_delete(bf, id) < 0) failures++;
+        } else if (compact_version(id) == 1) {
+            engine_vector(id, 1, vec);
+            snprintf(meta, sizeof(meta), "mem-%ld-v%d", (long)id, 1);
+            if (brain_file_append(bf, id, vec, meta, strlen(meta) + 1, 0.5f) < 0) failures++;
+        }
+    }
+
+    brain_header_t* h = brain_file_header(bf);
+    uint64_t live = h->live_count;
+    uint64_t issued = h->record_count;
+    uint64_t dead_heap = h->heap_dead;
+
+    /* 시작 전에 받은 포인터 (레코드 4는 chunk 0 → 옮겨짐) */
+    brain_entry_t held;
+    if (brain_file_get(bf, 4, &held) < 0) failures++;
+    uint64_t held_record = held.record_no;
+
+    /* 낮에는 실행되지 않음 */
+    circadian_t* circadian = circadian_create();
+    if (!circadian) return -1;
+    circadian_set_evening_task(circadian, brain_file_compact_task, bf);
+    circadian->current_phase = PHASE_DAY;
+    if (circadian_run_task(circadian) != 0 || circadian->evening_task_runs != 0) failures++;
+
+    circadian->current_phase = PHASE_EVENING;
+    clock_t start = clock();
+    int steps = 0, rc;
+    while ((rc = circadian_run_task(circadian)) > 0) {
+        steps++;
+
+        /* 단계 사이 조회 */
+        for (int64_t id = steps % 97; id < TEST_COMPACT_IDS; id += 997) {
+            brain_entry_t e;
+            if (compact_gone(id)) {
+                if (brain_file_get(bf, id, &e) == 0) failures++;
+            } else if (engine_check(bf, id, compact_version(id)) < 0) {
+                failures++;
+            }
+        }
+        if (bf->compact.phase != BRAIN_COMPACT_IDLE &&
+            bf->compact.phase != BRAIN_COMPACT_RELEASE) {
+            brain_file_entry(bf, held_record, &held);
+            if (held.record->id != 4 || held.vector[0] != 400.0f) failures++;
+        }
+    }
+    double compact_ms = (double)(clock() - start) / CLOCKS_PER_SEC * 1000.0;
+    if (rc < 0) failures++;
+
+    /* 할 일이 없으면 다음 저녁 작업은 바로 끝남 */
+    if (circadian_run_task(circadian) != 0) failures++;
+    circadian_destroy(circadian);
+
+    h = brain_file_header(bf);
+    const brain_compact_stats_t* st = &bf->compact.stats;
+    printf("  %d steps in %.2f ms: scanned %lu, moved %lu records + %lu metadata\n",
+           steps, compact_ms, (unsigned long)st->scanned, (unsigned long)st->moved,
+           (unsigned long)st->meta_moved);
+    printf("  Freed %lu chunks + %lu heap extents = %lu bytes (punched %lu, truncated %lu)\n",
+           (unsigned long)st->chunks_freed, (unsigned long)st->extents_freed,
+           (unsigned long)st->bytes_freed, (unsigned long)st->bytes_punched,
+           (unsigned long)st->bytes_truncated);
+    printf("  Dead heap %lu → %lu bytes, records issued %lu → %lu\n",
+           (unsigned long)dead_heap, (unsigned long)h->heap_dead,
+           (unsigned long)issued, (unsigned long)h->record_count);
+
+    if (steps < 2 || st->cycles != 1 || st->chunks_freed < 4 || st->extents_freed == 0 ||
+        st->moved != TEST_COMPACT_SPARSE / 4 || h->live_count != live ||
+        h->heap_dead >= dead_heap || bf->rec_chunk[0] != 0) {
+        failures++;
+    }
+
+    /* 반환된 chunk의 레코드 번호는 더 이상 보이지 않음 */
+    brain_entry_t e;
+    if (brain_file_entry(bf, held_record, &e) == 0) failures++;
+
+    /* 컴팩션 뒤에도 추가는 그대로 (반환된 공간은 크기가 맞는 할당부터 재사용) */
+    uint64_t free_before = h->free_bytes;
+    uint64_t size_before = h->file_size;
+    for (int64_t id = TEST_COMPACT_IDS; id < TEST_COMPACT_IDS + 20000; id++) {
+        engine_vector(id, 0, vec);
+        snprintf(meta, sizeof(meta), "mem-%ld-v%d", (long)id, 0);
+        if (brain_file_append(bf, id, vec, meta, strlen(meta) + 1, 0.5f) < 0) failures++;
+    }
+    h = brain_file_header(bf);
+    printf("  After 20000 more appends: free %lu → %lu bytes, file %lu → %lu bytes\n",
+           (unsigned long)free_before, (unsigned long)h->free_bytes,
+           (unsigned long)size_before, (unsigned long)h->file_size);
+    if (h->free_bytes > free_before) failures++;
+    brain_file_close(bf);
+
+    /* 다시 열어 전체 검증 */
+    bf = brain_file_open(TEST_COMPACT_FILE, 0);
+    if (!bf) return -1;
+    for (int64_t id = 0; id < TEST_COMPACT_IDS + 20000; id++) {
+        if (compact_gone(id)) {
+            if (brain_file_get(bf, id, &e) == 0) failures++;
+        } else if (engine_check(bf, id, id < TEST_COMPACT_IDS ? compact_version(id) : 0) < 0) {
+            failures++;
+        }
+    }
+    brain_file_close(bf);
+    unlink(TEST_COMPACT_FILE);
+
+    if (failures > 0) {
+        printf("  ❌ %d mismatches\n", failures);
+        return -1;
+    }
+
+    printf("  ✓ Lookups stayed valid during compaction, sparse chunks and extents freed\n");
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 테스트 11: 카운터 열 섹션
+ *
+ * timestamp / access_count / importance는 chunk마다 COUNTERS 섹션의
+ * 열 배열에 있다. 중요도 가지치기 훑기를 열만 읽는 방식과 레코드마다
+ * 항목을 꺼내는 방식으로 비교하고, 컴팩션 / 재열기 뒤 값을 확인한다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static float counter_importance(int64_t id) {
+    return (float)(id % 100) / 100.0f;
+}
+
+static uint32_t counter_touches(int64_t id) {
+    return (uint32_t)(id % 5);
+}
+
+/* 중요도 < 0.1인 살아 있는 레코드 수 (열만) */
+static uint64_t counter_scan_columns(const brain_file_t* bf) {
+    uint64_t hits = 0;
+    brain_columns_t col;
+    for (uint32_t k = 0; k < BRAIN_MAX_CHUNKS; k++) {
+        if (brain_file_columns(bf, k, &col) < 0) continue;
+        for (uint64_t i = 0; i < col.count; i++) {
+            if (col.importance[i] < 0.1f && (col.records[i].flags & BRAIN_RECORD_LIVE)) hits++;
+        }
+    }
+    return hits;
+}
+
+/* 같은 조건 (레코드마다 항목) */
+static uint64_t counter_scan_entries(const brain_file_t* bf) {
+    uint64_t hits = 0;
+    uint64_t issued = brain_file_header(bf)->record_count;
+    for (uint64_t r = 0; r < issued; r++) {
+        brain_entry_t e;
+        if (brain_file_entry(bf, r, &e) < 0) continue;
+        if ((e.record->flags & BRAIN_RECORD_LIVE) && *e.importance < 0.1f) hits++;
+    }
+    return hits;
+}
+
+static int counter_check(const brain_file_t* bf, int64_t id, int64_t timestamp) {
+    brain_entry_t e;
+    if (brain_file_get(bf, id, &e) < 0 || !e.timestamp) return -1;
+    if (*e.importance != counter_importance(id) || *e.timestamp != timestamp + id ||
+        *e.access_count != counter_touches(id)) {
+        return -1;
+    }
+    return 0;
+}
+
+int test_counters() {
+    printf("\n=== Test 11: Counter Columns (%d records) ===\n", TEST_COMPACT_IDS);
+
+    unlink(TEST_COUNTER_FILE);
+    brain_file_t* bf = brain_file_create(TEST_COUNTER_FILE, TEST_ENGINE_DIM,
+                                         INDEX_LAYOUT_ROBIN_HOOD);
+    if (!bf) return -1;
+
+    float vec[TEST_ENGINE_DIM];
+    int failures = 0;
+    int64_t timestamp = 1700000000;
+
+    for (int64_t id = 0; id < TEST_COMPACT_IDS; id++) {
+        engine_vector(id, 0, vec);
+        if (brain_file_append(bf, id, vec, NULL, 0, counter_importance(id)) < 0) failures++;
+    }
+
+    /* 값 쓰기: timestamp는 직접, access_count는 touch로 */
+    for (int64_t id = 0; id < TEST_COMPACT_IDS; id++) {
+        brain_entry_t e;
+        if (brain_file_get(bf, id, &e) < 0 || !e.timestamp || *e.access_count != 0) {
+            failures++;
+            continue;
+        }
+        *e.timestamp = timestamp + id;
+        for (uint32_t t = 0; t < counter_touches(id); t++) {
+            if (brain_file_touch(bf, &e) < 0) failures++;
+        }
     }
 
+    /* 섹션 배치: chunk마다 RECORDS / VECTORS / COUNTERS */
+    const brain_header_t* h = brain_file_header(bf);
+    uint32_t chunks = brain_chunk_of(h, h->record_count - 1, NULL) + 1;
+    for (uint32_t k = 0; k < chunks; k++) {
+        const brain_section_t* s = brain_section_find((void*)h, BRAIN_SECTION_COUNTERS, k);
+        if (!s || s->size != brain_chunk_records(h, k) * BRAIN_COUNTER_BYTES) failures++;
+    }
+    brain_columns_t col;
+    if (brain_file_columns(bf, chunks, &col) == 0) failures++;
+
+    /* 가지치기 훑기: 열만 vs 레코드마다 */
+    uint64_t hits_col = 0, hits_entry = 0;
+    clock_t start = clock();
+    for (int r = 0; r < TEST_COUNTER_SCANS; r++) hits_col = counter_scan_columns(bf);
+    double col_ms = (double)(clock() - start) / CLOCKS_PER_SEC * 1000.0 / TEST_COUNTER_SCANS;
+    start = clock();
+    for (int r = 0; r < TEST_COUNTER_SCANS; r++) hits_entry = counter_scan_entries(bf);
+    double entry_ms = (double)(clock() - start) / CLOCKS_PER_SEC * 1000.0 / TEST_COUNTER_SCANS;
+
+    printf("  %u chunks, counters %u bytes/record (record %zu, vector stride %u)\n",
+           chunks, (unsigned)BRAIN_COUNTER_BYTES, sizeof(brain_record_t), h->vector_stride);
+    printf("  Importance scan: columns %.3f ms, entries %.3f ms (%lu hits)\n",
+           col_ms, entry_ms, (unsigned long)hits_col);
+    if (hits_col != hits_entry || hits_col != TEST_COMPACT_IDS / 10) failures++;
+
+    /* 앞쪽 chunk를 성기게 → 컴팩션이 카운터도 함께 옮김 */
+    for (int64_t id = 0; id < TEST_COMPACT_SPARSE; id++) {
+        if (compact_gone(id) && brain_file_delete(bf, id) < 0) failures++;
+    }
+    if (brain_file_compact(bf) < 0) failures++;
+    uint64_t moved = bf->compact.stats.moved;
+    if (moved != TEST_COMPACT_SPARSE / 4 || bf->cnt_chunk[0] != 0) failures++;
+    if (brain_file_columns(bf, 0, &col) == 0) failures++;
+
+    for (int64_t id = 0; id < TEST_COMPACT_IDS; id++) {
+        if (!compact_gone(id) && counter_check(bf, id, timestamp) < 0) failures++;
+    }
+    brain_file_close(bf);
+
+    /* 읽기 전용으로 다시 열기: 값은 그대로, touch는 거부 */
+    bf = brain_file_open(TEST_COUNTER_FILE, 0);
+    if (!bf) return -1;
+    for (int64_t id = 0; id < TEST_COMPACT_IDS; id++) {
+        if (!compact_gone(id) && counter_check(bf, id, timestamp) < 0) failures++;
+    }
+    brain_entry_t e;
+    if (brain_file_get(bf, TEST_COMPACT_IDS - 1, &e) < 0 || brain_file_touch(bf, &e) == 0) {
+        failures++;
+    }
+    printf("  After compaction (%lu moved) + reopen: hits %lu\n",
+           (unsigned long)moved, (unsigned long)counter_scan_columns(bf));
+    brain_file_close(bf);
+    unlink(TEST_COUNTER_FILE);
+
+    if (failures > 0) {
+        printf("  ❌ %d mismatches\n", failures);
+        return -1;
+    }
+
+    printf("  ✓ Counters live in their own column section and follow records\n");
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 테스트 12: 보조 정렬 인덱스
+ *
+ * timestamp를 섞어서 쓰고, 시간 창 / 낮은 중요도 구간 순회 결과를
+ * 전체 훑기와 비교한다. 값 변경 / 삭제 / 컴팩션 / 재열기 (run 재사용)
+ * 뒤에도 같아야 하고, 구간 순회는 맞는 항목만 읽어야 한다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 분 단위로 섞인 timestamp (7919는 TEST_COMPACT_IDS와 서로소) */
+static int64_t range_timestamp(int64_t id) {
+    return TEST_RANGE_EPOCH + (id * 7919 % TEST_COMPACT_IDS) * 60;
+}
+
+/* 구간 순회로 센 레코드 수와 ID 합 (읽은 항목 수는 scanned) */
+static int range_count(brain_file_t* bf, uint32_t key, int64_t lo, int64_t hi,
+                       uint64_t* count, uint64_t* id_sum, uint64_t* scanned) {
+    *count = 0;
+    *id_sum = 0;
+    *scanned = 0;
+
+    brain_range_iter_t it;
+    if (brain_file_range(bf, key, lo, hi, &it) < 0) return -1;
+
+    brain_entry_t e;
+    int64_t prev = INT64_MIN;
+    int sorted = 1;
+    while (brain_file_range_next(&it, &e)) {
+        int64_t value = key == BRAIN_RANGE_TIMESTAMP ? *e.timestamp
+                                                     : brain_importance_key(*e.importance);
+        if (value < prev) sorted = 0;
+        prev = value;
+        (*count)++;
+        *id_sum += (uint64_t)e.record->id;
+    }
+    *scanned = it.scanned;
+    return sorted ? 0 : -1;
+}
+
+/* 같은 조건을 전체 레코드 훑기로 */
+static void range_brute(const brain_file_t* bf, uint32_t key, int64_t lo, int64_t hi,
+                        uint64_t* count, uint64_t* id_sum) {
+    *count = 0;
+    *id_sum = 0;
+    for (uint64_t r = 0; r < brain_file_header(bf)->record_count; r++) {
+        brain_entry_t e;
+        if (brain_file_entry(bf, r, &e) < 0 || !(e.record->flags & BRAIN_RECORD_LIVE)) continue;
+
+        int64_t value = key == BRAIN_RANGE_TIMESTAMP ? *e.timestamp
+                                                     : brain_importance_key(*e.importance);
+        if (value < lo || value > hi) continue;
+        (*count)++;
+        *id_sum += (uint64_t)e.record->id;
+    }
+}
+
+/* 시간 창 2개 + 중요도 구간 1개를 전체 훑기와 비교 (불일치 수) */
+static int range_compare(brain_file_t* bf, const char* label) {
+    struct { uint32_t key; int64_t lo, hi; } q[] = {
+        { BRAIN_RANGE_TIMESTAMP, TEST_RANGE_EPOCH + 1000 * 60, TEST_RANGE_EPOCH + 1999 * 60 },
+        { BRAIN_RANGE_TIMESTAMP, TEST_RANGE_EPOCH - 60, TEST_RANGE_EPOCH + 99 * 60 },
+        { BRAIN_RANGE_IMPORTANCE, brain_importance_key(0.0f), brain_importance_key(0.049f) },
+    };
+
+    int failures = 0;
+    for (size_t i = 0; i < sizeof(q) / sizeof(q[0]); i++) {
+        uint64_t count, sum, scanned, bcount, bsum;
+        if (range_count(bf, q[i].key, q[i].lo, q[i].hi, &count, &sum, &scanned) < 0) failures++;
+        range_brute(bf, q[i].key, q[i].lo, q[i].hi, &bcount, &bsum);
+        if (count != bcount || sum != bsum || count == 0) failures++;
+        if (i == 0) {
+            printf("  %-22s window: %lu records (read %lu index entries of %lu issued)\n", label,
+                   (unsigned long)count, (unsigned long)scanned,
+                   (unsigned long)brain_file_header(bf)->record_count);
+        }
+    }
+    return failures;
+}
+
+int test_range_index() {
+    printf("\n=== Test 12: Secondary Range Index (%d records) ===\n", TEST_COMPACT_IDS);
+
+    unlink(TEST_RANGE_FILE);
+    brain_file_t* bf = brain_file_create(TEST_RANGE_FILE, TEST_ENGINE_DIM,
+                                         INDEX_LAYOUT_ROBIN_HOOD);
+    if (!bf) return -1;
+
+    float vec[TEST_ENGINE_DIM];
+    int failures = 0;
+
+    /* 앞쪽 절반: 인덱스를 만들기 전에 추가 (첫 조회가 전부 따라잡음) */
+    for (int64_t id = 0; id < TEST_COMPACT_IDS / 2; id++) {
+        engine_vector(id, 0, vec);
+        brain_entry_t e;
+        if (brain_file_append(bf, id, vec, NULL, 0, counter_importance(id)) < 0 ||
+            brain_file_get(bf, id, &e) < 0 ||
+            brain_file_set_timestamp(bf, &e, range_timestamp(id)) < 0) {
+            failures++;
+        }
+    }
+    failures += range_compare(bf, "Built from records:");
+
+    /* 뒤쪽 절반: delta로 들어감 → 병합 */
+    for (int64_t id = TEST_COMPACT_IDS / 2; id < TEST_COMPACT_IDS; id++) {
+        engine_vector(id, 0, vec);
+        brain_entry_t e;
+        if (brain_file_append(bf, id, vec, NULL, 0, counter_importance(id)) < 0 ||
+            brain_file_get(bf, id, &e) < 0 ||
+            brain_file_set_timestamp(bf, &e, range_timestamp(id)) < 0) {
+            failures++;
+        }
+    }
+    failures += range_compare(bf, "After appends:");
+    if (bf->range[BRAIN_RANGE_TIMESTAMP].merges == 0) failures++;
+
+    /* 값 변경 (중요도 올리기 / 시간 옮기기), 삭제, 덮어쓰기 */
+    for (int64_t id = 0; id < TEST_COMPACT_IDS; id += 3) {
+        brain_entry_t e;
+        if (brain_file_get(bf, id, &e) < 0) continue;
+        if (brain_file_set_importance(bf, &e, 0.95f) < 0) failures++;
+        if (id % 2 == 0 && brain_file_set_timestamp(bf, &e, range_timestamp(id) + 30) < 0) {
+            failures++;
+        }
+    }
+    for (int64_t id = 1; id < TEST_COMPACT_SPARSE; id++) {
+        if (compact_gone(id) && brain_file_delete(bf, id) < 0) failures++;
+    }
+    for (int64_t id = TEST_COMPACT_SPARSE + 1; id < TEST_COMPACT_IDS; id += 50) {
+        engine_vector(id, 1, vec);
+        if (brain_file_append(bf, id, vec, NULL, 0, 0.01f) < 0) failures++;
+    }
+    failures += range_compare(bf, "After updates/deletes:");
+
+    /* 컴팩션이 레코드를 옮겨도 (번호 변경) 결과는 같아야 함 */
+    if (brain_file_compact(bf) < 0) failures++;
+    failures += range_compare(bf, "After compaction:");
+    brain_file_close(bf);
+
+    /* 읽기 전용으로 다시 열기: 닫을 때 병합한 run을 그대로 씀 (delta 0) */
+    bf = brain_file_open(TEST_RANGE_FILE, 0);
+    if (!bf) return -1;
+    clock_t start = clock();
+    failures += range_compare(bf, "Reopened (run only):");
+    double reopen_ms = (double)(clock() - start) / CLOCKS_PER_SEC * 1000.0;
+    for (uint32_t key = 0; key < BRAIN_RANGE_KEYS; key++) {
+        if (bf->range[key].delta_count != 0 || !bf->range[key].run_valid) failures++;
+    }
+    brain_file_stats(bf);
+    brain_file_close(bf);
+
+    /* 쓰기 가능으로 열어 값 변경 → 닫지 않고 버린 것처럼 봉인 해제 확인 */
+    bf = brain_file_open(TEST_RANGE_FILE, 1);
+    if (!bf) return -1;
+    brain_entry_t e;
+    if (brain_file_get(bf, 0, &e) < 0 || brain_file_set_importance(bf, &e, 0.0f) < 0) failures++;
+    const brain_header_t* h = brain_file_header(bf);
+    const brain_section_t* s = brain_section_find((void*)h, BRAIN_SECTION_RANGE,
+                                                  BRAIN_RANGE_IMPORTANCE);
+    if (!s || s->used != 0) failures++;
+    failures += range_compare(bf, "Reopened + update:");
+    brain_file_close(bf);
+    unlink(TEST_RANGE_FILE);
+
+    printf("  Reopened queries (3) in %.3f ms\n", reopen_ms);
+
+    if (failures > 0) {
+        printf("  ❌ %d mismatches\n", failures);
+        return -1;
+    }
+
+    printf("  ✓ Range iteration matches full scans and reads only matching entries\n");
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 테스트 13: 스냅샷
+ *
+ * 뷰를 잡은 뒤 덮어쓰기 / 삭제 / 추가 (재매핑) / 컴팩션을 계속해도
+ * 뷰와 뷰를 저장한 파일은 그 시점 내용 그대로여야 한다.
+ * 경로를 준 스냅샷 (reflink 또는 복사)도 마찬가지.
+ * 원본 매핑은 보호되지 않으므로 뷰가 열린 채로 축소 / punch도 된다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+static unsigned char snap_byte(size_t off) {
+    return (unsigned char)(off * 31 + (off >> 12));
+}
+
+/* mmap_file 수준: 뷰는 만든 시점의 복사본 */
+static int snap_raw(void) {
+    unlink(TEST_SNAP_RAW);
+    /* 페이지 경계가 아닌 크기 */
+    size_t size = 4 * 1024 * 1024 - 8192 + 100;
+    mmap_file_t* mf = mmap_file_create(TEST_SNAP_RAW, size);
+    if (!mf) return 1;
+
+    unsigned char* p = (unsigned char*)mf->addr;
+    for (size_t off = 0; off < size; off++) p[off] = snap_byte(off);
+
+    mmap_file_t* view = mmap_file_snapshot(mf);
+    if (!view) {
+        mmap_file_close(mf);
+        return 1;
+    }
+
+    int failures = 0;
+    if (view->size != size || view->writable || view->fd >= 0) failures++;
+    if (mmap_file_snapshot(view) != NULL) failures++;      /* 뷰의 뷰는 없음 */
+
+    /* 원본: 모든 페이지 쓰기 → punch → 축소 → 다시 키움 */
+    for (size_t off = 0; off < size; off += 4096) p[off]++;
+    mmap_file_punch(mf, 1024 * 1024, 1024 * 1024);          /* 지원 안 하면 그대로 */
+    if (mmap_file_resize(mf, size / 2) < 0 || mmap_file_resize(mf, size) < 0) failures++;
+
+    const unsigned char* v = (const unsigned char*)view->addr;
+    size_t bad = 0;
+    for (size_t off = 0; off < size; off++) {
+        if (v[off] != snap_byte(off)) bad++;
+    }
+    if (bad > 0) failures++;
+    printf("  Raw view: %zu bytes, %zu changed after writes / punch / shrink of the original\n",
+           size, bad);
+
+    mmap_file_close(view);
     mmap_file_close(mf);
+    unlink(TEST_SNAP_RAW);
+    return failures;
+}
+
+/* 처음 TEST_SNAP_IDS개 (v0)만 있는 시점 */
+static int snap_check_initial(const brain_file_t* bf) {
+    int failures = 0;
+    if (brain_file_count(bf) != TEST_SNAP_IDS ||
+        brain_file_header(bf)->record_count != TEST_SNAP_IDS) {
+        failures++;
+    }
+    for (int64_t id = 0; id < TEST_SNAP_IDS; id++) {
+        if (engine_check(bf, id, 0) < 0) failures++;
+    }
+    brain_entry_t e;
+    if (brain_file_get(bf, TEST_SNAP_IDS, &e) == 0) failures++;
+    return failures;
+}
+
+static int snap_append(brain_file_t* bf, int64_t id, int version) {
+    float vec[TEST_ENGINE_DIM];
+    char meta[32];
+    engine_vector(id, version, vec);
+    snprintf(meta, sizeof(meta), "mem-%ld-v%d", (long)id, version);
+    return brain_file_append(bf, id, vec, meta, strlen(meta) + 1, 0.5f) < 0 ? 1 : 0;
+}
+
+int test_snapshot() {
+    printf("\n=== Test 13: Snapshots (%d records) ===\n", TEST_SNAP_IDS);
+
+    unlink(TEST_SNAP_FILE);
+    unlink(TEST_SNAP_COPY);
+    unlink(TEST_SNAP_LINK);
+    brain_file_t* bf = brain_file_create(TEST_SNAP_FILE, TEST_ENGINE_DIM, INDEX_LAYOUT_GROUPED);
+    if (!bf) return -1;
+
+    int failures = 0;
+    for (int64_t id = 0; id < TEST_SNAP_IDS; id++) failures += snap_append(bf, id, 0);
+
+    /* 뷰 (파일 시스템과 무관한 경로) */
+    size_t file_size = bf->mf->size;
+    clock_t start = clock();
+    brain_file_t* snap = brain_file_snapshot(bf, NULL);
+    double snap_ms = (double)(clock() - start) / CLOCKS_PER_SEC * 1000.0;
+    if (!snap || !brain_file_is_view(snap)) return -1;
+
+    /* 쓰기 계속: 10개마다 덮어쓰기, 7개마다 삭제, 같은 수만큼 추가 → 컴팩션 */
+    start = clock();
+    for (int64_t id = 0; id < TEST_SNAP_IDS; id += 10) failures += snap_append(bf, id, 1);
+    for (int64_t id = 3; id < TEST_SNAP_IDS; id += 7) {
+        if (brain_file_delete(bf, id) < 0) failures++;
+    }
+    for (int64_t id = TEST_SNAP_IDS; id < 2 * TEST_SNAP_IDS; id++) failures += snap_append(bf, id, 0);
+    if (brain_file_compact(bf) < 0) failures++;
+    double write_ms = (double)(clock() - start) / CLOCKS_PER_SEC * 1000.0;
+
+    printf("  Snapshot copy: %zu bytes in %.2f ms, writes after snapshot: %.2f ms\n",
+           file_size, snap_ms, write_ms);
+    if (snap->mf->size != file_size) failures++;
+
+    failures += snap_check_initial(snap);
+
+    /* 뷰 → 백업 파일 (원본 쓰기 잠금 밖에서 해도 됨) */
+    if (brain_file_save(snap, TEST_SNAP_COPY) < 0) failures++;
+    brain_file_close(snap);
+
+    /* 뷰를 닫은 뒤에도 원본 쓰기 그대로 */
+    failures += snap_append(bf, 2 * TEST_SNAP_IDS, 0);
+
+    /* 경로 스냅샷 (reflink, 안 되면 copy_file_range) */
+    uint64_t live = brain_file_count(bf);
+    brain_file_t* link = brain_file_snapshot(bf, TEST_SNAP_LINK);
+    if (!link) return -1;
+    if (brain_file_is_view(link) || link->mf->writable) failures++;
+    failures += snap_append(bf, 2 * TEST_SNAP_IDS + 1, 0);
+    if (brain_file_count(link) != live) failures++;
+    brain_file_close(link);
+
+    brain_file_close(bf);
+
+    /* 저장 파일들 검사 */
+    brain_file_t* copy = brain_file_open(TEST_SNAP_COPY, 0);
+    if (!copy) return -1;
+    failures += snap_check_initial(copy);
+    brain_file_close(copy);
+
+    link = brain_file_open(TEST_SNAP_LINK, 0);
+    if (!link) return -1;
+    brain_entry_t e;
+    if (brain_file_count(link) != live || brain_file_get(link, 2 * TEST_SNAP_IDS, &e) < 0 ||
+        brain_file_get(link, 2 * TEST_SNAP_IDS + 1, &e) == 0) {
+        failures++;
+    }
+    brain_file_close(link);
+
+    /* 원본은 마지막 상태 */
+    bf = brain_file_open(TEST_SNAP_FILE, 0);
+    if (!bf) return -1;
+    for (int64_t id = 0; id < TEST_SNAP_IDS; id++) {
+        int gone = (id % 7 == 3);
+        if (gone ? brain_file_get(bf, id, &e) == 0 : engine_check(bf, id, id % 10 == 0) < 0) {
+            failures++;
+        }
+    }
+    if (brain_file_count(bf) != live + 1) failures++;
+    brain_file_close(bf);
+
+    failures += snap_raw();
+
+    unlink(TEST_SNAP_FILE);
+    unlink(TEST_SNAP_COPY);
+    unlink(TEST_SNAP_LINK);
+
+    if (failures > 0) {
+        printf("  ❌ %d mismatches\n", failures);
+        return -1;
+    }
+
+    printf("  ✓ Snapshot view and saved copies kept the point-in-time image\n");
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 테스트 14: Dirty 범위 추적 / 비동기 flush
+ *
+ * 레코드 1개 touch 뒤 배리어는 그 단위 하나만 내보내야 하고,
+ * flusher는 max-dirty-age 안에 dirty를 비워야 한다 (배리어 전까지 pending).
+ * 재열기 후 touch / 덮어쓰기가 모두 남아 있어야 한다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+static double sync_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+/* 12345: 배리어 / 전체 msync 앞에서 한 번씩, 997의 배수: flusher 단계에서 한 번 */
+static uint32_t sync_touches(int64_t id) {
+    return id == 12345 ? 2 : (id % 997 == 0 ? 1 : 0);
+}
+
+int test_dirty_tracking() {
+    printf("\n=== Test 14: Dirty-range tracking / async flush (%d records) ===\n", TEST_SYNC_IDS);
+
+    unlink(TEST_SYNC_FILE);
+    brain_file_t* bf = brain_file_create(TEST_SYNC_FILE, TEST_ENGINE_DIM, INDEX_LAYOUT_GROUPED);
+    if (!bf) return -1;
+
+    /* 추적은 고른 파일만 (기본은 표시해도 기록하지 않음) */
+    int failures = 0;
+    mmap_flush_stats_t st;
+    if (mmap_file_flush_stats(bf->mf, &st) == 0) failures++;
+    if (brain_file_set_flush_age(bf, 0) < 0) return -1;
+
+    for (int64_t id = 0; id < TEST_SYNC_IDS; id++) failures += snap_append(bf, id, 0);
+    if (brain_file_checkpoint(bf) < 0) failures++;
+
+    if (mmap_file_flush_stats(bf->mf, &st) < 0) return -1;
+    if (st.dirty_bytes != 0 || st.pending_bytes != 0) failures++;
+    uint64_t synced = st.synced_bytes;
+
+    /* 작은 변경 1개 → 배리어는 64KB 단위 하나 */
+    brain_entry_t e;
+    if (brain_file_get(bf, 12345, &e) < 0 || brain_file_touch(bf, &e) < 0) failures++;
+    mmap_file_flush_stats(bf->mf, &st);
+    size_t dirty = st.dirty_bytes;
+
+    double t0 = sync_now_ms();
+    if (mmap_file_sync(bf->mf) < 0) failures++;
+    double barrier_ms = sync_now_ms() - t0;
+    mmap_file_flush_stats(bf->mf, &st);
+    uint64_t one = st.synced_bytes - synced;
+    if (dirty != MMAP_DIRTY_GRANULE || one != MMAP_DIRTY_GRANULE) failures++;
+
+    /* 기준: 같은 변경 뒤 매핑 전체 msync */
+    if (brain_file_touch(bf, &e) < 0) failures++;
+    t0 = sync_now_ms();
+    msync(bf->mf->addr, bf->mf->size, MS_SYNC);
+    double full_ms = sync_now_ms() - t0;
+    if (mmap_file_sync(bf->mf) < 0) failures++;
+    printf("  1 touch: barrier %lu bytes in %.3f ms, full msync %zu bytes in %.3f ms\n",
+           (unsigned long)one, barrier_ms, bf->mf->size, full_ms);
+
+    /* flusher: 흩어진 touch + 덮어쓰기 → max-age 안에 비동기 flush */
+    if (brain_file_set_flush_age(bf, TEST_SYNC_AGE_MS) < 0) failures++;
+    for (int64_t id = 0; id < TEST_SYNC_IDS; id += 997) {
+        if (brain_file_get(bf, id, &e) < 0 || brain_file_touch(bf, &e) < 0) failures++;
+    }
+    for (int64_t id = 1; id < TEST_SYNC_IDS; id += 1000) failures += snap_append(bf, id, 1);
+    mmap_file_flush_stats(bf->mf, &st);
+    size_t written = st.dirty_bytes;
+    uint64_t flushes = st.flushes;
+
+    t0 = sync_now_ms();
+    struct timespec nap = { 0, 1000000 };
+    while (sync_now_ms() - t0 < 50 * TEST_SYNC_AGE_MS) {
+        nanosleep(&nap, NULL);
+        mmap_file_flush_stats(bf->mf, &st);
+        if (st.dirty_bytes == 0 && st.flushes > flushes) break;
+    }
+    double drained_ms = sync_now_ms() - t0;
+    printf("  Flusher (max age %d ms): %zu dirty bytes → async in %.1f ms, %lu pending\n",
+           TEST_SYNC_AGE_MS, written, drained_ms, (unsigned long)st.pending_bytes);
+    if (written == 0 || st.dirty_bytes != 0 || st.pending_bytes == 0) failures++;
+
+    /* 배리어가 pending까지 기다림 */
+    if (brain_file_checkpoint(bf) < 0) failures++;
+    mmap_file_flush_stats(bf->mf, &st);
+    if (st.dirty_bytes != 0 || st.pending_bytes != 0) failures++;
+    printf("  Marks %lu, async flushes %lu (%lu bytes), barriers %lu (%lu bytes)\n",
+           (unsigned long)st.marks, (unsigned long)st.flushes, (unsigned long)st.flushed_bytes,
+           (unsigned long)st.syncs, (unsigned long)st.synced_bytes);
+    brain_file_close(bf);
+
+    /* 재열기 (BRAIN_OPEN_TRACK): 모든 쓰기가 남아 있어야 함 */
+    bf = brain_file_open_ex(TEST_SYNC_FILE, 1, BRAIN_OPEN_TRACK);
+    if (!bf) return -1;
+    if (mmap_file_flush_stats(bf->mf, &st) < 0) failures++;
+    for (int64_t id = 0; id < TEST_SYNC_IDS; id++) {
+        if (engine_check(bf, id, id % 1000 == 1) < 0 ||
+            brain_file_get(bf, id, &e) < 0 || *e.access_count != sync_touches(id)) {
+            failures++;
+        }
+    }
+    brain_file_close(bf);
+    unlink(TEST_SYNC_FILE);
+
+    if (failures > 0) {
+        printf("  ❌ %d mismatches\n", failures);
+        return -1;
+    }
+
+    printf("  ✓ Barrier wrote only dirty ranges, flusher drained within max age\n");
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 테스트 15: 예열 열기
+ *
+ * 같은 파일을 그냥 / populate + hugepage로 열어 전체 조회 때 fault 수를 비교.
+ * 인덱스 warm + mlock은 파일이 커져 재매핑돼도 잠금이 유지되어야 한다.
+ * (페이지 캐시는 이미 차 있으므로 minor fault = 페이지 테이블 채우기)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+static long warm_faults(void) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_minflt + ru.ru_majflt;
+}
+
+/* 전체 조회 (첫 쿼리 부하 흉내) */
+static int warm_scan(const brain_file_t* bf, long* faults, double* ms) {
+    int failures = 0;
+    long f0 = warm_faults();
+    double t0 = sync_now_ms();
+    for (int64_t id = 0; id < TEST_WARM_IDS; id++) {
+        if (engine_check(bf, id, 0) < 0) failures++;
+    }
+    *ms = sync_now_ms() - t0;
+    *faults = warm_faults() - f0;
+    return failures;
+}
+
+int test_warm_start() {
+    printf("\n=== Test 15: Warm-start open options (%d records) ===\n", TEST_WARM_IDS);
+
+    unlink(TEST_WARM_FILE);
+    brain_file_t* bf = brain_file_create(TEST_WARM_FILE, TEST_ENGINE_DIM, INDEX_LAYOUT_GROUPED);
+    if (!bf) return -1;
+    int failures = 0;
+    for (int64_t id = 0; id < TEST_WARM_IDS; id++) failures += snap_append(bf, id, 0);
+    brain_file_close(bf);
+
+    /* 기본: 조회마다 demand fault */
+    long cold_faults, hot_faults;
+    double cold_ms, hot_ms;
+    bf = brain_file_open(TEST_WARM_FILE, 0);
+    if (!bf) return -1;
+    failures += warm_scan(bf, &cold_faults, &cold_ms);
+    brain_file_close(bf);
+
+    /* populate + hugepage: 열 때 한 번에 */
+    bf = brain_file_open_ex(TEST_WARM_FILE, 0, BRAIN_OPEN_POPULATE | BRAIN_OPEN_HUGEPAGE);
+    if (!bf) return -1;
+    const mmap_warm_t* warm = &bf->mf->warm;
+    if (bf->mf->size >= MMAP_HUGE_ALIGN && ((uintptr_t)bf->mf->addr % MMAP_HUGE_ALIGN) != 0) failures++;
+    failures += warm_scan(bf, &hot_faults, &hot_ms);
+    printf("  First scan: default %ld faults / %.2f ms, populated %ld faults / %.2f ms "
+           "(open: %lu faults, %.2f ms, hugepage %s)\n",
+           cold_faults, cold_ms, hot_faults, hot_ms,
+           (unsigned long)(warm->minor_faults + warm->major_faults), warm->warm_ms,
+           warm->huge ? "on" : "unavailable");
+    if (cold_faults <= 0 || hot_faults * 4 > cold_faults) failures++;
+    brain_file_close(bf);
+
+    /* 인덱스만 warm + mlock → 파일이 커져도 (재매핑 / 재해시) 잠금 유지 */
+    bf = brain_file_open_ex(TEST_WARM_FILE, 1, BRAIN_OPEN_WARM_INDEX);
+    if (!bf) return -1;
+    warm = &bf->mf->warm;
+    if (warm->minor_faults + warm->major_faults == 0) failures++;
+    if (brain_file_lock(bf, BRAIN_LOCK_INDEX | BRAIN_LOCK_RANGE) < 0) {
+        printf("  mlock unavailable (RLIMIT_MEMLOCK), skipping lock checks\n");
+    } else {
+        size_t locked = warm->locked_bytes;
+        for (int64_t id = TEST_WARM_IDS; id < 2 * TEST_WARM_IDS; id++) failures += snap_append(bf, id, 0);
+        if (warm->locked_bytes == 0 || brain_file_lock(bf, BRAIN_LOCK_INDEX) < 0 ||
+            warm->locked_bytes <= locked) {
+            failures++;
+        }
+        printf("  Index locked: %zu bytes → %zu bytes after growth\n", locked, warm->locked_bytes);
+    }
+    for (int64_t id = 0; id < TEST_WARM_IDS; id += 97) {
+        if (engine_check(bf, id, 0) < 0) failures++;
+    }
+    brain_file_stats(bf);
+    brain_file_close(bf);
+    unlink(TEST_WARM_FILE);
+
+    if (failures > 0) {
+        printf("  ❌ %d mismatches\n", failures);
+        return -1;
+    }
+
+    printf("  ✓ Populated open removed first-query faults, locks follow remaps\n");
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 테스트 16: 주소 고정 확장
+ *
+ * 첫 레코드 포인터를 잡아 둔 채 파일을 여러 번 키운다 → 예약 안에서
+ * 제자리로 커지므로 주소와 포인터가 그대로여야 한다.
+ * 꼬리를 잘랐다 다시 키워도 주소 유지, 새로 붙은 부분은 0.
+ * dirty 추적 중 다른 스레드가 쓰는 동안 키워도 표시가 빠지지 않아야 한다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+typedef struct {
+    mmap_file_t* mf;
+    volatile int stop;
+    uint64_t     writes;
+} growth_writer_t;
+
+/* 페이지마다 한 바이트씩 계속 쓰고 표시 */
+static void* growth_writer(void* arg) {
+    growth_writer_t* r = (growth_writer_t*)arg;
+    volatile char* p = (volatile char*)r->mf->addr;
+    while (!r->stop) {
+        for (size_t off = 0; off < r->mf->size; off += 4096) {
+            p[off]++;
+            mmap_file_mark_dirty(r->mf, off, 1);
+        }
+        __atomic_fetch_add(&r->writes, 1, __ATOMIC_RELEASE);
+    }
+    return NULL;
+}
+
+int test_stable_growth() {
+    printf("\n=== Test 16: Stable-address growth (%d records) ===\n", TEST_STABLE_IDS);
+
+    unlink(TEST_STABLE_FILE);
+    brain_file_t* bf = brain_file_create(TEST_STABLE_FILE, TEST_ENGINE_DIM, INDEX_LAYOUT_GROUPED);
+    if (!bf) return -1;
+    int failures = snap_append(bf, 0, 0);
+
+    void* base = bf->mf->addr;
+    brain_entry_t first;
+    if (brain_file_get(bf, 0, &first) < 0) return -1;
+    float expect[TEST_ENGINE_DIM];
+    engine_vector(0, 0, expect);
+
+    /* 키우기: 크기가 바뀔 때마다 주소 확인 */
+    int grows = 0;
+    size_t size = bf->mf->size;
+    for (int64_t id = 1; id < TEST_STABLE_IDS; id++) {
+        failures += snap_append(bf, id, 0);
+        if (bf->mf->size != size) {
+            size = bf->mf->size;
+            grows++;
+            if (bf->mf->addr != base) failures++;
+        }
+    }
+    if (grows < 2 || bf->mf->moves != 0 || bf->mf->reserved < bf->mf->size) failures++;
+    if (first.record->id != 0 || memcmp(first.vector, expect, sizeof(expect)) != 0) failures++;
+    printf("  Grew %d times to %.1f MB inside %zu MB reservation, %u moves\n",
+           grows, size / 1024.0 / 1024.0, bf->mf->reserved >> 20, bf->mf->moves);
+
+    brain_file_close(bf);
+
+    /* 다시 열어 내용 확인 */
+    bf = brain_file_open(TEST_STABLE_FILE, 0);
+    if (!bf) return -1;
+    for (int64_t id = 0; id < TEST_STABLE_IDS; id++) {
+        if (engine_check(bf, id, 0) < 0) failures++;
+    }
+    brain_file_close(bf);
+    unlink(TEST_STABLE_FILE);
+
+    /* 줄였다 다시 키우기 (mmap 레벨): 잘린 꼬리는 예약으로, 남은 내용은 그대로 */
+    mmap_file_t* mf = mmap_file_create(TEST_STABLE_FILE, 4 << 20);
+    if (!mf) return -1;
+    base = mf->addr;
+    memset(mf->addr, 0x5A, mf->size);
+    if (mmap_file_resize(mf, 1 << 20) < 0 || mmap_file_resize(mf, 8 << 20) < 0) failures++;
+    const uint8_t* bytes = (const uint8_t*)mf->addr;
+    if (mf->addr != base || mf->moves != 0 ||
+        bytes[0] != 0x5A || bytes[(1 << 20) - 1] != 0x5A || bytes[1 << 20] != 0 || bytes[(8 << 20) - 1] != 0) {
+        failures++;
+    }
+    printf("  Shrank 4 MB → 1 MB → regrew 8 MB at the same address\n");
+    mmap_file_close(mf);
+    unlink(TEST_STABLE_FILE);
+
+    /* dirty 추적 + 쓰는 스레드가 있는 동안 키우기 (비트맵은 예약 크기라 그대로) */
+    mf = mmap_file_create(TEST_STABLE_FILE, 1 << 20);
+    if (!mf || mmap_file_track(mf, 0) < 0) return -1;
+
+    /* 추적 중인 매핑도 커널이 쓸 수 있어야 함 (쓰기 보호 없음 → read(2)가 EFAULT 아님) */
+    int pipefd[2];
+    if (pipe(pipefd) < 0) return -1;
+    if (write(pipefd[1], "brain", 5) != 5 || mmap_file_sync(mf) < 0 ||
+        read(pipefd[0], (char*)mf->addr + 8192, 5) != 5 ||
+        memcmp((char*)mf->addr + 8192, "brain", 5) != 0) {
+        printf("  ❌ read(2) into a tracked mapping failed\n");
+        failures++;
+    }
+    close(pipefd[0]);
+    close(pipefd[1]);
+    mmap_file_mark_dirty(mf, 8192, 5);
+    growth_writer_t race = { mf, 0, 0 };
+    pthread_t writer;
+    if (pthread_create(&writer, NULL, growth_writer, &race) != 0) return -1;
+    struct timespec tick = { 0, 1000000 };
+    for (size_t mb = 2; mb <= 64; mb *= 2) {
+        uint64_t passes = __atomic_load_n(&race.writes, __ATOMIC_ACQUIRE);
+        while (__atomic_load_n(&race.writes, __ATOMIC_ACQUIRE) == passes) nanosleep(&tick, NULL);
+        if (mmap_file_resize(mf, mb << 20) < 0 || mmap_file_sync(mf) < 0) failures++;
+    }
+    race.stop = 1;
+    pthread_join(writer, NULL);
+    mmap_flush_stats_t fs;
+    if (mmap_file_sync(mf) < 0 || mmap_file_flush_stats(mf, &fs) < 0 ||
+        mf->moves != 0 || fs.marks == 0) {
+        failures++;
+    }
+    printf("  Grew 1 MB → 64 MB under tracking with a concurrent writer (%lu first marks)\n",
+           (unsigned long)fs.marks);
+    mmap_file_close(mf);
+    unlink(TEST_STABLE_FILE);
+
+    if (failures > 0) {
+        printf("  ❌ %d mismatches\n", failures);
+        return -1;
+    }
+
+    printf("  ✓ Entry pointers stayed valid across growth and truncation\n");
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * 테스트 17: 페이지 heat + 재시작 선읽기
+ *
+ * 한 구간만 반복 조회한 세션을 닫으면 heat 파일이 남는다.
+ * 페이지 캐시를 비운 뒤 (재부팅 흉내):
+ *   - 선읽기 없이 열기 → 뜨거운 구간 첫 조회가 major fault
+ *   - BRAIN_OPEN_PREFETCH → 배경 선읽기가 끝나면 그 구간은 이미 캐시에
+ *   - 한도 선읽기 → 뜨거운 벡터는 들어오고 안 쓴 뒤쪽 벡터는 안 들어옴
+ * (캐시 비우기가 안 되는 환경이면 fault 비교는 건너뜀)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+static void heat_drop_cache(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return;
+    fdatasync(fd);      /* dirty 페이지는 버려지지 않음 */
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+/* ids [first, first + count) 벡터 페이지 중 상주 비율 */
+static double heat_resident(const brain_file_t* bf, int64_t first, int64_t count) {
+    brain_entry_t a, b;
+    if (brain_file_get(bf, first, &a) < 0 || brain_file_get(bf, first + count - 1, &b) < 0) return -1;
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t)a.vector / page * page;
+    size_t len = (uintptr_t)b.vector + TEST_ENGINE_DIM * sizeof(float) - start;
+    size_t pages = (len + page - 1) / page;
+    unsigned char* vec = (unsigned char*)malloc(pages);
+    if (!vec || mincore((void*)start, len, vec) < 0) {
+        free(vec);
+        return -1;
+    }
+    size_t resident = 0;
+    for (size_t p = 0; p < pages; p++) resident += vec[p] & 1;
+    free(vec);
+    return (double)resident / pages;
+}
+
+/* 배경 선읽기가 요청한 readahead가 도착할 때까지 (최대 2초) */
+static double heat_wait_resident(const brain_file_t* bf, int64_t first, int64_t count) {
+    mmap_file_prefetch_wait(bf->mf);
+    double r = 0;
+    for (int i = 0; i < 200; i++) {
+        r = heat_resident(bf, first, count);
+        if (r >= 0.99) break;
+        struct timespec ts = {0, 10 * 1000000L};
+        nanosleep(&ts, NULL);
+    }
+    return r;
+}
+
+/* 뜨거운 구간 조회 (벡터까지 읽음) → major fault 수 */
+static long heat_scan(const brain_file_t* bf, int* failures) {
+    struct rusage r0, r1;
+    getrusage(RUSAGE_SELF, &r0);
+    for (int64_t id = TEST_HEAT_HOT; id < TEST_HEAT_HOT + TEST_HEAT_SPAN; id++) {
+        if (engine_check(bf, id, 0) < 0) (*failures)++;
+    }
+    getrusage(RUSAGE_SELF, &r1);
+    return r1.ru_majflt - r0.ru_majflt;
+}
+
+int test_heat_prefetch() {
+    printf("\n=== Test 17: Page heat + restart prefetch (%d records) ===\n", TEST_HEAT_IDS);
+
+    unlink(TEST_HEAT_FILE);
+    unlink(TEST_HEAT_PATH);
+    brain_file_t* bf = brain_file_create(TEST_HEAT_FILE, TEST_ENGINE_DIM, INDEX_LAYOUT_GROUPED);
+    if (!bf) return -1;
+    int failures = 0;
+    for (int64_t id = 0; id < TEST_HEAT_IDS; id++) failures += snap_append(bf, id, 0);
+    brain_file_close(bf);
+
+    /* 1세션: heat 파일 없음 → 선읽기 없이 시작, 한 구간만 반복 조회 */
+    bf = brain_file_open_ex(TEST_HEAT_FILE, 0, BRAIN_OPEN_PREFETCH);
+    if (!bf) return -1;
+    mmap_heat_stats_t hs;
+    if (mmap_file_heat_stats(bf->mf, &hs) < 0 || hs.prefetch_granules != 0) failures++;
+    for (int round = 0; round < TEST_HEAT_ROUNDS; round++) {
+        for (int64_t id = TEST_HEAT_HOT; id < TEST_HEAT_HOT + TEST_HEAT_SPAN; id++) {
+            if (engine_check(bf, id, 0) < 0) failures++;
+        }
+    }
+    brain_file_close(bf);
+    if (access(TEST_HEAT_PATH, R_OK) != 0) failures++;
+
+    /* 선읽기 경로 (BRAIN_OPEN_PREFETCH): heat 파일을 읽어 배경 스레드 시작 */
+    bf = brain_file_open_ex(TEST_HEAT_FILE, 0, BRAIN_OPEN_PREFETCH);
+    if (!bf) return -1;
+    mmap_file_prefetch_wait(bf->mf);
+    if (mmap_file_heat_stats(bf->mf, &hs) < 0 || hs.prefetch_granules == 0 || !hs.prefetch_done) failures++;
+    printf("  Prefetched %u granules (%.1f MB) in %.2f ms\n",
+           hs.prefetch_granules, hs.prefetched_bytes / 1024.0 / 1024.0, hs.prefetch_ms);
+    brain_file_stats(bf);
+    brain_file_close(bf);
+
+    /* 재시작 흉내: 연 뒤 캐시를 비우고 (매핑된 헤더 / 인덱스 페이지는 남음)
+     * 커널 read-around를 끈 상태에서 뜨거운 구간 조회 */
+    long major[3];
+    double hot[3], tail[3];
+    size_t budgets[3] = { 0, 0, TEST_HEAT_BUDGET };
+    double dropped = 1;
+    for (int run = 0; run < 3; run++) {
+        bf = brain_file_open(TEST_HEAT_FILE, 0);
+        if (!bf) return -1;
+        mmap_file_advise(bf->mf, MADV_RANDOM);
+        heat_drop_cache(TEST_HEAT_FILE);
+        if (run == 0) dropped = heat_resident(bf, TEST_HEAT_HOT, TEST_HEAT_SPAN);
+        if (run > 0 && mmap_file_prefetch(bf->mf, TEST_HEAT_PATH, budgets[run]) < 0) failures++;
+        hot[run] = run > 0 ? heat_wait_resident(bf, TEST_HEAT_HOT, TEST_HEAT_SPAN) : 0;
+        tail[run] = heat_resident(bf, TEST_HEAT_IDS - TEST_HEAT_SPAN, TEST_HEAT_SPAN);
+        major[run] = heat_scan(bf, &failures);
+        brain_file_close(bf);
+    }
+
+    if (dropped >= 0 && dropped < 0.1) {
+        printf("  Hot scan after cache drop: %ld major faults cold, %ld after prefetch (hot %.0f%% resident)\n",
+               major[0], major[1], hot[1] * 100);
+        printf("  %d KB budget: hot vectors %.0f%%, unused tail vectors %.0f%% resident\n",
+               TEST_HEAT_BUDGET / 1024, hot[2] * 100, tail[2] * 100);
+        if (hot[1] < 0.9 || major[0] == 0 || major[1] * 4 > major[0]) failures++;
+        if (hot[2] < 0.9 || tail[2] > 0.5) failures++;
+    } else {
+        printf("  Page cache drop unavailable (%.0f%% still resident), skipping fault checks\n",
+               dropped * 100);
+    }
+    unlink(TEST_HEAT_FILE);
+    unlink(TEST_HEAT_PATH);
+
+    if (failures > 0) {
+        printf("  ❌ %d mismatches\n", failures);
+        return -1;
+    }
+
+    printf("  ✓ Heat map replayed hottest pages first on restart\n");
+    return 0;
 }
 
 /* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -222,6 +1999,61 @@ int main() {
     test_file_creation();
     test_index_operations();
     test_vector_storage();
+    index_layout_t layouts[] = { INDEX_LAYOUT_ROBIN_HOOD, INDEX_LAYOUT_GROUPED };
+    for (int i = 0; i < 2; i++) {
+        if (test_index_growth(layouts[i]) < 0) {
+            printf("\n❌ Index growth test failed (%s)\n", layout_name(layouts[i]));
+            return 1;
+        }
+        if (test_index_churn(layouts[i]) < 0) {
+            printf("\n❌ Index churn test failed (%s)\n", layout_name(layouts[i]));
+            return 1;
+        }
+        if (test_index_batch(layouts[i]) < 0) {
+            printf("\n❌ Index batch test failed (%s)\n", layout_name(layouts[i]));
+            return 1;
+        }
+    }
+    if (test_v1_reader() < 0) {
+        printf("\n❌ v1 reader test failed\n");
+        return 1;
+    }
+    if (test_brain_file() < 0) {
+        printf("\n❌ Brain file engine test failed\n");
+        return 1;
+    }
+    if (test_compaction() < 0) {
+        printf("\n❌ Compaction test failed\n");
+        return 1;
+    }
+    if (test_counters() < 0) {
+        printf("\n❌ Counter column test failed\n");
+        return 1;
+    }
+    if (test_range_index() < 0) {
+        printf("\n❌ Range index test failed\n");
+        return 1;
+    }
+    if (test_snapshot() < 0) {
+        printf("\n❌ Snapshot test failed\n");
+        return 1;
+    }
+    if (test_dirty_tracking() < 0) {
+        printf("\n❌ Dirty tracking test failed\n");
+        return 1;
+    }
+    if (test_warm_start() < 0) {
+        printf("\n❌ Warm-start test failed\n");
+        return 1;
+    }
+    if (test_stable_growth() < 0) {
+        printf("\n❌ Stable-address growth test failed\n");
+        return 1;
+    }
+    if (test_heat_prefetch() < 0) {
+        printf("\n❌ Heat prefetch test failed\n");
+        return 1;
+    }
 
     printf("\n┏━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━┓\n");
     printf("┃  All tests completed!                           ┃\n");
@@ -20,6 +20,15 @@ typedef struct {
 
 static test_results_t results = {0, 0, 0};
 
+/* 테스트 전용 장기 기억 파일 (실제 HIPPO_DB_PATH는 건드리지 않음) */
+#define TEST_MEMORY_DB "test_brain_core.db"
+
+static void remove_memory(void) {
+    unlink(TEST_MEMORY_DB);
+    unlink(TEST_MEMORY_DB HIPPO_WAL_SUFFIX);
+    unlink(TEST_MEMORY_DB HIPPO_INDEX_SUFFIX);
+}
+
 /* Test helper macros */
 #define TEST_START(name) \
     printf("\n🟢 Test: %s\n", name)
@@ -47,7 +56,7 @@ void test_brain_lifecycle(void) {
     TEST_START("Brain Lifecycle (Create/Destroy)");
 
     /* Create */
-    brain_t* brain = brain_create();
+    brain_t* brain = brain_create_ex(TEST_MEMORY_DB);
     TEST_ASSERT(brain != NULL, "Brain created");
     TEST_ASSERT(brain->state == BRAIN_STATE_BIRTH, "Initial state is BIRTH");
 
@@ -80,7 +89,7 @@ void test_brain_lifecycle(void) {
 void test_brain_startup(void) {
     TEST_START("Brain Startup/Shutdown");
 
-    brain_t* brain = brain_create();
+    brain_t* brain = brain_create_ex(TEST_MEMORY_DB);
     TEST_ASSERT(brain != NULL, "Brain created");
 
     /* Start */
@@ -107,7 +116,7 @@ void test_brain_startup(void) {
 void test_think_pipeline(void) {
     TEST_START("Think Pipeline (Input→Process→Output)");
 
-    brain_t* brain = brain_create();
+    brain_t* brain = brain_create_ex(TEST_MEMORY_DB);
     TEST_ASSERT(brain != NULL, "Brain created");
 
     char output[BRAIN_MAX_OUTPUT_SIZE];
@@ -131,7 +140,7 @@ void test_think_pipeline(void) {
 void test_memory_system(void) {
     TEST_START("Memory System (Remember/Recall)");
 
-    brain_t* brain = brain_create();
+    brain_t* brain = brain_create_ex(TEST_MEMORY_DB);
     TEST_ASSERT(brain != NULL, "Brain created");
 
     /* Remember */
@@ -148,10 +157,11 @@ void test_memory_system(void) {
     TEST_ASSERT(mem_count > 0, "Memories stored in Hippocampus");
 
     /* Recall */
-    char** memories = brain_recall(brain, "Important fact", 3);
-    if (memories) {
-        TEST_ASSERT(brain->total_recalls > 0, "Recall executed");
-    }
+    hippocampus_recall_t memories;
+    int recalled = brain_recall(brain, "Important fact", 3, &memories);
+    TEST_ASSERT(recalled >= 0, "Recall executed");
+    TEST_ASSERT(brain->total_recalls > 0, "Recall counted");
+    brain_recall_release(&memories);
 
     printf("  💾 Stored %u memories\n", mem_count);
     printf("  🔍 Recalled top-3 similar memories\n");
@@ -167,7 +177,7 @@ void test_memory_system(void) {
 void test_24h_simulation(void) {
     TEST_START("24-Hour Simulation (100x speed)");
 
-    brain_t* brain = brain_create();
+    brain_t* brain = brain_create_ex(TEST_MEMORY_DB);
     TEST_ASSERT(brain != NULL, "Brain created");
 
     int result = brain_start(brain);
@@ -203,7 +213,9 @@ void test_24h_simulation(void) {
 void test_health_check(void) {
     TEST_START("Brain Health Check");
 
-    brain_t* brain = brain_create();
+    /* 기억은 파일에 남으므로 새 뇌로 시작 */
+    remove_memory();
+    brain_t* brain = brain_create_ex(TEST_MEMORY_DB);
     TEST_ASSERT(brain != NULL, "Brain created");
 
     int is_healthy = brain_is_healthy(brain);
@@ -235,7 +247,7 @@ void test_health_check(void) {
 void test_dream(void) {
     TEST_START("Dream (Memory Consolidation)");
 
-    brain_t* brain = brain_create();
+    brain_t* brain = brain_create_ex(TEST_MEMORY_DB);
     TEST_ASSERT(brain != NULL, "Brain created");
 
     /* Store some memories */
@@ -264,7 +276,7 @@ void test_dream(void) {
 void test_statistics(void) {
     TEST_START("Brain Statistics");
 
-    brain_t* brain = brain_create();
+    brain_t* brain = brain_create_ex(TEST_MEMORY_DB);
     TEST_ASSERT(brain != NULL, "Brain created");
 
     /* Perform some operations */
@@ -295,7 +307,8 @@ int main(void) {
     printf("║              Phase 10 Implementation                  ║\n");
     printf("╚═══════════════════════════════════════════════════════╝\n");
 
-    /* Run all tests */
+    /* Run all tests (장기 기억 파일 없이 시작) */
+    remove_memory();
     test_brain_lifecycle();
     test_brain_startup();
     test_think_pipeline();
@@ -304,6 +317,7 @@ int main(void) {
     test_health_check();
     test_dream();
     test_statistics();
+    remove_memory();
 
     /* Summary */
     printf("\n╔═══════════════════════════════════════════════════════╗\n");
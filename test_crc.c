@@ -0,0 +1,313 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * test_crc.c
+ *
+ * CRC32C / Checksum Verification Test
+ *
+ * 테스트:
+ *   1. CRC32C: 표준 벡터, SSE4.2 = slicing-by-8 (길이 / 정렬 / 이어 붙이기), 속도
+ *   2. FIRST_TOUCH: 벡터 / 메타데이터 1바이트 손상 → 첫 조회에서 거부
+ *   3. 인덱스 페이지 손상: 읽기 전용은 거부, DAWN scrub은 재구축
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* clock_gettime, pread/pwrite 선언을 위해 필요 */
+#define _POSIX_C_SOURCE 200809L
+
+#include "brain_file.h"
+#include "brain_crc.h"
+#include "kim_circadian.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define TEST_BRAIN      "test_crc.brain"
+#define TEST_DIM        128
+#define TEST_IDS        5000
+#define TEST_BYTES      (16 * 1024 * 1024)
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Helpers
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static brain_file_t* make_file(void) {
+    unlink(TEST_BRAIN);
+    brain_file_t* bf = brain_file_create(TEST_BRAIN, TEST_DIM, INDEX_LAYOUT_ROBIN_HOOD);
+    if (!bf) return NULL;
+
+    float v[TEST_DIM];
+    char meta[64];
+    for (int64_t id = 0; id < TEST_IDS; id++) {
+        for (int j = 0; j < TEST_DIM; j++) v[j] = (float)id + (float)j * 0.01f;
+        int n = snprintf(meta, sizeof(meta), "memory-%ld", (long)id);
+        if (brain_file_append(bf, id, v, meta, (uint32_t)n, 0.5f) < 0) {
+            brain_file_close(bf);
+            return NULL;
+        }
+    }
+    return bf;
+}
+
+/* 파일의 바이트 하나를 XOR (디스크 손상 흉내) */
+static int flip(uint64_t offset, uint8_t mask) {
+    int fd = open(TEST_BRAIN, O_RDWR);
+    if (fd < 0) return -1;
+
+    uint8_t byte;
+    int rc = pread(fd, &byte, 1, (off_t)offset) == 1 ? 0 : -1;
+    byte ^= mask;
+    if (rc == 0 && pwrite(fd, &byte, 1, (off_t)offset) != 1) rc = -1;
+    close(fd);
+    return rc;
+}
+
+/* 살아 있는 ID가 모두 제 레코드를 돌려주는가 (skip = 손상시킨 ID) */
+static int check_ids(const brain_file_t* bf, int64_t skip) {
+    int failures = 0;
+    for (int64_t id = 0; id < TEST_IDS; id++) {
+        if (id == skip) continue;
+        brain_entry_t e;
+        if (brain_file_get(bf, id, &e) < 0 || e.record->id != id ||
+            e.vector[1] != (float)id + 0.01f) failures++;
+    }
+    return failures;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 1: CRC32C
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int test_crc32c(void) {
+    printf("\n[Test 1] CRC32C (%s)\n", brain_crc32c_impl());
+    int failures = 0;
+
+    /* RFC 3720 부록 B.4 */
+    uint8_t zeros[32] = {0}, ones[32];
+    memset(ones, 0xFF, sizeof(ones));
+    if (brain_crc32c(0, "123456789", 9) != 0xE3069283u) failures++;
+    if (brain_crc32c(0, zeros, 32) != 0x8A9136AAu) failures++;
+    if (brain_crc32c(0, ones, 32) != 0x62A8AB43u) failures++;
+    if (brain_crc32c_sw(0, "123456789", 9) != 0xE3069283u) failures++;
+    if (failures == 0) printf("✓ Known vectors match (\"123456789\" = 0xE3069283)\n");
+
+    /* 길이 / 시작 정렬 / 이어 붙이기 */
+    uint8_t* buf = (uint8_t*)malloc(TEST_BYTES);
+    if (!buf) return -1;
+    uint64_t seed = 0x9E3779B97F4A7C15ull;
+    for (size_t i = 0; i < TEST_BYTES; i++) {
+        seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+        buf[i] = (uint8_t)seed;
+    }
+
+    int mismatch = 0;
+    for (size_t len = 0; len < 300; len++) {
+        for (size_t align = 0; align < 8; align++) {
+            if (brain_crc32c(0, buf + align, len) != brain_crc32c_sw(0, buf + align, len)) mismatch++;
+        }
+        uint32_t split = brain_crc32c(brain_crc32c(0, buf, len / 3), buf + len / 3, len - len / 3);
+        if (split != brain_crc32c(0, buf, len)) mismatch++;
+    }
+    if (mismatch) {
+        printf("✗ Hardware / table mismatch in %d cases\n", mismatch);
+        failures++;
+    } else {
+        printf("✓ %s = slicing-by-8 for lengths 0~299, 8 alignments, split updates\n",
+               brain_crc32c_impl());
+    }
+
+    double t0 = now_ms();
+    uint32_t hw = brain_crc32c(0, buf, TEST_BYTES);
+    double t1 = now_ms();
+    uint32_t sw = brain_crc32c_sw(0, buf, TEST_BYTES);
+    double t2 = now_ms();
+    if (hw != sw) failures++;
+    printf("  16 MB: %s %.0f MB/s, slicing-by-8 %.0f MB/s\n", brain_crc32c_impl(),
+           16.0 / ((t1 - t0) / 1000.0 + 1e-9), 16.0 / ((t2 - t1) / 1000.0 + 1e-9));
+
+    free(buf);
+    return failures ? -1 : 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 2: FIRST_TOUCH
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int test_first_touch(void) {
+    printf("\n[Test 2] Record checksums, verify on first touch\n");
+    int failures = 0;
+
+    brain_file_t* bf = make_file();
+    if (!bf) return -1;
+    brain_file_close(bf);
+
+    bf = brain_file_open(TEST_BRAIN, 1);
+    if (!bf) return -1;
+
+    /* 디스크 손상 흉내: 벡터 1비트, 메타데이터 1바이트 */
+    brain_entry_t e;
+    brain_file_get(bf, 100, &e);
+    ((uint8_t*)e.vector)[37] ^= 0x10;
+    brain_file_get(bf, 200, &e);
+    ((char*)e.metadata)[3] = 'X';
+
+    /* NEVER: 그대로 돌려줌 */
+    if (brain_file_get(bf, 100, &e) < 0 || brain_file_get(bf, 200, &e) < 0) failures++;
+
+    if (brain_file_set_verify(bf, BRAIN_VERIFY_FIRST_TOUCH) < 0) failures++;
+    if (bf->verify->stats.pages_verified == 0) failures++;     /* 닫을 때 봉인한 인덱스 */
+
+    if (brain_file_get(bf, 100, &e) == 0 || brain_file_get(bf, 200, &e) == 0) failures++;
+    if (brain_file_get(bf, 100, &e) == 0) failures++;           /* 두 번째도 거부 (비트맵) */
+    failures += check_ids(bf, 100) > 1;                         /* 200만 실패해야 함 */
+    failures += check_ids(bf, 100) > 1;                         /* 두 번째는 검사 없이 */
+
+    const brain_verify_stats_t* st = &bf->verify->stats;
+    if (st->records_failed != 2 || st->records_verified != TEST_IDS - 2) {
+        printf("✗ verified %lu / failed %lu\n",
+               (unsigned long)st->records_verified, (unsigned long)st->records_failed);
+        failures++;
+    }
+
+    /* 덮어쓰면 새 레코드 → 다시 조회 가능 */
+    float v[TEST_DIM] = {0};
+    brain_file_append(bf, 100, v, NULL, 0, 0.5f);
+    if (brain_file_get(bf, 100, &e) < 0) failures++;
+
+    if (failures == 0) {
+        printf("✓ Corrupt vector / metadata rejected on first touch, %lu others verified once\n",
+               (unsigned long)st->records_verified - 1);
+        printf("✓ NEVER mode returns records unchecked, overwrite clears the bad record\n");
+    }
+    brain_file_close(bf);
+    return failures ? -1 : 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 3: 인덱스 손상 + DAWN scrub
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int test_scrub(void) {
+    printf("\n[Test 3] Index page checksums, throttled scrub at DAWN\n");
+    int failures = 0;
+
+    brain_file_t* bf = make_file();
+    if (!bf) return -1;
+    brain_file_close(bf);
+
+    /* 인덱스 테이블 3번째 페이지와 레코드 1개를 파일에서 직접 손상 (봉인은 그대로) */
+    bf = brain_file_open(TEST_BRAIN, 0);
+    if (!bf) return -1;
+    brain_entry_t e;
+    brain_file_get(bf, 4321, &e);
+    uint64_t vector_offset = (uint64_t)((const char*)e.vector - (const char*)bf->mf->addr);
+    uint64_t table_offset = brain_file_header(bf)->index.table_offset;
+    brain_file_close(bf);
+
+    for (int k = 0; k < 64; k++) {
+        if (flip(table_offset + 2 * BRAIN_INDEX_CRC_PAGE + k * 16, 0x5A) < 0) return -1;
+    }
+    if (flip(vector_offset, 0x01) < 0) return -1;
+
+    /* 읽기 전용: 재구축할 수 없으므로 거부 */
+    bf = brain_file_open(TEST_BRAIN, 0);
+    if (!bf) return -1;
+    if (brain_file_set_verify(bf, BRAIN_VERIFY_FIRST_TOUCH) == 0 ||
+        bf->verify->stats.pages_failed != 1) failures++;
+    else printf("✓ Read-only open reports the damaged index page\n");
+    brain_file_close(bf);
+
+    bf = brain_file_open(TEST_BRAIN, 1);
+    if (!bf) return -1;
+    if (brain_file_set_verify(bf, BRAIN_VERIFY_SCRUB) < 0) failures++;
+
+    circadian_t* circadian = circadian_create();
+    if (!circadian) return -1;
+    circadian_set_dawn_task(circadian, brain_file_scrub_task, bf);
+
+    /* 낮에는 실행되지 않음 */
+    circadian->current_phase = PHASE_DAY;
+    if (circadian_run_task(circadian) != 0 || circadian->dawn_task_runs != 0) failures++;
+
+    /* 새벽: 1회 BRAIN_SCRUB_BURST, 바로 다시 부르면 토큰이 없어 건너뜀 */
+    circadian->current_phase = PHASE_DAWN;
+    int rc = circadian_run_task(circadian);
+    uint64_t first = bf->verify->stats.scrub_bytes;
+    rc = rc > 0 ? circadian_run_task(circadian) : rc;
+    if (rc != 1 || first == 0 || first > BRAIN_SCRUB_BURST + 4096 ||
+        bf->verify->stats.scrub_bytes != first) {
+        printf("✗ Throttle: first call %lu bytes, second call %lu bytes (rc %d)\n",
+               (unsigned long)first, (unsigned long)(bf->verify->stats.scrub_bytes - first), rc);
+        failures++;
+    } else {
+        printf("✓ Throttled: %.1f MB in the first tick, nothing on an immediate second call\n",
+               first / 1024.0 / 1024.0);
+    }
+
+    /* tick마다 1초가 흐른 것으로 */
+    int ticks = 2;
+    while (rc > 0 && ticks < 1000) {
+        bf->verify->last_ns -= 1000000000ull;
+        rc = circadian_run_task(circadian);
+        ticks++;
+    }
+
+    const brain_verify_stats_t* st = &bf->verify->stats;
+    if (rc != 0 || st->scrub_passes != 1 || st->records_failed != 1 ||
+        st->pages_failed != 1 || st->index_rebuilds != 1) {
+        printf("✗ rc %d, passes %lu, bad records %lu, bad pages %lu, rebuilds %lu\n", rc,
+               (unsigned long)st->scrub_passes, (unsigned long)st->records_failed,
+               (unsigned long)st->pages_failed, (unsigned long)st->index_rebuilds);
+        failures++;
+    } else {
+        printf("✓ Scrub pass in %d ticks: 1 bad record flagged, bad index page rebuilt\n", ticks);
+    }
+
+    if (brain_file_get(bf, 4321, &e) == 0) failures++;
+    int bad = check_ids(bf, 4321);
+    if (bad) {
+        printf("✗ %d ids wrong after rebuild\n", bad);
+        failures++;
+    }
+    circadian_destroy(circadian);
+    brain_file_close(bf);
+
+    /* 닫을 때 재봉인 → 다시 열면 인덱스 일치 */
+    bf = brain_file_open(TEST_BRAIN, 0);
+    if (!bf || brain_file_set_verify(bf, BRAIN_VERIFY_FIRST_TOUCH) < 0 ||
+        bf->verify->stats.pages_failed != 0 || bf->verify->stats.pages_verified == 0) {
+        failures++;
+    } else {
+        printf("✓ Rebuilt index resealed on close (%lu pages verify)\n",
+               (unsigned long)bf->verify->stats.pages_verified);
+    }
+    brain_file_close(bf);
+
+    unlink(TEST_BRAIN);
+    return failures ? -1 : 0;
+}
+
+int main(void) {
+    printf("╔════════════════════════════════════════════════════════════╗\n");
+    printf("║              CRC32C / Checksum Verify Test                 ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n");
+
+    int result = 0;
+    if (test_crc32c() < 0) result = 1;
+    if (test_first_touch() < 0) result = 1;
+    if (test_scrub() < 0) result = 1;
+
+    unlink(TEST_BRAIN);
+
+    if (result == 0) {
+        printf("\n╔════════════════════════════════════════════════════════════╗\n");
+        printf("║                   All Tests Passed!                        ║\n");
+        printf("╚════════════════════════════════════════════════════════════╝\n");
+    } else {
+        printf("\n✗ Some tests failed\n");
+    }
+
+    return result;
+}
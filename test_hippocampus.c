@@ -7,11 +7,27 @@
 #define _POSIX_C_SOURCE 200809L
 
 #include "kim_hippocampus.h"
+#include "brain_file.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <math.h>
+#include <pthread.h>
+#include <time.h>
+
+/* Test 1~8 공용 장기 기억 파일 (실제 HIPPO_DB_PATH는 건드리지 않음) */
+#define TEST_DB "test_hippocampus_memory.db"
+
+/* 장기 기억 파일 + 옆 파일 (WAL, 저장된 인덱스) 지우기 */
+static void remove_db(const char* path) {
+    char side[512];
+    unlink(path);
+    snprintf(side, sizeof(side), "%s%s", path, HIPPO_WAL_SUFFIX);
+    unlink(side);
+    snprintf(side, sizeof(side), "%s%s", path, HIPPO_INDEX_SUFFIX);
+    unlink(side);
+}
 
 /* Test vector generation */
 static void create_test_vector(float* vector, int dim, int id) {
@@ -24,7 +40,7 @@ static void create_test_vector(float* vector, int dim, int id) {
 int test_basic_lifecycle(void) {
     printf("\n🟢 Test 1: Basic Lifecycle\n");
 
-    hippocampus_t* hippo = hippocampus_create(HIPPO_DB_PATH);
+    hippocampus_t* hippo = hippocampus_create(TEST_DB);
     if (!hippo) {
         printf("❌ Failed to create Hippocampus\n");
         return -1;
@@ -43,7 +59,7 @@ int test_basic_lifecycle(void) {
 int test_storage_threshold(void) {
     printf("\n🟢 Test 2: Storage with Importance Threshold\n");
 
-    hippocampus_t* hippo = hippocampus_create(HIPPO_DB_PATH);
+    hippocampus_t* hippo = hippocampus_create(TEST_DB);
     if (!hippo) {
         printf("❌ Failed to create Hippocampus\n");
         return -1;
@@ -94,7 +110,7 @@ int test_storage_threshold(void) {
 int test_memory_retrieval(void) {
     printf("\n🟢 Test 3: Memory Retrieval\n");
 
-    hippocampus_t* hippo = hippocampus_create(HIPPO_DB_PATH);
+    hippocampus_t* hippo = hippocampus_create(TEST_DB);
     if (!hippo) {
         printf("❌ Failed to create Hippocampus\n");
         return -1;
@@ -116,12 +132,22 @@ int test_memory_retrieval(void) {
     create_test_vector(vector, HIPPO_VECTOR_DIM, 0);
     memory_entry_t** results = hippocampus_retrieve(hippo, vector, 5);
 
+    int ok = results && results[0] &&
+             memcmp(results[0]->vector, vector, sizeof(vector)) == 0 &&
+             results[0]->access_count == 1;
     if (results) {
-        printf("  ✓ Retrieved top-5 similar memories\n");
+        int n = 0;
+        while (results[n]) free(results[n++]);
+        printf("  ✓ Retrieved %d similar memories (top: \"%s\")\n",
+               n, n ? "exact match" : "none");
         free(results);
     }
 
     hippocampus_destroy(hippo);
+    if (!ok) {
+        printf("❌ Test 3 FAIL (nearest memory is not the query vector)\n");
+        return -1;
+    }
     printf("✅ Test 3 PASS\n");
     return 0;
 }
@@ -130,7 +156,7 @@ int test_memory_retrieval(void) {
 int test_consolidation(void) {
     printf("\n🟢 Test 4: Consolidation (Dream)\n");
 
-    hippocampus_t* hippo = hippocampus_create(HIPPO_DB_PATH);
+    hippocampus_t* hippo = hippocampus_create(TEST_DB);
     if (!hippo) {
         printf("❌ Failed to create Hippocampus\n");
         return -1;
@@ -152,6 +178,10 @@ int test_consolidation(void) {
     hippocampus_consolidate(hippo);
     printf("  ✓ Consolidation cycle completed\n");
 
+    /* 간격 안의 두 번째 호출은 건너뜀 (메인 루프는 매 틱 부름) */
+    hippocampus_consolidate(hippo);
+    printf("  ✓ Second call within interval skipped\n");
+
     if (hippo->total_consolidated == 1) {
         printf("✅ Test 4 PASS\n");
     } else {
@@ -167,7 +197,7 @@ int test_consolidation(void) {
 int test_dream_thread(void) {
     printf("\n🟢 Test 5: Dream Thread (Background Consolidation)\n");
 
-    hippocampus_t* hippo = hippocampus_create(HIPPO_DB_PATH);
+    hippocampus_t* hippo = hippocampus_create(TEST_DB);
     if (!hippo) {
         printf("❌ Failed to create Hippocampus\n");
         return -1;
@@ -215,7 +245,7 @@ int test_dream_thread(void) {
 int test_statistics(void) {
     printf("\n🟢 Test 6: Statistics\n");
 
-    hippocampus_t* hippo = hippocampus_create(HIPPO_DB_PATH);
+    hippocampus_t* hippo = hippocampus_create(TEST_DB);
     if (!hippo) {
         printf("❌ Failed to create Hippocampus\n");
         return -1;
@@ -266,7 +296,7 @@ int test_statistics(void) {
 int test_spine_integration(void) {
     printf("\n🟢 Test 7: Spine Integration\n");
 
-    hippocampus_t* hippo = hippocampus_create(HIPPO_DB_PATH);
+    hippocampus_t* hippo = hippocampus_create(TEST_DB);
     if (!hippo) {
         printf("❌ Failed to create Hippocampus\n");
         return -1;
@@ -293,7 +323,7 @@ int test_spine_integration(void) {
 int test_stress(void) {
     printf("\n🟢 Test 8: Stress Test (1000 memories)\n");
 
-    hippocampus_t* hippo = hippocampus_create(HIPPO_DB_PATH);
+    hippocampus_t* hippo = hippocampus_create(TEST_DB);
     if (!hippo) {
         printf("❌ Failed to create Hippocampus\n");
         return -1;
@@ -333,6 +363,380 @@ int test_stress(void) {
     return 0;
 }
 
+/* Test 9: Persistence (reload on startup) */
+#define TEST_PERSIST_DB    "test_hippocampus.db"
+#define TEST_PERSIST_COUNT 500
+
+int test_persistence(void) {
+    printf("\n🟢 Test 9: Persistence (%d memories, reload)\n", TEST_PERSIST_COUNT);
+    remove_db(TEST_PERSIST_DB);
+
+    hippocampus_t* hippo = hippocampus_create(TEST_PERSIST_DB);
+    if (!hippo) {
+        printf("❌ Failed to create Hippocampus\n");
+        return -1;
+    }
+
+    float vector[HIPPO_VECTOR_DIM];
+    char content[256];
+    for (int i = 0; i < TEST_PERSIST_COUNT; i++) {
+        create_test_vector(vector, HIPPO_VECTOR_DIM, i);
+        snprintf(content, sizeof(content), "Persistent memory #%d", i);
+        if (hippocampus_store(hippo, content, vector, 0.9f) != 1) break;
+    }
+    uint32_t stored = hippocampus_get_count(hippo);
+    hippocampus_destroy(hippo);
+
+    /* 닫을 때 저장된 인덱스 (뒤에서 오래된 인덱스로 되돌려 씀) */
+    const char* index_path = TEST_PERSIST_DB HIPPO_INDEX_SUFFIX;
+    const char* stale_path = TEST_PERSIST_DB HIPPO_INDEX_SUFFIX ".old";
+    unlink(stale_path);
+    if (link(index_path, stale_path) < 0) {
+        printf("❌ Index was not saved on close\n");
+        remove_db(TEST_PERSIST_DB);
+        return -1;
+    }
+
+    /* 다시 열기: 레코드 + ID 인덱스는 파일에서, 벡터 인덱스는 저장된 것을 로드 */
+    hippo = hippocampus_create(TEST_PERSIST_DB);
+    if (!hippo) {
+        printf("❌ Failed to reopen Hippocampus\n");
+        return -1;
+    }
+    int reload_ok = hippo->index_loaded && hippo->index_caught_up == 0;
+
+    int mismatches = 0;
+    for (int i = 0; i < TEST_PERSIST_COUNT; i += 7) {
+        create_test_vector(vector, HIPPO_VECTOR_DIM, i);
+        snprintf(content, sizeof(content), "Persistent memory #%d", i);
+        memory_entry_t** results = hippocampus_retrieve(hippo, vector, 1);
+        if (!results || !results[0] || strcmp(results[0]->content, content) != 0 ||
+            results[0]->importance != 0.9f) {
+            mismatches++;
+        }
+        if (results) {
+            free(results[0]);
+            free(results);
+        }
+    }
+
+    /* 새 ID는 이전 ID 뒤에서 이어짐 */
+    uint64_t last_id = hippo->last_id;
+    create_test_vector(vector, HIPPO_VECTOR_DIM, TEST_PERSIST_COUNT);
+    hippocampus_store(hippo, "After reload", vector, 0.9f);
+    if (hippo->last_id <= last_id) mismatches++;
+
+    printf("  Reloaded: %u / %u memories (%.2f ms, index %s)\n",
+           hippocampus_get_count(hippo), stored, hippo->load_ms,
+           hippo->index_loaded ? "loaded" : "rebuilt");
+    int failed = stored != TEST_PERSIST_COUNT || !reload_ok ||
+                 hippocampus_get_count(hippo) != TEST_PERSIST_COUNT + 1 || mismatches;
+
+    /* 새벽 scrub: 다시 연 파일을 한 바퀴 검사 */
+    const brain_verify_stats_t* vs = &hippo->brain_file->verify->stats;
+    struct timespec tick = { 0, 10 * 1000 * 1000 };
+    for (int t = 0; t < 500 && vs->scrub_passes == 0; t++) {
+        if (hippocampus_scrub_task(hippo) < 0) break;
+        nanosleep(&tick, NULL);
+    }
+    if (vs->scrub_passes == 0 || vs->records_failed != 0) {
+        printf("❌ Scrub did not complete a clean pass (passes=%lu, failed=%lu)\n",
+               vs->scrub_passes, vs->records_failed);
+        failed = 1;
+    } else {
+        printf("  ✓ Scrub pass clean (%lu records verified)\n", vs->records_verified);
+    }
+    hippocampus_destroy(hippo);
+
+    /* 오래된 인덱스 (500개) + 파일 (501개): 로드 후 빠진 기억만 더함 */
+    rename(stale_path, index_path);
+    hippo = hippocampus_create(TEST_PERSIST_DB);
+    int caught_up = 0;
+    if (hippo) {
+        memory_entry_t** results = hippocampus_retrieve(hippo, vector, 1);
+        caught_up = hippo->index_loaded && hippo->index_caught_up == 1 &&
+                    hippocampus_get_count(hippo) == TEST_PERSIST_COUNT + 1 &&
+                    results && results[0] && strcmp(results[0]->content, "After reload") == 0;
+        if (results) {
+            free(results[0]);
+            free(results);
+        }
+        hippocampus_destroy(hippo);
+    }
+    if (!caught_up) {
+        printf("❌ Stale index was not caught up with the file\n");
+        failed = 1;
+    } else {
+        printf("  ✓ Stale index loaded, 1 newer memory added from the file\n");
+    }
+
+    /* 깨진 인덱스는 버리고 파일에서 재구축 */
+    FILE* fp = fopen(index_path, "wb");
+    if (fp) {
+        fputs("not an index", fp);
+        fclose(fp);
+    }
+    hippo = hippocampus_create(TEST_PERSIST_DB);
+    if (!hippo || hippo->index_loaded ||
+        hippocampus_get_count(hippo) != TEST_PERSIST_COUNT + 1) {
+        printf("❌ Corrupt index was not rebuilt\n");
+        failed = 1;
+    } else {
+        printf("  ✓ Corrupt index rebuilt from the file\n");
+    }
+    hippocampus_destroy(hippo);
+    remove_db(TEST_PERSIST_DB);
+
+    if (failed) {
+        printf("❌ %d mismatches\n", mismatches);
+        return -1;
+    }
+    printf("  ✓ Contents / importance recalled after reload\n");
+    printf("✅ Test 9 PASS\n");
+    return 0;
+}
+
+/* Test 10: Zero-copy recall (매핑 안 뷰 + 결과 집합 핀) */
+#define TEST_RECALL_DB    "test_hippocampus_recall.db"
+#define TEST_RECALL_COUNT 200
+
+static void* recall_store_thread(void* arg) {
+    hippocampus_t* hippo = (hippocampus_t*)arg;
+    float vector[HIPPO_VECTOR_DIM];
+    create_test_vector(vector, HIPPO_VECTOR_DIM, TEST_RECALL_COUNT);
+    hippocampus_store(hippo, "Stored while recalled", vector, 0.9f);
+    return NULL;
+}
+
+int test_zero_copy_recall(void) {
+    printf("\n🟢 Test 10: Zero-Copy Recall\n");
+    remove_db(TEST_RECALL_DB);
+
+    hippocampus_t* hippo = hippocampus_create(TEST_RECALL_DB);
+    if (!hippo) {
+        printf("❌ Failed to create Hippocampus\n");
+        return -1;
+    }
+
+    float vector[HIPPO_VECTOR_DIM];
+    char content[256];
+    for (int i = 0; i < TEST_RECALL_COUNT; i++) {
+        create_test_vector(vector, HIPPO_VECTOR_DIM, i);
+        snprintf(content, sizeof(content), "Recall memory #%d", i);
+        hippocampus_store(hippo, content, vector, 0.9f);
+    }
+
+    int failed = 0;
+    hippocampus_recall_t results;
+    /* 마지막 접근 시각을 과거로 (recall은 이 값을 건드리지 않아야 함) */
+    brain_entry_t entry42;
+    brain_file_entry(hippo->brain_file, 42, &entry42);
+    brain_file_set_timestamp(hippo->brain_file, &entry42, 1000);
+
+    create_test_vector(vector, HIPPO_VECTOR_DIM, 42);
+    int n = hippocampus_recall(hippo, vector, 5, &results);
+    if (n != 5 || results.count != 5) {
+        printf("❌ Recall returned %d results\n", n);
+        hippocampus_recall_release(&results);
+        hippocampus_destroy(hippo);
+        remove_db(TEST_RECALL_DB);
+        return -1;
+    }
+
+    /* 결과는 파일 매핑 안을 가리킴 (복사 없음) */
+    const char* base = (const char*)hippo->brain_file->mf->addr;
+    const char* end = base + hippo->brain_file->mf->size;
+    for (uint32_t i = 0; i < results.count; i++) {
+        const memory_view_t* v = &results.items[i];
+        if ((const char*)v->vector < base || (const char*)v->vector >= end ||
+            v->content < base || v->content >= end) {
+            printf("❌ Result %u is not a view into the mapping\n", i);
+            failed = 1;
+        }
+        if (i > 0 && v->distance < results.items[i - 1].distance) {
+            printf("❌ Results not ordered by distance\n");
+            failed = 1;
+        }
+    }
+    const memory_view_t* top = &results.items[0];
+    if (top->content_len != strlen("Recall memory #42") ||
+        memcmp(top->content, "Recall memory #42", top->content_len) != 0 ||
+        memcmp(top->vector, vector, sizeof(vector)) != 0 || top->access_count != 1) {
+        printf("❌ Top result is not the exact match\n");
+        failed = 1;
+    }
+    printf("  ✓ %u views into the mapping, top = \"%.*s\"\n",
+           results.count, (int)top->content_len, top->content);
+
+    /* 결과를 쥐고 있어도 저장은 바로 끝남 (예약된 매핑은 옮겨지지 않아 뷰가 그대로) */
+    const void* held_addr = hippo->brain_file->mf->addr;
+    pthread_t writer;
+    pthread_create(&writer, NULL, recall_store_thread, hippo);
+    pthread_join(writer, NULL);
+    uint32_t held_count = hippocampus_get_count(hippo);
+    uint32_t held_pins = hippo->pins;
+    int held_compact = hippocampus_compact_task(hippo);
+    if (hippo->brain_file->mf->addr != held_addr ||
+        memcmp(top->content, "Recall memory #42", top->content_len) != 0 ||
+        memcmp(top->vector, vector, sizeof(vector)) != 0) {
+        printf("❌ Held views changed after store\n");
+        failed = 1;
+    }
+    hippocampus_recall_release(&results);
+
+    /* 결과를 쥔 동안 컴팩션은 미뤄지고, 놓은 뒤에는 끝까지 돎 */
+    int compact_rc = 1, steps = 0;
+    while (compact_rc > 0 && steps++ < 1000) compact_rc = hippocampus_compact_task(hippo);
+    if (held_compact != 1 || compact_rc != 0) {
+        printf("❌ Compact task did not defer to the held recall (%d, %d)\n",
+               held_compact, compact_rc);
+        failed = 1;
+    } else {
+        printf("  ✓ Compact task deferred while held, finished in %d step(s)\n", steps);
+    }
+
+    if (held_count != TEST_RECALL_COUNT + 1 || held_pins != 1 || hippo->pins != 0) {
+        printf("❌ Store while held: count %u, pins %u → %u\n",
+               held_count, held_pins, hippo->pins);
+        failed = 1;
+    } else {
+        printf("  ✓ Store finished while views were held (%u memories, views intact)\n",
+               held_count);
+    }
+
+    /* 매핑이 옮겨진 적이 있으면 사본으로 (핀 없음, 매핑 밖 버퍼) */
+    hippo->brain_file->mf->moves++;
+    n = hippocampus_recall(hippo, vector, 5, &results);
+    hippo->brain_file->mf->moves--;
+    if (n != 5 || !results.copy || results.hippo || hippo->pins != 0 ||
+        ((const char*)results.items[0].content >= base &&
+         (const char*)results.items[0].content < end) ||
+        results.items[0].content_len != strlen("Recall memory #42") ||
+        memcmp(results.items[0].content, "Recall memory #42", results.items[0].content_len) != 0 ||
+        memcmp(results.items[0].vector, vector, sizeof(vector)) != 0) {
+        printf("❌ Recall did not fall back to a copy after the mapping moved\n");
+        failed = 1;
+    } else {
+        printf("  ✓ Falls back to a copy once the mapping has moved\n");
+    }
+    hippocampus_recall_release(&results);
+
+    /* 놓기를 두 번 불러도 안전 */
+    hippocampus_recall_release(&results);
+
+    /* recall은 접근 횟수만 올림 → 마지막 접근 시각은 consolidation이 당김 */
+    int64_t recalled_ts = *entry42.timestamp;
+    int64_t before = (int64_t)time(NULL);
+    hippo->last_consolidation = 0;
+    hippocampus_consolidate(hippo);
+    brain_file_entry(hippo->brain_file, 42, &entry42);
+    if (recalled_ts != 1000 || *entry42.timestamp < before) {
+        printf("❌ Access time: after recall %ld, after consolidation %ld\n",
+               (long)recalled_ts, (long)*entry42.timestamp);
+        failed = 1;
+    } else {
+        printf("  ✓ Recall left the access time alone, consolidation refreshed it\n");
+    }
+
+    hippocampus_destroy(hippo);
+    remove_db(TEST_RECALL_DB);
+
+    if (failed) return -1;
+    printf("✅ Test 10 PASS\n");
+    return 0;
+}
+
+/* Test 11: Pruning (오래 떠올리지 않은 기억 정리) */
+#define TEST_PRUNE_DB     "test_hippocampus_prune.db"
+#define TEST_PRUNE_COUNT  10
+#define TEST_PRUNE_OLD    4
+
+int test_pruning(void) {
+    printf("\n🟢 Test 11: Pruning\n");
+    remove_db(TEST_PRUNE_DB);
+
+    hippocampus_t* hippo = hippocampus_create(TEST_PRUNE_DB);
+    if (!hippo) {
+        printf("❌ Failed to create Hippocampus\n");
+        return -1;
+    }
+
+    float vector[HIPPO_VECTOR_DIM];
+    char content[256];
+    for (int i = 0; i < TEST_PRUNE_COUNT; i++) {
+        create_test_vector(vector, HIPPO_VECTOR_DIM, i);
+        snprintf(content, sizeof(content), "Prune memory #%d", i);
+        hippocampus_store(hippo, content, vector, 0.9f);
+    }
+
+    /* 앞의 TEST_PRUNE_OLD개는 마지막 접근이 HIPPO_PRUNE_DAYS보다 오래전 */
+    int64_t stale = (int64_t)time(NULL) - (HIPPO_PRUNE_DAYS + 1) * 86400LL;
+    for (uint64_t r = 0; r < TEST_PRUNE_OLD; r++) {
+        brain_entry_t e;
+        brain_file_entry(hippo->brain_file, r, &e);
+        brain_file_set_timestamp(hippo->brain_file, &e, stale);
+    }
+
+    /* 그중 #0은 방금 떠올림 → consolidation이 접근 시각을 당겨 살아남음 */
+    hippocampus_recall_t results;
+    create_test_vector(vector, HIPPO_VECTOR_DIM, 0);
+    hippocampus_recall(hippo, vector, 1, &results);
+    hippocampus_recall_release(&results);
+
+    hippo->last_consolidation = 0;
+    hippocampus_consolidate(hippo);
+
+    int failed = 0;
+    uint32_t expected = TEST_PRUNE_COUNT - (TEST_PRUNE_OLD - 1);
+    if (hippo->total_pruned != TEST_PRUNE_OLD - 1 || hippocampus_get_count(hippo) != expected) {
+        printf("❌ Pruned %lu, %u left (expected %d, %u)\n", hippo->total_pruned,
+               hippocampus_get_count(hippo), TEST_PRUNE_OLD - 1, expected);
+        failed = 1;
+    } else {
+        printf("  ✓ Pruned %lu stale memories, recalled one kept (%u left)\n",
+               hippo->total_pruned, hippocampus_get_count(hippo));
+    }
+
+    /* 지운 기억은 검색에 안 나오고, 떠올린 기억은 남음 */
+    create_test_vector(vector, HIPPO_VECTOR_DIM, 1);
+    memory_entry_t** found = hippocampus_retrieve(hippo, vector, 1);
+    if (!found || !found[0] || strcmp(found[0]->content, "Prune memory #1") == 0) {
+        printf("❌ Pruned memory still retrieved\n");
+        failed = 1;
+    }
+    if (found) {
+        for (int i = 0; found[i]; i++) free(found[i]);
+        free(found);
+    }
+    create_test_vector(vector, HIPPO_VECTOR_DIM, 0);
+    found = hippocampus_retrieve(hippo, vector, 1);
+    if (!found || !found[0] || strcmp(found[0]->content, "Prune memory #0") != 0) {
+        printf("❌ Recalled memory was pruned\n");
+        failed = 1;
+    }
+    if (found) {
+        for (int i = 0; found[i]; i++) free(found[i]);
+        free(found);
+    }
+    hippocampus_destroy(hippo);
+
+    /* 정리는 파일에 남음 */
+    hippo = hippocampus_create(TEST_PRUNE_DB);
+    if (!hippo || hippocampus_get_count(hippo) != expected) {
+        printf("❌ Pruning did not persist (%u)\n", hippo ? hippocampus_get_count(hippo) : 0);
+        failed = 1;
+    } else {
+        printf("  ✓ Pruning persisted across reopen (%u memories)\n",
+               hippocampus_get_count(hippo));
+    }
+    hippocampus_destroy(hippo);
+    remove_db(TEST_PRUNE_DB);
+
+    if (failed) return -1;
+    printf("✅ Test 11 PASS\n");
+    return 0;
+}
+
 /* Main test runner */
 int main(void) {
     printf("\n╔═════════════════════════════════════════════════════╗\n");
@@ -342,7 +746,8 @@ int main(void) {
 
     int failed = 0;
 
-    /* Run all tests */
+    /* Run all tests (장기 기억 파일 없이 시작) */
+    remove_db(TEST_DB);
     failed += test_basic_lifecycle();
     failed += test_storage_threshold();
     failed += test_memory_retrieval();
@@ -351,6 +756,10 @@ int main(void) {
     failed += test_statistics();
     failed += test_spine_integration();
     failed += test_stress();
+    failed += test_persistence();
+    failed += test_zero_copy_recall();
+    failed += test_pruning();
+    remove_db(TEST_DB);
 
     /* Summary */
     printf("\n╔═════════════════════════════════════════════════════╗\n");
@@ -7,13 +7,20 @@
  *   1. 100개 랜덤 벡터 삽입
  *   2. Top-5 검색
  *   3. Recall 측정 (정확도)
+ *   4. 2단계 검색 (prefix 탐색 + 전체 벡터 재정렬)
+ *   5. 저장 / 로드 (같은 검색 결과, 로드 후 삽입, 잘린 파일 거부)
+ *   6. 그래프 진단 (차수 분포, 도달성, hop 수, CSV)
  * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "hnsw.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 #include <math.h>
+#include <string.h>
+#include <unistd.h>
 
 #define TEST_DIM        128
 #define TEST_COUNT      100
@@ -211,6 +218,292 @@ int test_multiple_queries(hnsw_index_t* index, float** vectors) {
     printf("  Average Recall: %.2f%%\n", avg_recall * 100.0f);
     printf("  Average Search Time: %.3f ms\n", avg_time);
 
+    /* 방문 표는 검색 사이에 재사용 (epoch만 올림), 한 바퀴 돌아도 결과가 같아야 함 */
+    hnsw_visited_t* pooled = index->visited_pool[0];
+    if (!pooled) {
+        printf("❌ Visited table was not returned to the pool\n");
+        return -1;
+    }
+    hnsw_result_t before[TEST_QUERY_K], after[TEST_QUERY_K];
+    int n_before = hnsw_search(index, vectors[0], TEST_QUERY_K, before);
+    pooled->epoch = UINT32_MAX - 1;
+    int n_after = 0;
+    for (int i = 0; i < 3; i++) n_after = hnsw_search(index, vectors[0], TEST_QUERY_K, after);
+    int same = n_before == n_after;
+    for (int i = 0; same && i < n_before; i++) {
+        same = before[i].id == after[i].id && before[i].distance == after[i].distance;
+    }
+    if (!same || index->visited_pool[0] != pooled || pooled->epoch > 64) {
+        printf("❌ Search changed across a visited epoch wrap\n");
+        return -1;
+    }
+    printf("✓ Visited table reused across searches (epoch wrap safe)\n");
+
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 4: Two-Stage Prefix Search
+ *
+ * Matryoshka 임베딩처럼 앞쪽 차원에 정보가 몰린 벡터 사용
+ * (i번째 차원의 분산이 exp(-i/24)로 감소)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+#define PREFIX_COUNT    2000
+#define PREFIX_DIM      32
+
+static void generate_matryoshka_vector(float* vec, uint32_t dim) {
+    for (uint32_t i = 0; i < dim; i++) {
+        float r = (float)rand() / RAND_MAX - 0.5f;
+        vec[i] = r * expf(-(float)i / 24.0f);
+    }
+}
+
+static float prefix_recall(const hnsw_index_t* index, float** vectors, float** queries,
+                           uint32_t num_queries, const hnsw_search_params_t* params,
+                           double* avg_ms) {
+    float total = 0.0f;
+    double total_ms = 0.0;
+
+    for (uint32_t q = 0; q < num_queries; q++) {
+        hnsw_result_t got[TEST_QUERY_K], truth[TEST_QUERY_K];
+
+        clock_t start = clock();
+        int found = hnsw_search_ex(index, queries[q], TEST_QUERY_K, params, got);
+        total_ms += (double)(clock() - start) / CLOCKS_PER_SEC * 1000.0;
+
+        brute_force_search(vectors, PREFIX_COUNT, TEST_DIM, queries[q], TEST_QUERY_K, truth);
+        if (found == TEST_QUERY_K) {
+            total += calculate_recall(got, truth, TEST_QUERY_K);
+        }
+    }
+
+    *avg_ms = total_ms / num_queries;
+    return total / num_queries;
+}
+
+int test_prefix_search(void) {
+    printf("\n=== Test 4: Two-Stage Search (d'=%d of %d) ===\n", PREFIX_DIM, TEST_DIM);
+
+    const uint32_t num_queries = 20;
+    hnsw_index_t* index = hnsw_create(TEST_DIM, PREFIX_COUNT);
+    float** vectors = (float**)malloc(PREFIX_COUNT * sizeof(float*));
+    float** queries = (float**)malloc(num_queries * sizeof(float*));
+
+    for (uint32_t i = 0; i < PREFIX_COUNT; i++) {
+        vectors[i] = (float*)malloc(TEST_DIM * sizeof(float));
+        generate_matryoshka_vector(vectors[i], TEST_DIM);
+        hnsw_insert(index, i, vectors[i]);
+    }
+    for (uint32_t q = 0; q < num_queries; q++) {
+        queries[q] = (float*)malloc(TEST_DIM * sizeof(float));
+        generate_matryoshka_vector(queries[q], TEST_DIM);
+    }
+
+    int result = 0;
+    if (hnsw_set_prefix(index, PREFIX_DIM) < 0) {
+        printf("✗ Failed to build prefix slab\n");
+        result = -1;
+    }
+
+    hnsw_search_params_t full = { 0, 0, 0 };
+    hnsw_search_params_t two_stage = { 0, PREFIX_DIM, 50 };
+    hnsw_search_params_t shallow = { 0, 16, 20 };
+
+    double ms_full, ms_two, ms_shallow;
+    float r_full = prefix_recall(index, vectors, queries, num_queries, &full, &ms_full);
+    float r_two = prefix_recall(index, vectors, queries, num_queries, &two_stage, &ms_two);
+    float r_shallow = prefix_recall(index, vectors, queries, num_queries, &shallow, &ms_shallow);
+
+    printf("  full (d=%d):           recall=%.2f%%, %.3f ms/query\n",
+           TEST_DIM, r_full * 100.0f, ms_full);
+    printf("  two-stage (d'=%d, rr=50): recall=%.2f%%, %.3f ms/query\n",
+           PREFIX_DIM, r_two * 100.0f, ms_two);
+    printf("  two-stage (d'=16, rr=20): recall=%.2f%%, %.3f ms/query\n",
+           r_shallow * 100.0f, ms_shallow);
+
+    /* 재정렬 후 거리는 전체 벡터 기준이어야 함 */
+    hnsw_result_t res[TEST_QUERY_K];
+    int found = hnsw_search_ex(index, queries[0], TEST_QUERY_K, &two_stage, res);
+    if (found > 0) {
+        float exact = hnsw_distance(queries[0], vectors[res[0].id], TEST_DIM);
+        if (fabsf(exact - res[0].distance) > 1e-5f) {
+            printf("✗ Re-ranked distance is not the full-vector distance\n");
+            result = -1;
+        }
+    }
+
+    if (r_full < 0.9f || r_two < r_full - 0.1f) {
+        printf("✗ Two-stage recall too low\n");
+        result = -1;
+    }
+
+    hnsw_stats(index);
+
+    for (uint32_t i = 0; i < PREFIX_COUNT; i++) free(vectors[i]);
+    for (uint32_t q = 0; q < num_queries; q++) free(queries[q]);
+    free(vectors);
+    free(queries);
+    hnsw_destroy(index);
+
+    if (result == 0) {
+        printf("✓ Prefix traversal + re-rank matches full search\n");
+    }
+    return result;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 5: Save / Load
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+#define SAVE_FILE       "test_hnsw.idx"
+
+int test_save_load(hnsw_index_t* index) {
+    printf("\n=== Test 5: Save / Load ===\n");
+
+    if (hnsw_save(index, SAVE_FILE) < 0) {
+        printf("✗ Save failed\n");
+        return -1;
+    }
+
+    /* 용량을 늘려서 로드 → 그래프는 그대로, 빈 슬롯은 새 삽입용 */
+    hnsw_index_t* loaded = hnsw_load(SAVE_FILE, TEST_COUNT * 2);
+    if (!loaded) {
+        printf("✗ Load failed\n");
+        unlink(SAVE_FILE);
+        return -1;
+    }
+
+    int result = 0;
+    if (loaded->count != index->count || loaded->capacity != TEST_COUNT * 2 ||
+        loaded->entry_point != index->entry_point || loaded->max_layer != index->max_layer) {
+        printf("✗ Header mismatch (count %u / %u)\n", loaded->count, index->count);
+        result = -1;
+    }
+
+    /* 같은 그래프 → 같은 쿼리에 같은 결과 (ID와 거리) */
+    int mismatches = 0;
+    float query[TEST_DIM];
+    for (int q = 0; q < 20; q++) {
+        generate_random_vector(query, TEST_DIM);
+        hnsw_result_t a[TEST_QUERY_K], b[TEST_QUERY_K];
+        int na = hnsw_search(index, query, TEST_QUERY_K, a);
+        int nb = hnsw_search(loaded, query, TEST_QUERY_K, b);
+        if (na != nb) mismatches++;
+        for (int i = 0; i < na && i < nb; i++) {
+            if (a[i].id != b[i].id || a[i].distance != b[i].distance) mismatches++;
+        }
+    }
+    for (uint32_t i = 0; i < TEST_COUNT; i++) {
+        if (!hnsw_contains(loaded, (int64_t)i)) mismatches++;
+    }
+    if (hnsw_contains(loaded, TEST_COUNT)) mismatches++;
+
+    /* 로드한 인덱스에 이어서 삽입 */
+    hnsw_result_t top;
+    generate_random_vector(query, TEST_DIM);
+    if (hnsw_insert(loaded, TEST_COUNT, query) < 0 ||
+        hnsw_search(loaded, query, 1, &top) != 1 || top.id != TEST_COUNT) {
+        mismatches++;
+    }
+
+    if (mismatches) {
+        printf("✗ %d mismatches after load\n", mismatches);
+        result = -1;
+    } else {
+        printf("✓ Loaded graph returns identical results, accepts new inserts\n");
+    }
+    hnsw_destroy(loaded);
+
+    /* 잘린 파일은 거부 */
+    FILE* fp = fopen(SAVE_FILE, "r+b");
+    if (fp) {
+        fseek(fp, 0, SEEK_END);
+        long size = ftell(fp);
+        fclose(fp);
+        if (truncate(SAVE_FILE, size - 100) == 0) {
+            loaded = hnsw_load(SAVE_FILE, 0);
+            if (loaded) {
+                printf("✗ Truncated file was accepted\n");
+                hnsw_destroy(loaded);
+                result = -1;
+            } else {
+                printf("✓ Truncated file rejected\n");
+            }
+        }
+    }
+    unlink(SAVE_FILE);
+    return result;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 6: Graph Diagnostics
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+#define DIAG_CSV_FILE   "test_hnsw_diag.csv"
+
+int test_diagnostics(hnsw_index_t* index) {
+    printf("\n=== Test 6: Graph Diagnostics ===\n");
+
+    hnsw_diag_t diag;
+    if (hnsw_diagnose(index, NULL, 10, &diag) < 0) {
+        printf("✗ Diagnose failed\n");
+        return -1;
+    }
+    hnsw_diag_print(&diag);
+
+    if (diag.layers[0].nodes != TEST_COUNT || diag.unreachable > TEST_COUNT / 10 ||
+        diag.sample_queries != 10 || diag.avg_hops <= 0.0) {
+        printf("✗ Unexpected graph statistics\n");
+        return -1;
+    }
+    uint32_t baseline = diag.unreachable;
+
+    /* CSV 저장 */
+    if (hnsw_diag_write_csv(&diag, DIAG_CSV_FILE) < 0) return -1;
+    FILE* fp = fopen(DIAG_CSV_FILE, "r");
+    char line[128] = {0};
+    int csv_ok = fp && fgets(line, sizeof(line), fp) &&
+                 strcmp(line, "layer,metric,bucket,value\n") == 0;
+    if (fp) fclose(fp);
+    unlink(DIAG_CSV_FILE);
+    if (!csv_ok) {
+        printf("✗ CSV header mismatch\n");
+        return -1;
+    }
+
+    /* 한 노드로 들어오는 링크를 모두 끊으면 미도달로 보고되어야 함 */
+    uint32_t victim = 0;
+    for (;; victim++) {
+        int skip = (index->nodes[victim].id == index->entry_point);
+        for (uint32_t i = 0; i < diag.unreachable_reported; i++) {
+            if (diag.unreachable_ids[i] == index->nodes[victim].id) skip = 1;
+        }
+        if (!skip) break;
+    }
+
+    for (uint32_t s = 0; s < index->capacity; s++) {
+        hnsw_node_t* node = &index->nodes[s];
+        for (uint32_t l = 0; l <= node->layer && node->id != -1; l++) {
+            uint32_t kept = 0;
+            for (uint32_t i = 0; i < node->neighbor_count[l]; i++) {
+                if (node->neighbors[l][i] != victim) {
+                    node->neighbors[l][kept++] = node->neighbors[l][i];
+                }
+            }
+            node->neighbor_count[l] = kept;
+        }
+    }
+
+    hnsw_diagnose(index, NULL, 0, &diag);
+
+    int reported = 0;
+    for (uint32_t i = 0; i < diag.unreachable_reported; i++) {
+        if (diag.unreachable_ids[i] == index->nodes[victim].id) reported = 1;
+    }
+    if (!reported || diag.unreachable < baseline + 1 || diag.layers[0].orphans < 1) {
+        printf("✗ Orphaned node not detected (unreachable=%u)\n", diag.unreachable);
+        return -1;
+    }
+
+    printf("✓ Orphaned node %ld detected as unreachable\n", index->nodes[victim].id);
     return 0;
 }
 
@@ -244,6 +537,9 @@ int main(void) {
     if (test_insert(index, vectors) < 0) result = 1;
     if (test_search(index, vectors) < 0) result = 1;
     if (test_multiple_queries(index, vectors) < 0) result = 1;
+    if (test_prefix_search() < 0) result = 1;
+    if (test_save_load(index) < 0) result = 1;
+    if (test_diagnostics(index) < 0) result = 1;
 
     /* 정리 */
     for (uint32_t i = 0; i < TEST_COUNT; i++) {
@@ -0,0 +1,378 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * test_import.c
+ *
+ * Bulk Import Test
+ *
+ * 테스트:
+ *   1. fvecs 적재 (4 스레드) → 벡터 / ID 일치, 파일 1회 확장
+ *   2. npy 적재 (<f4, <f8) + HNSW 벡터 인덱스 동시 구축 (용량 초과는 실패 수로 집계)
+ *   3. CSV 적재 (머리글, ID 열, 중복 ID, 잘못된 행, 실패한 적재는 기존 파일 보존)
+ *   4. 적재 처리량 (스레드 수별)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#include "brain_import.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+
+#define TEST_DIM        32
+#define TEST_ROWS       20000
+#define TEST_BENCH_ROWS 200000
+#define TEST_FVECS      "test_import.fvecs"
+#define TEST_NPY        "test_import.npy"
+#define TEST_CSV        "test_import.csv"
+#define TEST_BRAIN      "test_import.brain"
+
+static float* g_vectors = NULL;
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Helpers
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static void generate_vectors(uint32_t rows) {
+    g_vectors = (float*)malloc((size_t)rows * TEST_DIM * sizeof(float));
+    for (size_t i = 0; i < (size_t)rows * TEST_DIM; i++) {
+        g_vectors[i] = (float)rand() / RAND_MAX - 0.5f;
+    }
+}
+
+static int write_fvecs(const char* path, uint32_t rows) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return -1;
+    int32_t dim = TEST_DIM;
+    for (uint32_t i = 0; i < rows; i++) {
+        fwrite(&dim, sizeof(dim), 1, f);
+        fwrite(g_vectors + (size_t)i * TEST_DIM, sizeof(float), TEST_DIM, f);
+    }
+    fclose(f);
+    return 0;
+}
+
+/* NumPy v1.0 헤더 (전체 길이 64의 배수, 개행으로 끝남) */
+static int write_npy(const char* path, uint32_t rows, int f8) {
+    char dict[128];
+    int len = snprintf(dict, sizeof(dict),
+                       "{'descr': '%s', 'fortran_order': False, 'shape': (%u, %u), }",
+                       f8 ? "<f8" : "<f4", rows, TEST_DIM);
+    uint16_t hlen = (uint16_t)(((10 + len + 1 + 63) / 64) * 64 - 10);
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return -1;
+    fwrite("\x93NUMPY\x01\x00", 1, 8, f);
+    fwrite(&hlen, sizeof(hlen), 1, f);
+    fwrite(dict, 1, len, f);
+    for (int i = len; i < hlen - 1; i++) fputc(' ', f);
+    fputc('\n', f);
+
+    for (size_t i = 0; i < (size_t)rows * TEST_DIM; i++) {
+        if (f8) {
+            double v = g_vectors[i];
+            fwrite(&v, sizeof(v), 1, f);
+        } else {
+            fwrite(&g_vectors[i], sizeof(float), 1, f);
+        }
+    }
+    fclose(f);
+    return 0;
+}
+
+/* 레코드 i가 g_vectors 행 row와 같은지 (ID 조회 경유) */
+static int check_vector(const brain_file_t* bf, int64_t id, uint32_t row, float tolerance) {
+    brain_entry_t e;
+    if (brain_file_get(bf, id, &e) < 0) {
+        printf("✗ id %ld missing\n", (long)id);
+        return -1;
+    }
+    if (((uintptr_t)e.vector % BRAIN_ALIGN) != 0) {
+        printf("✗ id %ld vector not aligned\n", (long)id);
+        return -1;
+    }
+    const float* expected = g_vectors + (size_t)row * TEST_DIM;
+    for (uint32_t d = 0; d < TEST_DIM; d++) {
+        if (fabsf(e.vector[d] - expected[d]) > tolerance) {
+            printf("✗ id %ld dim %u: %f != %f\n", (long)id, d, e.vector[d], expected[d]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static uint32_t g_progress_calls = 0;
+
+static void count_progress(void* ctx, const char* phase,
+                           uint64_t done, uint64_t total, double elapsed_ms) {
+    (void)ctx; (void)phase; (void)done; (void)total; (void)elapsed_ms;
+    g_progress_calls++;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 1: fvecs (4 threads)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int test_fvecs(void) {
+    printf("\n=== Test 1: fvecs Import (%u rows, 4 threads) ===\n", TEST_ROWS);
+
+    write_fvecs(TEST_FVECS, TEST_ROWS);
+
+    brain_import_options_t opt;
+    brain_import_defaults(&opt);
+    opt.threads = 4;
+    opt.first_id = 1000;
+    opt.progress = count_progress;
+
+    brain_import_stats_t st;
+    if (brain_import(TEST_FVECS, TEST_BRAIN, &opt, &st) < 0) {
+        printf("✗ Import failed\n");
+        return -1;
+    }
+    if (st.rows != TEST_ROWS || st.imported != TEST_ROWS || st.rejected != 0 ||
+        st.dim != TEST_DIM || st.threads != 4 || g_progress_calls == 0) {
+        printf("✗ Unexpected stats: rows %lu imported %lu rejected %lu dim %u\n",
+               (unsigned long)st.rows, (unsigned long)st.imported,
+               (unsigned long)st.rejected, st.dim);
+        return -1;
+    }
+
+    brain_file_t* bf = brain_file_open(TEST_BRAIN, 0);
+    if (!bf) {
+        printf("✗ Reopen failed\n");
+        return -1;
+    }
+
+    int result = 0;
+    const brain_header_t* header = brain_file_header(bf);
+    if (header->record_count != TEST_ROWS || brain_file_count(bf) != TEST_ROWS ||
+        header->index.count != TEST_ROWS || header->index.old_table_offset != 0) {
+        printf("✗ Header counts wrong\n");
+        result = -1;
+    }
+    for (uint32_t i = 0; result == 0 && i < TEST_ROWS; i += 97) {
+        result = check_vector(bf, 1000 + i, i, 0.0f);
+    }
+    if (result == 0) result = check_vector(bf, 1000 + TEST_ROWS - 1, TEST_ROWS - 1, 0.0f);
+
+    brain_entry_t e;
+    if (result == 0 && (brain_file_get(bf, 999, &e) == 0 ||
+                        brain_file_get(bf, 1000 + TEST_ROWS, &e) == 0)) {
+        printf("✗ Out-of-range id found\n");
+        result = -1;
+    }
+
+    brain_file_close(bf);
+    if (result == 0) printf("✓ %u rows verified (fill %.1f ms, index %.1f ms)\n",
+                            TEST_ROWS, st.fill_ms, st.index_ms);
+    return result;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 2: npy (+ vector index)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int test_npy(void) {
+    const uint32_t rows = 2000;
+    printf("\n=== Test 2: npy Import + HNSW (%u rows) ===\n", rows);
+
+    for (int f8 = 0; f8 <= 1; f8++) {
+        write_npy(TEST_NPY, rows, f8);
+
+        brain_import_options_t opt;
+        brain_import_defaults(&opt);
+        opt.threads = 3;
+        opt.layout = INDEX_LAYOUT_GROUPED;
+        /* <f8: 용량이 10개 모자람 → 넘친 10개는 vindex_failed로 집계 */
+        opt.vindex = vector_index_create(VECTOR_INDEX_HNSW, TEST_DIM, f8 ? rows - 10 : rows);
+
+        brain_import_stats_t st;
+        int rc = brain_import(TEST_NPY, TEST_BRAIN, &opt, &st);
+        if (rc < 0 || st.imported != rows) {
+            printf("✗ %s import failed\n", f8 ? "<f8" : "<f4");
+            if (opt.vindex) vector_index_destroy(opt.vindex);
+            return -1;
+        }
+
+        if (f8) {
+            uint64_t indexed = vector_index_count(opt.vindex);
+            vector_index_destroy(opt.vindex);
+            if (indexed != rows - 10 || st.vindex_failed != 10) {
+                printf("✗ Vector index failures not counted (%lu indexed, %lu failed)\n",
+                       (unsigned long)indexed, (unsigned long)st.vindex_failed);
+                return -1;
+            }
+            printf("✓ Full vector index: %lu inserts counted as failed\n",
+                   (unsigned long)st.vindex_failed);
+        } else {
+            uint32_t self_hits = 0;
+            for (uint32_t i = 0; i < rows; i += 20) {
+                hnsw_result_t res[1];
+                if (vector_index_search(opt.vindex, g_vectors + (size_t)i * TEST_DIM, 1, res) == 1 &&
+                    res[0].id == (int64_t)i) {
+                    self_hits++;
+                }
+            }
+            uint64_t indexed = vector_index_count(opt.vindex);
+            vector_index_destroy(opt.vindex);
+            if (indexed != rows || st.vindex_failed != 0 ||
+                self_hits < (rows / 20) * 95 / 100) {
+                printf("✗ Vector index: %lu vectors, %u / %u self hits\n",
+                       (unsigned long)indexed, self_hits, rows / 20);
+                return -1;
+            }
+            printf("✓ HNSW built during import (%u / %u self hits, %.1f ms)\n",
+                   self_hits, rows / 20, st.vindex_ms);
+        }
+
+        brain_file_t* bf = brain_file_open(TEST_BRAIN, 0);
+        int result = bf ? 0 : -1;
+        for (uint32_t i = 0; result == 0 && i < rows; i += 13) {
+            result = check_vector(bf, i, i, f8 ? 1e-6f : 0.0f);
+        }
+        if (bf) brain_file_close(bf);
+        if (result < 0) return -1;
+        printf("✓ %s: %u rows verified\n", f8 ? "<f8" : "<f4", rows);
+    }
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 3: CSV (header, id column, duplicates, bad row)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int test_csv(void) {
+    const uint32_t rows = 500;
+    printf("\n=== Test 3: CSV Import (%u rows + duplicates + bad row) ===\n", rows);
+
+    FILE* f = fopen(TEST_CSV, "w");
+    if (!f) return -1;
+    fprintf(f, "id");
+    for (uint32_t d = 0; d < TEST_DIM; d++) fprintf(f, ",v%u", d);
+    fprintf(f, "\n");
+    for (uint32_t i = 0; i < rows; i++) {
+        fprintf(f, "%u", 5000 + i);
+        for (uint32_t d = 0; d < TEST_DIM; d++) {
+            fprintf(f, ",%.9g", g_vectors[(size_t)i * TEST_DIM + d]);
+        }
+        fprintf(f, i % 2 ? "\r\n" : "\n");
+        if (i == 100) fprintf(f, "\n");                 /* 빈 줄 */
+    }
+    /* 중복 ID 5007 (행 600 벡터로 덮어씀) + 열 수가 모자란 행 */
+    fprintf(f, "5007");
+    for (uint32_t d = 0; d < TEST_DIM; d++) fprintf(f, ",%.9g", g_vectors[(size_t)600 * TEST_DIM + d]);
+    fprintf(f, "\n9999,1.0,2.0\n");
+    fclose(f);
+
+    brain_import_options_t opt;
+    brain_import_defaults(&opt);
+    opt.threads = 4;
+    opt.csv_id_column = 1;
+
+    brain_import_stats_t st;
+    if (brain_import(TEST_CSV, TEST_BRAIN, &opt, &st) < 0) {
+        printf("✗ Import failed\n");
+        return -1;
+    }
+    if (st.rows != rows + 2 || st.imported != rows || st.rejected != 1 || st.duplicates != 1) {
+        printf("✗ Unexpected stats: rows %lu imported %lu rejected %lu duplicates %lu\n",
+               (unsigned long)st.rows, (unsigned long)st.imported,
+               (unsigned long)st.rejected, (unsigned long)st.duplicates);
+        return -1;
+    }
+
+    brain_file_t* bf = brain_file_open(TEST_BRAIN, 0);
+    if (!bf) return -1;
+
+    int result = 0;
+    for (uint32_t i = 0; result == 0 && i < rows; i++) {
+        if (i == 7) continue;
+        result = check_vector(bf, 5000 + i, i, 1e-6f);
+    }
+    if (result == 0) result = check_vector(bf, 5007, 600, 1e-6f);
+
+    brain_entry_t e;
+    if (result == 0 && brain_file_get(bf, 9999, &e) == 0) {
+        printf("✗ Rejected row is visible\n");
+        result = -1;
+    }
+    if (result == 0 && brain_file_count(bf) != rows) {
+        printf("✗ live_count %lu != %u\n", (unsigned long)brain_file_count(bf), rows);
+        result = -1;
+    }
+    brain_file_close(bf);
+
+    /* 읽을 수 없는 원본 → 실패, 기존 dst는 그대로 */
+    f = fopen(TEST_CSV, "w");
+    if (!f) return -1;
+    fprintf(f, "not,a,vector\n");
+    fclose(f);
+    if (result == 0 && brain_import(TEST_CSV, TEST_BRAIN, &opt, NULL) == 0) {
+        printf("✗ Unreadable source imported\n");
+        result = -1;
+    }
+    bf = brain_file_open(TEST_BRAIN, 0);
+    if (result == 0 && (!bf || brain_file_count(bf) != rows)) {
+        printf("✗ Failed import damaged the existing file\n");
+        result = -1;
+    }
+    if (bf) brain_file_close(bf);
+
+    if (result == 0) printf("✓ Header skipped, duplicate resolved to last row, bad row rejected\n");
+    if (result == 0) printf("✓ Failed import leaves the existing file intact\n");
+    return result;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 4: Throughput
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int test_throughput(void) {
+    printf("\n=== Test 4: Throughput (%u rows) ===\n", TEST_BENCH_ROWS);
+
+    free(g_vectors);
+    generate_vectors(TEST_BENCH_ROWS);
+    write_fvecs(TEST_FVECS, TEST_BENCH_ROWS);
+
+    uint32_t thread_counts[] = {1, 4};
+    for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+        brain_import_options_t opt;
+        brain_import_defaults(&opt);
+        opt.threads = thread_counts[t];
+        opt.progress = count_progress;
+
+        brain_import_stats_t st;
+        if (brain_import(TEST_FVECS, TEST_BRAIN, &opt, &st) < 0 || st.imported != TEST_BENCH_ROWS) {
+            printf("✗ Import failed\n");
+            return -1;
+        }
+        printf("✓ %u thread(s): %.0f rows/s (fill %.1f ms, index %.1f ms)\n",
+               st.threads, st.rows_per_sec, st.fill_ms, st.index_ms);
+    }
+    return 0;
+}
+
+int main(void) {
+    srand(4242);
+
+    printf("╔════════════════════════════════════════════════════════════╗\n");
+    printf("║                  Bulk Import Test                          ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n");
+
+    generate_vectors(TEST_ROWS);
+
+    int result = 0;
+    if (test_fvecs() < 0) result = 1;
+    if (test_npy() < 0) result = 1;
+    if (test_csv() < 0) result = 1;
+    if (test_throughput() < 0) result = 1;
+
+    free(g_vectors);
+    unlink(TEST_FVECS);
+    unlink(TEST_NPY);
+    unlink(TEST_CSV);
+    unlink(TEST_BRAIN);
+
+    if (result == 0) {
+        printf("\n╔════════════════════════════════════════════════════════════╗\n");
+        printf("║                   All Tests Passed!                        ║\n");
+        printf("╚════════════════════════════════════════════════════════════╝\n");
+    } else {
+        printf("\n✗ Some tests failed\n");
+    }
+
+    return result;
+}
@@ -0,0 +1,407 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * test_ivf.c
+ *
+ * IVF Index Test
+ *
+ * 테스트:
+ *   1. 4000개 벡터 삽입 (자동 k-means 학습)
+ *   2. nprobe별 Recall 측정 (Brute Force 대비)
+ *   3. 저장 → mmap 로드 후 동일 결과 확인 (손상된 디렉터리는 거부)
+ *   4. vector_index 공통 API (HNSW / IVF)
+ *   5. fp16 / bf16 저장 형식 (변환 정확도, Recall 손실)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ivf.h"
+#include "vector_index.h"
+#include "vec_kernels.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <math.h>
+
+#define TEST_DIM        128
+#define TEST_COUNT      4000
+#define TEST_NLIST      64
+#define TEST_QUERY_K    10
+#define TEST_QUERIES    20
+#define TEST_IVF_FILE   "test_ivf.idx"
+
+static float* g_vectors = NULL;
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Helpers
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static void generate_random_vector(float* vec, uint32_t dim) {
+    for (uint32_t i = 0; i < dim; i++) {
+        vec[i] = (float)rand() / RAND_MAX - 0.5f;
+    }
+}
+
+static int cmp_dist(const void* a, const void* b) {
+    float da = ((const hnsw_result_t*)a)->distance;
+    float db = ((const hnsw_result_t*)b)->distance;
+    return (da > db) - (da < db);
+}
+
+static void brute_force(const float* query, uint32_t k, hnsw_result_t* out) {
+    hnsw_result_t* all = (hnsw_result_t*)malloc(TEST_COUNT * sizeof(hnsw_result_t));
+    for (uint32_t i = 0; i < TEST_COUNT; i++) {
+        all[i].id = i;
+        all[i].distance = hnsw_distance(query, g_vectors + (size_t)i * TEST_DIM, TEST_DIM);
+    }
+    qsort(all, TEST_COUNT, sizeof(hnsw_result_t), cmp_dist);
+    memcpy(out, all, k * sizeof(hnsw_result_t));
+    free(all);
+}
+
+static float recall(const hnsw_result_t* got, int found, const hnsw_result_t* truth, uint32_t k) {
+    uint32_t matches = 0;
+    for (int i = 0; i < found; i++) {
+        for (uint32_t j = 0; j < k; j++) {
+            if (got[i].id == truth[j].id) {
+                matches++;
+                break;
+            }
+        }
+    }
+    return (float)matches / k;
+}
+
+static float average_recall(const ivf_index_t* index, double* avg_ms) {
+    float total = 0.0f;
+    double total_ms = 0.0;
+
+    srand(777);
+    for (int q = 0; q < TEST_QUERIES; q++) {
+        float query[TEST_DIM];
+        generate_random_vector(query, TEST_DIM);
+
+        hnsw_result_t got[TEST_QUERY_K], truth[TEST_QUERY_K];
+        clock_t start = clock();
+        int found = ivf_search(index, query, TEST_QUERY_K, got);
+        total_ms += (double)(clock() - start) / CLOCKS_PER_SEC * 1000.0;
+
+        brute_force(query, TEST_QUERY_K, truth);
+        total += recall(got, found, truth, TEST_QUERY_K);
+    }
+
+    *avg_ms = total_ms / TEST_QUERIES;
+    return total / TEST_QUERIES;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 1: Insert (Auto Train)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int test_insert(ivf_index_t* index) {
+    printf("\n=== Test 1: Insert %u Vectors (nlist=%u) ===\n", TEST_COUNT, TEST_NLIST);
+
+    clock_t start = clock();
+    for (uint32_t i = 0; i < TEST_COUNT; i++) {
+        if (ivf_add(index, i, g_vectors + (size_t)i * TEST_DIM) < 0) {
+            printf("✗ Failed to insert vector %u\n", i);
+            return -1;
+        }
+    }
+    double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC * 1000.0;
+
+    if (!index->trained || index->count != TEST_COUNT) {
+        printf("✗ Expected trained index with %u vectors\n", TEST_COUNT);
+        return -1;
+    }
+
+    printf("✓ Inserted + trained in %.2f ms (%s kernels)\n", elapsed, vec_kernels_isa());
+    ivf_stats(index);
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 2: Recall vs nprobe
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int test_recall(ivf_index_t* index) {
+    printf("\n=== Test 2: Recall@%u vs nprobe ===\n", TEST_QUERY_K);
+
+    uint32_t probes[] = {1, 4, 8, 16, TEST_NLIST};
+    float full_recall = 0.0f;
+
+    for (size_t p = 0; p < sizeof(probes) / sizeof(probes[0]); p++) {
+        ivf_set_nprobe(index, probes[p]);
+        double ms;
+        float r = average_recall(index, &ms);
+        printf("  nprobe=%2u: recall=%.2f%%, %.3f ms/query\n", probes[p], r * 100.0f, ms);
+        full_recall = r;
+    }
+
+    /* 모든 리스트를 탐색하면 전수 검색과 같아야 함 */
+    if (full_recall < 0.999f) {
+        printf("✗ Full probe recall must be 100%%\n");
+        return -1;
+    }
+
+    printf("✓ Full probe matches brute force\n");
+    ivf_set_nprobe(index, IVF_DEFAULT_NPROBE);
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 3: Save → mmap Load
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int test_save_load(ivf_index_t* index) {
+    printf("\n=== Test 3: Save / mmap Load ===\n");
+
+    if (ivf_save(index, TEST_IVF_FILE) < 0) {
+        printf("✗ Save failed\n");
+        return -1;
+    }
+
+    ivf_index_t* loaded = ivf_load(TEST_IVF_FILE);
+    if (!loaded) {
+        printf("✗ Load failed\n");
+        return -1;
+    }
+
+    int result = 0;
+    float query[TEST_DIM];
+    generate_random_vector(query, TEST_DIM);
+
+    hnsw_result_t a[TEST_QUERY_K], b[TEST_QUERY_K];
+    int na = ivf_search(index, query, TEST_QUERY_K, a);
+    int nb = ivf_search(loaded, query, TEST_QUERY_K, b);
+
+    if (na != nb) result = -1;
+    for (int i = 0; i < na && result == 0; i++) {
+        if (a[i].id != b[i].id) result = -1;
+    }
+
+    if (((uintptr_t)loaded->lists[0].vectors % IVF_ALIGN) != 0) {
+        printf("✗ Mapped vectors not %d-byte aligned\n", IVF_ALIGN);
+        result = -1;
+    }
+
+    /* 매핑된 인덱스에 추가 (copy-on-write) */
+    if (result == 0 && ivf_add(loaded, TEST_COUNT, query) < 0) result = -1;
+    if (result == 0) {
+        int found = ivf_search(loaded, query, 1, b);
+        if (found < 1 || b[0].id != TEST_COUNT) result = -1;
+    }
+
+    /* 리스트 디렉터리 손상 (범위 밖 오프셋 / 개수) → 로드 거부 */
+    uint64_t lists_offset = sizeof(ivf_file_header_t) +
+                            (uint64_t)TEST_NLIST * TEST_DIM * sizeof(float);
+    ivf_file_list_t entry;
+    int fd = open(TEST_IVF_FILE, O_RDWR);
+    if (fd < 0 || pread(fd, &entry, sizeof(entry), (off_t)lists_offset) != sizeof(entry)) {
+        result = -1;
+    } else {
+        ivf_file_list_t bad = entry;
+        bad.vectors_offset = UINT64_MAX - IVF_ALIGN + 1;
+        if (pwrite(fd, &bad, sizeof(bad), (off_t)lists_offset) != sizeof(bad)) result = -1;
+        ivf_index_t* corrupt = ivf_load(TEST_IVF_FILE);
+        if (corrupt) {
+            printf("✗ Out-of-range list offset accepted\n");
+            ivf_destroy(corrupt);
+            result = -1;
+        }
+
+        bad = entry;
+        bad.count = UINT32_MAX;
+        if (pwrite(fd, &bad, sizeof(bad), (off_t)lists_offset) != sizeof(bad)) result = -1;
+        corrupt = ivf_load(TEST_IVF_FILE);
+        if (corrupt) {
+            printf("✗ Oversized list count accepted\n");
+            ivf_destroy(corrupt);
+            result = -1;
+        }
+    }
+    if (fd >= 0) close(fd);
+
+    ivf_destroy(loaded);
+    unlink(TEST_IVF_FILE);
+
+    if (result == 0) {
+        printf("✓ Loaded index returns identical results, accepts new vectors\n");
+        printf("✓ Corrupt list directory rejected\n");
+    } else {
+        printf("✗ Loaded index mismatch\n");
+    }
+    return result;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 4: vector_index API
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int test_vector_index_api(void) {
+    printf("\n=== Test 4: vector_index API (HNSW / IVF) ===\n");
+
+    vector_index_type_t types[] = {VECTOR_INDEX_HNSW, VECTOR_INDEX_IVF};
+    const uint32_t n = 500;
+
+    for (int t = 0; t < 2; t++) {
+        vector_index_t* vi = vector_index_create(types[t], TEST_DIM, n);
+        if (!vi) return -1;
+
+        for (uint32_t i = 0; i < n; i++) {
+            vector_index_insert(vi, i, g_vectors + (size_t)i * TEST_DIM);
+        }
+
+        /* 저장된 벡터 자체로 검색하면 자기 자신이 1위 */
+        hnsw_result_t res[1];
+        int found = vector_index_search(vi, g_vectors + 42 * TEST_DIM, 1, res);
+
+        printf("  %-4s: count=%lu, self-query → ID=%ld (dist=%.4f)\n",
+               vector_index_type_string(types[t]), vector_index_count(vi),
+               found > 0 ? res[0].id : -1L, found > 0 ? res[0].distance : 0.0f);
+
+        int ok = (vector_index_count(vi) == n);
+        if (types[t] == VECTOR_INDEX_IVF) ok = ok && found == 1 && res[0].id == 42;
+        vector_index_destroy(vi);
+
+        if (!ok) {
+            printf("✗ %s via vector_index failed\n", vector_index_type_string(types[t]));
+            return -1;
+        }
+    }
+
+    printf("✓ Both index types usable through one API\n");
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 5: Half Precision Storage
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int test_half_storage(void) {
+    printf("\n=== Test 5: fp16 / bf16 Storage (%s kernels) ===\n", vec_kernels_isa());
+
+    /* 변환 왕복 오차: fp16 상대오차 ≤ 2^-11, bf16 ≤ 2^-8 */
+    vec_storage_t formats[] = {VEC_STORAGE_F16, VEC_STORAGE_BF16};
+    float tolerance[] = {1.0f / 2048.0f, 1.0f / 256.0f};
+    float decoded[TEST_DIM];
+    uint16_t encoded[TEST_DIM];
+
+    for (int f = 0; f < 2; f++) {
+        float max_err = 0.0f;
+        for (uint32_t v = 0; v < 100; v++) {
+            const float* src = g_vectors + (size_t)v * TEST_DIM;
+            vec_encode(formats[f], src, encoded, TEST_DIM);
+            vec_decode(formats[f], encoded, decoded, TEST_DIM);
+            for (uint32_t i = 0; i < TEST_DIM; i++) {
+                if (fabsf(src[i]) < 1e-4f) continue;
+                float err = fabsf(decoded[i] - src[i]) / fabsf(src[i]);
+                if (err > max_err) max_err = err;
+            }
+        }
+
+        /* 저장 벡터 커널 = 복원 벡터로 계산한 fp32 거리 */
+        const float* q = g_vectors + 7 * TEST_DIM;
+        vec_encode(formats[f], g_vectors, encoded, TEST_DIM);
+        vec_decode(formats[f], encoded, decoded, TEST_DIM);
+        float d_stored = vec_cosine_distance_stored(formats[f], q, encoded, TEST_DIM);
+        float d_ref = vec_cosine_distance(q, decoded, TEST_DIM);
+
+        printf("  %s: max relative error=%.2e, kernel diff=%.2e\n",
+               vec_storage_string(formats[f]), max_err, fabsf(d_stored - d_ref));
+
+        if (max_err > tolerance[f] || fabsf(d_stored - d_ref) > 1e-4f) {
+            printf("✗ %s conversion out of tolerance\n", vec_storage_string(formats[f]));
+            return -1;
+        }
+    }
+
+    /* IVF 전체 탐색 Recall: fp32 정답 대비 */
+    for (int f = 0; f < 2; f++) {
+        ivf_index_t* index = ivf_create_ex(TEST_DIM, TEST_NLIST, formats[f]);
+        if (!index) return -1;
+
+        for (uint32_t i = 0; i < TEST_COUNT; i++) {
+            ivf_add(index, i, g_vectors + (size_t)i * TEST_DIM);
+        }
+        ivf_set_nprobe(index, TEST_NLIST);
+
+        double ms;
+        float r = average_recall(index, &ms);
+        printf("  %s: full probe recall=%.2f%%, %.3f ms/query, %zu bytes/vector\n",
+               vec_storage_string(formats[f]), r * 100.0f, ms,
+               TEST_DIM * vec_storage_size(formats[f]));
+
+        int ok = (r >= 0.95f);
+
+        /* 저장 형식이 파일에 기록되는지 */
+        if (ok && ivf_save(index, TEST_IVF_FILE) == 0) {
+            ivf_index_t* loaded = ivf_load(TEST_IVF_FILE);
+            ok = loaded && loaded->storage == formats[f];
+            if (loaded) ivf_destroy(loaded);
+            unlink(TEST_IVF_FILE);
+        }
+
+        ivf_destroy(index);
+        if (!ok) {
+            printf("✗ %s IVF recall or persistence failed\n", vec_storage_string(formats[f]));
+            return -1;
+        }
+    }
+
+    /* HNSW도 같은 저장 형식 사용 */
+    vector_index_t* vi = vector_index_create_ex(VECTOR_INDEX_HNSW, TEST_DIM, 200, VEC_STORAGE_F16);
+    if (!vi) return -1;
+    for (uint32_t i = 0; i < 200; i++) {
+        vector_index_insert(vi, i, g_vectors + (size_t)i * TEST_DIM);
+    }
+    hnsw_result_t res[1];
+    int found = vector_index_search(vi, g_vectors, 1, res);
+    int ok = (found == 1 && vi->impl.hnsw->storage == VEC_STORAGE_F16);
+    vector_index_destroy(vi);
+
+    if (!ok) {
+        printf("✗ fp16 HNSW search failed\n");
+        return -1;
+    }
+
+    printf("✓ Half precision storage within tolerance\n");
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Main
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int main(void) {
+    srand(12345);
+
+    printf("╔════════════════════════════════════════════════════════════╗\n");
+    printf("║             IVF (Inverted File) Index Test                ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n");
+
+    g_vectors = (float*)malloc((size_t)TEST_COUNT * TEST_DIM * sizeof(float));
+    for (uint32_t i = 0; i < TEST_COUNT; i++) {
+        generate_random_vector(g_vectors + (size_t)i * TEST_DIM, TEST_DIM);
+    }
+
+    ivf_index_t* index = ivf_create(TEST_DIM, TEST_NLIST);
+    if (!index) {
+        printf("✗ Failed to create IVF index\n");
+        return 1;
+    }
+
+    int result = 0;
+    if (test_insert(index) < 0) result = 1;
+    if (result == 0 && test_recall(index) < 0) result = 1;
+    if (result == 0 && test_save_load(index) < 0) result = 1;
+    if (test_vector_index_api() < 0) result = 1;
+    if (test_half_storage() < 0) result = 1;
+
+    ivf_destroy(index);
+    free(g_vectors);
+
+    if (result == 0) {
+        printf("\n╔════════════════════════════════════════════════════════════╗\n");
+        printf("║                   All Tests Passed!                        ║\n");
+        printf("╚════════════════════════════════════════════════════════════╝\n");
+    } else {
+        printf("\n✗ Some tests failed\n");
+    }
+
+    return result;
+}
@@ -0,0 +1,234 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * test_sharded.c
+ *
+ * Sharded HNSW Index Test
+ *
+ * 테스트:
+ *   1. 4개 스레드 동시 삽입 → 총 개수 / 샤드 분포 확인
+ *   2. Scatter-Gather 결과 = 샤드별 검색 결과의 정확한 병합
+ *   3. 삽입과 검색 동시 실행
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#include "sharded_index.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TEST_DIM            64
+#define TEST_SHARDS         8
+#define TEST_THREADS        4
+#define TEST_PER_THREAD     500
+#define TEST_COUNT          (TEST_THREADS * TEST_PER_THREAD)
+#define TEST_QUERY_K        10
+#define TEST_QUERIES        20
+
+static float* g_vectors = NULL;
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Helpers
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static void generate_random_vector(float* vec, uint32_t dim) {
+    for (uint32_t i = 0; i < dim; i++) {
+        vec[i] = (float)rand() / RAND_MAX - 0.5f;
+    }
+}
+
+static int cmp_dist(const void* a, const void* b) {
+    float da = ((const hnsw_result_t*)a)->distance;
+    float db = ((const hnsw_result_t*)b)->distance;
+    return (da > db) - (da < db);
+}
+
+typedef struct {
+    sharded_index_t* si;
+    uint32_t         first;
+    uint32_t         count;
+    int              failures;
+} insert_job_t;
+
+static void* insert_thread(void* arg) {
+    insert_job_t* job = (insert_job_t*)arg;
+    for (uint32_t i = job->first; i < job->first + job->count; i++) {
+        if (sharded_insert(job->si, i, g_vectors + (size_t)i * TEST_DIM) < 0) {
+            job->failures++;
+        }
+    }
+    return NULL;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 1: Parallel Insert
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int test_parallel_insert(sharded_index_t* si) {
+    printf("\n=== Test 1: Parallel Insert (%d threads × %d) ===\n",
+           TEST_THREADS, TEST_PER_THREAD);
+
+    pthread_t threads[TEST_THREADS];
+    insert_job_t jobs[TEST_THREADS];
+
+    clock_t start = clock();
+    for (int t = 0; t < TEST_THREADS; t++) {
+        jobs[t].si = si;
+        jobs[t].first = (uint32_t)t * TEST_PER_THREAD;
+        jobs[t].count = TEST_PER_THREAD;
+        jobs[t].failures = 0;
+        pthread_create(&threads[t], NULL, insert_thread, &jobs[t]);
+    }
+
+    int failures = 0;
+    for (int t = 0; t < TEST_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+        failures += jobs[t].failures;
+    }
+    double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC * 1000.0;
+
+    if (failures > 0 || sharded_count(si) != TEST_COUNT) {
+        printf("✗ Expected %d vectors, got %lu (%d failures)\n",
+               TEST_COUNT, sharded_count(si), failures);
+        return -1;
+    }
+
+    /* 모든 샤드가 벡터를 받았는지 (해시 분산) */
+    for (uint32_t s = 0; s < si->shard_count; s++) {
+        if (si->shards[s].index->count == 0) {
+            printf("✗ Shard %u is empty\n", s);
+            return -1;
+        }
+    }
+
+    printf("✓ Inserted %d vectors in %.2f ms\n", TEST_COUNT, elapsed);
+    sharded_stats(si);
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 2: Scatter-Gather Merge
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int test_merge(sharded_index_t* si) {
+    printf("\n=== Test 2: Scatter-Gather Top-%d Merge ===\n", TEST_QUERY_K);
+
+    hnsw_result_t* all = (hnsw_result_t*)malloc(
+        (size_t)si->shard_count * TEST_QUERY_K * sizeof(hnsw_result_t));
+    double total_ms = 0.0;
+    int result = 0;
+
+    for (int q = 0; q < TEST_QUERIES && result == 0; q++) {
+        float query[TEST_DIM];
+        generate_random_vector(query, TEST_DIM);
+
+        hnsw_result_t got[TEST_QUERY_K];
+        clock_t start = clock();
+        int found = sharded_search(si, query, TEST_QUERY_K, got);
+        total_ms += (double)(clock() - start) / CLOCKS_PER_SEC * 1000.0;
+
+        /* 기대값: 샤드별 검색 결과 전체를 정렬한 앞부분 */
+        uint32_t n = 0;
+        for (uint32_t s = 0; s < si->shard_count; s++) {
+            int r = hnsw_search(si->shards[s].index, query, TEST_QUERY_K, all + n);
+            if (r > 0) n += (uint32_t)r;
+        }
+        qsort(all, n, sizeof(hnsw_result_t), cmp_dist);
+        int expected = (n < TEST_QUERY_K) ? (int)n : TEST_QUERY_K;
+
+        if (found != expected) result = -1;
+        for (int i = 0; i < found && result == 0; i++) {
+            if (got[i].distance != all[i].distance) result = -1;
+            if (i > 0 && got[i].distance < got[i - 1].distance) result = -1;
+        }
+    }
+
+    free(all);
+
+    if (result < 0) {
+        printf("✗ Merged results differ from per-shard ground truth\n");
+        return -1;
+    }
+
+    printf("✓ %d queries merged correctly (%.3f ms/query)\n",
+           TEST_QUERIES, total_ms / TEST_QUERIES);
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 3: Concurrent Insert + Search
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int test_concurrent(void) {
+    printf("\n=== Test 3: Concurrent Insert + Search ===\n");
+
+    sharded_index_t* si = sharded_create(TEST_DIM, TEST_SHARDS, TEST_COUNT, 0);
+    if (!si) return -1;
+
+    /* 절반은 미리 삽입 */
+    for (uint32_t i = 0; i < TEST_COUNT / 2; i++) {
+        sharded_insert(si, i, g_vectors + (size_t)i * TEST_DIM);
+    }
+
+    /* 나머지 절반은 백그라운드 스레드에서 삽입 */
+    insert_job_t job = { si, TEST_COUNT / 2, TEST_COUNT / 2, 0 };
+    pthread_t writer;
+    pthread_create(&writer, NULL, insert_thread, &job);
+
+    int bad = 0;
+    for (int q = 0; q < TEST_QUERIES * 5; q++) {
+        hnsw_result_t res[TEST_QUERY_K];
+        int found = sharded_search(si, g_vectors + (size_t)(q % 100) * TEST_DIM,
+                                   TEST_QUERY_K, res);
+        if (found <= 0) bad++;
+    }
+
+    pthread_join(writer, NULL);
+
+    int ok = (bad == 0 && job.failures == 0 && sharded_count(si) == TEST_COUNT);
+    sharded_destroy(si);
+
+    if (!ok) {
+        printf("✗ Concurrent run failed (bad searches=%d, insert failures=%d)\n",
+               bad, job.failures);
+        return -1;
+    }
+
+    printf("✓ %d searches during background inserts\n", TEST_QUERIES * 5);
+    return 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Main
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int main(void) {
+    srand(12345);
+
+    printf("╔════════════════════════════════════════════════════════════╗\n");
+    printf("║              Sharded HNSW Index Test                      ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n");
+
+    g_vectors = (float*)malloc((size_t)TEST_COUNT * TEST_DIM * sizeof(float));
+    for (uint32_t i = 0; i < TEST_COUNT; i++) {
+        generate_random_vector(g_vectors + (size_t)i * TEST_DIM, TEST_DIM);
+    }
+
+    sharded_index_t* si = sharded_create(TEST_DIM, TEST_SHARDS, TEST_COUNT, 0);
+    if (!si) {
+        printf("✗ Failed to create sharded index\n");
+        return 1;
+    }
+
+    int result = 0;
+    if (test_parallel_insert(si) < 0) result = 1;
+    if (result == 0 && test_merge(si) < 0) result = 1;
+    sharded_destroy(si);
+
+    if (result == 0 && test_concurrent() < 0) result = 1;
+
+    free(g_vectors);
+
+    if (result == 0) {
+        printf("\n╔════════════════════════════════════════════════════════════╗\n");
+        printf("║                   All Tests Passed!                        ║\n");
+        printf("╚════════════════════════════════════════════════════════════╝\n");
+    } else {
+        printf("\n✗ Some tests failed\n");
+    }
+
+    return result;
+}
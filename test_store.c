@@ -0,0 +1,385 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * test_store.c
+ *
+ * Segmented Store Test
+ *
+ * 테스트:
+ *   1. 세그먼트 넘김: 작은 segment_size로 여러 세그먼트 → 모두 조회
+ *   2. 세그먼트 사이 덮어쓰기 / 삭제
+ *   3. 다시 열기 (병렬 + FIRST_TOUCH): ROUTING 그대로 사용
+ *   4. 크래시 (새 사본만 쓰고 종료) → ROUTING 재구축, 큰 번호 사본 유지
+ *      (읽기 전용 열기는 메모리에만 재구축, 디렉터리는 그대로)
+ *   5. 세그먼트 단위 컴팩션 / 버리기
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* fork, clock_gettime 선언을 위해 필요 */
+#define _POSIX_C_SOURCE 200809L
+
+#include "brain_store.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+
+#define TEST_DIR        "test_store.d"
+#define TEST_DIM        64
+#define TEST_IDS        12000
+#define TEST_SEGMENT    (1024 * 1024)
+#define TEST_THREADS    4
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Helpers
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static void cleanup(void) {
+    DIR* d = opendir(TEST_DIR);
+    if (d) {
+        struct dirent* de;
+        char path[512];
+        while ((de = readdir(d))) {
+            if (de->d_name[0] == '.') continue;
+            snprintf(path, sizeof(path), "%s/%s", TEST_DIR, de->d_name);
+            unlink(path);
+        }
+        closedir(d);
+    }
+    rmdir(TEST_DIR);
+}
+
+/* 벡터 첫 값 = id + version (어느 사본인지 구분) */
+static int64_t put(brain_store_t* st, int64_t id, int version) {
+    float v[TEST_DIM];
+    char meta[64];
+    for (int j = 0; j < TEST_DIM; j++) v[j] = (float)(id + version) + (float)j * 0.01f;
+    int n = snprintf(meta, sizeof(meta), "memory-%ld-v%d", (long)id, version);
+    return brain_store_append(st, id, v, meta, (uint32_t)n, 0.5f);
+}
+
+/* [from, to) 가 모두 version 사본으로 조회되는가 */
+static int check_range(const brain_store_t* st, int64_t from, int64_t to, int version) {
+    int failures = 0;
+    for (int64_t id = from; id < to; id++) {
+        brain_entry_t e;
+        if (brain_store_get(st, id, &e, NULL) < 0 || e.record->id != id ||
+            e.vector[0] != (float)(id + version)) failures++;
+    }
+    return failures;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 1: Segment rollover
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int test_rollover(void) {
+    printf("\n=== Test 1: Segment Rollover ===\n");
+    cleanup();
+    int failures = 0;
+
+    brain_store_t* st = brain_store_create(TEST_DIR, TEST_DIM, INDEX_LAYOUT_ROBIN_HOOD, TEST_SEGMENT);
+    if (!st) return -1;
+
+    double t0 = now_ms();
+    for (int64_t id = 0; id < TEST_IDS; id++) {
+        if (put(st, id, 0) < 0) failures++;
+    }
+    double t1 = now_ms();
+    printf("  %d records in %.2f ms → %u segments\n", TEST_IDS, t1 - t0, st->segment_count);
+
+    if (st->segment_count < 3) {
+        printf("  ❌ Expected several segments, got %u\n", st->segment_count);
+        failures++;
+    }
+    for (uint32_t i = 0; i + 1 < st->segment_count; i++) {
+        if (st->segments[i].state != BRAIN_SEGMENT_SEALED) failures++;
+    }
+
+    /* 봉인된 세그먼트도 segment_size를 넘지 않음 (chunk가 2배로 커져도 넘기 전에 넘김) */
+    uint64_t largest = 0;
+    for (uint32_t i = 0; i < st->segment_count; i++) {
+        uint64_t size = brain_file_header(st->segments[i].bf)->file_size;
+        if (size > largest) largest = size;
+    }
+    if (largest > TEST_SEGMENT) {
+        printf("  ❌ Segment grew to %lu bytes (limit %lu)\n", (unsigned long)largest,
+               (unsigned long)TEST_SEGMENT);
+        failures++;
+    } else {
+        printf("  ✓ Largest segment %lu bytes ≤ %lu\n", (unsigned long)largest,
+               (unsigned long)TEST_SEGMENT);
+    }
+    if (st->segments[st->segment_count - 1].state != BRAIN_SEGMENT_ACTIVE) failures++;
+
+    int missing = check_range(st, 0, TEST_IDS, 0);
+    if (missing) {
+        printf("  ❌ %d mismatches\n", missing);
+        failures++;
+    } else {
+        printf("  ✓ All %d ids found across segments\n", TEST_IDS);
+    }
+    if (brain_store_count(st) != TEST_IDS || index_count(st->route) != TEST_IDS) failures++;
+
+    brain_store_close(st);
+    return failures ? -1 : 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 2: Overwrite / delete across segments
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int test_overwrite(void) {
+    printf("\n=== Test 2: Overwrite / Delete Across Segments ===\n");
+    int failures = 0;
+
+    brain_store_t* st = brain_store_open(TEST_DIR, 1, NULL);
+    if (!st) return -1;
+    uint32_t first = st->segments[0].number;
+    uint64_t first_live = brain_file_count(st->segments[0].bf);
+
+    /* 첫 세그먼트의 ID → 지금 ACTIVE로 옮겨 감 */
+    for (int64_t id = 0; id < 500; id++) {
+        int64_t seg = put(st, id, 1);
+        if (seg < 0 || (uint32_t)seg == first) failures++;
+    }
+    for (int64_t id = 500; id < 700; id++) {
+        if (brain_store_delete(st, id) < 0) failures++;
+    }
+    if (brain_store_delete(st, 500) == 0) failures++;          /* 두 번째는 없음 */
+
+    int bad = check_range(st, 0, 500, 1) + check_range(st, 700, TEST_IDS, 0);
+    brain_entry_t e;
+    for (int64_t id = 500; id < 700; id++) {
+        if (brain_store_get(st, id, &e, NULL) == 0) bad++;
+    }
+    uint32_t seg = 0;
+    if (brain_store_get(st, 0, &e, &seg) < 0 || seg == first) bad++;
+    if (brain_file_count(st->segments[0].bf) != first_live - 700) bad++;
+    if (brain_store_count(st) != TEST_IDS - 200) bad++;
+
+    if (bad) {
+        printf("  ❌ %d mismatches\n", bad);
+        failures++;
+    } else {
+        printf("  ✓ 500 overwrites moved out of segment %u, 200 deletes gone\n", first);
+    }
+
+    brain_store_close(st);
+    return failures ? -1 : 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 3: Clean reopen (parallel)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int test_reopen(void) {
+    printf("\n=== Test 3: Parallel Reopen ===\n");
+    int failures = 0;
+
+    brain_store_options_t opt = { 1, 0, BRAIN_VERIFY_NEVER };
+    brain_store_t* st = brain_store_open(TEST_DIR, 0, &opt);
+    if (!st) return -1;
+    double serial = st->stats.open_ms;
+    brain_store_close(st);
+
+    opt.threads = TEST_THREADS;
+    opt.verify = BRAIN_VERIFY_FIRST_TOUCH;
+    st = brain_store_open(TEST_DIR, 0, &opt);
+    if (!st) return -1;
+
+    if (st->stats.route_rebuilt) {
+        printf("  ❌ ROUTING rebuilt after a clean close\n");
+        failures++;
+    }
+    int bad = check_range(st, 0, 500, 1) + check_range(st, 700, TEST_IDS, 0);
+    if (bad) {
+        printf("  ❌ %d mismatches\n", bad);
+        failures++;
+    } else {
+        printf("  ✓ %u segments: 1 thread %.2f ms, %u threads %.2f ms (with verify), ROUTING reused\n",
+               st->segment_count, serial, st->stats.threads, st->stats.open_ms);
+    }
+    brain_store_stats(st);
+
+    brain_store_close(st);
+    return failures ? -1 : 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 4: Unclean shutdown
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 자식 프로세스: 덮어쓰기 도중 (새 사본만 쓰고 이전 사본 삭제 전) 종료 */
+static void crash_child(void) {
+    brain_store_t* st = brain_store_open(TEST_DIR, 1, NULL);
+    if (!st) _exit(2);
+
+    brain_segment_t* active = &st->segments[st->segment_count - 1];
+    float v[TEST_DIM];
+    for (int64_t id = 1000; id < 1300; id++) {
+        for (int j = 0; j < TEST_DIM; j++) v[j] = (float)(id + 2) + (float)j * 0.01f;
+        if (brain_file_append(active->bf, id, v, NULL, 0, 0.5f) < 0) _exit(2);
+    }
+    if (brain_store_sync(st) < 0) _exit(2);
+    _exit(0);
+}
+
+/* 디렉터리 파일이 그대로인가 (같은 inode / 크기 / 수정 시각) */
+static int same_file(const struct stat* a, const char* name) {
+    char path[512];
+    struct stat b;
+    snprintf(path, sizeof(path), "%s/%s", TEST_DIR, name);
+    return stat(path, &b) == 0 && a->st_ino == b.st_ino && a->st_size == b.st_size &&
+           a->st_mtim.tv_sec == b.st_mtim.tv_sec && a->st_mtim.tv_nsec == b.st_mtim.tv_nsec;
+}
+
+static int run_child(void (*fn)(void)) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) fn();
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : -1;
+}
+
+static int test_crash(void) {
+    printf("\n=== Test 4: Unclean Shutdown → ROUTING Rebuild ===\n");
+    int failures = 0;
+
+    if (run_child(crash_child) < 0) {
+        printf("  ❌ Child failed\n");
+        return -1;
+    }
+
+    brain_store_options_t opt = { TEST_THREADS, 0, BRAIN_VERIFY_NEVER };
+
+    /* 읽기 전용: 재구축은 익명 메모리에서, ROUTING / MANIFEST는 건드리지 않음 */
+    struct stat routing, manifest;
+    if (stat(TEST_DIR "/" BRAIN_STORE_ROUTING, &routing) < 0 ||
+        stat(TEST_DIR "/" BRAIN_STORE_MANIFEST, &manifest) < 0) return -1;
+    brain_store_t* st = brain_store_open(TEST_DIR, 0, &opt);
+    if (!st) return -1;
+    int ro_bad = !st->stats.route_rebuilt || st->route_mf->fd >= 0 ||
+                 check_range(st, 1000, 1300, 2) != 0;
+    brain_store_close(st);
+    if (ro_bad || !same_file(&routing, BRAIN_STORE_ROUTING) ||
+        !same_file(&manifest, BRAIN_STORE_MANIFEST)) {
+        printf("  ❌ Read-only open rewrote the store directory\n");
+        failures++;
+    } else {
+        printf("  ✓ Read-only open rebuilt ROUTING in memory, directory untouched\n");
+    }
+
+    st = brain_store_open(TEST_DIR, 1, &opt);
+    if (!st) return -1;
+
+    if (!st->stats.route_rebuilt || st->stats.duplicates != 300) {
+        printf("  ❌ rebuilt %d, duplicates %lu\n",
+               st->stats.route_rebuilt, (unsigned long)st->stats.duplicates);
+        failures++;
+    }
+    int bad = check_range(st, 0, 500, 1) + check_range(st, 700, 1000, 0) +
+              check_range(st, 1000, 1300, 2) + check_range(st, 1300, TEST_IDS, 0);
+    if (brain_store_count(st) != TEST_IDS - 200 || index_count(st->route) != TEST_IDS - 200) bad++;
+    if (bad) {
+        printf("  ❌ %d mismatches\n", bad);
+        failures++;
+    } else {
+        printf("  ✓ Rebuilt in %.2f ms, 300 duplicates resolved to the newer segment\n",
+               st->stats.route_ms);
+    }
+    brain_store_close(st);
+
+    /* 정상 종료 후에는 다시 ROUTING 사용 */
+    st = brain_store_open(TEST_DIR, 0, &opt);
+    if (!st) return -1;
+    if (st->stats.route_rebuilt || check_range(st, 1000, 1300, 2)) failures++;
+    brain_store_close(st);
+
+    return failures ? -1 : 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 5: Per-segment compaction / drop
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static int test_segment_ops(void) {
+    printf("\n=== Test 5: Per-Segment Compaction / Drop ===\n");
+    int failures = 0;
+
+    brain_store_t* st = brain_store_open(TEST_DIR, 1, NULL);
+    if (!st) return -1;
+
+    /* 첫 세그먼트는 덮어쓰기 / 삭제로 구멍투성이 */
+    uint32_t first = st->segments[0].number;
+    if (brain_store_compact_segment(st, first) < 0) failures++;
+    int bad = check_range(st, 0, 500, 1) + check_range(st, 700, 1000, 0) +
+              check_range(st, 1000, 1300, 2) + check_range(st, 1300, TEST_IDS, 0);
+    if (bad) {
+        printf("  ❌ %d mismatches after compaction\n", bad);
+        failures++;
+    } else {
+        printf("  ✓ Segment %u compacted, all ids still routed\n", first);
+    }
+
+    /* 두 번째 세그먼트를 통째로 버림 → 그 ID만 사라짐 */
+    uint32_t victim = st->segments[1].number;
+    uint64_t victim_live = brain_file_count(st->segments[1].bf);
+    uint64_t before = brain_store_count(st);
+    int64_t lost = -1;
+    brain_entry_t e;
+    uint32_t seg;
+    for (int64_t id = 0; id < TEST_IDS && lost < 0; id++) {
+        if (brain_store_get(st, id, &e, &seg) == 0 && seg == victim) lost = id;
+    }
+
+    if (brain_store_drop_segment(st, victim) < 0 || brain_store_segment(st, victim)) failures++;
+    if (lost < 0 || brain_store_get(st, lost, &e, NULL) == 0) failures++;
+    if (brain_store_count(st) != before - victim_live) failures++;
+    if (index_count(st->route) != before - victim_live) failures++;
+    brain_store_close(st);
+
+    st = brain_store_open(TEST_DIR, 0, NULL);
+    if (!st) return -1;
+    if (st->stats.route_rebuilt || brain_store_segment(st, victim) ||
+        brain_store_count(st) != before - victim_live) failures++;
+    if (failures == 0) {
+        printf("  ✓ Dropped segment %u (%lu records), survives reopen\n",
+               victim, (unsigned long)victim_live);
+    }
+    brain_store_close(st);
+
+    return failures ? -1 : 0;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Main
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+int main(void) {
+    printf("╔════════════════════════════════════════════════════════════╗\n");
+    printf("║                  Segmented Store Test                      ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n");
+
+    int result = 0;
+    if (test_rollover() < 0) result = 1;
+    if (test_overwrite() < 0) result = 1;
+    if (test_reopen() < 0) result = 1;
+    if (test_crash() < 0) result = 1;
+    if (test_segment_ops() < 0) result = 1;
+
+    cleanup();
+
+    if (result == 0) {
+        printf("\n╔════════════════════════════════════════════════════════════╗\n");
+        printf("║                   All Tests Passed!                        ║\n");
+        printf("╚════════════════════════════════════════════════════════════╝\n");
+    } else {
+        printf("\n✗ Some tests failed\n");
+    }
+
+    return result;
+}
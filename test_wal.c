@@ -0,0 +1,410 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * test_wal.c
+ *
+ * Write-Ahead Log Test
+ *
+ * 테스트:
+ *   1. 그룹 커밋 (8 스레드) → fdatasync 수 < 커밋 수, 저장 비용 비교
+ *   2. 크래시 복구: 커밋된 변경만 남고, 커밋 안 된 변경 / 깨진 헤더와
+ *      인덱스는 스냅샷 + 재생으로 복원
+ *   3. 컴팩션 도중 크래시 + 잘린 로그 꼬리
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* fork, clock_gettime 선언을 위해 필요 */
+#define _POSIX_C_SOURCE 200809L
+
+#include "brain_file.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#define TEST_DIM        16
+#define TEST_META       200
+#define TEST_BRAIN      "test_wal.brain"
+#define TEST_WAL        "test_wal.brain.wal"
+#define TEST_THREADS    8
+#define TEST_PER_THREAD 400
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Helpers
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static void make_vector(float* v, int64_t id, int version) {
+    for (int j = 0; j < TEST_DIM; j++) v[j] = (float)id * 0.001f + (float)version * 100.0f + (float)j;
+}
+
+/* 메타데이터 TEST_META 바이트 (heap extent 하나에 ~300개) */
+static void make_meta(char* meta, int64_t id, int version) {
+    int n = snprintf(meta, TEST_META, "v%d-meta-%ld-", version, (long)id);
+    for (int k = n; k < TEST_META; k++) meta[k] = (char)('a' + (id + k + version) % 26);
+}
+
+static int put(brain_file_t* bf, int64_t id, int version) {
+    float v[TEST_DIM];
+    char meta[TEST_META];
+    make_vector(v, id, version);
+    make_meta(meta, id, version);
+    return brain_file_append(bf, id, v, meta, TEST_META, 0.5f) < 0 ? -1 : 0;
+}
+
+/* id가 version으로 저장되어 있는가 (version < 0 = 없어야 함) */
+static int check(const brain_file_t* bf, int64_t id, int version) {
+    brain_entry_t e;
+    int found = brain_file_get(bf, id, &e) == 0;
+    if (version < 0) {
+        if (found) printf("✗ id %ld should be absent\n", (long)id);
+        return found ? -1 : 0;
+    }
+    if (!found || !(e.record->flags & BRAIN_RECORD_LIVE) || e.record->id != id) {
+        printf("✗ id %ld missing\n", (long)id);
+        return -1;
+    }
+
+    float v[TEST_DIM];
+    char meta[TEST_META];
+    make_vector(v, id, version);
+    make_meta(meta, id, version);
+    if (memcmp(e.vector, v, sizeof(v)) != 0 || e.meta_len != TEST_META ||
+        memcmp(e.metadata, meta, TEST_META) != 0) {
+        printf("✗ id %ld has wrong contents (want version %d)\n", (long)id, version);
+        return -1;
+    }
+    return 0;
+}
+
+static void cleanup(void) {
+    unlink(TEST_BRAIN);
+    unlink(TEST_WAL);
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 1: Group commit
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+typedef struct {
+    brain_file_t*    bf;
+    pthread_mutex_t* lock;
+    int              thread;
+    int              failed;
+} writer_t;
+
+static void* writer_main(void* arg) {
+    writer_t* w = (writer_t*)arg;
+    for (int i = 0; i < TEST_PER_THREAD; i++) {
+        int64_t id = (int64_t)w->thread * TEST_PER_THREAD + i;
+
+        pthread_mutex_lock(w->lock);
+        int rc = put(w->bf, id, 0);
+        uint64_t lsn = brain_file_lsn(w->bf);
+        pthread_mutex_unlock(w->lock);
+
+        /* 잠금 밖에서 대기 → 다른 스레드의 커밋과 fdatasync 공유 */
+        if (rc < 0 || brain_file_commit(w->bf, lsn) < 0) w->failed = 1;
+    }
+    return NULL;
+}
+
+static int test_group_commit(void) {
+    printf("\n=== Test 1: Group Commit (%d threads × %d stores) ===\n",
+           TEST_THREADS, TEST_PER_THREAD);
+    cleanup();
+
+    /* 기준: 저장마다 전체 msync */
+    const int base_n = 200;
+    brain_file_t* bf = brain_file_create(TEST_BRAIN, TEST_DIM, INDEX_LAYOUT_GROUPED);
+    if (!bf) return -1;
+    double t0 = now_ms();
+    for (int i = 0; i < base_n; i++) {
+        put(bf, i, 0);
+        mmap_file_sync(bf->mf);
+    }
+    double msync_ms = now_ms() - t0;
+    brain_file_close(bf);
+    cleanup();
+
+    /* 단일 스레드: 저장마다 커밋 (대기 창 없음) */
+    bf = brain_file_create(TEST_BRAIN, TEST_DIM, INDEX_LAYOUT_GROUPED);
+    if (!bf || brain_file_attach_wal(bf, TEST_WAL, 0) < 0) return -1;
+    t0 = now_ms();
+    for (int i = 0; i < base_n; i++) {
+        put(bf, i, 0);
+        brain_file_commit(bf, brain_file_lsn(bf));
+    }
+    double wal_ms = now_ms() - t0;
+    brain_file_close(bf);
+    cleanup();
+
+    /* 여러 스레드: 그룹 커밋 */
+    bf = brain_file_create(TEST_BRAIN, TEST_DIM, INDEX_LAYOUT_GROUPED);
+    if (!bf || brain_file_attach_wal(bf, TEST_WAL, BRAIN_WAL_GROUP_US) < 0) return -1;
+
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    pthread_t threads[TEST_THREADS];
+    writer_t writers[TEST_THREADS];
+    uint64_t syncs_before = bf->wal->stats.syncs;
+    uint64_t commits_before = bf->wal->stats.commits;
+
+    t0 = now_ms();
+    for (int t = 0; t < TEST_THREADS; t++) {
+        writers[t] = (writer_t){ bf, &lock, t, 0 };
+        pthread_create(&threads[t], NULL, writer_main, &writers[t]);
+    }
+    int result = 0;
+    for (int t = 0; t < TEST_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+        if (writers[t].failed) result = -1;
+    }
+    double group_ms = now_ms() - t0;
+
+    uint64_t syncs = bf->wal->stats.syncs - syncs_before;
+    uint64_t commits = bf->wal->stats.commits - commits_before;
+    const uint32_t total = TEST_THREADS * TEST_PER_THREAD;
+
+    if (result < 0) printf("✗ A writer failed\n");
+    if (result == 0 && (commits < total || syncs == 0 || syncs >= commits)) {
+        printf("✗ No grouping: %lu commits, %lu fdatasync\n",
+               (unsigned long)commits, (unsigned long)syncs);
+        result = -1;
+    }
+    if (result == 0 && brain_file_count(bf) != total) {
+        printf("✗ Count %lu != %u\n", (unsigned long)brain_file_count(bf), total);
+        result = -1;
+    }
+    brain_wal_stats(bf->wal);
+    brain_file_close(bf);
+
+    /* 닫을 때 체크포인트 → 로그에는 헤더 + 스냅샷 (디렉터리 126칸)만 */
+    struct stat st;
+    if (result == 0 && (stat(TEST_WAL, &st) < 0 ||
+                        st.st_size != (off_t)(sizeof(brain_wal_header_t) + sizeof(brain_header_t) +
+                                              BRAIN_DEFAULT_SECTIONS * sizeof(brain_section_t)))) {
+        printf("✗ Log not truncated by the closing checkpoint\n");
+        result = -1;
+    }
+
+    bf = brain_file_open_durable(TEST_BRAIN, TEST_WAL, 0);
+    if (!bf) return -1;
+    for (int64_t id = 0; result == 0 && id < total; id += 37) result = check(bf, id, 0);
+    brain_file_close(bf);
+
+    if (result == 0) {
+        printf("✓ %lu commits shared %lu fdatasync (%.1f per sync)\n",
+               (unsigned long)commits, (unsigned long)syncs, (double)commits / syncs);
+        printf("✓ Per store: msync %.3f ms, WAL commit %.3f ms, group commit %.3f ms\n",
+               msync_ms / base_n, wal_ms / base_n, group_ms / total);
+    }
+    cleanup();
+    return result;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 2: Crash recovery
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 자식 프로세스: 체크포인트 → 커밋된 변경 → 커밋 안 된 변경 → 파일 훼손 → 종료 */
+static void crash_child(void) {
+    brain_file_t* bf = brain_file_create(TEST_BRAIN, TEST_DIM, INDEX_LAYOUT_ROBIN_HOOD);
+    if (!bf || brain_file_attach_wal(bf, TEST_WAL, 0) < 0) _exit(2);
+
+    for (int64_t id = 0; id < 3000; id++) put(bf, id, 0);
+    if (brain_file_checkpoint(bf) < 0) _exit(2);
+
+    for (int64_t id = 0; id < 300; id++) put(bf, id, 1);
+    for (int64_t id = 300; id < 500; id++) brain_file_delete(bf, id);
+    for (int64_t id = 3000; id < 4000; id++) put(bf, id, 0);
+    if (brain_file_commit(bf, 0) < 0) _exit(2);
+
+    /* 로그는 메모리에만, 매핑은 바뀜 → 복구 후 사라져야 함 */
+    for (int64_t id = 500; id < 600; id++) put(bf, id, 2);
+    for (int64_t id = 600; id < 700; id++) brain_file_delete(bf, id);
+
+    /* 찢어진 페이지 흉내: 인덱스 테이블과 헤더 훼손 */
+    brain_header_t* header = brain_file_header(bf);
+    memset((char*)bf->mf->addr + header->index.table_offset, 0xA5, 64 * 1024);
+    header->record_count += 12345;
+    header->magic = 0;
+    _exit(0);
+}
+
+static int run_child(void (*fn)(void)) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) fn();
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : -1;
+}
+
+static int test_recovery(void) {
+    printf("\n=== Test 2: Crash Recovery ===\n");
+    cleanup();
+
+    if (run_child(crash_child) < 0) {
+        printf("✗ Child failed\n");
+        return -1;
+    }
+
+    brain_file_t* bf = brain_file_open(TEST_BRAIN, 0);
+    if (bf) {
+        printf("✗ Damaged header should not open without the WAL\n");
+        brain_file_close(bf);
+        return -1;
+    }
+
+    bf = brain_file_open_durable(TEST_BRAIN, TEST_WAL, 0);
+    if (!bf) {
+        printf("✗ Recovery failed\n");
+        return -1;
+    }
+
+    int result = 0;
+    for (int64_t id = 0; result == 0 && id < 4000; id++) {
+        int version = id < 300 ? 1 : id < 500 ? -1 : 0;
+        result = check(bf, id, version);
+    }
+    if (result == 0 && brain_file_count(bf) != 3800) {
+        printf("✗ Count %lu != 3800\n", (unsigned long)brain_file_count(bf));
+        result = -1;
+    }
+    brain_file_close(bf);
+
+    /* 복구 결과도 그대로 다시 열림 */
+    bf = brain_file_open(TEST_BRAIN, 0);
+    if (result == 0 && (!bf || brain_file_count(bf) != 3800 || check(bf, 3999, 0) < 0)) {
+        printf("✗ Recovered file did not reopen cleanly\n");
+        result = -1;
+    }
+    brain_file_close(bf);
+
+    if (result == 0) {
+        printf("✓ Committed overwrite / delete / append survived\n");
+        printf("✓ Uncommitted changes rolled back, header and index rebuilt\n");
+    }
+    cleanup();
+    return result;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Test 3: Crash during compaction + torn log tail
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+/* chunk 0: 3/4 삭제 → 레코드 이동
+ * chunk 2 앞부분: 3/4 삭제 → chunk는 절반 넘게 살아 있지만 그 구간의
+ * heap extent는 성겨짐 → 메타데이터만 이동 */
+static int deleted_id(int64_t id) {
+    return id % 4 != 0 && (id < 1024 || (id >= 3072 && id < 4913));
+}
+
+static void compact_child(void) {
+    brain_file_t* bf = brain_file_create(TEST_BRAIN, TEST_DIM, INDEX_LAYOUT_GROUPED);
+    if (!bf || brain_file_attach_wal(bf, TEST_WAL, 0) < 0) _exit(2);
+
+    for (int64_t id = 0; id < 8000; id++) put(bf, id, 0);
+    if (brain_file_checkpoint(bf) < 0) _exit(2);
+
+    for (int64_t id = 0; id < 8000; id++) {
+        if (deleted_id(id)) brain_file_delete(bf, id);
+    }
+    if (brain_file_commit(bf, 0) < 0) _exit(2);
+
+    /* 레코드 / 메타데이터 이동까지만 (RELEASE 직전) */
+    while (bf->compact.phase != BRAIN_COMPACT_RELEASE) {
+        if (brain_file_compact_step(bf, 512) <= 0) _exit(3);
+    }
+    if (bf->compact.stats.moved == 0 || bf->compact.stats.meta_moved == 0) _exit(4);
+
+    /* 옮긴 메타데이터 자리에 새 메타데이터가 재생되도록 */
+    for (int64_t id = 10000; id < 10100; id++) put(bf, id, 0);
+    if (brain_file_commit(bf, 0) < 0) _exit(2);
+    _exit(0);
+}
+
+static int verify_compacted(const brain_file_t* bf) {
+    for (int64_t id = 0; id < 8000; id++) {
+        if (check(bf, id, deleted_id(id) ? -1 : 0) < 0) return -1;
+    }
+    for (int64_t id = 10000; id < 10100; id++) {
+        if (check(bf, id, 0) < 0) return -1;
+    }
+    if (brain_file_count(bf) != 8000 - 2148 + 100) {
+        printf("✗ Count %lu\n", (unsigned long)brain_file_count(bf));
+        return -1;
+    }
+    return 0;
+}
+
+static int test_compaction_crash(void) {
+    printf("\n=== Test 3: Crash During Compaction + Torn Log Tail ===\n");
+    cleanup();
+
+    if (run_child(compact_child) < 0) {
+        printf("✗ Child failed\n");
+        return -1;
+    }
+
+    /* 쓰다 만 레코드 흉내 */
+    FILE* f = fopen(TEST_WAL, "ab");
+    if (!f) return -1;
+    brain_wal_record_t torn = { 0x12345678, 4096, 999999, BRAIN_WAL_PUT, 0 };
+    fwrite(&torn, sizeof(torn), 1, f);
+    fwrite("partial", 1, 7, f);
+    fclose(f);
+
+    brain_file_t* bf = brain_file_open_durable(TEST_BRAIN, TEST_WAL, 0);
+    if (!bf) {
+        printf("✗ Recovery failed\n");
+        return -1;
+    }
+
+    int result = verify_compacted(bf);
+    if (result == 0) printf("✓ Records and metadata restored to their pre-move homes\n");
+
+    /* 복구 후 컴팩션을 처음부터 끝까지 */
+    if (result == 0 && (brain_file_compact(bf) < 0 || bf->compact.stats.cycles != 1 ||
+                        bf->compact.stats.chunks_freed == 0)) {
+        printf("✗ Compaction after recovery failed\n");
+        result = -1;
+    }
+    if (result == 0) result = verify_compacted(bf);
+    brain_file_close(bf);
+
+    bf = brain_file_open_durable(TEST_BRAIN, TEST_WAL, 0);
+    if (result == 0 && (!bf || verify_compacted(bf) < 0)) result = -1;
+    brain_file_close(bf);
+
+    if (result == 0) printf("✓ Compaction completed after recovery, file reopens intact\n");
+    cleanup();
+    return result;
+}
+
+int main(void) {
+    printf("╔════════════════════════════════════════════════════════════╗\n");
+    printf("║                  Write-Ahead Log Test                      ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n");
+
+    int result = 0;
+    if (test_group_commit() < 0) result = 1;
+    if (test_recovery() < 0) result = 1;
+    if (test_compaction_crash() < 0) result = 1;
+
+    cleanup();
+
+    if (result == 0) {
+        printf("\n╔════════════════════════════════════════════════════════════╗\n");
+        printf("║                   All Tests Passed!                        ║\n");
+        printf("╚════════════════════════════════════════════════════════════╝\n");
+    } else {
+        printf("\n✗ Some tests failed\n");
+    }
+
+    return result;
+}
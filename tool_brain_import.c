@@ -0,0 +1,92 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * tool_brain_import.c
+ *
+ * brain_import 명령행 도구
+ *
+ *   brain_import [옵션] <원본 .fvecs|.npy|.csv> <대상 .brain>
+ *
+ *   -t N          스레드 수 (기본: CPU 수)
+ *   -f FORMAT     fvecs / npy / csv (기본: 확장자)
+ *   --id-column   CSV 첫 열을 ID로 사용
+ *   --first-id N  ID 시작 번호 (기본 0)
+ *   --grouped     ID 인덱스 GROUPED 레이아웃
+ *   --ivf         IVF 벡터 인덱스도 구축해 <대상>.ivf로 저장
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#include "brain_import.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "usage: %s [-t threads] [-f fvecs|npy|csv] [--id-column] [--first-id N]\n"
+            "          [--grouped] [--ivf] <source> <target.brain>\n", prog);
+}
+
+int main(int argc, char** argv) {
+    brain_import_options_t opt;
+    brain_import_defaults(&opt);
+
+    int build_ivf = 0;
+    const char* paths[2] = { NULL, NULL };
+    int npaths = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            opt.threads = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            const char* f = argv[++i];
+            opt.format = strcmp(f, "fvecs") == 0 ? BRAIN_IMPORT_FVECS :
+                         strcmp(f, "npy") == 0   ? BRAIN_IMPORT_NPY :
+                         strcmp(f, "csv") == 0   ? BRAIN_IMPORT_CSV : BRAIN_IMPORT_AUTO;
+        } else if (strcmp(argv[i], "--id-column") == 0) {
+            opt.csv_id_column = 1;
+        } else if (strcmp(argv[i], "--first-id") == 0 && i + 1 < argc) {
+            opt.first_id = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--grouped") == 0) {
+            opt.layout = INDEX_LAYOUT_GROUPED;
+        } else if (strcmp(argv[i], "--ivf") == 0) {
+            build_ivf = 1;
+        } else if (argv[i][0] != '-' && npaths < 2) {
+            paths[npaths++] = argv[i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (npaths != 2) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    brain_import_stats_t stats;
+    if (brain_import(paths[0], paths[1], &opt, &stats) < 0) return 1;
+
+    /* IVF는 차원을 알아야 만들 수 있으므로 적재가 끝난 파일에서 구축 */
+    if (build_ivf) {
+        brain_file_t* bf = brain_file_open(paths[1], 0);
+        if (!bf) return 1;
+
+        vector_index_t* vi = vector_index_create(VECTOR_INDEX_IVF, stats.dim,
+                                                 (uint32_t)stats.imported);
+        const brain_header_t* header = brain_file_header(bf);
+        for (uint64_t r = 0; r < header->record_count; r++) {
+            brain_entry_t e;
+            if (brain_file_entry(bf, r, &e) == 0 && (e.record->flags & BRAIN_RECORD_LIVE)) {
+                vector_index_insert(vi, e.record->id, e.vector);
+            }
+        }
+
+        char ivf_path[4096];
+        snprintf(ivf_path, sizeof(ivf_path), "%s.ivf", paths[1]);
+        int rc = ivf_save(vi->impl.ivf, ivf_path);
+        printf("[import] %s IVF index → %s\n", rc == 0 ? "✓" : "❌", ivf_path);
+
+        vector_index_destroy(vi);
+        brain_file_close(bf);
+        if (rc != 0) return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,613 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * vec_kernels.c
+ *
+ * 벡터 거리 커널 구현 (런타임 디스패치)
+ *
+ * Zero Dependency: 컴파일러 내장 intrinsic만 사용
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#include "vec_kernels.h"
+#include <math.h>
+#include <string.h>
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define VEC_X86 1
+#include <immintrin.h>
+#endif
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Scalar (기준 구현)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static float dot_scalar(const float* a, const float* b, uint32_t dim) {
+    float dot = 0.0f;
+    for (uint32_t i = 0; i < dim; i++) {
+        dot += a[i] * b[i];
+    }
+    return dot;
+}
+
+static void dot_norms_scalar(const float* a, const float* b, uint32_t dim,
+                             float* dot, float* na, float* nb) {
+    float d = 0.0f, x = 0.0f, y = 0.0f;
+    for (uint32_t i = 0; i < dim; i++) {
+        d += a[i] * b[i];
+        x += a[i] * a[i];
+        y += b[i] * b[i];
+    }
+    *dot = d;
+    *na = x;
+    *nb = y;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Half Precision 변환 (Scalar)
+ *
+ * fp16: IEEE 754 binary16 (1/5/10), 최근접 짝수 반올림
+ * bf16: fp32 상위 16비트 (1/8/7), 최근접 짝수 반올림
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static inline uint32_t f32_bits(float f) {
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    return x;
+}
+
+static inline float bits_f32(uint32_t x) {
+    float f;
+    memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+static uint16_t f32_to_f16(float f) {
+    uint32_t x = f32_bits(f);
+    uint32_t sign = (x >> 16) & 0x8000;
+    uint32_t exp = (x >> 23) & 0xFF;
+    uint32_t mant = x & 0x7FFFFF;
+
+    if (exp == 0xFF) {
+        return (uint16_t)(sign | 0x7C00 | (mant ? 0x200 : 0));  /* Inf / NaN */
+    }
+
+    int32_t e = (int32_t)exp - 127 + 15;
+    if (e >= 31) return (uint16_t)(sign | 0x7C00);              /* Overflow → Inf */
+
+    if (e <= 0) {
+        if (e < -10) return (uint16_t)sign;                     /* Underflow → 0 */
+
+        /* Subnormal */
+        mant |= 0x800000;
+        uint32_t shift = (uint32_t)(14 - e);
+        uint32_t half = mant >> shift;
+        uint32_t rem = mant & ((1u << shift) - 1);
+        uint32_t mid = 1u << (shift - 1);
+        if (rem > mid || (rem == mid && (half & 1))) half++;
+        return (uint16_t)(sign | half);
+    }
+
+    /* 반올림 자리올림이 지수로 넘어가도 올바른 값 (최대 → Inf) */
+    uint32_t half = ((uint32_t)e << 10) | (mant >> 13);
+    uint32_t rem = mant & 0x1FFF;
+    if (rem > 0x1000 || (rem == 0x1000 && (half & 1))) half++;
+    return (uint16_t)(sign | half);
+}
+
+static float f16_to_f32(uint16_t h) {
+    uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+    uint32_t exp = (h >> 10) & 0x1F;
+    uint32_t mant = h & 0x3FF;
+
+    if (exp == 0) {
+        if (mant == 0) return bits_f32(sign);
+
+        /* Subnormal → 정규화 */
+        exp = 127 - 15 + 1;
+        while (!(mant & 0x400)) {
+            mant <<= 1;
+            exp--;
+        }
+        return bits_f32(sign | (exp << 23) | ((mant & 0x3FF) << 13));
+    }
+    if (exp == 0x1F) {
+        return bits_f32(sign | 0x7F800000 | (mant << 13));
+    }
+    return bits_f32(sign | ((exp + 112) << 23) | (mant << 13));
+}
+
+static inline uint16_t f32_to_bf16(float f) {
+    uint32_t x = f32_bits(f);
+    if ((x & 0x7FFFFFFF) > 0x7F800000) {
+        return (uint16_t)((x >> 16) | 0x40);                    /* Quiet NaN 유지 */
+    }
+    return (uint16_t)((x + 0x7FFF + ((x >> 16) & 1)) >> 16);
+}
+
+static inline float bf16_to_f32(uint16_t h) {
+    return bits_f32((uint32_t)h << 16);
+}
+
+static void encode_f16_scalar(const float* src, uint16_t* dst, uint32_t dim) {
+    for (uint32_t i = 0; i < dim; i++) dst[i] = f32_to_f16(src[i]);
+}
+
+static void decode_f16_scalar(const uint16_t* src, float* dst, uint32_t dim) {
+    for (uint32_t i = 0; i < dim; i++) dst[i] = f16_to_f32(src[i]);
+}
+
+static void encode_bf16_scalar(const float* src, uint16_t* dst, uint32_t dim) {
+    for (uint32_t i = 0; i < dim; i++) dst[i] = f32_to_bf16(src[i]);
+}
+
+static float dot_f16_scalar(const float* q, const uint16_t* v, uint32_t dim) {
+    float dot = 0.0f;
+    for (uint32_t i = 0; i < dim; i++) {
+        dot += q[i] * f16_to_f32(v[i]);
+    }
+    return dot;
+}
+
+static void dot_norms_f16_scalar(const float* q, const uint16_t* v, uint32_t dim,
+                                 float* dot, float* nq, float* nv) {
+    float d = 0.0f, x = 0.0f, y = 0.0f;
+    for (uint32_t i = 0; i < dim; i++) {
+        float b = f16_to_f32(v[i]);
+        d += q[i] * b;
+        x += q[i] * q[i];
+        y += b * b;
+    }
+    *dot = d;
+    *nq = x;
+    *nv = y;
+}
+
+static float dot_bf16_scalar(const float* q, const uint16_t* v, uint32_t dim) {
+    float dot = 0.0f;
+    for (uint32_t i = 0; i < dim; i++) {
+        dot += q[i] * bf16_to_f32(v[i]);
+    }
+    return dot;
+}
+
+static void dot_norms_bf16_scalar(const float* q, const uint16_t* v, uint32_t dim,
+                                  float* dot, float* nq, float* nv) {
+    float d = 0.0f, x = 0.0f, y = 0.0f;
+    for (uint32_t i = 0; i < dim; i++) {
+        float b = bf16_to_f32(v[i]);
+        d += q[i] * b;
+        x += q[i] * q[i];
+        y += b * b;
+    }
+    *dot = d;
+    *nq = x;
+    *nv = y;
+}
+
+#ifdef VEC_X86
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * SSE2 (x86-64 기본 ISA)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+static inline float hsum_sse(__m128 v) {
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    sums = _mm_add_ss(sums, shuf);
+    return _mm_cvtss_f32(sums);
+}
+
+__attribute__((target("sse2")))
+static float dot_sse2(const float* a, const float* b, uint32_t dim) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    uint32_t i = 0;
+
+    for (; i + 8 <= dim; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+
+    float dot = hsum_sse(_mm_add_ps(acc0, acc1));
+    for (; i < dim; i++) {
+        dot += a[i] * b[i];
+    }
+    return dot;
+}
+
+__attribute__((target("sse2")))
+static void dot_norms_sse2(const float* a, const float* b, uint32_t dim,
+                           float* dot, float* na, float* nb) {
+    __m128 d = _mm_setzero_ps();
+    __m128 x = _mm_setzero_ps();
+    __m128 y = _mm_setzero_ps();
+    uint32_t i = 0;
+
+    for (; i + 4 <= dim; i += 4) {
+        __m128 va = _mm_loadu_ps(a + i);
+        __m128 vb = _mm_loadu_ps(b + i);
+        d = _mm_add_ps(d, _mm_mul_ps(va, vb));
+        x = _mm_add_ps(x, _mm_mul_ps(va, va));
+        y = _mm_add_ps(y, _mm_mul_ps(vb, vb));
+    }
+
+    float sd = hsum_sse(d), sx = hsum_sse(x), sy = hsum_sse(y);
+    for (; i < dim; i++) {
+        sd += a[i] * b[i];
+        sx += a[i] * a[i];
+        sy += b[i] * b[i];
+    }
+    *dot = sd;
+    *na = sx;
+    *nb = sy;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * AVX2 + FMA
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+__attribute__((target("avx2,fma")))
+static inline float hsum_avx(__m256 v) {
+    __m128 lo = _mm256_castps256_ps128(v);
+    __m128 hi = _mm256_extractf128_ps(v, 1);
+    return hsum_sse(_mm_add_ps(lo, hi));
+}
+
+__attribute__((target("avx2,fma")))
+static float dot_avx2(const float* a, const float* b, uint32_t dim) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    uint32_t i = 0;
+
+    for (; i + 16 <= dim; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    for (; i + 8 <= dim; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    }
+
+    float dot = hsum_avx(_mm256_add_ps(acc0, acc1));
+    for (; i < dim; i++) {
+        dot += a[i] * b[i];
+    }
+    return dot;
+}
+
+__attribute__((target("avx2,fma")))
+static void dot_norms_avx2(const float* a, const float* b, uint32_t dim,
+                           float* dot, float* na, float* nb) {
+    __m256 d = _mm256_setzero_ps();
+    __m256 x = _mm256_setzero_ps();
+    __m256 y = _mm256_setzero_ps();
+    uint32_t i = 0;
+
+    for (; i + 8 <= dim; i += 8) {
+        __m256 va = _mm256_loadu_ps(a + i);
+        __m256 vb = _mm256_loadu_ps(b + i);
+        d = _mm256_fmadd_ps(va, vb, d);
+        x = _mm256_fmadd_ps(va, va, x);
+        y = _mm256_fmadd_ps(vb, vb, y);
+    }
+
+    float sd = hsum_avx(d), sx = hsum_avx(x), sy = hsum_avx(y);
+    for (; i < dim; i++) {
+        sd += a[i] * b[i];
+        sx += a[i] * a[i];
+        sy += b[i] * b[i];
+    }
+    *dot = sd;
+    *na = sx;
+    *nb = sy;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * AVX2 + FMA + F16C (fp16 / bf16 저장 벡터)
+ *
+ * 저장 벡터 8개 요소를 레지스터에서 fp32로 확장한 뒤 FMA.
+ * fp16: vcvtph2ps (F16C)
+ * bf16: 16비트 좌측 시프트 (정확한 변환이므로 전용 명령 불필요)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+__attribute__((target("avx2,fma,f16c")))
+static inline __m256 load_f16x8(const uint16_t* v) {
+    return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)v));
+}
+
+__attribute__((target("avx2,fma")))
+static inline __m256 load_bf16x8(const uint16_t* v) {
+    __m256i wide = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)v));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(wide, 16));
+}
+
+__attribute__((target("avx2,fma,f16c")))
+static float dot_f16_avx2(const float* q, const uint16_t* v, uint32_t dim) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    uint32_t i = 0;
+
+    for (; i + 16 <= dim; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(q + i), load_f16x8(v + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(q + i + 8), load_f16x8(v + i + 8), acc1);
+    }
+    for (; i + 8 <= dim; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(q + i), load_f16x8(v + i), acc0);
+    }
+
+    float dot = hsum_avx(_mm256_add_ps(acc0, acc1));
+    for (; i < dim; i++) {
+        dot += q[i] * f16_to_f32(v[i]);
+    }
+    return dot;
+}
+
+__attribute__((target("avx2,fma,f16c")))
+static void dot_norms_f16_avx2(const float* q, const uint16_t* v, uint32_t dim,
+                               float* dot, float* nq, float* nv) {
+    __m256 d = _mm256_setzero_ps();
+    __m256 x = _mm256_setzero_ps();
+    __m256 y = _mm256_setzero_ps();
+    uint32_t i = 0;
+
+    for (; i + 8 <= dim; i += 8) {
+        __m256 va = _mm256_loadu_ps(q + i);
+        __m256 vb = load_f16x8(v + i);
+        d = _mm256_fmadd_ps(va, vb, d);
+        x = _mm256_fmadd_ps(va, va, x);
+        y = _mm256_fmadd_ps(vb, vb, y);
+    }
+
+    float sd = hsum_avx(d), sx = hsum_avx(x), sy = hsum_avx(y);
+    for (; i < dim; i++) {
+        float b = f16_to_f32(v[i]);
+        sd += q[i] * b;
+        sx += q[i] * q[i];
+        sy += b * b;
+    }
+    *dot = sd;
+    *nq = sx;
+    *nv = sy;
+}
+
+__attribute__((target("avx2,fma")))
+static float dot_bf16_avx2(const float* q, const uint16_t* v, uint32_t dim) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    uint32_t i = 0;
+
+    for (; i + 16 <= dim; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(q + i), load_bf16x8(v + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(q + i + 8), load_bf16x8(v + i + 8), acc1);
+    }
+    for (; i + 8 <= dim; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(q + i), load_bf16x8(v + i), acc0);
+    }
+
+    float dot = hsum_avx(_mm256_add_ps(acc0, acc1));
+    for (; i < dim; i++) {
+        dot += q[i] * bf16_to_f32(v[i]);
+    }
+    return dot;
+}
+
+__attribute__((target("avx2,fma")))
+static void dot_norms_bf16_avx2(const float* q, const uint16_t* v, uint32_t dim,
+                                float* dot, float* nq, float* nv) {
+    __m256 d = _mm256_setzero_ps();
+    __m256 x = _mm256_setzero_ps();
+    __m256 y = _mm256_setzero_ps();
+    uint32_t i = 0;
+
+    for (; i + 8 <= dim; i += 8) {
+        __m256 va = _mm256_loadu_ps(q + i);
+        __m256 vb = load_bf16x8(v + i);
+        d = _mm256_fmadd_ps(va, vb, d);
+        x = _mm256_fmadd_ps(va, va, x);
+        y = _mm256_fmadd_ps(vb, vb, y);
+    }
+
+    float sd = hsum_avx(d), sx = hsum_avx(x), sy = hsum_avx(y);
+    for (; i < dim; i++) {
+        float b = bf16_to_f32(v[i]);
+        sd += q[i] * b;
+        sx += q[i] * q[i];
+        sy += b * b;
+    }
+    *dot = sd;
+    *nq = sx;
+    *nv = sy;
+}
+
+__attribute__((target("avx2,f16c")))
+static void encode_f16_f16c(const float* src, uint16_t* dst, uint32_t dim) {
+    uint32_t i = 0;
+    for (; i + 8 <= dim; i += 8) {
+        __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i*)(dst + i), h);
+    }
+    for (; i < dim; i++) dst[i] = f32_to_f16(src[i]);
+}
+
+__attribute__((target("avx2,f16c")))
+static void decode_f16_f16c(const uint16_t* src, float* dst, uint32_t dim) {
+    uint32_t i = 0;
+    for (; i + 8 <= dim; i += 8) {
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(src + i))));
+    }
+    for (; i < dim; i++) dst[i] = f16_to_f32(src[i]);
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * AVX-512 BF16 (fp32 → bf16 인코딩, vcvtneps2bf16)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+__attribute__((target("avx512f,avx512bf16")))
+static void encode_bf16_avx512(const float* src, uint16_t* dst, uint32_t dim) {
+    uint32_t i = 0;
+    for (; i + 16 <= dim; i += 16) {
+        __m256bh h = _mm512_cvtneps_pbh(_mm512_loadu_ps(src + i));
+        memcpy(dst + i, &h, sizeof(h));
+    }
+    for (; i < dim; i++) dst[i] = f32_to_bf16(src[i]);
+}
+#endif /* VEC_X86 */
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Dispatch
+ *
+ * 첫 호출 시 pthread_once로 한 번만 결정 (동시에 처음 부르는 스레드는
+ * 결정이 끝날 때까지 기다림 → 반쯤 채워진 g_impl을 보지 않음).
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+typedef float (*dot_half_fn)(const float*, const uint16_t*, uint32_t);
+typedef void  (*dot_norms_half_fn)(const float*, const uint16_t*, uint32_t,
+                                   float*, float*, float*);
+
+typedef struct {
+    float (*dot)(const float*, const float*, uint32_t);
+    void  (*dot_norms)(const float*, const float*, uint32_t, float*, float*, float*);
+    const char* name;
+
+    /* Half precision 저장 벡터 (쿼리는 fp32) */
+    dot_half_fn       dot_f16;
+    dot_norms_half_fn dot_norms_f16;
+    dot_half_fn       dot_bf16;
+    dot_norms_half_fn dot_norms_bf16;
+    void (*encode_f16)(const float*, uint16_t*, uint32_t);
+    void (*decode_f16)(const uint16_t*, float*, uint32_t);
+    void (*encode_bf16)(const float*, uint16_t*, uint32_t);
+} vec_impl_t;
+
+static vec_impl_t g_impl;
+static pthread_once_t g_impl_once = PTHREAD_ONCE_INIT;
+
+static void resolve_impl(void) {
+    vec_impl_t impl = {
+        dot_scalar, dot_norms_scalar, "scalar",
+        dot_f16_scalar, dot_norms_f16_scalar,
+        dot_bf16_scalar, dot_norms_bf16_scalar,
+        encode_f16_scalar, decode_f16_scalar, encode_bf16_scalar
+    };
+
+#ifdef VEC_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        impl.dot = dot_avx2;
+        impl.dot_norms = dot_norms_avx2;
+        impl.name = "avx2";
+        impl.dot_bf16 = dot_bf16_avx2;
+        impl.dot_norms_bf16 = dot_norms_bf16_avx2;
+
+        if (__builtin_cpu_supports("f16c")) {
+            impl.dot_f16 = dot_f16_avx2;
+            impl.dot_norms_f16 = dot_norms_f16_avx2;
+            impl.encode_f16 = encode_f16_f16c;
+            impl.decode_f16 = decode_f16_f16c;
+            impl.name = "avx2+f16c";
+        }
+    } else if (__builtin_cpu_supports("sse2")) {
+        impl.dot = dot_sse2;
+        impl.dot_norms = dot_norms_sse2;
+        impl.name = "sse2";
+    }
+
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bf16")) {
+        impl.encode_bf16 = encode_bf16_avx512;
+    }
+#endif
+
+    g_impl = impl;
+}
+
+static inline const vec_impl_t* impl(void) {
+    pthread_once(&g_impl_once, resolve_impl);
+    return &g_impl;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Public API
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+float vec_dot(const float* a, const float* b, uint32_t dim) {
+    return impl()->dot(a, b, dim);
+}
+
+float vec_norm_sq(const float* a, uint32_t dim) {
+    return impl()->dot(a, a, dim);
+}
+
+float vec_cosine_distance(const float* a, const float* b, uint32_t dim) {
+    float dot, norm_a, norm_b;
+    impl()->dot_norms(a, b, dim, &dot, &norm_a, &norm_b);
+
+    if (norm_a == 0.0f || norm_b == 0.0f) {
+        return 1.0f;  /* Undefined → 최대 거리 */
+    }
+
+    float cosine = dot / (sqrtf(norm_a) * sqrtf(norm_b));
+    return 1.0f - cosine;  /* [0, 2] 범위 */
+}
+
+const char* vec_kernels_isa(void) {
+    return impl()->name;
+}
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Storage Formats (fp32 / fp16 / bf16)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+size_t vec_storage_size(vec_storage_t storage) {
+    return (storage == VEC_STORAGE_F32) ? sizeof(float) : sizeof(uint16_t);
+}
+
+const char* vec_storage_string(vec_storage_t storage) {
+    switch (storage) {
+        case VEC_STORAGE_F32:  return "fp32";
+        case VEC_STORAGE_F16:  return "fp16";
+        case VEC_STORAGE_BF16: return "bf16";
+        default:               return "unknown";
+    }
+}
+
+void vec_encode(vec_storage_t storage, const float* src, void* dst, uint32_t dim) {
+    switch (storage) {
+        case VEC_STORAGE_F32:  memcpy(dst, src, (size_t)dim * sizeof(float)); break;
+        case VEC_STORAGE_F16:  impl()->encode_f16(src, (uint16_t*)dst, dim);  break;
+        case VEC_STORAGE_BF16: impl()->encode_bf16(src, (uint16_t*)dst, dim); break;
+    }
+}
+
+void vec_decode(vec_storage_t storage, const void* src, float* dst, uint32_t dim) {
+    switch (storage) {
+        case VEC_STORAGE_F32:
+            memcpy(dst, src, (size_t)dim * sizeof(float));
+            break;
+        case VEC_STORAGE_F16:
+            impl()->decode_f16((const uint16_t*)src, dst, dim);
+            break;
+        case VEC_STORAGE_BF16:
+            for (uint32_t i = 0; i < dim; i++) {
+                dst[i] = bf16_to_f32(((const uint16_t*)src)[i]);
+            }
+            break;
+    }
+}
+
+float vec_dot_stored(vec_storage_t storage, const float* q, const void* v, uint32_t dim) {
+    switch (storage) {
+        case VEC_STORAGE_F16:  return impl()->dot_f16(q, (const uint16_t*)v, dim);
+        case VEC_STORAGE_BF16: return impl()->dot_bf16(q, (const uint16_t*)v, dim);
+        default:               return impl()->dot(q, (const float*)v, dim);
+    }
+}
+
+float vec_cosine_distance_stored(vec_storage_t storage, const float* q,
+                                 const void* v, uint32_t dim) {
+    float dot, norm_q, norm_v;
+
+    switch (storage) {
+        case VEC_STORAGE_F16:
+            impl()->dot_norms_f16(q, (const uint16_t*)v, dim, &dot, &norm_q, &norm_v);
+            break;
+        case VEC_STORAGE_BF16:
+            impl()->dot_norms_bf16(q, (const uint16_t*)v, dim, &dot, &norm_q, &norm_v);
+            break;
+        default:
+            return vec_cosine_distance(q, (const float*)v, dim);
+    }
+
+    if (norm_q == 0.0f || norm_v == 0.0f) {
+        return 1.0f;
+    }
+    return 1.0f - dot / (sqrtf(norm_q) * sqrtf(norm_v));
+}
@@ -0,0 +1,69 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * vec_kernels.h
+ *
+ * 벡터 거리 커널 (SIMD)
+ *
+ * 목적:
+ *   - HNSW / IVF 가 공유하는 내적·코사인 거리 계산
+ *   - CPU 기능을 런타임에 감지하여 가장 빠른 구현 선택
+ *
+ * 구현 선택 순서 (x86-64):
+ *   AVX2+FMA → SSE2 → Scalar
+ *   그 외 아키텍처는 Scalar
+ *
+ * 저장 형식 (fp16 / bf16):
+ *   - 벡터를 16비트로 저장 → 메모리·대역폭 절반
+ *   - 쿼리는 fp32 유지, 커널이 저장 벡터를 레지스터에서 fp32로 확장
+ *   - fp16: F16C, bf16 인코딩: AVX-512 BF16 (없으면 Scalar)
+ *
+ * -march 플래그 없이 빌드해도 target attribute로 SIMD 경로가 컴파일되며,
+ * 실행 시 __builtin_cpu_supports()로 선택된다.
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#ifndef VEC_KERNELS_H
+#define VEC_KERNELS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Storage Formats
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+typedef enum {
+    VEC_STORAGE_F32  = 0,       /* 4 bytes/요소 (기본) */
+    VEC_STORAGE_F16  = 1,       /* IEEE binary16, 범위 ±65504 */
+    VEC_STORAGE_BF16 = 2        /* bfloat16, fp32와 같은 지수 범위 */
+} vec_storage_t;
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Functions
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 내적 a·b */
+float vec_dot(const float* a, const float* b, uint32_t dim);
+
+/* 제곱 노름 |a|² */
+float vec_norm_sq(const float* a, uint32_t dim);
+
+/* 코사인 거리 (1 - cos), 한 번의 패스로 dot/norm 동시 계산
+ * 노름이 0이면 1.0 (hnsw_distance와 동일한 규약) */
+float vec_cosine_distance(const float* a, const float* b, uint32_t dim);
+
+/* 선택된 구현 이름 ("avx2+f16c", "avx2", "sse2", "scalar") */
+const char* vec_kernels_isa(void);
+
+/* 요소당 바이트 수 / 이름 */
+size_t      vec_storage_size(vec_storage_t storage);
+const char* vec_storage_string(vec_storage_t storage);
+
+/* fp32 ↔ 저장 형식 변환 (dst는 dim × vec_storage_size 바이트) */
+void vec_encode(vec_storage_t storage, const float* src, void* dst, uint32_t dim);
+void vec_decode(vec_storage_t storage, const void* src, float* dst, uint32_t dim);
+
+/* fp32 쿼리 × 저장 벡터 */
+float vec_dot_stored(vec_storage_t storage, const float* q, const void* v, uint32_t dim);
+float vec_cosine_distance_stored(vec_storage_t storage, const float* q,
+                                 const void* v, uint32_t dim);
+
+#endif /* VEC_KERNELS_H */
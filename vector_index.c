@@ -0,0 +1,165 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * vector_index.c
+ *
+ * 벡터 인덱스 공통 API 구현 (종류별 디스패치)
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#include "vector_index.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+/* IVF 리스트 수: 예상 벡터 수의 제곱근 (16 ~ 65536) */
+static uint32_t ivf_nlist_for(uint32_t capacity) {
+    if (capacity == 0) return IVF_DEFAULT_NLIST;
+
+    uint32_t nlist = (uint32_t)sqrt((double)capacity);
+    if (nlist < 16) nlist = 16;
+    if (nlist > 65536) nlist = 65536;
+    return nlist;
+}
+
+vector_index_t* vector_index_create(vector_index_type_t type, uint32_t dim, uint32_t capacity) {
+    return vector_index_create_ex(type, dim, capacity, VEC_STORAGE_F32);
+}
+
+vector_index_t* vector_index_create_ex(vector_index_type_t type, uint32_t dim, uint32_t capacity,
+                                       vec_storage_t storage) {
+    vector_index_t* vi = (vector_index_t*)calloc(1, sizeof(vector_index_t));
+    if (!vi) {
+        fprintf(stderr, "[vindex] Error: malloc failed\n");
+        return NULL;
+    }
+
+    vi->type = type;
+    vi->dim = dim;
+
+    void* impl = NULL;
+    switch (type) {
+        case VECTOR_INDEX_HNSW:
+            impl = vi->impl.hnsw = hnsw_create_ex(dim, capacity, storage);
+            break;
+        case VECTOR_INDEX_IVF:
+            impl = vi->impl.ivf = ivf_create_ex(dim, ivf_nlist_for(capacity), storage);
+            break;
+    }
+
+    if (!impl) {
+        fprintf(stderr, "[vindex] Error: cannot create %s index\n",
+                vector_index_type_string(type));
+        free(vi);
+        return NULL;
+    }
+
+    return vi;
+}
+
+vector_index_t* vector_index_load_ivf(const char* filepath) {
+    return vector_index_load(VECTOR_INDEX_IVF, filepath, 0);
+}
+
+vector_index_t* vector_index_load(vector_index_type_t type, const char* filepath,
+                                  uint32_t capacity) {
+    vector_index_t* vi = (vector_index_t*)calloc(1, sizeof(vector_index_t));
+    if (!vi) {
+        fprintf(stderr, "[vindex] Error: malloc failed\n");
+        return NULL;
+    }
+
+    vi->type = type;
+    switch (type) {
+        case VECTOR_INDEX_HNSW:
+            vi->impl.hnsw = hnsw_load(filepath, capacity);
+            if (vi->impl.hnsw) vi->dim = vi->impl.hnsw->dim;
+            break;
+        case VECTOR_INDEX_IVF:
+            vi->impl.ivf = ivf_load(filepath);
+            if (vi->impl.ivf) vi->dim = vi->impl.ivf->dim;
+            break;
+    }
+
+    if (vi->dim == 0) {
+        free(vi);
+        return NULL;
+    }
+    return vi;
+}
+
+int vector_index_save(const vector_index_t* vi, const char* filepath) {
+    if (!vi) return -1;
+
+    switch (vi->type) {
+        case VECTOR_INDEX_HNSW: return hnsw_save(vi->impl.hnsw, filepath);
+        case VECTOR_INDEX_IVF:  return ivf_save(vi->impl.ivf, filepath);
+    }
+    return -1;
+}
+
+void vector_index_destroy(vector_index_t* vi) {
+    if (!vi) return;
+
+    switch (vi->type) {
+        case VECTOR_INDEX_HNSW: hnsw_destroy(vi->impl.hnsw); break;
+        case VECTOR_INDEX_IVF:  ivf_destroy(vi->impl.ivf);   break;
+    }
+
+    free(vi);
+}
+
+int vector_index_insert(vector_index_t* vi, int64_t id, const float* vector) {
+    if (!vi) return -1;
+
+    switch (vi->type) {
+        case VECTOR_INDEX_HNSW: return hnsw_insert(vi->impl.hnsw, id, vector);
+        case VECTOR_INDEX_IVF:  return ivf_add(vi->impl.ivf, id, vector);
+    }
+    return -1;
+}
+
+int vector_index_search(const vector_index_t* vi, const float* query,
+                        uint32_t k, hnsw_result_t* results) {
+    if (!vi) return -1;
+
+    switch (vi->type) {
+        case VECTOR_INDEX_HNSW: return hnsw_search(vi->impl.hnsw, query, k, results);
+        case VECTOR_INDEX_IVF:  return ivf_search(vi->impl.ivf, query, k, results);
+    }
+    return -1;
+}
+
+int vector_index_contains(const vector_index_t* vi, int64_t id) {
+    if (!vi) return 0;
+
+    switch (vi->type) {
+        case VECTOR_INDEX_HNSW: return hnsw_contains(vi->impl.hnsw, id);
+        case VECTOR_INDEX_IVF:  return ivf_contains(vi->impl.ivf, id);
+    }
+    return 0;
+}
+
+uint64_t vector_index_count(const vector_index_t* vi) {
+    if (!vi) return 0;
+
+    switch (vi->type) {
+        case VECTOR_INDEX_HNSW: return vi->impl.hnsw->count;
+        case VECTOR_INDEX_IVF:  return vi->impl.ivf->count;
+    }
+    return 0;
+}
+
+void vector_index_stats(const vector_index_t* vi) {
+    if (!vi) return;
+
+    switch (vi->type) {
+        case VECTOR_INDEX_HNSW: hnsw_stats(vi->impl.hnsw); break;
+        case VECTOR_INDEX_IVF:  ivf_stats(vi->impl.ivf);   break;
+    }
+}
+
+const char* vector_index_type_string(vector_index_type_t type) {
+    switch (type) {
+        case VECTOR_INDEX_HNSW: return "HNSW";
+        case VECTOR_INDEX_IVF:  return "IVF";
+        default:                return "UNKNOWN";
+    }
+}
@@ -0,0 +1,73 @@
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * vector_index.h
+ *
+ * 벡터 인덱스 공통 API (HNSW / IVF 선택)
+ *
+ * 목적:
+ *   - 배포 환경별로 인덱스 종류를 선택 (Hippocampus 등)
+ *   - 호출 측은 종류와 무관하게 insert / search 사용
+ *
+ * 선택 기준:
+ *   - HNSW: 점진적 삽입, 높은 recall, 링크 메모리 큼
+ *   - IVF:  대량 적재, 빠른 구축, mmap 로드
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+#ifndef VECTOR_INDEX_H
+#define VECTOR_INDEX_H
+
+#include <stdint.h>
+#include "hnsw.h"
+#include "ivf.h"
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Data Structures
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+typedef enum {
+    VECTOR_INDEX_HNSW = 0,      /* 계층 그래프 */
+    VECTOR_INDEX_IVF  = 1       /* 역색인 (coarse quantizer) */
+} vector_index_type_t;
+
+typedef struct vector_index_t {
+    vector_index_type_t type;
+    uint32_t            dim;
+    union {
+        hnsw_index_t* hnsw;
+        ivf_index_t*  ivf;
+    } impl;
+} vector_index_t;
+
+/* ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+ * Functions
+ * ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━ */
+
+/* 생성/삭제
+ *   capacity: HNSW = 노드 수, IVF = 예상 벡터 수 (nlist 결정에 사용) */
+vector_index_t* vector_index_create(vector_index_type_t type, uint32_t dim, uint32_t capacity);
+vector_index_t* vector_index_create_ex(vector_index_type_t type, uint32_t dim, uint32_t capacity,
+                                       vec_storage_t storage);
+void            vector_index_destroy(vector_index_t* vi);
+
+/* 기존 IVF 파일을 mmap으로 열어 감싸기 */
+vector_index_t* vector_index_load_ivf(const char* filepath);
+
+/* 저장 / 로드 (HNSW = 그래프 그대로 읽음, IVF = mmap)
+ *   capacity: 로드 후 HNSW 용량 (IVF는 무시) */
+int             vector_index_save(const vector_index_t* vi, const char* filepath);
+vector_index_t* vector_index_load(vector_index_type_t type, const char* filepath,
+                                  uint32_t capacity);
+
+/* 삽입 / 검색 (hnsw_search와 동일한 규약) */
+int vector_index_insert(vector_index_t* vi, int64_t id, const float* vector);
+int vector_index_search(const vector_index_t* vi, const float* query,
+                        uint32_t k, hnsw_result_t* results);
+
+/* ID가 들어 있는가 (HNSW = ID 맵, IVF = 전체 스캔) */
+int vector_index_contains(const vector_index_t* vi, int64_t id);
+
+/* 상태 */
+uint64_t    vector_index_count(const vector_index_t* vi);
+void        vector_index_stats(const vector_index_t* vi);
+const char* vector_index_type_string(vector_index_type_t type);
+
+#endif /* VECTOR_INDEX_H */